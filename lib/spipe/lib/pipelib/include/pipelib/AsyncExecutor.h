@@ -0,0 +1,75 @@
+/*
+ * AsyncExecutor.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef ASYNC_EXECUTOR_H
+#define ASYNC_EXECUTOR_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <vector>
+
+#include <boost/function.hpp>
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+namespace pipelib {
+
+/**
+/* Something that runs jobs on behalf of an AsyncPipeBlock.  The jobs may be run
+/* on other threads but the executor methods themselves are only ever called
+/* from the runner thread.
+/**/
+class AsyncExecutor
+{
+public:
+  typedef size_t Ticket;
+  typedef ::boost::function<void ()> Job;
+  typedef ::std::vector<Ticket> Tickets;
+
+  virtual ~AsyncExecutor() {}
+
+  /** The number of jobs that can be running at the same time. */
+  virtual size_t getNumSlots() const = 0;
+
+  /** Run the job, the ticket is used to report back when it has completed. */
+  virtual void submit(const Ticket ticket, const Job & job) = 0;
+
+  /**
+  /* Get the tickets of all the jobs that have completed since the last call.
+  /* If wait is true and there are jobs outstanding this blocks until at least
+  /* one has completed.
+  /**/
+  virtual void getCompleted(Tickets & completed, const bool wait) = 0;
+};
+
+/**
+/* Runs each job straight away on the calling thread.
+/**/
+class SerialExecutor : public AsyncExecutor
+{
+public:
+  virtual size_t getNumSlots() const { return 1; }
+
+  virtual void submit(const Ticket ticket, const Job & job)
+  {
+    job();
+    myCompleted.push_back(ticket);
+  }
+
+  virtual void getCompleted(Tickets & completed, const bool /*wait*/)
+  {
+    completed.insert(completed.end(), myCompleted.begin(), myCompleted.end());
+    myCompleted.clear();
+  }
+
+private:
+  Tickets myCompleted;
+};
+
+}
+
+#endif /* ASYNC_EXECUTOR_H */
@@ -0,0 +1,115 @@
+/*
+ * AsyncPipeBlock.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef ASYNC_PIPE_BLOCK_H
+#define ASYNC_PIPE_BLOCK_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <map>
+
+#include <boost/shared_ptr.hpp>
+
+#include "pipelib/AsyncExecutor.h"
+#include "pipelib/PipeBlock.h"
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+namespace pipelib {
+
+struct CompletionOrder
+{
+  enum Value
+  {
+    // Data is passed on as soon as the work on it has finished
+    COMPLETION,
+    // Data is passed on in the order it came in
+    SUBMISSION
+  };
+};
+
+/**
+/* A block that hands the (expensive) work on each piece of data to an executor
+/* so that it can be done while the runner carries on.  The work itself is done
+/* by processAsync() which may be called on another thread so it must not touch
+/* the runner or any state shared with the rest of the pipe.  Once the work is
+/* done the data is handed to processed() on the runner thread, so the blocks
+/* downstream see data arriving as normal.
+/**/
+template <typename PipelineData, typename SharedData, typename GlobalData>
+class AsyncPipeBlock : public virtual PipeBlock<PipelineData, SharedData, GlobalData>
+{
+  typedef Block<PipelineData, SharedData, GlobalData> BlockType;
+  typedef typename BlockType::RunnerSetupType RunnerSetupType;
+public:
+  typedef ::boost::shared_ptr<AsyncExecutor> ExecutorPtr;
+
+  /** By default the work is done straight away on the runner thread. */
+  AsyncPipeBlock();
+
+  /**
+  /* Use the given executor, each block should have its own.  At most maxInFlight
+  /* pieces of data are held by the block at any one time, 0 means the number of
+  /* executor slots.
+  /**/
+  void setExecutor(
+    ExecutorPtr executor,
+    const size_t maxInFlight = 0,
+    const CompletionOrder::Value order = CompletionOrder::COMPLETION);
+  AsyncExecutor & getExecutor();
+
+  virtual void in(PipelineData & data);
+
+  /** Is there any data that this block hasn't passed on yet. */
+  bool hasPendingWork() const;
+  /** Wait for all outstanding work to finish and pass on the data. */
+  void finishPendingWork();
+
+protected:
+  /**
+  /* Do the work on the data, possibly on another thread.  Return false if the
+  /* data should be dropped.
+  /**/
+  virtual bool processAsync(PipelineData & data) = 0;
+
+  /**
+  /* Called on the runner thread once the work on the data is done.  By default
+  /* passes the data on or drops it.
+  /**/
+  virtual void processed(PipelineData & data, const bool keep);
+
+  virtual void runnerAttached(RunnerSetupType & setup);
+
+private:
+  struct InFlight
+  {
+    InFlight(): data(NULL), keep(false), done(false) {}
+    PipelineData * data;
+    bool keep;
+    bool done;
+  };
+  typedef AsyncExecutor::Ticket Ticket;
+  typedef ::std::map<Ticket, InFlight> InFlightMap;
+
+  void run(InFlight * const job);
+  void collectCompleted(const bool wait);
+  void pass(const typename InFlightMap::iterator it);
+
+  ExecutorPtr myExecutor;
+  size_t myMaxInFlight;
+  CompletionOrder::Value myOrder;
+
+  /** Keyed by ticket which are handed out in submission order. */
+  InFlightMap myInFlight;
+  Ticket myNextTicket;
+};
+
+}
+
+#include "pipelib/detail/AsyncPipeBlock.h"
+
+#endif /* ASYNC_PIPE_BLOCK_H */
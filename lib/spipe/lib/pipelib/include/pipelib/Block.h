@@ -108,6 +108,21 @@ public:
   void notifyFinished(RunnerAccessType & access);
   void notifyDetached();
 
+  ////////////////////////////////////////////
+  // Checkpointing
+  ////////////////////////////////////////////
+  /**
+  /* Save whatever the block needs to carry on from where it is now into the
+  /* given directory, which the block has to itself.  This is only called at
+  /* points where all the data sent out so far has gone as far as it can.
+  /**/
+  virtual bool saveState(const ::std::string & /*dir*/) { return true; }
+  /**
+  /* Restore the state saved by saveState.  Called once the pipeline is about
+  /* to start running.
+  /**/
+  virtual bool restoreState(const ::std::string & /*dir*/) { return true; }
+
   /**
   /* Set the output block for a particular channel.
   /**/
@@ -0,0 +1,36 @@
+/*
+ * DataPoolTraits.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef DATA_POOL_TRAITS_H
+#define DATA_POOL_TRAITS_H
+
+// INCLUDES /////////////////////////////////////////////
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+namespace pipelib
+{
+
+/**
+/* Runners can keep hold of pipeline data that has finished or been dropped
+/* and hand it out again from createData() rather than freeing it and
+/* allocating new data each time.  This is off by default, to switch it on for
+/* a data type specialise this template with POOLED set to true and a
+/* recycle() that puts the data back into the state of a newly constructed one
+/* (keeping hold of any memory that can be reused).
+/**/
+template <typename PipelineData>
+struct DataPoolTraits
+{
+  static const bool POOLED = false;
+  static void recycle(PipelineData & /*data*/) {}
+};
+
+}
+
+#endif /* DATA_POOL_TRAITS_H */
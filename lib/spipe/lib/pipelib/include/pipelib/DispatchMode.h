@@ -0,0 +1,34 @@
+/*
+ * DispatchMode.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef DISPATCH_MODE_H
+#define DISPATCH_MODE_H
+
+// INCLUDES /////////////////////////////////////////////
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+namespace pipelib
+{
+
+struct DispatchMode
+{
+  enum Value
+  {
+    // Data sent out of a block is passed straight to the next block's in() so
+    // it travels the rest of the pipe on the call stack
+    DIRECT = 0,
+    // Data sent out of a block is put on the runner's work queue and passed on
+    // when the queue is drained, producers are held back when the queue is full
+    QUEUED
+  };
+};
+
+}
+
+#endif /* DISPATCH_MODE_H */
@@ -12,6 +12,8 @@
 // INCLUDES /////////////////////////////////////////////
 #include "pipelib/Block.h"
 
+#include <vector>
+
 // FORWARD DECLARATIONS ////////////////////////////////////
 
 namespace pipelib {
@@ -24,6 +26,7 @@ protected:
 
 public:
   typedef BlockConnector<PipelineData, SharedData, GlobalData, PipeBlock> ConnectorType;
+  typedef ::std::vector<PipelineData *> DataBatch;
 
   PipeBlock(const size_t numOutputs = 1): BlockType("Pipe block", numOutputs) {}
 
@@ -41,6 +44,22 @@ public:
 
 	virtual void in(PipelineData & data) = 0;
 
+  /**
+  /* Take a number of pieces of data at once.  Only called by runners that are
+  /* batching (see SingleThreadedEngine::setMaxBatchSize) and only if the block
+  /* says it supports batches, so blocks that can do better than dealing with
+  /* the data one at a time should override both of these.
+  /**/
+  virtual void inBatch(const DataBatch & batch)
+  {
+    for(typename DataBatch::const_iterator it = batch.begin(), end = batch.end();
+      it != end; ++it)
+    {
+      in(**it);
+    }
+  }
+  virtual bool supportsBatches() const { return false; }
+
   virtual PipeBlock * asPipeBlock() { return this; }
   virtual const PipeBlock * asPipeBlock() const { return this; }
 };
@@ -21,6 +21,9 @@ namespace pipelib {
 template <typename PipelineData, typename SharedData, typename GlobalData>
 class Block;
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+class AsyncPipeBlock;
+
 template <typename PipelineData, typename SharedData, typename GlobalData>
 class Barrier;
 
@@ -30,6 +33,9 @@ class Pipe;
 template <typename PipelineData, typename SharedData, typename GlobalData>
 class PipeBlock;
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+class RunnerProfile;
+
 namespace event {
 template <typename Runner>
 class PipeRunnerListener;
@@ -62,6 +68,7 @@ public:
   typedef Block<PipelineData, SharedData, GlobalData> BlockType;
   typedef typename UniquePtr<PipelineData>::Type PipelineDataPtr;
   typedef event::PipeRunnerListener<RunnerAccess> ListenerType;
+  typedef RunnerProfile<PipelineData, SharedData, GlobalData> ProfileType;
 
   virtual ~RunnerAccess() {}
 
@@ -70,12 +77,23 @@ public:
   virtual RunnerAccess * getParentAccess() = 0;
   virtual const RunnerAccess * getParentAccess() const = 0;
   virtual PipelineState::Value getState() const = 0;
+  /**
+  /* Pass on any data that is waiting to go between blocks so that everything
+  /* sent out so far has gone as far as it can.
+  /**/
+  virtual void flush() = 0;
 
   // Pipeline data methods
   virtual PipelineData & createData() = 0;
   virtual void dropData(PipelineData & toDrop) = 0;
   virtual PipelineData & registerData(PipelineDataPtr data) = 0;
   virtual PipelineDataHandle createDataHandle(PipelineData & data) = 0;
+  /**
+  /* Take ownership of data that isn't going down the pipe (e.g. restored from
+  /* a checkpoint) and get a handle to it.  The data lives until the handle is
+  /* released.
+  /**/
+  virtual PipelineDataHandle createDataHandle(PipelineDataPtr data) = 0;
   virtual void releaseDataHandle(const PipelineDataHandle & handle) = 0;
   virtual PipelineData & getData(const PipelineDataHandle & handle) = 0;
 
@@ -96,6 +114,7 @@ class PipeRunner
 {
 public:
   typedef Pipe<PipelineData, SharedData, GlobalData> PipeType;
+  typedef event::PipeRunnerListener<RunnerAccess<PipelineData, SharedData, GlobalData> > ListenerType;
 
   virtual ~PipeRunner() {}
 
@@ -116,6 +135,10 @@ public:
   virtual MemoryAccess<SharedData, GlobalData> & memory() = 0;
   virtual const MemoryAccess<SharedData, GlobalData> & memory() const = 0;
 
+  // Event
+  virtual void addListener(ListenerType & listener) = 0;
+  virtual void removeListener(ListenerType & listener) = 0;
+
 protected:
 
   typedef RunnerAccess<PipelineData, SharedData, GlobalData> RunnerAccessType;
@@ -149,6 +172,7 @@ public:
   typedef Pipe<PipelineData, SharedData, GlobalData> PipeType;
   typedef PipeRunner<PipelineData, SharedData, GlobalData> RunnerType;
   typedef Barrier<PipelineData, SharedData, GlobalData> BarrierType;
+  typedef AsyncPipeBlock<PipelineData, SharedData, GlobalData> AsyncPipeBlockType;
   typedef LoanPtr<RunnerType> ChildRunnerPtr;
 
   virtual ~RunnerSetup() {}
@@ -156,6 +180,7 @@ public:
   virtual ChildRunnerPtr createChildRunner() = 0;
   virtual ChildRunnerPtr createChildRunner(PipeType & subpipe) = 0;
   virtual void registerBarrier(BarrierType & barrier) = 0;
+  virtual void registerAsyncBlock(AsyncPipeBlockType & block) = 0;
 };
 
 template <class T>
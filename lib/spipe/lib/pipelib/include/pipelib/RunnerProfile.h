@@ -0,0 +1,104 @@
+/*
+ * RunnerProfile.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef RUNNER_PROFILE_H
+#define RUNNER_PROFILE_H
+
+// INCLUDES /////////////////////////////////////////////
+#include "pipelib/Pipeline.h"
+
+#include <map>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace pipelib {
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+template <typename PipelineData, typename SharedData, typename GlobalData>
+class Block;
+
+/**
+/* Timings and data counts for each block driven by a runner.  The runner only
+/* records these if profiling has been switched on.
+/**/
+template <typename PipelineData, typename SharedData, typename GlobalData>
+class RunnerProfile
+{
+public:
+  typedef Block<PipelineData, SharedData, GlobalData> BlockType;
+
+  struct BlockProfile
+  {
+    explicit BlockProfile(const BlockType & block_);
+
+    const BlockType * block;
+    /** Wall time (s) spent in the block not counting the blocks it passed data on to. */
+    double time;
+    size_t numReceived;
+    size_t numEmitted;
+    size_t numDropped;
+    /** For barriers, the total time (s) data was held before being released. */
+    double holdTime;
+    size_t numReleases;
+  };
+
+  typedef ::std::vector<BlockProfile> BlockProfiles;
+  typedef typename BlockProfiles::const_iterator const_iterator;
+
+  explicit RunnerProfile(const double reportInterval);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  /** Wall time (s) since profiling started. */
+  double getElapsedTime() const;
+  size_t getNumLiveData() const;
+  size_t getPeakLiveData() const;
+
+  // Recording, used by the runner ///////////////
+  void reset();
+  void addBarrier(const BlockType & barrier);
+  void enter(const BlockType & block);
+  void leave();
+  void received(const BlockType & block);
+  void emitted(const BlockType & block);
+  void dropped();
+  void released(const BlockType & barrier);
+  void liveDataChanged(const size_t numLiveData);
+  /** Is it time for a periodic report, if so the report timer is restarted. */
+  bool reportDue();
+
+private:
+  typedef ::boost::posix_time::ptime Time;
+  typedef ::std::map<const BlockType *, size_t> Indices;
+
+  static Time now();
+  static double seconds(const Time & from, const Time & to);
+
+  BlockProfile & getProfile(const BlockType & block);
+
+  const double myReportInterval;
+  BlockProfiles myProfiles;
+  Indices myIndices;
+  /** Indices of the blocks currently being called, innermost last. */
+  ::std::vector<size_t> myStack;
+  /** When the barriers started holding data, not a date time if they're empty. */
+  ::std::map<size_t, Time> myHoldStarts;
+  Time myStart;
+  Time myLastMark;
+  Time myLastReport;
+  size_t myNumLiveData;
+  size_t myPeakLiveData;
+};
+
+}
+
+#include "pipelib/detail/RunnerProfile.h"
+
+#endif /* RUNNER_PROFILE_H */
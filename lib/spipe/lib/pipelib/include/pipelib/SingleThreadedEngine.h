@@ -12,16 +12,22 @@
 // INCLUDES /////////////////////////////////////////////
 #include "pipelib/Pipeline.h"
 
+#include <deque>
 #include <map>
 #include <set>
+#include <vector>
 
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include "pipelib/AsyncPipeBlock.h"
+#include "pipelib/DataPoolTraits.h"
+#include "pipelib/DispatchMode.h"
 #include "pipelib/PipelineState.h"
 #include "pipelib/PipeEngine.h"
 #include "pipelib/PipeRunner.h"
+#include "pipelib/RunnerProfile.h"
 #include "pipelib/event/EventSupport.h"
 
 namespace pipelib {
@@ -34,6 +40,46 @@ public:
   typedef typename Base::PipeType PipeType;
   typedef typename Base::RunnerPtr RunnerPtr;
 
+  static const size_t DEFAULT_MAX_QUEUE_SIZE = 1000;
+
+  SingleThreadedEngine();
+
+  /**
+  /* How the runners created by this engine pass data between blocks, see
+  /* DispatchMode.  Only affects runners created after the call.
+  /**/
+  DispatchMode::Value getDispatchMode() const;
+  void setDispatchMode(const DispatchMode::Value mode);
+
+  /**
+  /* In queued mode this is the number of work items that can be waiting before
+  /* whatever is producing data (normally the start block) is held back.  Once
+  /* it is full, data coming out of blocks that are being drained is passed
+  /* straight to the next block.  This only goes a limited number of calls deep
+  /* (in case the pipe has a loop) after which the queue grows for a while.
+  /**/
+  size_t getMaxQueueSize() const;
+  void setMaxQueueSize(const size_t maxQueueSize);
+
+  /**
+  /* In queued mode, data waiting on the queue for the same block is passed to
+  /* it in batches of up to this size if the block supports batches (see
+  /* PipeBlock::inBatch).  The default of 1 means no batching.
+  /**/
+  size_t getMaxBatchSize() const;
+  void setMaxBatchSize(const size_t maxBatchSize);
+
+  /**
+  /* Have runners record per block timings and data counts, see RunnerProfile.
+  /* These are sent to the runner's listeners when it finishes and, if the report
+  /* interval (in seconds) is positive, periodically while it is running.  Only
+  /* affects runners created after the call.
+  /**/
+  bool isProfiling() const;
+  void setProfiling(const bool profiling);
+  double getProfileReportInterval() const;
+  void setProfileReportInterval(const double interval);
+
   virtual void run(PipeType & pipe);
   virtual RunnerPtr createRunner();
   virtual RunnerPtr createRunner(PipeType & subpipe);
@@ -45,6 +91,11 @@ private:
   void loanReturned(const RunnerOwningPtr & runnerPtr);
 
   Runners myRunners;
+  DispatchMode::Value myDispatchMode;
+  size_t myMaxQueueSize;
+  size_t myMaxBatchSize;
+  bool myProfiling;
+  double myProfileReportInterval;
 
   friend class LoaningPtr<typename Base::RunnerType, SingleThreadedEngine>;
 };
@@ -64,11 +115,17 @@ class SingleThreadedRunner :
   typedef LoaningPtr<RunnerBase, SingleThreadedRunner> ChildRunnerOwningPtr;
 
   static const unsigned int DEFAULT_MAX_RELEASES = 10000;
+  /** The most spare data kept for reuse, see DataPoolTraits. */
+  static const size_t MAX_DATA_POOL_SIZE = 1000;
+  /** How many calls deep data is passed straight on while the queue is full. */
+  static const unsigned int MAX_DIRECT_DEPTH = 32;
 public:
   // Pipeline
   typedef Pipe<PipelineData, SharedData, GlobalData> PipeType;
   typedef PipeBlock<PipelineData, SharedData, GlobalData> PipeBlockType;
+  typedef typename PipeBlockType::DataBatch DataBatch;
   typedef typename SetupBase::BarrierType BarrierType;
+  typedef typename SetupBase::AsyncPipeBlockType AsyncPipeBlockType;
   typedef typename SetupBase::ChildRunnerPtr ChildRunnerPtr;
   // Access
   typedef pipelib::RunnerAccess<PipelineData, SharedData, GlobalData> RunnerAccessType;
@@ -78,6 +135,7 @@ public:
   typedef DroppedSink<PipelineData> DroppedSinkType;
   // Event
   typedef typename RunnerAccessType::ListenerType ListenerType;
+  typedef typename RunnerAccessType::ProfileType ProfileType;
 
   virtual ~SingleThreadedRunner();
 
@@ -110,11 +168,13 @@ public:
   virtual void out(PipelineData & data, const BlockType & outBlock, const Channel channel);
   virtual RunnerAccessType * getParentAccess();
   virtual const RunnerAccessType * getParentAccess() const;
+  virtual void flush();
   // Data methods
   virtual PipelineData & createData();
   virtual void dropData(PipelineData & toDrop);
   virtual PipelineData & registerData(PipelineDataPtr data);
   virtual PipelineDataHandle createDataHandle(PipelineData & data);
+  virtual PipelineDataHandle createDataHandle(PipelineDataPtr data);
   virtual void releaseDataHandle(const PipelineDataHandle & handle);
   virtual PipelineData & getData(const PipelineDataHandle & handle);
   // Memory methods 
@@ -126,6 +186,7 @@ public:
   virtual ChildRunnerPtr createChildRunner();
   virtual ChildRunnerPtr createChildRunner(PipeType & subpipe);
   virtual void registerBarrier(BarrierType & barrier);
+  virtual void registerAsyncBlock(AsyncPipeBlockType & block);
   // End from RunnerSetup /////////////////////////
 
 private:
@@ -135,6 +196,13 @@ private:
     enum Value { FRESH, FINISHED, DROPPED };
   };
 
+  struct WorkItem
+  {
+    WorkItem(PipeBlockType & block_, PipelineData & data_): block(&block_), data(&data_) {}
+    PipeBlockType * block;
+    PipelineData * data;
+  };
+
   struct Metadata
   {
     Metadata(): dataState(DataState::FRESH), referenceCount(1) {}
@@ -147,8 +215,12 @@ private:
   typedef ::boost::ptr_vector<ChildRunnerOwningPtr> ChildRunners;
   typedef ::std::map<PipelineData *, Metadata> DataStore;
   typedef ::std::set<BarrierType *> Barriers;
+  typedef ::std::set<AsyncPipeBlockType *> AsyncBlocks;
   typedef ::std::map<PipelineDataHandle, PipelineData *> HandleMap;
   typedef event::EventSupport<ListenerType> RunnerEventSupport;
+  typedef ::std::deque<WorkItem> WorkQueue;
+  typedef ::std::vector<PipelineData *> DataPool;
+  typedef ::boost::scoped_ptr<ProfileType> ProfilePtr;
   
   SingleThreadedRunner(unsigned int maxReleases = DEFAULT_MAX_RELEASES);
   SingleThreadedRunner(
@@ -166,8 +238,17 @@ private:
     const unsigned int maxReleases);
 
   void init();
+  void setDispatch(
+    const DispatchMode::Value mode,
+    const size_t maxQueueSize,
+    const size_t maxBatchSize);
+  void setProfiling(const bool profiling, const double reportInterval);
 
   void doRun();
+  void drainQueue();
+  void finishAsyncWork();
+  void deliver(PipeBlockType & block, PipelineData & data);
+  void deliverBatch(PipeBlockType & block, const DataBatch & batch);
   void changeState(const PipelineState::Value newState);
   void clear();
   bool releaseNextBarrier();
@@ -176,6 +257,7 @@ private:
   PipelineDataHandle generateHandle();
   void increaseReferenceCount(const typename DataStore::iterator & it);
   void decreaseReferenceCount(const typename DataStore::iterator & it);
+  void recycleData(PipelineData * const data);
 
   void loanReturned(ChildRunnerOwningPtr & childRunner);
 
@@ -188,12 +270,17 @@ private:
   unsigned int myMaxReleases;
   Barriers myBarriers;
 
+  // Blocks that may still be holding data after they've been called
+  AsyncBlocks myAsyncBlocks;
+
   // Data
   DataStore myDataStore;
   GlobalDataPtr myGlobalData;
   SharedDataPtr mySharedData;
   HandleMap myHandles;
   PipelineDataHandle myLastHandle;
+  /** Finished or dropped data kept to be handed out again by createData(). */
+  DataPool myDataPool;
 
   // Pipeline
   PipeType * myPipeline;
@@ -201,6 +288,20 @@ private:
   // State
   PipelineState::Value myState;
 
+  // Dispatch
+  DispatchMode::Value myDispatchMode;
+  size_t myMaxQueueSize;
+  size_t myMaxBatchSize;
+  WorkQueue myWorkQueue;
+  bool myDraining;
+  unsigned int myDirectDepth;
+  /** Reused to gather each batch while draining. */
+  DataBatch myBatch;
+
+  // Profiling, NULL unless switched on
+  ProfilePtr myProfile;
+  double myProfileReportInterval;
+
   // Sinks
   FinishedSinkType * myFinishedSink;
   DroppedSinkType * myDroppedSink;
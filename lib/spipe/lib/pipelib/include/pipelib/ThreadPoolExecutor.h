@@ -0,0 +1,66 @@
+/*
+ * ThreadPoolExecutor.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef THREAD_POOL_EXECUTOR_H
+#define THREAD_POOL_EXECUTOR_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <deque>
+#include <utility>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "pipelib/AsyncExecutor.h"
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+namespace pipelib {
+
+/**
+/* Runs jobs on a fixed number of worker threads.  Each thread is a slot so
+/* for jobs that hand their work on to an external process (e.g. CASTEP) this
+/* also limits the number of processes running at once.  Users of this
+/* executor have to link to boost thread.
+/**/
+class ThreadPoolExecutor : public AsyncExecutor, ::boost::noncopyable
+{
+public:
+  explicit ThreadPoolExecutor(const size_t numThreads);
+  virtual ~ThreadPoolExecutor();
+
+  // From AsyncExecutor ////////////////////
+  virtual size_t getNumSlots() const;
+  virtual void submit(const Ticket ticket, const Job & job);
+  virtual void getCompleted(Tickets & completed, const bool wait);
+  // End from AsyncExecutor ////////////////
+
+private:
+  typedef ::std::pair<Ticket, Job> QueuedJob;
+
+  void work();
+
+  ::boost::thread_group myThreads;
+  const size_t myNumThreads;
+
+  ::boost::mutex myMutex;
+  ::boost::condition_variable myJobQueued;
+  ::boost::condition_variable myJobCompleted;
+  ::std::deque<QueuedJob> myJobs;
+  Tickets myCompleted;
+  size_t myNumOutstanding;
+  bool myStopping;
+};
+
+}
+
+#include "pipelib/detail/ThreadPoolExecutor.h"
+
+#endif /* THREAD_POOL_EXECUTOR_H */
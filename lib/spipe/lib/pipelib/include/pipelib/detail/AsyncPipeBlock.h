@@ -0,0 +1,143 @@
+/*
+ * AsyncPipeBlock.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef ASYNC_PIPE_BLOCK_DETAIL_H
+#define ASYNC_PIPE_BLOCK_DETAIL_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#include "pipelib/PipeRunner.h"
+
+namespace pipelib {
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+AsyncPipeBlock<PipelineData, SharedData, GlobalData>::AsyncPipeBlock():
+BlockType("Async pipe block"),
+myExecutor(new SerialExecutor()),
+myMaxInFlight(0),
+myOrder(CompletionOrder::COMPLETION),
+myNextTicket(0)
+{}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::setExecutor(
+  ExecutorPtr executor,
+  const size_t maxInFlight,
+  const CompletionOrder::Value order)
+{
+  PIPELIB_ASSERT(executor.get());
+  PIPELIB_ASSERT(myInFlight.empty());
+
+  myExecutor = executor;
+  myMaxInFlight = maxInFlight;
+  myOrder = order;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+AsyncExecutor & AsyncPipeBlock<PipelineData, SharedData, GlobalData>::getExecutor()
+{
+  return *myExecutor;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::in(PipelineData & data)
+{
+  const size_t maxInFlight = myMaxInFlight == 0 ? myExecutor->getNumSlots() : myMaxInFlight;
+
+  // Hold the runner back until there is room for more work
+  while(!myInFlight.empty() && myInFlight.size() >= maxInFlight)
+    collectCompleted(true);
+
+  const Ticket ticket = myNextTicket++;
+  InFlight & job = myInFlight[ticket];
+  job.data = &data;
+  myExecutor->submit(ticket, ::boost::bind(&AsyncPipeBlock::run, this, &job));
+
+  // Pass on anything that has already finished
+  collectCompleted(false);
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+bool AsyncPipeBlock<PipelineData, SharedData, GlobalData>::hasPendingWork() const
+{
+  return !myInFlight.empty();
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::finishPendingWork()
+{
+  while(!myInFlight.empty())
+    collectCompleted(true);
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::processed(
+  PipelineData & data,
+  const bool keep)
+{
+  if(keep)
+    this->out(data);
+  else
+    this->getRunner()->dropData(data);
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::runnerAttached(
+  RunnerSetupType & setup)
+{
+  setup.registerAsyncBlock(*this);
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::run(InFlight * const job)
+{
+  // The runner thread doesn't look at the job again until the executor
+  // says it has completed
+  job->keep = processAsync(*job->data);
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::collectCompleted(const bool wait)
+{
+  // Passing on data can bring us back here so use a fresh list each time
+  AsyncExecutor::Tickets completed;
+  myExecutor->getCompleted(completed, wait);
+
+  BOOST_FOREACH(const Ticket ticket, completed)
+  {
+    const typename InFlightMap::iterator it = myInFlight.find(ticket);
+    PIPELIB_ASSERT(it != myInFlight.end());
+
+    it->second.done = true;
+    if(myOrder == CompletionOrder::COMPLETION)
+      pass(it);
+  }
+
+  if(myOrder == CompletionOrder::SUBMISSION)
+  {
+    while(!myInFlight.empty() && myInFlight.begin()->second.done)
+      pass(myInFlight.begin());
+  }
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void AsyncPipeBlock<PipelineData, SharedData, GlobalData>::pass(
+  const typename InFlightMap::iterator it)
+{
+  PipelineData & data = *it->second.data;
+  const bool keep = it->second.keep;
+  // Forget about it before passing it on in case it comes back round to us
+  myInFlight.erase(it);
+  processed(data, keep);
+}
+
+}
+
+#endif /* ASYNC_PIPE_BLOCK_DETAIL_H */
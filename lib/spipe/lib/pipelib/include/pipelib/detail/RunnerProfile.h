@@ -0,0 +1,209 @@
+/*
+ * RunnerProfile.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef RUNNER_PROFILE_DETAIL_H
+#define RUNNER_PROFILE_DETAIL_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <algorithm>
+
+namespace pipelib {
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+RunnerProfile<PipelineData, SharedData, GlobalData>::BlockProfile::BlockProfile(
+  const BlockType & block_):
+block(&block_),
+time(0.0),
+numReceived(0),
+numEmitted(0),
+numDropped(0),
+holdTime(0.0),
+numReleases(0)
+{}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+RunnerProfile<PipelineData, SharedData, GlobalData>::RunnerProfile(
+  const double reportInterval):
+myReportInterval(reportInterval)
+{
+  reset();
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+typename RunnerProfile<PipelineData, SharedData, GlobalData>::const_iterator
+RunnerProfile<PipelineData, SharedData, GlobalData>::begin() const
+{
+  return myProfiles.begin();
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+typename RunnerProfile<PipelineData, SharedData, GlobalData>::const_iterator
+RunnerProfile<PipelineData, SharedData, GlobalData>::end() const
+{
+  return myProfiles.end();
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+double RunnerProfile<PipelineData, SharedData, GlobalData>::getElapsedTime() const
+{
+  return seconds(myStart, now());
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+size_t RunnerProfile<PipelineData, SharedData, GlobalData>::getNumLiveData() const
+{
+  return myNumLiveData;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+size_t RunnerProfile<PipelineData, SharedData, GlobalData>::getPeakLiveData() const
+{
+  return myPeakLiveData;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::reset()
+{
+  myProfiles.clear();
+  myIndices.clear();
+  myStack.clear();
+  myHoldStarts.clear();
+  myStart = myLastMark = myLastReport = now();
+  myNumLiveData = 0;
+  myPeakLiveData = 0;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::addBarrier(
+  const BlockType & barrier)
+{
+  getProfile(barrier);
+  myHoldStarts[myIndices[&barrier]] = Time(::boost::posix_time::not_a_date_time);
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::enter(
+  const BlockType & block)
+{
+  const Time t = now();
+  // Stop the clock on the block that is passing data on
+  if(!myStack.empty())
+    myProfiles[myStack.back()].time += seconds(myLastMark, t);
+
+  getProfile(block);
+  myStack.push_back(myIndices[&block]);
+  myLastMark = t;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::leave()
+{
+  PIPELIB_ASSERT(!myStack.empty());
+
+  const Time t = now();
+  myProfiles[myStack.back()].time += seconds(myLastMark, t);
+  myStack.pop_back();
+  myLastMark = t;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::received(
+  const BlockType & block)
+{
+  BlockProfile & profile = getProfile(block);
+  ++profile.numReceived;
+
+  const typename ::std::map<size_t, Time>::iterator it = myHoldStarts.find(myIndices[&block]);
+  if(it != myHoldStarts.end() && it->second.is_not_a_date_time())
+    it->second = now();
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::emitted(
+  const BlockType & block)
+{
+  ++getProfile(block).numEmitted;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::dropped()
+{
+  // Data is dropped by whichever block is being called at the moment
+  if(!myStack.empty())
+    ++myProfiles[myStack.back()].numDropped;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::released(
+  const BlockType & barrier)
+{
+  BlockProfile & profile = getProfile(barrier);
+  ++profile.numReleases;
+
+  const typename ::std::map<size_t, Time>::iterator it = myHoldStarts.find(myIndices[&barrier]);
+  if(it != myHoldStarts.end() && !it->second.is_not_a_date_time())
+  {
+    profile.holdTime += seconds(it->second, now());
+    it->second = Time(::boost::posix_time::not_a_date_time);
+  }
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void RunnerProfile<PipelineData, SharedData, GlobalData>::liveDataChanged(
+  const size_t numLiveData)
+{
+  myNumLiveData = numLiveData;
+  myPeakLiveData = ::std::max(myPeakLiveData, numLiveData);
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+bool RunnerProfile<PipelineData, SharedData, GlobalData>::reportDue()
+{
+  if(myReportInterval <= 0.0)
+    return false;
+
+  const Time t = now();
+  if(seconds(myLastReport, t) < myReportInterval)
+    return false;
+
+  myLastReport = t;
+  return true;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+typename RunnerProfile<PipelineData, SharedData, GlobalData>::Time
+RunnerProfile<PipelineData, SharedData, GlobalData>::now()
+{
+  return ::boost::posix_time::microsec_clock::universal_time();
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+double RunnerProfile<PipelineData, SharedData, GlobalData>::seconds(
+  const Time & from,
+  const Time & to)
+{
+  return 1e-6 * static_cast<double>((to - from).total_microseconds());
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+typename RunnerProfile<PipelineData, SharedData, GlobalData>::BlockProfile &
+RunnerProfile<PipelineData, SharedData, GlobalData>::getProfile(
+  const BlockType & block)
+{
+  const typename Indices::const_iterator it = myIndices.find(&block);
+  if(it != myIndices.end())
+    return myProfiles[it->second];
+
+  myIndices[&block] = myProfiles.size();
+  myProfiles.push_back(BlockProfile(block));
+  return myProfiles.back();
+}
+
+}
+
+#endif /* RUNNER_PROFILE_DETAIL_H */
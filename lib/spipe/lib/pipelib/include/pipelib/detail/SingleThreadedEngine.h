@@ -26,11 +26,91 @@
 
 namespace pipelib {
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+SingleThreadedEngine<PipelineData, SharedData, GlobalData>::SingleThreadedEngine():
+myDispatchMode(DispatchMode::DIRECT),
+myMaxQueueSize(DEFAULT_MAX_QUEUE_SIZE),
+myMaxBatchSize(1),
+myProfiling(false),
+myProfileReportInterval(0.0)
+{}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+DispatchMode::Value
+SingleThreadedEngine<PipelineData, SharedData, GlobalData>::getDispatchMode() const
+{
+  return myDispatchMode;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedEngine<PipelineData, SharedData, GlobalData>::setDispatchMode(
+  const DispatchMode::Value mode)
+{
+  myDispatchMode = mode;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+size_t SingleThreadedEngine<PipelineData, SharedData, GlobalData>::getMaxQueueSize() const
+{
+  return myMaxQueueSize;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedEngine<PipelineData, SharedData, GlobalData>::setMaxQueueSize(
+  const size_t maxQueueSize)
+{
+  PIPELIB_ASSERT(maxQueueSize > 0);
+  myMaxQueueSize = maxQueueSize;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+size_t SingleThreadedEngine<PipelineData, SharedData, GlobalData>::getMaxBatchSize() const
+{
+  return myMaxBatchSize;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedEngine<PipelineData, SharedData, GlobalData>::setMaxBatchSize(
+  const size_t maxBatchSize)
+{
+  PIPELIB_ASSERT(maxBatchSize > 0);
+  myMaxBatchSize = maxBatchSize;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+bool SingleThreadedEngine<PipelineData, SharedData, GlobalData>::isProfiling() const
+{
+  return myProfiling;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedEngine<PipelineData, SharedData, GlobalData>::setProfiling(
+  const bool profiling)
+{
+  myProfiling = profiling;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+double
+SingleThreadedEngine<PipelineData, SharedData, GlobalData>::getProfileReportInterval() const
+{
+  return myProfileReportInterval;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedEngine<PipelineData, SharedData, GlobalData>::setProfileReportInterval(
+  const double interval)
+{
+  myProfileReportInterval = interval;
+}
+
 template <typename PipelineData, typename SharedData, typename GlobalData>
 void SingleThreadedEngine<PipelineData, SharedData, GlobalData>::run(
   PipeType & pipe)
 {
   SingleThreadedRunner<PipelineData, SharedData, GlobalData> runner(pipe);
+  runner.setDispatch(myDispatchMode, myMaxQueueSize, myMaxBatchSize);
+  runner.setProfiling(myProfiling, myProfileReportInterval);
   runner.run();
 }
 
@@ -39,9 +119,12 @@ typename SingleThreadedEngine<PipelineData, SharedData, GlobalData>::RunnerPtr
 SingleThreadedEngine<PipelineData, SharedData, GlobalData>::createRunner()
 {
   typedef SingleThreadedRunner<PipelineData, SharedData, GlobalData> RunnerType;
+  RunnerType * const runner = new RunnerType();
+  runner->setDispatch(myDispatchMode, myMaxQueueSize, myMaxBatchSize);
+  runner->setProfiling(myProfiling, myProfileReportInterval);
   return myRunners.insert(
     myRunners.end(),
-    new RunnerOwningPtr(new RunnerType())
+    new RunnerOwningPtr(runner)
   )->loan();
 }
 
@@ -51,9 +134,12 @@ SingleThreadedEngine<PipelineData, SharedData, GlobalData>::createRunner(
   PipeType & pipeline)
 {
   typedef SingleThreadedRunner<PipelineData, SharedData, GlobalData> RunnerType;
+  RunnerType * const runner = new RunnerType(pipeline);
+  runner->setDispatch(myDispatchMode, myMaxQueueSize, myMaxBatchSize);
+  runner->setProfiling(myProfiling, myProfileReportInterval);
   return myRunners.insert(
     myRunners.end(),
-    new RunnerOwningPtr(new RunnerType(pipeline))
+    new RunnerOwningPtr(runner)
   )->loan();
 }
 
@@ -82,6 +168,10 @@ SingleThreadedRunner<PipelineData, SharedData, GlobalData>::~SingleThreadedRunne
   {
     delete data.first;
   }
+  BOOST_FOREACH(PipelineData * const data, myDataPool)
+  {
+    delete data;
+  }
   myRunnerEventSupport.notify(event::makeDestroyedEvent(*this));
 }
 
@@ -212,8 +302,36 @@ void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::out(
   PipelineData & data, const BlockType & outBlock, const Channel channel)
 {
   PipeBlockType * const inBlock = outBlock.getOutput(channel);
+  if(myProfile)
+  {
+    myProfile->emitted(outBlock);
+    if(inBlock)
+      myProfile->received(*inBlock);
+  }
+
   if(inBlock)
-    inBlock->in(data);
+  {
+    if(myDispatchMode == DispatchMode::DIRECT)
+      deliver(*inBlock, data);
+    else if(myDraining && myWorkQueue.size() >= myMaxQueueSize && myDirectDepth < MAX_DIRECT_DEPTH)
+    {
+      // A block being drained is producing more than the queue can take so,
+      // rather than let the queue grow past its limit, pass the data straight on.
+      // A pipe with a loop could keep doing this forever so past a certain depth
+      // the queue has to take it after all.
+      ++myDirectDepth;
+      deliver(*inBlock, data);
+      --myDirectDepth;
+    }
+    else
+    {
+      myWorkQueue.push_back(WorkItem(*inBlock, data));
+      // If we're not already draining then the data is coming from a producer
+      // (normally the start block) so hold it back until the queue is empty
+      if(!myDraining && myWorkQueue.size() >= myMaxQueueSize)
+        drainQueue();
+    }
+  }
   else
   {
     // So this data is finished, check if we have a sink, otherwise delete
@@ -240,10 +358,30 @@ SingleThreadedRunner<PipelineData, SharedData, GlobalData>::getParentAccess() co
   return myParent;
 }
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::flush()
+{
+  drainQueue();
+  finishAsyncWork();
+}
+
 template <typename PipelineData, typename SharedData, typename GlobalData>
 PipelineData & SingleThreadedRunner<PipelineData, SharedData, GlobalData>::createData()
 {
-  return *(myDataStore.insert(::std::make_pair(new PipelineData, Metadata())).first->first);
+  PipelineData * newData;
+  if(myDataPool.empty())
+    newData = new PipelineData;
+  else
+  {
+    newData = myDataPool.back();
+    myDataPool.pop_back();
+  }
+
+  PipelineData & data =
+    *(myDataStore.insert(::std::make_pair(newData, Metadata())).first->first);
+  if(myProfile)
+    myProfile->liveDataChanged(myDataStore.size());
+  return data;
 }
 
 template <typename PipelineData, typename SharedData, typename GlobalData>
@@ -256,6 +394,8 @@ void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::dropData(
   PIPELIB_ASSERT_MSG(it != myDataStore.end(), "Couldn't find data in data store");
 
   it->second.dataState = DataState::DROPPED;
+  if(myProfile)
+    myProfile->dropped();
   decreaseReferenceCount(it);
 }
 
@@ -264,7 +404,11 @@ PipelineData &
 SingleThreadedRunner<PipelineData, SharedData, GlobalData>::registerData(
   PipelineDataPtr data)
 {
-  return *(myDataStore.insert(::std::make_pair(data.release(), Metadata())).first->first);
+  PipelineData & registered =
+    *(myDataStore.insert(::std::make_pair(data.release(), Metadata())).first->first);
+  if(myProfile)
+    myProfile->liveDataChanged(myDataStore.size());
+  return registered;
 }
 
 template <typename PipelineData, typename SharedData, typename GlobalData>
@@ -283,6 +427,23 @@ SingleThreadedRunner<PipelineData, SharedData, GlobalData>::createDataHandle(
   return handle;
 }
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+PipelineDataHandle
+SingleThreadedRunner<PipelineData, SharedData, GlobalData>::createDataHandle(
+  PipelineDataPtr data)
+{
+  // The data has nowhere left to go so it's finished and only the handle
+  // keeps it alive
+  Metadata metadata;
+  metadata.dataState = DataState::FINISHED;
+  metadata.referenceCount = 0;
+  PipelineData & adopted =
+    *(myDataStore.insert(::std::make_pair(data.release(), metadata)).first->first);
+  if(myProfile)
+    myProfile->liveDataChanged(myDataStore.size());
+  return createDataHandle(adopted);
+}
+
 template <typename PipelineData, typename SharedData, typename GlobalData>
 void
 SingleThreadedRunner<PipelineData, SharedData, GlobalData>::releaseDataHandle(
@@ -373,6 +534,13 @@ void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::registerBarrier
   myBarriers.insert(&barrier);
 }
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::registerAsyncBlock(
+  AsyncPipeBlockType & block)
+{
+  myAsyncBlocks.insert(&block);
+}
+
 template <typename PipelineData, typename SharedData, typename GlobalData>
 SingleThreadedRunner<PipelineData, SharedData, GlobalData>::SingleThreadedRunner(
   unsigned int maxReleases):
@@ -408,6 +576,8 @@ myParent(&parent),
 myMaxReleases(maxReleases)
 {
   init();
+  setDispatch(parent.myDispatchMode, parent.myMaxQueueSize, parent.myMaxBatchSize);
+  setProfiling(parent.myProfile.get() != NULL, parent.myProfileReportInterval);
 }
 
 template <typename PipelineData, typename SharedData, typename GlobalData>
@@ -421,6 +591,8 @@ myParent(&parent),
 myMaxReleases(maxReleases)
 {
   init();
+  setDispatch(parent.myDispatchMode, parent.myMaxQueueSize, parent.myMaxBatchSize);
+  setProfiling(parent.myProfile.get() != NULL, parent.myProfileReportInterval);
   attach(pipe);
 }
 
@@ -430,24 +602,167 @@ void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::init()
   myFinishedSink = NULL;
   myDroppedSink = NULL;
   myLastHandle = 0;
+  myDispatchMode = DispatchMode::DIRECT;
+  myMaxQueueSize = EngineType::DEFAULT_MAX_QUEUE_SIZE;
+  myMaxBatchSize = 1;
+  myDraining = false;
+  myDirectDepth = 0;
+  myProfileReportInterval = 0.0;
   clear();
 }
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::setDispatch(
+  const DispatchMode::Value mode,
+  const size_t maxQueueSize,
+  const size_t maxBatchSize)
+{
+  PIPELIB_ASSERT(myWorkQueue.empty());
+
+  myDispatchMode = mode;
+  myMaxQueueSize = maxQueueSize;
+  myMaxBatchSize = maxBatchSize;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::setProfiling(
+  const bool profiling,
+  const double reportInterval)
+{
+  myProfileReportInterval = reportInterval;
+  if(profiling)
+    myProfile.reset(new ProfileType(reportInterval));
+  else
+    myProfile.reset();
+}
+
 template <typename PipelineData, typename SharedData, typename GlobalData>
 void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::doRun()
 {
+  if(myProfile)
+  {
+    myProfile->reset();
+    BOOST_FOREACH(BarrierType * const barrier, myBarriers)
+    {
+      myProfile->addBarrier(*barrier);
+    }
+    myProfile->enter(*myPipeline->getStartBlock());
+  }
   myPipeline->getStartBlock()->start();
+  if(myProfile)
+    myProfile->leave();
+  drainQueue();
+  finishAsyncWork();
   
   // Release any barriers that are waiting
   unsigned int numReleases = 0;
   while(releaseNextBarrier())
   {
+    drainQueue();
+    finishAsyncWork();
     ++numReleases;
     if(numReleases >= myMaxReleases)
       break;
   }
 }
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::drainQueue()
+{
+  if(myDraining)
+    return;
+
+  myDraining = true;
+  while(!myWorkQueue.empty())
+  {
+    const WorkItem item = myWorkQueue.front();
+    myWorkQueue.pop_front();
+
+    // Gather up any more data waiting for the same block into a batch
+    if(myMaxBatchSize > 1 && !myWorkQueue.empty() &&
+      myWorkQueue.front().block == item.block && item.block->supportsBatches())
+    {
+      myBatch.clear();
+      myBatch.push_back(item.data);
+      while(myBatch.size() < myMaxBatchSize && !myWorkQueue.empty() &&
+        myWorkQueue.front().block == item.block)
+      {
+        myBatch.push_back(myWorkQueue.front().data);
+        myWorkQueue.pop_front();
+      }
+      // This may put more work on the end of the queue
+      deliverBatch(*item.block, myBatch);
+    }
+    else
+    {
+      // This may put more work on the end of the queue
+      deliver(*item.block, *item.data);
+    }
+  }
+  myDraining = false;
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::finishAsyncWork()
+{
+  // Data passed on by one async block may end up at another so keep going
+  // until they're all done
+  bool finished = false;
+  while(!finished)
+  {
+    finished = true;
+    BOOST_FOREACH(AsyncPipeBlockType * const block, myAsyncBlocks)
+    {
+      if(block->hasPendingWork())
+      {
+        if(myProfile)
+          myProfile->enter(*block);
+        block->finishPendingWork();
+        if(myProfile)
+          myProfile->leave();
+        drainQueue();
+        finished = false;
+      }
+    }
+  }
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::deliver(
+  PipeBlockType & block,
+  PipelineData & data)
+{
+  if(!myProfile)
+  {
+    block.in(data);
+    return;
+  }
+
+  myProfile->enter(block);
+  block.in(data);
+  myProfile->leave();
+  if(myProfile->reportDue())
+    myRunnerEventSupport.notify(event::makeProfileUpdatedEvent(*this, *myProfile));
+}
+
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::deliverBatch(
+  PipeBlockType & block,
+  const DataBatch & batch)
+{
+  if(!myProfile)
+  {
+    block.inBatch(batch);
+    return;
+  }
+
+  myProfile->enter(block);
+  block.inBatch(batch);
+  myProfile->leave();
+  if(myProfile->reportDue())
+    myRunnerEventSupport.notify(event::makeProfileUpdatedEvent(*this, *myProfile));
+}
+
 template <typename PipelineData, typename SharedData, typename GlobalData>
 void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::changeState(
   const PipelineState::Value newState)
@@ -487,6 +802,8 @@ void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::changeState(
     this->notifyFinished(*myPipeline, *this);
 
     // Tell any listeners
+    if(myProfile)
+      myRunnerEventSupport.notify(event::makeProfileUpdatedEvent(*this, *myProfile));
     myRunnerEventSupport.notify(event::makeStateChangedEvent(*this, oldState, myState));
     break;
   }
@@ -506,6 +823,9 @@ void SingleThreadedRunner<PipelineData, SharedData, GlobalData>::clear()
   }
   myDataStore.clear();
   myBarriers.clear();
+  myAsyncBlocks.clear();
+  myWorkQueue.clear();
+  myDirectDepth = 0;
 }
 
 template <typename PipelineData, typename SharedData, typename GlobalData>
@@ -516,7 +836,14 @@ bool SingleThreadedRunner<PipelineData, SharedData, GlobalData>::releaseNextBarr
   {
     if(barrier->hasData())
     {
+      if(myProfile)
+      {
+        myProfile->released(*barrier);
+        myProfile->enter(*barrier);
+      }
       barrier->release();
+      if(myProfile)
+        myProfile->leave();
       released = true;
     }
   }
@@ -574,19 +901,32 @@ SingleThreadedRunner<PipelineData, SharedData, GlobalData>::decreaseReferenceCou
     PipelineData * tmpPtr = it->first;
     const typename DataState::Value state = it->second.dataState;
     myDataStore.erase(it);
+    if(myProfile)
+      myProfile->liveDataChanged(myDataStore.size());
 
     if(state == DataState::FINISHED && myFinishedSink)
       myFinishedSink->finished(PipelineDataPtr(tmpPtr));
     else if(state == DataState::DROPPED && myDroppedSink)
       myDroppedSink->dropped(PipelineDataPtr(tmpPtr));
     else
-    {
-      delete tmpPtr;
-      tmpPtr = NULL;
-    }
+      recycleData(tmpPtr);
   }
 }
 
+template <typename PipelineData, typename SharedData, typename GlobalData>
+void
+SingleThreadedRunner<PipelineData, SharedData, GlobalData>::recycleData(
+  PipelineData * const data)
+{
+  if(DataPoolTraits<PipelineData>::POOLED && myDataPool.size() < MAX_DATA_POOL_SIZE)
+  {
+    DataPoolTraits<PipelineData>::recycle(*data);
+    myDataPool.push_back(data);
+  }
+  else
+    delete data;
+}
+
 }
 
 #ifdef _MSC_VER
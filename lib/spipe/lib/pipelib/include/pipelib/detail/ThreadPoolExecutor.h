@@ -0,0 +1,93 @@
+/*
+ * ThreadPoolExecutor.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef THREAD_POOL_EXECUTOR_DETAIL_H
+#define THREAD_POOL_EXECUTOR_DETAIL_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace pipelib {
+
+inline ThreadPoolExecutor::ThreadPoolExecutor(const size_t numThreads):
+myNumThreads(numThreads == 0 ? 1 : numThreads),
+myNumOutstanding(0),
+myStopping(false)
+{
+  for(size_t i = 0; i < myNumThreads; ++i)
+    myThreads.create_thread(::boost::bind(&ThreadPoolExecutor::work, this));
+}
+
+inline ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+  {
+    ::boost::lock_guard< ::boost::mutex> lock(myMutex);
+    myStopping = true;
+  }
+  myJobQueued.notify_all();
+  myThreads.join_all();
+}
+
+inline size_t ThreadPoolExecutor::getNumSlots() const
+{
+  return myNumThreads;
+}
+
+inline void ThreadPoolExecutor::submit(const Ticket ticket, const Job & job)
+{
+  {
+    ::boost::lock_guard< ::boost::mutex> lock(myMutex);
+    myJobs.push_back(QueuedJob(ticket, job));
+    ++myNumOutstanding;
+  }
+  myJobQueued.notify_one();
+}
+
+inline void ThreadPoolExecutor::getCompleted(Tickets & completed, const bool wait)
+{
+  ::boost::unique_lock< ::boost::mutex> lock(myMutex);
+  if(wait)
+  {
+    while(myCompleted.empty() && myNumOutstanding != 0)
+      myJobCompleted.wait(lock);
+  }
+  completed.insert(completed.end(), myCompleted.begin(), myCompleted.end());
+  myCompleted.clear();
+}
+
+inline void ThreadPoolExecutor::work()
+{
+  QueuedJob job;
+  while(true)
+  {
+    {
+      ::boost::unique_lock< ::boost::mutex> lock(myMutex);
+      while(myJobs.empty() && !myStopping)
+        myJobQueued.wait(lock);
+      if(myJobs.empty())
+        return; // Stopping and nothing left to do
+
+      job = myJobs.front();
+      myJobs.pop_front();
+    }
+
+    job.second();
+
+    {
+      ::boost::lock_guard< ::boost::mutex> lock(myMutex);
+      myCompleted.push_back(job.first);
+      --myNumOutstanding;
+    }
+    myJobCompleted.notify_one();
+  }
+}
+
+}
+
+#endif /* THREAD_POOL_EXECUTOR_DETAIL_H */
@@ -18,6 +18,8 @@ template <typename T, typename U, typename V>
 class PipeRunner;
 template <typename T, typename U, typename V>
 class RunnerAccess;
+template <typename T, typename U, typename V>
+class RunnerProfile;
 
 namespace event {
 
@@ -70,6 +72,35 @@ makeDestroyedEvent(const RunnerAccess<T, U, V> & runner)
   return PipeRunnerDestroyed<RunnerAccess<T, U, V> >(runner);
 }
 
+/**
+/* Sent by a runner that is profiling with the latest timings, periodically
+/* during the run and once more when it finishes.
+/**/
+template <class Runner>
+class PipeRunnerProfileUpdated
+{
+public:
+  typedef typename Runner::ProfileType ProfileType;
+
+  PipeRunnerProfileUpdated(const Runner & runner, const ProfileType & profile);
+
+  const Runner & getRunner() const;
+  const ProfileType & getProfile() const;
+
+private:
+  const Runner & myRunner;
+  const ProfileType & myProfile;
+};
+
+template <class T, class U, class V>
+PipeRunnerProfileUpdated<RunnerAccess<T, U, V> >
+makeProfileUpdatedEvent(
+  const RunnerAccess<T, U, V> & runner,
+  const RunnerProfile<T, U, V> & profile)
+{
+  return PipeRunnerProfileUpdated<RunnerAccess<T, U, V> >(runner, profile);
+}
+
 }
 }
 
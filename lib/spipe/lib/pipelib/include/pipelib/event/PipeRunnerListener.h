@@ -21,6 +21,8 @@ template <class Runner>
 class PipeRunnerDestroyed;
 template <class Runner>
 class PipeRunnerStateChanged;
+template <class Runner>
+class PipeRunnerProfileUpdated;
 
 template <class Runner>
 class PipeRunnerListener
@@ -28,6 +30,7 @@ class PipeRunnerListener
 public:
   virtual void notify(const PipeRunnerStateChanged<Runner> & evt) {}
   virtual void notify(const PipeRunnerDestroyed<Runner> & evt) {}
+  virtual void notify(const PipeRunnerProfileUpdated<Runner> & evt) {}
 
 };
 
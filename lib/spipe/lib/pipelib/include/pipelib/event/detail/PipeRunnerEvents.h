@@ -54,6 +54,27 @@ const Runner & PipeRunnerDestroyed<Runner>::getRunner() const
   return myRunner;
 }
 
+template <class Runner>
+PipeRunnerProfileUpdated<Runner>::PipeRunnerProfileUpdated(
+  const Runner & runner,
+  const ProfileType & profile):
+myRunner(runner),
+myProfile(profile)
+{}
+
+template <class Runner>
+const Runner & PipeRunnerProfileUpdated<Runner>::getRunner() const
+{
+  return myRunner;
+}
+
+template <class Runner>
+const typename PipeRunnerProfileUpdated<Runner>::ProfileType &
+PipeRunnerProfileUpdated<Runner>::getProfile() const
+{
+  return myProfile;
+}
+
 }
 }
 
@@ -8,7 +8,15 @@
 // INCLUDES //////////////////////////////////
 #include "pipelibtest.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <pipelib/pipelib.h>
+#include <pipelib/ThreadPoolExecutor.h>
 
 #include <strings/PrintStringBlock.h>
 #include <strings/RandomStringBlock.h>
@@ -29,3 +37,635 @@ BOOST_AUTO_TEST_CASE(BasicTest)
   Runner runner;
   runner.run(pipe);
 }
+
+namespace {
+
+typedef pipelib::Pipe< ::std::string, const void *, const void *> StringPipe;
+typedef StringPipe::StartBlockType StringStartBlock;
+typedef StringPipe::PipeBlockType StringPipeBlock;
+
+// Keeps track of how many strings have been created but not yet seen
+// by the block at the end of the pipe
+struct InFlight
+{
+  InFlight(): current(0), max(0) {}
+  size_t current;
+  size_t max;
+};
+
+class CountingStartBlock : public StringStartBlock
+{
+public:
+  CountingStartBlock(const size_t numStrings, InFlight & inFlight):
+    StringStartBlock::BlockType("Counting start block"),
+    myNumStrings(numStrings),
+    myInFlight(inFlight)
+  {}
+
+  virtual void start()
+  {
+    for(size_t i = 0; i < myNumStrings; ++i)
+    {
+      ::std::string & str = getRunner()->createData();
+      ++myInFlight.current;
+      myInFlight.max = ::std::max(myInFlight.max, myInFlight.current);
+      out(str);
+    }
+  }
+
+private:
+  const size_t myNumStrings;
+  InFlight & myInFlight;
+};
+
+class CountingPipeBlock : public StringPipeBlock
+{
+public:
+  CountingPipeBlock(InFlight & inFlight):
+    StringPipeBlock::BlockType("Counting pipe block"),
+    myInFlight(inFlight)
+  {}
+
+  virtual void in(::std::string & data)
+  {
+    --myInFlight.current;
+    out(data);
+  }
+
+private:
+  InFlight & myInFlight;
+};
+
+// Sends out a number of new strings for each one that comes in
+class FanOutPipeBlock : public StringPipeBlock
+{
+public:
+  FanOutPipeBlock(const size_t fanOut, InFlight & inFlight):
+    StringPipeBlock::BlockType("Fan out pipe block"),
+    myFanOut(fanOut),
+    myInFlight(inFlight)
+  {}
+
+  virtual void in(::std::string & data)
+  {
+    for(size_t i = 1; i < myFanOut; ++i)
+    {
+      ::std::string & str = getRunner()->createData();
+      ++myInFlight.current;
+      myInFlight.max = ::std::max(myInFlight.max, myInFlight.current);
+      out(str);
+    }
+    out(data);
+  }
+
+private:
+  const size_t myFanOut;
+  InFlight & myInFlight;
+};
+
+// Sends each string back to itself a number of times before passing it on
+// down the second channel
+class LoopingPipeBlock : public StringPipeBlock
+{
+public:
+  static const pipelib::Channel LOOP_CHANNEL = 0;
+  static const pipelib::Channel EXIT_CHANNEL = 1;
+
+  LoopingPipeBlock(const size_t numLaps):
+    StringPipeBlock::BlockType("Looping pipe block", 2),
+    maxDepth(0),
+    myNumLaps(numLaps),
+    myDepth(0)
+  {}
+
+  virtual void in(::std::string & data)
+  {
+    ++myDepth;
+    maxDepth = ::std::max(maxDepth, myDepth);
+
+    size_t & laps = myLaps[&data];
+    if(++laps < myNumLaps)
+      out(data, LOOP_CHANNEL);
+    else
+    {
+      myLaps.erase(&data);
+      out(data, EXIT_CHANNEL);
+    }
+
+    --myDepth;
+  }
+
+  size_t maxDepth;
+
+private:
+  const size_t myNumLaps;
+  size_t myDepth;
+  ::std::map<const ::std::string *, size_t> myLaps;
+};
+
+class BatchingPipeBlock : public StringPipeBlock
+{
+public:
+  BatchingPipeBlock():
+    StringPipeBlock::BlockType("Batching pipe block"),
+    numReceived(0),
+    numBatches(0),
+    maxBatchSize(0)
+  {}
+
+  virtual void in(::std::string & data)
+  {
+    ++numReceived;
+    out(data);
+  }
+
+  virtual void inBatch(const DataBatch & batch)
+  {
+    ++numBatches;
+    maxBatchSize = ::std::max(maxBatchSize, batch.size());
+    for(size_t i = 0; i < batch.size(); ++i)
+      in(*batch[i]);
+  }
+
+  virtual bool supportsBatches() const { return true; }
+
+  size_t numReceived;
+  size_t numBatches;
+  size_t maxBatchSize;
+};
+
+class DropEverySecondBlock : public StringPipeBlock
+{
+public:
+  DropEverySecondBlock():
+    StringPipeBlock::BlockType("Drop every second block"),
+    myCount(0)
+  {}
+
+  virtual void in(::std::string & data)
+  {
+    if(myCount++ % 2 == 0)
+      out(data);
+    else
+      getRunner()->dropData(data);
+  }
+
+private:
+  size_t myCount;
+};
+
+class NumberingBlock : public StringPipeBlock
+{
+public:
+  NumberingBlock():
+    StringPipeBlock::BlockType("Numbering block"),
+    myCount(0)
+  {}
+
+  virtual void in(::std::string & data)
+  {
+    data = ::boost::lexical_cast< ::std::string>(myCount++);
+    out(data);
+  }
+
+private:
+  int myCount;
+};
+
+typedef pipelib::AsyncPipeBlock< ::std::string, const void *, const void *> StringAsyncPipeBlock;
+
+class SlowAsyncBlock : public StringAsyncPipeBlock
+{
+public:
+  SlowAsyncBlock():
+    StringPipeBlock::BlockType("Slow async block")
+  {}
+
+  ::std::vector<int> processedOrder;
+
+protected:
+  virtual bool processAsync(::std::string & data)
+  {
+    // Take a varying amount of time so the jobs finish out of order
+    const int number = ::boost::lexical_cast<int>(data);
+    ::boost::this_thread::sleep(::boost::posix_time::milliseconds(3 * (3 - number % 3)));
+    // Drop every fifth one
+    return number % 5 != 4;
+  }
+
+  virtual void processed(::std::string & data, const bool keep)
+  {
+    if(keep)
+      processedOrder.push_back(::boost::lexical_cast<int>(data));
+    StringAsyncPipeBlock::processed(data, keep);
+  }
+};
+
+// Data type that keeps track of how many times it has been created and recycled
+struct PooledData
+{
+  PooledData(): value(0) { ++numConstructed; }
+  int value;
+  static size_t numConstructed;
+  static size_t numRecycled;
+};
+size_t PooledData::numConstructed = 0;
+size_t PooledData::numRecycled = 0;
+
+typedef pipelib::Pipe<PooledData, const void *, const void *> PooledPipe;
+
+class PooledStartBlock : public PooledPipe::StartBlockType
+{
+public:
+  PooledStartBlock(const int numData):
+    PooledPipe::StartBlockType::BlockType("Pooled start block"),
+    myNumData(numData)
+  {}
+
+  virtual void start()
+  {
+    for(int i = 0; i < myNumData; ++i)
+    {
+      PooledData & data = getRunner()->createData();
+      // Recycled data should come back as new
+      BOOST_REQUIRE(data.value == 0);
+      data.value = i + 1;
+      if(i % 2 == 0)
+        out(data);
+      else
+        getRunner()->dropData(data);
+    }
+  }
+
+private:
+  const int myNumData;
+};
+
+typedef pipelib::RunnerAccess< ::std::string, const void *, const void *> StringRunnerAccess;
+
+// Keeps a copy of the last profile the runner sent
+// Flushes the runner after sending out its strings and holds on to one of its own
+class FlushingStartBlock : public StringStartBlock
+{
+public:
+  FlushingStartBlock(const size_t numStrings, InFlight & inFlight):
+    StringStartBlock::BlockType("Flushing start block"),
+    myNumStrings(numStrings),
+    myInFlight(inFlight),
+    inFlightAfterFlush(0)
+  {}
+
+  virtual void start()
+  {
+    const pipelib::PipelineDataHandle handle =
+      getRunner()->createDataHandle(StringRunnerAccess::PipelineDataPtr(new ::std::string("held")));
+
+    for(size_t i = 0; i < myNumStrings; ++i)
+    {
+      ::std::string & str = getRunner()->createData();
+      ++myInFlight.current;
+      out(str);
+    }
+    getRunner()->flush();
+    inFlightAfterFlush = myInFlight.current;
+
+    getRunner()->releaseDataHandle(handle);
+  }
+
+private:
+  const size_t myNumStrings;
+  InFlight & myInFlight;
+public:
+  size_t inFlightAfterFlush;
+};
+
+class CollectingSink : public pipelib::FinishedSink< ::std::string>
+{
+public:
+  virtual void finished(PipelineDataPtr data)
+  {
+    strings.push_back(*data);
+  }
+
+  ::std::vector< ::std::string> strings;
+};
+
+class ProfileListener : public pipelib::event::PipeRunnerListener<StringRunnerAccess>
+{
+public:
+  typedef StringRunnerAccess::ProfileType Profile;
+
+  ProfileListener(): numUpdates(0), peakLiveData(0) {}
+
+  virtual void notify(const pipelib::event::PipeRunnerProfileUpdated<StringRunnerAccess> & evt)
+  {
+    ++numUpdates;
+    blocks.assign(evt.getProfile().begin(), evt.getProfile().end());
+    peakLiveData = evt.getProfile().getPeakLiveData();
+  }
+
+  const Profile::BlockProfile * find(const StringRunnerAccess::BlockType * const block) const
+  {
+    for(size_t i = 0; i < blocks.size(); ++i)
+    {
+      if(blocks[i].block == block)
+        return &blocks[i];
+    }
+    return NULL;
+  }
+
+  size_t numUpdates;
+  size_t peakLiveData;
+  ::std::vector<Profile::BlockProfile> blocks;
+};
+
+}
+
+namespace pipelib {
+
+template <>
+struct DataPoolTraits<PooledData>
+{
+  static const bool POOLED = true;
+  static void recycle(PooledData & data)
+  {
+    data.value = 0;
+    ++PooledData::numRecycled;
+  }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(QueuedDispatchTest)
+{
+  typedef pipelib::SingleThreadedEngine< ::std::string, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const size_t numStrings = 100;
+  const size_t maxQueueSize = 8;
+
+  InFlight inFlight;
+  StringPipe pipe;
+
+  StringStartBlock * const startBlock = pipe.addBlock(new CountingStartBlock(numStrings, inFlight));
+  pipe.setStartBlock(startBlock);
+  // A few blocks in between so the work has to go through the queue more than once
+  StringPipeBlock * last = pipe.addBlock(new PrintStringBlock(1));
+  pipe.connect(startBlock, last);
+  for(int i = 2; i < 4; ++i)
+  {
+    StringPipeBlock * const next = pipe.addBlock(new PrintStringBlock(i));
+    pipe.connect(last, next);
+    last = next;
+  }
+  pipe.connect(last, pipe.addBlock(new CountingPipeBlock(inFlight)));
+
+  Engine engine;
+  engine.setDispatchMode(pipelib::DispatchMode::QUEUED);
+  engine.setMaxQueueSize(maxQueueSize);
+  engine.run(pipe);
+
+  // Everything should have made it through but the start block should have been
+  // held back so there were never more than a queue's worth of strings in flight
+  BOOST_REQUIRE(inFlight.current == 0);
+  BOOST_REQUIRE(inFlight.max <= maxQueueSize);
+}
+
+BOOST_AUTO_TEST_CASE(QueuedDispatchFanOutTest)
+{
+  typedef pipelib::SingleThreadedEngine< ::std::string, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const size_t numStrings = 50;
+  const size_t fanOut = 10;
+  const size_t maxQueueSize = 8;
+
+  InFlight inFlight;
+  StringPipe pipe;
+
+  StringStartBlock * const startBlock = pipe.addBlock(new CountingStartBlock(numStrings, inFlight));
+  pipe.setStartBlock(startBlock);
+  StringPipeBlock * const fanOutBlock = pipe.addBlock(new FanOutPipeBlock(fanOut, inFlight));
+  pipe.connect(startBlock, fanOutBlock);
+  StringPipeBlock * const printBlock = pipe.addBlock(new PrintStringBlock(1));
+  pipe.connect(fanOutBlock, printBlock);
+  pipe.connect(printBlock, pipe.addBlock(new CountingPipeBlock(inFlight)));
+
+  Engine engine;
+  engine.setDispatchMode(pipelib::DispatchMode::QUEUED);
+  engine.setMaxQueueSize(maxQueueSize);
+  engine.run(pipe);
+
+  // The fan out block produces many times what it takes in while it is being
+  // drained but the queue should still have stayed within its limit.  On top of
+  // the queue only the strings on their way down the call stack are in flight.
+  BOOST_REQUIRE(inFlight.current == 0);
+  BOOST_REQUIRE(inFlight.max <= maxQueueSize + 2);
+}
+
+BOOST_AUTO_TEST_CASE(QueuedDispatchLoopTest)
+{
+  typedef pipelib::SingleThreadedEngine< ::std::string, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const size_t numStrings = 20;
+  const size_t fanOut = 10;
+  const size_t maxQueueSize = 8;
+  const size_t numLaps = 1000;
+
+  InFlight inFlight;
+  StringPipe pipe;
+
+  StringStartBlock * const startBlock = pipe.addBlock(new CountingStartBlock(numStrings, inFlight));
+  pipe.setStartBlock(startBlock);
+  StringPipeBlock * const fanOutBlock = pipe.addBlock(new FanOutPipeBlock(fanOut, inFlight));
+  pipe.connect(startBlock, fanOutBlock);
+  LoopingPipeBlock * const loopBlock = pipe.addBlock(new LoopingPipeBlock(numLaps));
+  pipe.connect(fanOutBlock, loopBlock);
+  pipe.connect(loopBlock, loopBlock, LoopingPipeBlock::LOOP_CHANNEL);
+  pipe.connect(loopBlock, pipe.addBlock(new CountingPipeBlock(inFlight)), LoopingPipeBlock::EXIT_CHANNEL);
+
+  Engine engine;
+  engine.setDispatchMode(pipelib::DispatchMode::QUEUED);
+  engine.setMaxQueueSize(maxQueueSize);
+  engine.run(pipe);
+
+  // With the queue full, strings coming out of the loop are passed straight
+  // back in, but only so many times before the queue has to take them
+  BOOST_REQUIRE(inFlight.current == 0);
+  BOOST_REQUIRE(loopBlock->maxDepth > 1);
+  BOOST_REQUIRE(loopBlock->maxDepth <= 64);
+}
+
+BOOST_AUTO_TEST_CASE(ProfilingTest)
+{
+  typedef pipelib::SingleThreadedEngine< ::std::string, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const size_t numStrings = 10;
+
+  InFlight inFlight;
+  StringPipe pipe;
+
+  StringStartBlock * const startBlock = pipe.addBlock(new CountingStartBlock(numStrings, inFlight));
+  pipe.setStartBlock(startBlock);
+  StringPipeBlock * const dropBlock = pipe.addBlock(new DropEverySecondBlock());
+  StringPipeBlock * const endBlock = pipe.addBlock(new CountingPipeBlock(inFlight));
+  pipe.connect(startBlock, dropBlock);
+  pipe.connect(dropBlock, endBlock);
+
+  ProfileListener listener;
+  Engine engine;
+  engine.setProfiling(true);
+  Engine::RunnerPtr runner = engine.createRunner(pipe);
+  runner->addListener(listener);
+  runner->run();
+
+  // There should be exactly one, final, report as there is no report interval
+  BOOST_REQUIRE(listener.numUpdates == 1);
+  BOOST_REQUIRE(listener.peakLiveData >= 1);
+
+  const ProfileListener::Profile::BlockProfile * profile = listener.find(startBlock);
+  BOOST_REQUIRE(profile);
+  BOOST_REQUIRE(profile->numEmitted == numStrings);
+
+  profile = listener.find(dropBlock);
+  BOOST_REQUIRE(profile);
+  BOOST_REQUIRE(profile->numReceived == numStrings);
+  BOOST_REQUIRE(profile->numEmitted == numStrings / 2);
+  BOOST_REQUIRE(profile->numDropped == numStrings / 2);
+
+  profile = listener.find(endBlock);
+  BOOST_REQUIRE(profile);
+  BOOST_REQUIRE(profile->numReceived == numStrings / 2);
+  BOOST_REQUIRE(profile->numDropped == 0);
+}
+
+BOOST_AUTO_TEST_CASE(DataPoolTest)
+{
+  typedef pipelib::SingleThreadedEngine<PooledData, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const int numData = 20;
+
+  PooledPipe pipe;
+  pipe.setStartBlock(pipe.addBlock(new PooledStartBlock(numData)));
+
+  Engine engine;
+  engine.run(pipe);
+
+  // Each piece of data is finished or dropped before the next is created so
+  // the same one should have been used throughout
+  BOOST_REQUIRE(PooledData::numConstructed == 1);
+  BOOST_REQUIRE(PooledData::numRecycled == static_cast<size_t>(numData));
+}
+
+BOOST_AUTO_TEST_CASE(BatchingTest)
+{
+  typedef pipelib::SingleThreadedEngine< ::std::string, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const size_t numStrings = 20;
+  const size_t maxQueueSize = 8;
+  const size_t maxBatchSize = 3;
+
+  InFlight inFlight;
+  StringPipe pipe;
+
+  StringStartBlock * const startBlock = pipe.addBlock(new CountingStartBlock(numStrings, inFlight));
+  pipe.setStartBlock(startBlock);
+  BatchingPipeBlock * const batchBlock = new BatchingPipeBlock();
+  pipe.connect(startBlock, pipe.addBlock(batchBlock));
+  pipe.connect(batchBlock, pipe.addBlock(new CountingPipeBlock(inFlight)));
+
+  Engine engine;
+  engine.setDispatchMode(pipelib::DispatchMode::QUEUED);
+  engine.setMaxQueueSize(maxQueueSize);
+  engine.setMaxBatchSize(maxBatchSize);
+  engine.run(pipe);
+
+  // Everything should have got through, most of it in full batches
+  BOOST_REQUIRE(inFlight.current == 0);
+  BOOST_REQUIRE(batchBlock->numReceived == numStrings);
+  BOOST_REQUIRE(batchBlock->maxBatchSize == maxBatchSize);
+  BOOST_REQUIRE(batchBlock->numBatches >= numStrings / maxQueueSize);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncTest)
+{
+  typedef pipelib::SingleThreadedEngine< ::std::string, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const size_t numStrings = 40;
+  const size_t numThreads = 3;
+  const size_t maxInFlight = 5;
+
+  for(int queued = 0; queued < 2; ++queued)
+  {
+    for(int inOrder = 0; inOrder < 2; ++inOrder)
+    {
+      InFlight inFlight;
+      StringPipe pipe;
+
+      StringStartBlock * const startBlock = pipe.addBlock(new CountingStartBlock(numStrings, inFlight));
+      pipe.setStartBlock(startBlock);
+      StringPipeBlock * const numbering = pipe.addBlock(new NumberingBlock());
+      pipe.connect(startBlock, numbering);
+      SlowAsyncBlock * const asyncBlock = new SlowAsyncBlock();
+      asyncBlock->setExecutor(
+        StringAsyncPipeBlock::ExecutorPtr(new pipelib::ThreadPoolExecutor(numThreads)),
+        maxInFlight,
+        inOrder ? pipelib::CompletionOrder::SUBMISSION : pipelib::CompletionOrder::COMPLETION
+      );
+      pipe.connect(numbering, pipe.addBlock(asyncBlock));
+      pipe.connect(asyncBlock, pipe.addBlock(new CountingPipeBlock(inFlight)));
+
+      Engine engine;
+      if(queued)
+        engine.setDispatchMode(pipelib::DispatchMode::QUEUED);
+      engine.run(pipe);
+
+      // Everything that wasn't dropped should have made it to the end by the time the run finishes
+      BOOST_REQUIRE(asyncBlock->processedOrder.size() == numStrings - numStrings / 5);
+      BOOST_REQUIRE(inFlight.current == numStrings / 5);
+      if(inOrder)
+      {
+        BOOST_REQUIRE(::std::adjacent_find(
+          asyncBlock->processedOrder.begin(),
+          asyncBlock->processedOrder.end(),
+          ::std::greater<int>()) == asyncBlock->processedOrder.end());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FlushTest)
+{
+  typedef pipelib::SingleThreadedEngine< ::std::string, const void *, const void *> Engine;
+
+  // SETTINGS //////////////
+  const size_t numStrings = 20;
+
+  InFlight inFlight;
+  StringPipe pipe;
+
+  FlushingStartBlock * const startBlock = new FlushingStartBlock(numStrings, inFlight);
+  pipe.setStartBlock(pipe.addBlock(startBlock));
+  pipe.connect(startBlock, pipe.addBlock(new CountingPipeBlock(inFlight)));
+
+  // Make the queue big enough that nothing would be passed on until the start block is done
+  Engine engine;
+  engine.setDispatchMode(pipelib::DispatchMode::QUEUED);
+  engine.setMaxQueueSize(2 * numStrings);
+
+  CollectingSink sink;
+  Engine::RunnerPtr runner = engine.createRunner(pipe);
+  runner->setFinishedDataSink(&sink);
+  runner->run();
+
+  // Flushing should have pushed everything through and the held string should
+  // have finished once its handle was released
+  BOOST_REQUIRE(startBlock->inFlightAfterFlush == 0);
+  BOOST_REQUIRE(sink.strings.size() == numStrings + 1);
+  BOOST_REQUIRE(::std::find(sink.strings.begin(), sink.strings.end(), "held") != sink.strings.end());
+}
@@ -0,0 +1,135 @@
+/*
+ * TpsdStepBenchmark.cpp
+ *
+ * Times the per-step overhead of the TPSD optimiser, that is the time per
+ * step spent outside of the potential evaluation.  This isn't a test, it
+ * only prints the timings.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include <cmath>
+#include <iostream>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <armadillo>
+
+#include <common/AtomSpeciesDatabase.h>
+#include <common/Structure.h>
+#include <common/Types.h>
+#include <common/UnitCell.h>
+#include <math/Random.h>
+#include <potential/IPotentialEvaluator.h>
+#include <potential/OptimisationSettings.h>
+#include <potential/SimplePairPotential.h>
+#include <potential/TpsdGeomOptimiser.h>
+
+namespace pt = ::boost::posix_time;
+namespace ssc = ::sstbx::common;
+namespace ssm = ::sstbx::math;
+namespace ssp = ::sstbx::potential;
+
+ssp::TpsdGeomOptimiser::PotentialPtr createPotential(ssc::AtomSpeciesDatabase & speciesDb);
+void createStructures(
+  ::boost::ptr_vector<ssc::Structure> & structures,
+  const size_t numStructures,
+  const size_t numAtoms);
+
+int main()
+{
+  // SETTINGS ////////////////
+  const size_t numStructures = 20;
+  const unsigned int numSteps = 200;
+  const size_t sizes[] = {8, 30};
+
+  ssc::AtomSpeciesDatabase speciesDb;
+  ssp::TpsdGeomOptimiser optimiser(createPotential(speciesDb));
+  // Never converge so that every optimisation runs for the full number of steps
+  optimiser.setTolerance(0.0);
+  ssp::OptimisationSettings settings;
+  settings.maxSteps.reset(numSteps);
+
+  for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+  {
+    ::boost::ptr_vector<ssc::Structure> structures;
+    createStructures(structures, numStructures, sizes[s]);
+
+    // Time the potential evaluation on its own...
+    pt::ptime start = pt::microsec_clock::universal_time();
+    for(size_t i = 0; i < numStructures; ++i)
+    {
+      ::boost::shared_ptr<ssp::IPotentialEvaluator> evaluator =
+        optimiser.getPotential()->createEvaluator(structures[i]);
+      for(unsigned int step = 0; step < numSteps; ++step)
+        evaluator->evalPotential();
+    }
+    const double evalUs =
+      static_cast<double>((pt::microsec_clock::universal_time() - start).total_microseconds()) /
+      (numStructures * numSteps);
+
+    // ...and as part of the optimisation, what's left is the per-step overhead of TPSD
+    start = pt::microsec_clock::universal_time();
+    for(size_t i = 0; i < numStructures; ++i)
+      optimiser.optimise(structures[i], settings);
+    const double stepUs =
+      static_cast<double>((pt::microsec_clock::universal_time() - start).total_microseconds()) /
+      (numStructures * numSteps);
+
+    ::std::cout << "TPSD " << sizes[s] << " atoms: " << stepUs << "us/step, of which potential "
+      << evalUs << "us, overhead " << stepUs - evalUs << "us" << ::std::endl;
+  }
+
+  return 0;
+}
+
+ssp::TpsdGeomOptimiser::PotentialPtr createPotential(ssc::AtomSpeciesDatabase & speciesDb)
+{
+  ssp::SimplePairPotential::SpeciesList species;
+  species.push_back(ssc::AtomSpeciesId::CUSTOM_1);
+  species.push_back(ssc::AtomSpeciesId::CUSTOM_2);
+
+  ::arma::mat epsilon, sigma, beta;
+  epsilon.set_size(2, 2);
+  epsilon.fill(1.0);
+  sigma.set_size(2, 2);
+  sigma(0, 0) = 2.0;
+  sigma(0, 1) = sigma(1, 0) = 2.5;
+  sigma(1, 1) = 3.0;
+  beta.set_size(2, 2);
+  beta.fill(1.0);
+
+  return ssp::TpsdGeomOptimiser::PotentialPtr(
+    new ssp::SimplePairPotential(speciesDb, species, epsilon, sigma, 2.5, beta, 12, 6)
+  );
+}
+
+void createStructures(
+  ::boost::ptr_vector<ssc::Structure> & structures,
+  const size_t numStructures,
+  const size_t numAtoms)
+{
+  // Keep the density the same as for a six atom cell of side 4-6
+  const double scale = ::std::pow(static_cast<double>(numAtoms) / 6.0, 1.0 / 3.0);
+
+  for(size_t i = 0; i < numStructures; ++i)
+  {
+    ssc::Structure * const structure = new ssc::Structure();
+    structures.push_back(structure);
+
+    structure->setUnitCell(ssc::UnitCellPtr(new ssc::UnitCell(
+      ssm::randu(4.0, 6.0) * scale,
+      ssm::randu(4.0, 6.0) * scale,
+      ssm::randu(4.0, 6.0) * scale, 90.0, 90.0, 90.0)));
+
+    for(size_t j = 0; j < numAtoms; ++j)
+    {
+      structure->newAtom(j % 2 == 0 ? ssc::AtomSpeciesId::CUSTOM_1 : ssc::AtomSpeciesId::CUSTOM_2)
+        .setPosition(structure->getUnitCell()->randomPoint());
+    }
+  }
+}
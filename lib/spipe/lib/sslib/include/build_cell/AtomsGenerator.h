@@ -23,6 +23,9 @@
 // FORWARD DECLARES //////////////////////////
 
 namespace sstbx {
+namespace common {
+class UnitCell;
+}
 namespace build_cell {
 class AtomsDescription;
 class BuildAtomInfo;
@@ -102,6 +105,11 @@ private:
     const IGeneratorShape & genShape,
     const ::arma::mat44 & transformation
   ) const;
+  ::arma::vec3 generateWyckoffPosition(
+    SymmetryGroup::OpMask & opMaskOut,
+    const SymmetryGroup::WyckoffPositions & positions,
+    const common::UnitCell & unitCell
+  ) const;
   OptionalArmaVec3 generateSpeciesPosition(
     const SymmetryGroup::Eigenspace & eigenspace,
     const IGeneratorShape & genShape,
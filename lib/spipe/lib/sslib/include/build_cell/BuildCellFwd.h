@@ -11,6 +11,8 @@
 // INCLUDES ////////////
 #include "SSLib.h"
 
+#include <boost/shared_ptr.hpp>
+
 namespace sstbx {
 namespace build_cell {
 
@@ -22,6 +24,7 @@ class IStructureGenerator;
 class IUnitCellGenerator;
 class RandomUnitCellGenerator;
 class StructureBuilder;
+class SymmetryGroup;
 
 // TYPEDEFS /////////////////////
 typedef UniquePtr<AtomsDescription>::Type AtomsDescriptionPtr;
@@ -31,6 +34,8 @@ typedef UniquePtr<IUnitCellGenerator>::Type IUnitCellGeneratorPtr;
 typedef UniquePtr<IStructureGenerator>::Type IStructureGeneratorPtr;
 typedef UniquePtr<RandomUnitCellGenerator>::Type RandomUnitCellPtr;
 typedef UniquePtr<StructureBuilder>::Type StructureBuilderPtr;
+// Symmetry groups are shared and never changed once generated
+typedef ::boost::shared_ptr<const SymmetryGroup> SymmetryGroupConstPtr;
 
 
 }
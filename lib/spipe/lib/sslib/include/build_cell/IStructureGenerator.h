@@ -30,6 +30,10 @@ public:
 
   virtual ~IStructureGenerator() {}
 
+  /**
+  /* If structureOut already holds a structure it may be cleared and reused
+  /* rather than allocating a new one.
+  /**/
   virtual GenerationOutcome generateStructure(
     common::StructurePtr & structureOut,
     const common::AtomSpeciesDatabase & speciesDb
@@ -11,6 +11,7 @@
 // INCLUDES ////////////
 #include "build_cell/BuildCellFwd.h"
 #include "build_cell/GenerationOutcome.h"
+#include "build_cell/SpaceGroups.h"
 #include "common/Types.h"
 
 namespace sstbx {
@@ -36,6 +37,13 @@ public:
     const StructureContents & contents,
     const bool structureIsCluster = false
   ) const = 0;
+  /** Generate a cell with the lattice of the given crystal system. */
+  virtual GenerationOutcome generateCell(
+    common::UnitCellPtr & cellOut,
+    const StructureContents & contents,
+    const CrystalSystem::Value crystalSystem,
+    const bool structureIsCluster = false
+  ) const = 0;
 
   virtual IUnitCellGeneratorPtr clone() const = 0;
 };
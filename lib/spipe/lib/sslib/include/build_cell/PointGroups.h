@@ -14,6 +14,7 @@
 
 #include <boost/optional.hpp>
 
+#include "build_cell/BuildCellFwd.h"
 #include "build_cell/SymmetryGroup.h"
 
 // DEFINITION ///////////////////////
@@ -40,6 +41,15 @@ void generatePointGroup(
   const PointGroupFamily::Value family,
   const unsigned int n = 0);
 
+/**
+/* Get the point group, along with its multiplicities and eigenspaces, shared
+/* with everyone else that has asked for the same one.  It is only generated
+/* the first time and can't be changed so it is safe to use from any thread.
+/**/
+SymmetryGroupConstPtr getSharedPointGroup(
+  const PointGroupFamily::Value family,
+  const unsigned int n = 0);
+
 bool getPointGroup(PointGroup & groupOut, const ::std::string & groupString);
 
 ::boost::optional<PointGroup>
@@ -10,6 +10,8 @@
 
 // INCLUDES ////////////
 
+#include <boost/thread/mutex.hpp>
+
 #include "OptionalTypes.h"
 #include "build_cell/IUnitCellGenerator.h"
 #include "utility/IndexingEnums.h"
@@ -25,6 +27,29 @@ class RandomUnitCellGenerator : public IUnitCellGenerator
 public:
   typedef ::std::pair<double, bool> ParameterValueAndSpecific;
 
+  /**
+  /* Counts of how the lattice parameters have been generated.  Angles and
+  /* lengths are drawn directly from their valid region so the only cells that
+  /* can't be made are those where the ranges admit no valid parameters at all.
+  /**/
+  struct Statistics
+  {
+    Statistics();
+
+    /** The fraction of requested cells that were generated. */
+    double getAcceptanceRate() const;
+
+    size_t numRequested;
+    /** No set of angles within the ranges forms a valid cell. */
+    size_t numInvalidAngles;
+    /**
+    /* The lengths ranges couldn't satisfy the maximum length ratio (along with
+    /* any lengths the crystal system makes equal) so it was ignored.
+    /**/
+    size_t numLengthRatioIgnored;
+    size_t numSingular;
+  };
+
   static const double DEFAULT_MIN_ANGLE;
   static const double DEFAULT_MAX_ANGLE;
   static const double DEFAULT_MIN_LENGTH;
@@ -54,6 +79,10 @@ public:
   void setMaxLengthRatio(const OptionalDouble maxLengthRatio = OptionalDouble());
   ParameterValueAndSpecific getMaxLengthRatio() const;
 
+  /** The statistics so far, safe to call while other threads are generating cells. */
+  Statistics getStatistics() const;
+  void resetStatistics();
+
   // From IUnitCellGenerator ////
   virtual GenerationOutcome generateCell(
     common::UnitCellPtr & cellOut,
@@ -64,27 +93,49 @@ public:
     const StructureContents & contents,
     const bool structureIsCluster = false
   ) const;
+  virtual GenerationOutcome generateCell(
+    common::UnitCellPtr & cellOut,
+    const StructureContents & contents,
+    const CrystalSystem::Value crystalSystem,
+    const bool structureIsCluster = false
+  ) const;
 
   virtual IUnitCellGeneratorPtr clone() const;
   // End from IUnitCellGenerator //////
 
 private:
   typedef ::std::pair<OptionalDouble, OptionalDouble> MinMax;
-  typedef ::std::pair<size_t, size_t> MinMaxIndex;
   typedef ::std::pair<double, double> VolAndDelta;
 
+  /** The statistics are updated by the const generate methods so they are locked for each update. */
+  class GuardedStatistics
+  {
+  public:
+    GuardedStatistics() {}
+    GuardedStatistics(const GuardedStatistics & toCopy);
+    GuardedStatistics & operator =(const GuardedStatistics & rhs);
+
+    Statistics get() const;
+    void reset();
+    void increment(size_t Statistics::* const counter);
+  private:
+    Statistics myStatistics;
+    mutable ::boost::mutex myMutex;
+  };
+
   inline bool isLength(const size_t param) const { return param <= utility::cell_params_enum::C; }
 
-  double generateParameter(const size_t param) const;
-  GenerationOutcome generateLatticeParameters(common::UnitCellPtr & cellOut) const;
+  GenerationOutcome generateLatticeParameters(
+    common::UnitCellPtr & cellOut,
+    const CrystalSystem::Value crystalSystem = CrystalSystem::TRICLINIC
+  ) const;
+  void applyCrystalSystem(double (&latticeParams)[6], const CrystalSystem::Value crystalSystem) const;
 
-  void generateLengths(double (&latticeParams)[6]) const;
+  void generateLengths(double (&latticeParams)[6], const CrystalSystem::Value crystalSystem) const;
+  bool generateAngles(double (&latticeParams)[6], const CrystalSystem::Value crystalSystem) const;
 
   double generateVolume(const VolAndDelta & volAndDelta) const;
 
-  MinMaxIndex getMinMaxLengths(const double (&latticeParams)[6]) const;
-
-  bool areParametersValid(const double (&latticeParams)[6]) const;
   bool cellFullySpecified() const;
   VolAndDelta generateVolumeParams(
     const double currentVolume,
@@ -103,6 +154,8 @@ private:
   OptionalDouble myContentsMultiplier;
   OptionalDouble myVolumeDelta;
   OptionalDouble myMaxLengthRatio;
+
+  mutable GuardedStatistics myStatistics;
 };
 
 }
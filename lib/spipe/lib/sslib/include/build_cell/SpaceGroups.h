@@ -0,0 +1,66 @@
+/*
+ * SpaceGroups.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SPACE_GROUPS_H
+#define SPACE_GROUPS_H
+
+// INCLUDES ////////////
+#include <string>
+#include <vector>
+
+#include "build_cell/BuildCellFwd.h"
+
+// DEFINITION ///////////////////////
+
+namespace sstbx {
+namespace build_cell {
+
+struct CrystalSystem
+{
+  enum Value
+  {
+    TRICLINIC,
+    MONOCLINIC,   // Unique axis b
+    ORTHORHOMBIC,
+    TETRAGONAL,
+    TRIGONAL,     // Hexagonal axes (including the rhombohedral groups)
+    HEXAGONAL,
+    CUBIC
+  };
+};
+
+CrystalSystem::Value getCrystalSystem(const unsigned int spaceGroup);
+
+/**
+/* Generate the space group (in the standard setting and conventional cell) with
+/* the operators acting on fractional coordinates, along with its Wyckoff
+/* positions.  Only a selection of the most common space groups is available,
+/* returns false if the group isn't one of them.
+/**/
+bool generateSpaceGroup(SymmetryGroup & groupOut, const unsigned int number);
+
+/**
+/* As getSharedPointGroup, the space group is only generated the first time it
+/* is asked for.  Returns a null pointer if the space group isn't available.
+/**/
+SymmetryGroupConstPtr getSharedSpaceGroup(const unsigned int number);
+
+/** Get the space group number from either the number or the symbol e.g. Fm-3m. */
+bool getSpaceGroup(unsigned int & numberOut, const ::std::string & groupString);
+
+::std::string getSpaceGroupSymbol(const unsigned int number);
+
+/** Any of the available space groups other than P1. */
+unsigned int getRandomSpaceGroup();
+
+::std::vector<unsigned int> getAvailableSpaceGroups();
+
+}
+}
+
+
+#endif /* SPACE_GROUPS_H */
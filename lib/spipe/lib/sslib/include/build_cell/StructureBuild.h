@@ -15,6 +15,7 @@
 #include <set>
 
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "build_cell/AtomExtruder.h"
 #include "build_cell/BuildAtomInfo.h"
@@ -37,7 +38,8 @@ class StructureBuild
   typedef ::boost::ptr_vector<BuildAtomInfo> AtomInfoList;
 public:
   typedef ::std::set<size_t> FixedSet;
-  typedef UniquePtr<SymmetryGroup>::Type SymmetryGroupPtr;
+  // Symmetry groups are shared between builds and never changed
+  typedef ::boost::shared_ptr<const SymmetryGroup> SymmetryGroupPtr;
   typedef AtomInfoList::iterator AtomInfoIterator;
   typedef UniquePtr<IGeneratorShape>::Type GenShapePtr;
 
@@ -22,6 +22,7 @@
 #include "build_cell/IUnitCellGenerator.h"
 #include "build_cell/BuildCellFwd.h"
 #include "build_cell/PointGroups.h"
+#include "build_cell/SpaceGroups.h"
 
 // FORWARD DECLARES //////////////////////////
 
@@ -67,15 +68,27 @@ public:
   void setPointGroup(const PointGroup & pointGroup);
   const PointGroup & getPointGroup() const;
 
+  /**
+  /* The space group that crystals are built in (the default is P1), see
+  /* SpaceGroups.h for the ones that are available.  With a random space group
+  /* a different one is drawn for each structure.
+  /**/
+  void setSpaceGroup(const unsigned int spaceGroup);
+  unsigned int getSpaceGroup() const;
+  void setRandomSpaceGroup(const bool random);
+  bool isRandomSpaceGroup() const;
+
   void setCluster(const bool isCluster);
   bool isCluster() const;
 
 private:
-  bool chooseSymmetry(StructureBuild & build) const;
+  bool chooseSymmetry(StructureBuild & build, unsigned int & spaceGroupOut) const;
   GenerationOutcome generateSymmetry(StructureBuild & build) const;
 
   PointGroup myPointGroup;
   unsigned int myNumSymOps;
+  unsigned int mySpaceGroup;
+  bool myRandomSpaceGroup;
   bool myIsCluster;
 
   IUnitCellGeneratorPtr myUnitCellGenerator;
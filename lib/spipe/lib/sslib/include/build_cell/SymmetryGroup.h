@@ -36,6 +36,20 @@ public:
   typedef ::std::vector<bool> OpMask;
   typedef ::std::pair<Eigenspace, OpMask> EigenspaceAndMask;
   typedef ::std::vector<EigenspaceAndMask> EigenspacesAndMasks;
+
+  /**
+  /* A Wyckoff position of a space group, i.e. the points that share a particular
+  /* site symmetry.  Any of the origins plus a combination of the columns of space
+  /* (all in fractional coordinates) is on the position and the operators in the
+  /* mask take it to each of the (multiplicity) equivalent points.
+  /**/
+  struct WyckoffPosition
+  {
+    ::std::vector< ::arma::vec3> origins;
+    Eigenspace space;
+    OpMask opMask;
+  };
+  typedef ::std::vector<WyckoffPosition> WyckoffPositions;
 private:
   typedef ::std::vector<SymOp> SymOps;
 public:
@@ -45,6 +59,11 @@ public:
 
   void reset();
   void generateEigenvectors();
+  /**
+  /* For space groups, where the operators act on fractional coordinates, find
+  /* the Wyckoff positions instead of the eigenspaces.
+  /**/
+  void generateWyckoffPositions();
 
   void addOp(const SymOp & symmetryOp);
 
@@ -57,9 +76,11 @@ public:
   Multiplicities getMultiplicities() const;
 
   const EigenspacesAndMasks * getEigenspacesAndMasks(const unsigned int multiplicity) const;
+  const WyckoffPositions * getWyckoffPositions(const unsigned int multiplicity) const;
 
 protected:
   typedef ::std::map<unsigned int, EigenspacesAndMasks> InvariantsMap;
+  typedef ::std::map<unsigned int, WyckoffPositions> WyckoffMap;
 
   void generateMultiplicityEigenvectors2();
   bool getEigenspaces(
@@ -91,6 +112,7 @@ protected:
   
   SymOps mySymOps;
   InvariantsMap myInvariantsMap;
+  WyckoffMap myWyckoffMap;
 };
 
 }
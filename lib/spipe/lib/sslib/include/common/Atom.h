@@ -21,6 +21,11 @@ namespace common {
 // FORWARD DECLARES ///////////////////////////
 class Structure;
 
+/**
+/* A view onto one of the atoms of a structure.  The atom data itself (position,
+/* species and radius) is held in contiguous blocks by the structure so that
+/* all the positions can be used as a single 3xN matrix.
+/**/
 class Atom
 {
 public:
@@ -28,7 +33,7 @@ public:
   Structure & getStructure();
   const Structure & getStructure() const;
 
-  const ::arma::vec3 & getPosition() const;
+  ::arma::vec3 getPosition() const;
   void setPosition(const ::arma::vec3 & pos);
   void setPosition(const double x, const double y, const double z);
   void moveBy(const ::arma::vec3 & dr);
@@ -42,16 +47,7 @@ public:
 
 private:
 
-  Atom(const AtomSpeciesId::Value species, Structure & structure, const size_t index);
-
-  /**
-  /* Special constructor for use by Structure that copies everything an
-  /* atom except the structure and index within the structure which are
-  /* provided by the caller.
-  /*
-  /* Make sure to update this if any changes are made to Atom!
-  /**/
-  Atom(const Atom & toCopy, Structure & structure, const size_t index);
+  Atom(Structure & structure, const size_t index);
 
   void setIndex(const size_t index);
 
@@ -60,10 +56,6 @@ private:
   /** The index of this atom in the structure. */
   size_t                myIndex;
 
-  AtomSpeciesId::Value	mySpecies;
-  ::arma::vec3          myPosition;
-	double                myRadius;
-
   friend class Structure;
 };
 
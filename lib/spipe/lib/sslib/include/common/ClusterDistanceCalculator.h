@@ -11,6 +11,7 @@
 // INCLUDES ///////////////////////////////////
 #include "common/DistanceCalculator.h"
 
+#include "common/PairImages.h"
 #include "common/Structure.h"
 
 namespace sstbx {
@@ -62,6 +63,9 @@ public:
     return true;
   }
 
+  virtual inline void getPairImages(PairImages & imagesOut, const double cutoff) const
+  { imagesOut.reset(cutoff); }
+
   virtual inline bool isValid() const
   { return myStructure.getUnitCell() == NULL; }
 
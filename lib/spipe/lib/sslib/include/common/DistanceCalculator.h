@@ -20,6 +20,7 @@
 namespace sstbx {
 namespace common {
 
+class PairImages;
 class Structure;
 
 class DistanceCalculator : private ::boost::noncopyable
@@ -88,6 +89,13 @@ public:
     const unsigned int maxCellMultiples = DEFAULT_MAX_CELL_MULTIPLES) const
   { return getVecsBetween(atom1.getPosition(), atom2.getPosition(), cutoff, outVectors, maxVectors, maxCellMultiples); }
 
+  /**
+  /* Set up imagesOut to visit the images of pairs within the cutoff.  This is
+  /* the fast path for code that loops over many pairs, the default builds the
+  /* lattice translations from scratch each time.
+  /**/
+  virtual void getPairImages(PairImages & imagesOut, const double cutoff) const;
+
   virtual bool isValid() const = 0;
 
   virtual void unitCellChanged() {};
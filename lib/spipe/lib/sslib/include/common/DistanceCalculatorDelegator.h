@@ -87,6 +87,9 @@ public:
     const unsigned int maxCellMultiples = DEFAULT_MAX_CELL_MULTIPLES) const
   { return myDelegate->getVecsBetween(atom1, atom2, cutoff, outVectors, maxVectors, maxCellMultiples); }
 
+  virtual void getPairImages(PairImages & imagesOut, const double cutoff) const
+  { myDelegate->getPairImages(imagesOut, cutoff); }
+
   bool isValid() const
   { return myDelegate->isValid(); }
 
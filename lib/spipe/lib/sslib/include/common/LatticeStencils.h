@@ -0,0 +1,96 @@
+/*
+ * LatticeStencils.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef LATTICE_STENCILS_H
+#define LATTICE_STENCILS_H
+
+// INCLUDES ///////////////////////////////////
+#include "SSLib.h"
+
+#include <map>
+#include <vector>
+
+#include <armadillo>
+
+#include <boost/shared_ptr.hpp>
+
+namespace sstbx {
+namespace common {
+
+class UnitCell;
+
+/**
+/* A cache, keyed on cutoff, of the lattice translations that can take a vector
+/* within the unit cell to within the cutoff.  The translations are sorted by
+/* length so a search for images of a displacement dR can stop as soon as they
+/* get longer than cutoff + |dR|.  Call clear() whenever the cell changes.
+/**/
+class LatticeStencils
+{
+public:
+
+  static const size_t DEFAULT_MAX_STENCILS;
+
+  struct Stencil
+  {
+    ::std::vector< ::arma::vec3> translations;
+    ::std::vector<double> lengths;
+    /** The largest multiple of any cell vector used. */
+    unsigned int maxMultiple;
+  };
+  /** Shared so that a stencil outlives being dropped from the cache. */
+  typedef ::boost::shared_ptr<const Stencil> StencilPtr;
+
+  explicit LatticeStencils(const size_t maxStencils = DEFAULT_MAX_STENCILS);
+
+  /**
+  /* Call visitor(dr, drSq) for each image dr of dR (which must be within the
+  /* cell) that is within the cutoff.  Returns false if maxImages was reached.
+  /**/
+  template <class Visitor>
+  static bool forEachImage(
+    const Stencil & stencil,
+    const ::arma::vec3 & dR,
+    const double cutoff,
+    Visitor & visitor,
+    const size_t maxImages);
+
+  /**
+  /* Append the images of dR (which must be within the cell) that are within
+  /* the cutoff.  Returns false if maxValues was reached.
+  /**/
+  static bool getDistsBetween(
+    const Stencil & stencil,
+    const ::arma::vec3 & dR,
+    const double cutoff,
+    ::std::vector<double> & outDistances,
+    const size_t maxDistances);
+  static bool getVecsBetween(
+    const Stencil & stencil,
+    const ::arma::vec3 & dR,
+    const double cutoff,
+    ::std::vector< ::arma::vec3> & outVectors,
+    const size_t maxVectors);
+
+  StencilPtr getStencil(const UnitCell & cell, const double cutoff) const;
+  void clear();
+
+private:
+  typedef ::std::map<double, StencilPtr> Stencils;
+
+  void generateStencil(Stencil & stencil, const UnitCell & cell, const double cutoff) const;
+
+  const size_t myMaxStencils;
+  mutable Stencils myStencils;
+};
+
+}
+}
+
+#include "common/detail/LatticeStencils.h"
+
+#endif /* LATTICE_STENCILS_H */
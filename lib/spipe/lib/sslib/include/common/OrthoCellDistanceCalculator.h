@@ -15,6 +15,7 @@
 
 #include "SSLibAssert.h"
 #include "common/DistanceCalculator.h"
+#include "common/LatticeStencils.h"
 
 namespace sstbx {
 namespace common {
@@ -50,6 +51,8 @@ public:
     const size_t maxVectors = DEFAULT_MAX_OUTPUTS,
     const unsigned int maxCellMultiples = DEFAULT_MAX_CELL_MULTIPLES) const;
 
+  virtual void getPairImages(PairImages & imagesOut, const double cutoff) const;
+
   virtual bool isValid() const;
 
   void unitCellChanged();
@@ -70,6 +73,7 @@ private:
   double myBRecip;
   double myCRecip;
 
+  LatticeStencils myStencils;
 };
 
 } // namespace common
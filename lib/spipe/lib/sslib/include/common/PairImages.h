@@ -0,0 +1,84 @@
+/*
+ * PairImages.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PAIR_IMAGES_H
+#define PAIR_IMAGES_H
+
+// INCLUDES ///////////////////////////////////
+#include "SSLib.h"
+
+#include <cmath>
+#include <vector>
+
+#include <armadillo>
+
+#include "common/LatticeStencils.h"
+
+namespace sstbx {
+namespace common {
+
+class UnitCell;
+
+/**
+/* Visits the images of pairs of points that are within a fixed cutoff.  Get
+/* one from DistanceCalculator::getPairImages once per structure and cutoff,
+/* after that each pair is visited without any virtual calls or allocations.
+/* It takes a copy of the cell so it stays valid, but won't see later changes.
+/*
+/* The visitor is called as visitor(dr, drSq) for each image vector dr (from
+/* a to b) within the cutoff.
+/**/
+class PairImages
+{
+public:
+
+  PairImages();
+
+  /** There is no lattice so every pair has just the one image. */
+  void reset(const double cutoff);
+  void reset(const UnitCell & cell, const LatticeStencils::StencilPtr & stencil, const double cutoff);
+
+  double getCutoff() const;
+
+  /** Returns false if maxImages was reached. */
+  template <class Visitor>
+  bool forEachImage(
+    const ::arma::vec3 & a,
+    const ::arma::vec3 & b,
+    Visitor & visitor,
+    const size_t maxImages) const;
+
+private:
+
+  LatticeStencils::StencilPtr myStencil;
+  ::arma::mat33 myOrthoMtx;
+  ::arma::mat33 myFracMtx;
+  double myCutoff;
+  double myCutoffSq;
+};
+
+/** A visitor that appends the length of each image to a vector. */
+class ImageDistancesAppender
+{
+public:
+  explicit ImageDistancesAppender(::std::vector<double> & distances):
+  myDistances(distances)
+  {}
+
+  inline void operator()(const ::arma::vec3 & /*dr*/, const double drSq)
+  { myDistances.push_back(::std::sqrt(drSq)); }
+
+private:
+  ::std::vector<double> & myDistances;
+};
+
+}
+}
+
+#include "common/detail/PairImages.h"
+
+#endif /* PAIR_IMAGES_H */
@@ -11,11 +11,15 @@
 // INCLUDES ///////////////////////////////////////////////
 #include "SSLib.h"
 
+#include <map>
 #include <memory>
 #include <ostream>
+#include <vector>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <armadillo>
 
@@ -23,6 +27,7 @@
 #include "common/AtomSpeciesId.h"
 #include "common/DistanceCalculatorDelegator.h"
 #include "common/StructureProperties.h"
+#include "common/SymmetryDataset.h"
 #include "common/Types.h"
 #include "common/UnitCell.h"
 #include "utility/HeterogeneousMap.h"
@@ -42,12 +47,20 @@ namespace common {
 class DistanceCalculator;
 class UnitCell;
 
+/**
+/* A structure is not thread safe, not even through its const methods: the
+/* symmetry caches and the distance calculator are filled in lazily.  Each
+/* thread should work on its own copy, copies share the atoms data until one
+/* of them changes it so they are cheap to make.
+/**/
 class Structure
 {
 public:
 
   typedef utility::NamedProperty<utility::HeterogeneousMap> VisibleProperty;
 
+  static const double DEFAULT_SYMMETRY_PRECISION;
+
 	explicit Structure(UnitCellPtr cell = UnitCellPtr());
   Structure(const Structure & toCopy);
   Structure & operator =(const Structure & rhs);
@@ -55,6 +68,12 @@ public:
 
   void updateWith(const Structure & structure);
 
+  /**
+  /* Return the structure to the state of a newly constructed one but hold on to
+  /* the memory used for the atoms so that it can be reused.
+  /**/
+  void clear();
+
 	const std::string & getName() const;
 	void setName(const std::string & name);
 
@@ -77,11 +96,20 @@ public:
   Atom & newAtom(const Atom & toCopy);
 	bool removeAtom(const Atom & atom);
   size_t clearAtoms();
-
+  /** Make space for this many atoms in total without further allocation. */
+  void reserveAtoms(const size_t numAtoms);
+
+  /**
+  /* The positions of all the atoms as the columns of a 3xN matrix.  This is
+  /* the storage used by the structure itself so no copy is made, the reference
+  /* is valid until the atoms are next changed.
+  /**/
+  const ::arma::mat & getAtomPositions() const;
   void getAtomPositions(::arma::mat & posMtx) const;
   void getAtomPositions(::arma::subview<double> & posMtx) const;
   void setAtomPositions(const ::arma::mat & posMtx);
 
+  const ::std::vector<AtomSpeciesId::Value> & getAtomSpecies() const;
   void getAtomSpecies(::std::vector<AtomSpeciesId::Value> & species) const;
   size_t getNumAtomsOfSpecies(const AtomSpeciesId::Value species) const;
 
@@ -105,9 +133,37 @@ public:
   ::boost::optional< ::std::string> getVisibleProperty(const VisibleProperty & property) const;
   void setVisibleProperty(VisibleProperty & property, const ::std::string & value);
 
-  bool makePrimitive();
-
-  UniquePtr<Structure>::Type getPrimitiveCopy() const;
+  /**
+  /* Get a structure with the same unit cell and atoms as this one but none of
+  /* the name or properties.  The atoms are shared with this structure until
+  /* either of them changes so this is cheap to take.
+  /**/
+  UniquePtr<Structure>::Type getGeometryCopy() const;
+
+  /**
+  /* Get the symmetry of this structure found to the given precision.  Like
+  /* the primitive structure this is kept until the atoms or unit cell are next
+  /* changed so everything that needs the symmetry shares one search.  Returns
+  /* a null pointer if the structure has no unit cell or atoms.
+  /**/
+  SymmetryDatasetConstPtr getSymmetryDataset(const double precision = DEFAULT_SYMMETRY_PRECISION) const;
+
+  bool makePrimitive(const double precision = DEFAULT_SYMMETRY_PRECISION);
+
+  /**
+  /* Get the primitive version of this structure (just the geometry).  This is
+  /* kept until the atoms or unit cell are next changed so repeated calls don't
+  /* search for it again.  If this structure is already primitive the atoms are
+  /* shared with it.
+  /**/
+  StructureConstPtr getPrimitive(const double precision = DEFAULT_SYMMETRY_PRECISION) const;
+
+  /**
+  /* As getPrimitive but a copy that can be changed freely.  If this structure
+  /* is primitive already the copy is a full one including the name and
+  /* properties, otherwise it has just the geometry.
+  /**/
+  UniquePtr<Structure>::Type getPrimitiveCopy(const double precision = DEFAULT_SYMMETRY_PRECISION) const;
 
   void scale(const double scaleFactor);
 
@@ -117,12 +173,70 @@ private:
 
   typedef ::boost::ptr_vector<Atom> AtomsContainer;
 
-	void atomMoved(const Atom & atom) const;
+  /**
+  /* The data of all the atoms.  Extra position columns are kept in the storage
+  /* beyond the number of atoms so that adding atoms doesn't reallocate every
+  /* time, positions uses the memory of the storage but only has a column for
+  /* each atom.  Anything that changes the number of atoms or reallocates the
+  /* storage has to call setNumAtoms or reserve to keep the two in step.
+  /**/
+  struct AtomsData
+  {
+    AtomsData();
+    AtomsData(const AtomsData & toCopy);
+
+    /** Resize positions to this many columns, growing the storage if needed. */
+    void setNumAtoms(const size_t numAtoms);
+    /** Make the storage big enough for this many atoms. */
+    void reserve(const size_t numAtoms);
+
+    ::arma::mat storage;
+    ::boost::scoped_ptr< ::arma::mat> positions;
+    ::std::vector<AtomSpeciesId::Value> species;
+    ::std::vector<double> radii;
+
+  private:
+    AtomsData & operator =(const AtomsData &);
+  };
+  typedef ::boost::shared_ptr<AtomsData> AtomsDataPtr;
+
+  /**
+  /* Get the atoms data to change it.  If the data is shared with another
+  /* structure this gets a copy first.
+  /**/
+  AtomsData & getWritableAtomsData();
+  void setAtomsData(const AtomsDataPtr & data);
+
+  Atom & addAtom(const AtomSpeciesId::Value species, const double radius);
+  Atom & addAtomView();
+  Atom * reuseAtom();
+
+  /** What has been found about the symmetry at a particular precision. */
+  struct SymmetryCache
+  {
+    SymmetryCache();
+
+    bool datasetSearched;
+    SymmetryDatasetConstPtr dataset;
+    StructureConstPtr primitive;
+  };
+  typedef ::std::map<double, SymmetryCache> SymmetryCaches;
+
+  /** Get the symmetry found at this precision since the last geometry change. */
+  SymmetryCache & getSymmetryCache(const double precision) const;
+  void copySymmetryCaches(const Structure & structure);
+
+  SymmetryDatasetConstPtr findSymmetryDataset(const double precision) const;
+  StructureConstPtr findPrimitive(const double precision) const;
+
+  inline void geometryChanged() const
+  { ++myGeometryVersion; }
 
   inline void unitCellChanged() const
-  { myDistanceCalculator.unitCellChanged(); }
-
-  void updatePosBuffer() const;
+  {
+    geometryChanged();
+    myDistanceCalculator.unitCellChanged();
+  }
 
 	/** The name of this structure, set by calling code */
 	std::string		  myName;
@@ -135,15 +249,23 @@ private:
 	/** The atoms contained in this group */
 	AtomsContainer  myAtoms;
 
+  /** Atoms that have been removed, kept to be reused by newAtom. */
+  AtomsContainer  mySpareAtoms;
+
   utility::HeterogeneousMap  myTypedProperties;
 
-	/**
-	/* Flag to indicate whether the structure has changed since
-	/* the last time that all atom positions were requested
-	/**/
-	mutable bool			    myAtomPositionsCurrent;
+  /** Shared (copy-on-write) with any copies or snapshots of this structure. */
+  AtomsDataPtr    myAtomsData;
+
+  /** Incremented every time the atoms or unit cell are changed. */
+  mutable size_t  myGeometryVersion;
 
-  mutable ::arma::mat		myAtomPositionsBuffer;
+  /**
+  /* The symmetry found at each precision, only valid if the version matches
+  /* the geometry version.
+  /**/
+  mutable SymmetryCaches mySymmetryCaches;
+  mutable size_t  mySymmetryVersion;
 
   mutable DistanceCalculatorDelegator  myDistanceCalculator;
 
@@ -43,6 +43,8 @@ extern utility::Key< ::arma::mat33>          STRESS_TENSOR;
 
 namespace searching {
 extern utility::NamedKey<unsigned int>       TIMES_FOUND;
+// Energy per atom above the convex hull of the structures found
+extern utility::NamedKey<double>             HULL_DISTANCE;
 }
 
 namespace io {
@@ -0,0 +1,51 @@
+/*
+ * SymmetryDataset.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SYMMETRY_DATASET_H
+#define SYMMETRY_DATASET_H
+
+// INCLUDES ////////////
+#include "SSLib.h"
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <armadillo>
+
+// DEFINITION ///////////////////////
+
+namespace sstbx {
+namespace common {
+
+/**
+/* The symmetry of a structure as found by spglib.  The operations act on
+/* fractional coordinates of the structure's unit cell.
+/**/
+struct SymmetryDataset
+{
+  struct Operation
+  {
+    ::arma::mat33 rotation;
+    ::arma::vec3 translation;
+  };
+
+  unsigned int spacegroupNumber;
+  ::std::string iucSymbol;
+  ::std::string hallSymbol;
+  ::std::vector<Operation> operations;
+  /** For each atom the index of the atom that represents its symmetry equivalent set. */
+  ::std::vector<size_t> equivalentAtoms;
+};
+
+typedef ::boost::shared_ptr<const SymmetryDataset> SymmetryDatasetConstPtr;
+
+}
+}
+
+#endif /* SYMMETRY_DATASET_H */
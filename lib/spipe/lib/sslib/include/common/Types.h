@@ -29,6 +29,7 @@ class Structure;
 class UnitCell;
 
 typedef UniquePtr<Structure>::Type StructurePtr;
+typedef ::boost::shared_ptr<const Structure> StructureConstPtr;
 
 typedef UniquePtr<UnitCell>::Type UnitCellPtr;
 
@@ -37,6 +38,7 @@ typedef UniquePtr<DistanceCalculator>::Type DistanceCalculatorPtr;
 namespace types {
 
 typedef UniquePtr<Structure>::Type StructurePtr;
+typedef ::boost::shared_ptr<const Structure> StructureConstPtr;
 
 typedef UniquePtr<UnitCell>::Type UnitCellPtr;
 
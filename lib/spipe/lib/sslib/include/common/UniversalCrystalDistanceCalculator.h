@@ -10,10 +10,17 @@
 
 // INCLUDES ///////////////////////////////////
 #include "common/DistanceCalculator.h"
+#include "common/LatticeStencils.h"
+#include "common/UnitCell.h"
 
 namespace sstbx {
 namespace common {
 
+/**
+/* Image searches are done in a Niggli reduced basis of the structure's unit
+/* cell.  This spans the same lattice, so the vectors found are the same, but
+/* however skewed the cell is only a handful of images need to be checked.
+/**/
 class UniversalCrystalDistanceCalculator : public DistanceCalculator
 {
 public:
@@ -41,15 +48,24 @@ public:
     const size_t maxVectors = DistanceCalculator::DEFAULT_MAX_OUTPUTS,
     const unsigned int maxCellMultiples = DEFAULT_MAX_CELL_MULTIPLES) const;
 
+  virtual void getPairImages(PairImages & imagesOut, const double cutoff) const;
+
   virtual bool isValid() const;
 
+  virtual void unitCellChanged();
+
 private:
 
+  void updateReducedCell();
+
 	double getNumPlaneRepetitionsToBoundSphere(
     const ::arma::vec3 & planeVec1,
     const ::arma::vec3 & planeVec2,
 		const double radius) const;
 
+  /** The structure's unit cell in its reduced basis. */
+  UnitCell myReducedCell;
+  LatticeStencils myStencils;
 };
 
 }
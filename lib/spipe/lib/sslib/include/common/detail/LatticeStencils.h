@@ -0,0 +1,49 @@
+/*
+ * LatticeStencils.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef LATTICE_STENCILS_DETAIL_H
+#define LATTICE_STENCILS_DETAIL_H
+
+// INCLUDES ///////////////////////////////////
+#include <cmath>
+
+namespace sstbx {
+namespace common {
+
+template <class Visitor>
+bool LatticeStencils::forEachImage(
+  const Stencil & stencil,
+  const ::arma::vec3 & dR,
+  const double cutoff,
+  Visitor & visitor,
+  const size_t maxImages)
+{
+  const double cutoffSq = cutoff * cutoff;
+  // The translations are sorted so none past this one can bring dR within the cutoff
+  const double maxLength = cutoff + ::std::sqrt(::arma::dot(dR, dR));
+
+  size_t numFound = 0;
+  ::arma::vec3 dRImg;
+  double drSq;
+  for(size_t i = 0; i < stencil.translations.size() && stencil.lengths[i] <= maxLength; ++i)
+  {
+    dRImg = dR + stencil.translations[i];
+    drSq = ::arma::dot(dRImg, dRImg);
+    if(drSq < cutoffSq)
+    {
+      visitor(dRImg, drSq);
+      if(++numFound >= maxImages)
+        return false;
+    }
+  }
+  return true;
+}
+
+}
+}
+
+#endif /* LATTICE_STENCILS_DETAIL_H */
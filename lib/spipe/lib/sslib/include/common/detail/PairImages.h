@@ -0,0 +1,42 @@
+/*
+ * PairImages.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PAIR_IMAGES_DETAIL_H
+#define PAIR_IMAGES_DETAIL_H
+
+namespace sstbx {
+namespace common {
+
+template <class Visitor>
+bool PairImages::forEachImage(
+  const ::arma::vec3 & a,
+  const ::arma::vec3 & b,
+  Visitor & visitor,
+  const size_t maxImages) const
+{
+  ::arma::vec3 dR = b - a;
+
+  if(!myStencil.get())
+  {
+    const double drSq = ::arma::dot(dR, dR);
+    if(drSq < myCutoffSq)
+      visitor(dR, drSq);
+    return true;
+  }
+
+  // Wrap the displacement into the cell
+  dR = myFracMtx * dR;
+  dR -= ::arma::floor(dR);
+  dR = myOrthoMtx * dR;
+
+  return LatticeStencils::forEachImage(*myStencil, dR, myCutoff, visitor, maxImages);
+}
+
+}
+}
+
+#endif /* PAIR_IMAGES_DETAIL_H */
@@ -58,6 +58,7 @@ extern utility::Key<int> CASTEP_NUM_SELF_CONSISTENT;
 extern utility::Key<int> CASTEP_NUM_ROUGH_STEPS;
 extern utility::Key<double> PRESSURE;
 extern utility::Key<int> MAX_STEPS;
+extern utility::Key<bool> MIXED_PRECISION;
 
 // POTENTIALS //////////////////////////////////////////////
 extern utility::Key<utility::HeterogeneousMap> POTENTIAL;
@@ -100,6 +101,7 @@ extern utility::Key<double> DEPTH;
 extern utility::Key<utility::HeterogeneousMap> SYMMETRY;
 extern utility::Key<MinMax> SYM_OPS;
 extern utility::Key< ::std::string> POINT_GROUP;
+extern utility::Key< ::std::string> SPACE_GROUP;
 
 // STRUCTURE COMPARATORS //////////////////////////
 extern utility::Key<utility::HeterogeneousMap> COMPARATOR;
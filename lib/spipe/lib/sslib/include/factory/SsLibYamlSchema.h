@@ -41,6 +41,8 @@ struct Tpsd : public yaml_schema::SchemaHeteroMap
       ->defaultValue(potential::TpsdGeomOptimiser::DEFAULT_TOLERANCE);
     addScalarEntry("maxSteps", MAX_STEPS)->element()
       ->defaultValue(potential::TpsdGeomOptimiser::DEFAULT_MAX_STEPS);
+    addScalarEntry("mixedPrecision", MIXED_PRECISION)->element()
+      ->defaultValue(false);
   }
 };
 
@@ -261,6 +263,7 @@ struct Symmetry : public yaml_schema::SchemaHeteroMap
   {
     addScalarEntry("ops", SYM_OPS);
     addScalarEntry("pointGroup", POINT_GROUP);
+    addScalarEntry("spaceGroup", SPACE_GROUP);
   }
 };
 
@@ -32,6 +32,8 @@ namespace io {
 class IStructureWriter
 {
 public:
+  typedef ::std::vector< ::sstbx::common::Structure *> Structures;
+  typedef ::std::vector<ResourceLocator> Locators;
 
 	virtual ~IStructureWriter() {}
 
@@ -46,6 +48,20 @@ public:
 		const ResourceLocator & locator,
 		const ::sstbx::common::AtomSpeciesDatabase & speciesDb) const = 0;
 
+  /**
+  /* Write each structure out to the corresponding locator.  By default they are
+  /* written one at a time, writers that can do better (e.g. by only opening a file
+  /* once for all the structures going to it) should override this.
+  /**/
+  virtual void writeStructures(
+    const Structures & structures,
+    const Locators & locators,
+		const ::sstbx::common::AtomSpeciesDatabase & speciesDb) const
+  {
+    for(size_t i = 0; i < structures.size(); ++i)
+      writeStructure(*structures[i], locators[i], speciesDb);
+  }
+
 	virtual ::std::vector<std::string> getSupportedFileExtensions() const = 0;
 
   /**
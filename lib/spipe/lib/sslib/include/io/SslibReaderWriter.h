@@ -42,6 +42,15 @@ public:
 		const ResourceLocator & locator,
 		const common::AtomSpeciesDatabase & speciesDb) const;
 
+  /**
+  /* Structures going to the same file (one after the other) are written with the
+  /* file only being read and written once.
+  /**/
+  virtual void writeStructures(
+    const Structures & structures,
+    const Locators & locators,
+		const common::AtomSpeciesDatabase & speciesDb) const;
+
   // From IStructureReader //
 
   virtual ::sstbx::common::types::StructurePtr readStructure(
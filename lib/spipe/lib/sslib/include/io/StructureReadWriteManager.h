@@ -94,6 +94,22 @@ public:
     const common::AtomSpeciesDatabase & atomSpeciesDb,
     const ::std::string & fileType) const;
 
+  /**
+  /* Write a batch of structures, structures[i] going to locators[i].  Consecutive
+  /* structures of the same type are handed to the writer together.  Returns
+  /* false if any of them couldn't be written.
+  /**/
+  bool writeStructures(
+    const IStructureWriter::Structures & structures,
+    IStructureWriter::Locators locators,
+    const common::AtomSpeciesDatabase & atomSpeciesDb) const;
+
+  bool writeStructures(
+    const IStructureWriter::Structures & structures,
+    const IStructureWriter::Locators & locators,
+    const common::AtomSpeciesDatabase & atomSpeciesDb,
+    const ::std::string & fileType) const;
+
   common::types::StructurePtr readStructure(
     const ResourceLocator & locator,
     const common::AtomSpeciesDatabase & speciesDb) const;
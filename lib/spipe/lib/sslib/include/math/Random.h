@@ -10,6 +10,8 @@
 #define RANDOM_H
 
 // INCLUDES ///////////////////////////////////////
+#include <iosfwd>
+
 #include <armadillo>
 
 // FORWARD DECLARES ////////////////////////////////
@@ -21,9 +23,28 @@
 namespace sstbx {
 namespace math {
 
+/**
+/* Seed the generator used by the calling thread.  All threads share the
+/* process wide generator, which is not thread safe, unless they have been
+/* given their own using seedThread.
+/**/
 void seed();
 void seed(const unsigned int randSeed);
 
+/**
+/* Give the calling thread its own generator, seeded with randSeed, so that it
+/* can draw random numbers concurrently with other threads.  The generator
+/* lives until the thread exits.
+/**/
+void seedThread(const unsigned int randSeed);
+
+/**
+/* Save/load the state of the calling thread's generator, e.g. so that a calculation can be
+/* picked up from where it left off.
+/**/
+void saveState(::std::ostream & os);
+bool loadState(::std::istream & is);
+
 template <typename T>
 T randu();
 
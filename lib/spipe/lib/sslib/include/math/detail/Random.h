@@ -46,7 +46,20 @@ private:
   Rand(); // non constructible
 };
 
-extern boost::mt19937 mt19937;
+/** The generator and any distributions that carry state from one draw to the next. */
+struct RandomState
+{
+  RandomState();
+
+  ::boost::mt19937 engine;
+  ::boost::normal_distribution<> normal;
+};
+
+/**
+/* The state used by the calling thread.  This is the process wide state unless
+/* the thread has been given its own using seedThread().
+/**/
+RandomState & state();
 
 // Specialisations
 // TODO: Make these use boost random as this method doesn't generate
@@ -58,22 +71,22 @@ struct Rand<int>
   {
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
     const ::boost::uniform_int<> dist(0, to - 1);
-    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<> > gen(mt19937, dist);
+    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<> > gen(state().engine, dist);
     return gen();
 #else
     const ::boost::random::uniform_int_distribution<> dist(0, to - 1);
-    return dist(mt19937);
+    return dist(state().engine);
 #endif
   }
   static int getUniform(const int from, const int to)
   {
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
     const ::boost::uniform_int<> dist(from, to - 1);
-    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<> > gen(mt19937, dist);
+    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<> > gen(state().engine, dist);
     return gen();
 #else
     const ::boost::random::uniform_int_distribution<> dist(from, to - 1);
-    return dist(mt19937);
+    return dist(state().engine);
 #endif
   }
 };
@@ -87,11 +100,11 @@ struct Rand<unsigned int>
 
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
     const ::boost::uniform_int<unsigned int> dist(0, to - 1);
-    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<unsigned int> > gen(mt19937, dist);
+    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<unsigned int> > gen(state().engine, dist);
     return gen();
 #else
     const ::boost::random::uniform_int_distribution<unsigned int> dist(0, to - 1);
-    return dist(mt19937);
+    return dist(state().engine);
 #endif
   }
   static unsigned int getUniform(const unsigned int from, const unsigned int to)
@@ -100,11 +113,11 @@ struct Rand<unsigned int>
 
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
     const ::boost::uniform_int<unsigned int> dist(from, to - 1);
-    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<unsigned int> > gen(mt19937, dist);
+    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<unsigned int> > gen(state().engine, dist);
     return gen();
 #else
     const ::boost::random::uniform_int_distribution<unsigned int> dist(from, to - 1);
-    return dist(mt19937);
+    return dist(state().engine);
 #endif
   }
 };
@@ -118,11 +131,11 @@ struct Rand<long unsigned int>
 
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
     const ::boost::uniform_int<long unsigned int> dist(0, to - 1);
-    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<long unsigned int> > gen(mt19937, dist);
+    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<long unsigned int> > gen(state().engine, dist);
     return gen();
 #else
     const ::boost::random::uniform_int_distribution<long unsigned int> dist(0, to - 1);
-    return dist(mt19937);
+    return dist(state().engine);
 #endif
   }
   static long unsigned int getUniform(const long unsigned int from, const long unsigned int to)
@@ -131,11 +144,11 @@ struct Rand<long unsigned int>
 
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
     const ::boost::uniform_int<long unsigned int> dist(from, to - 1);
-    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<long unsigned int> > gen(mt19937, dist);
+    ::boost::variate_generator<boost::mt19937&, boost::uniform_int<long unsigned int> > gen(state().engine, dist);
     return gen();
 #else
     const ::boost::random::uniform_int_distribution<long unsigned int> dist(from, to - 1);
-    return dist(mt19937);
+    return dist(state().engine);
 #endif
   }
 };
@@ -143,11 +156,8 @@ struct Rand<long unsigned int>
 template <>
 struct Rand<double>
 {
-  static ::boost::normal_distribution<> normal;
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
   static const ::boost::uniform_real<> uniform;
-  static ::boost::variate_generator< ::boost::mt19937 &, ::boost::uniform_real<> > uniformGenerator;
-  static ::boost::variate_generator< ::boost::mt19937 &, ::boost::normal_distribution<> > normalGenerator;
 #else
   static const ::boost::random::uniform_real_distribution<> uniform;
 #endif
@@ -155,18 +165,16 @@ struct Rand<double>
   static double getUniform()
   {
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
-    return uniformGenerator();
+    ::boost::variate_generator< ::boost::mt19937 &, ::boost::uniform_real<> >
+      gen(state().engine, uniform);
+    return gen();
 #else
-    return uniform(mt19937);
+    return uniform(state().engine);
 #endif
   }
   static double getUniform(const double to)
   {
-#ifdef SSLIB_USE_BOOST_OLD_RANDOM
-    return uniformGenerator() * to;
-#else
-    return uniform(mt19937) * to;
-#endif
+    return getUniform() * to;
   }
   static double getUniform(const double from, const double to)
   {
@@ -174,21 +182,27 @@ struct Rand<double>
   }
   static double getNormal()
   {
+    RandomState & rs = state();
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
-    return normalGenerator();
+    ::boost::variate_generator< ::boost::mt19937 &, ::boost::normal_distribution<> >
+      gen(rs.engine, rs.normal);
+    const double value = gen();
+    // The generator works on a copy so keep any cached value
+    rs.normal = gen.distribution();
+    return value;
 #else
-    return normal(mt19937);
+    return rs.normal(rs.engine);
 #endif
   }
   static double getNormal(const double mean, const double variance)
   {
     ::boost::normal_distribution<> normal(mean, variance);
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
-    ::boost::variate_generator<boost::mt19937&, ::boost::normal_distribution<> >
-      normalGen(mt19937, normal);
-    normalGen();
+    ::boost::variate_generator< ::boost::mt19937 &, ::boost::normal_distribution<> >
+      normalGen(state().engine, normal);
+    return normalGen();
 #else
-    return normal(mt19937);
+    return normal(state().engine);
 #endif
   }
 };
@@ -198,13 +212,13 @@ struct Rand<double>
 inline void seed(const unsigned int randSeed)
 {
   ::std::srand(randSeed);
-  detail::mt19937.seed(randSeed);
+  detail::state().engine.seed(randSeed);
 }
 
 inline void seed()
 {
   ::std::srand(static_cast<unsigned int>(time(NULL)));
-  detail::mt19937.seed(static_cast<unsigned int>(time(NULL)));
+  detail::state().engine.seed(static_cast<unsigned int>(time(NULL)));
 }
 
 template <typename T>
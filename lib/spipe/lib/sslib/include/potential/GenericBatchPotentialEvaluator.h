@@ -0,0 +1,78 @@
+/*
+ * GenericBatchPotentialEvaluator.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef GENERIC_BATCH_POTENTIAL_EVALUATOR_H
+#define GENERIC_BATCH_POTENTIAL_EVALUATOR_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <memory>
+
+#include "potential/IPotential.h"
+#include "potential/IBatchPotentialEvaluator.h"
+
+namespace sstbx {
+namespace potential {
+
+template <class Potential>
+class GenericBatchPotentialEvaluator : public IBatchPotentialEvaluator
+{
+public:
+
+  typedef typename Potential::BatchDataType DataTyp;
+
+  GenericBatchPotentialEvaluator(
+    const Potential & potential,
+    ::std::auto_ptr<DataTyp> & data);
+
+  // From IBatchPotentialEvaluator
+  virtual PotentialBatchData & getData();
+
+	virtual bool evalPotential();
+
+  virtual const IPotential & getPotential() const;
+  // End from IBatchPotentialEvaluator
+
+private:
+
+  const Potential &             myPotential;
+  ::std::auto_ptr<DataTyp>      myData;
+
+};
+
+// IMPLEMENTATION //////////////////
+
+template <class Potential>
+GenericBatchPotentialEvaluator<Potential>::GenericBatchPotentialEvaluator(
+  const Potential & potential,
+  ::std::auto_ptr<DataTyp> & data):
+myPotential(potential),
+myData(data)
+{}
+
+template <class Potential>
+PotentialBatchData & GenericBatchPotentialEvaluator<Potential>::getData()
+{
+  return *myData;
+}
+
+template <class Potential>
+bool GenericBatchPotentialEvaluator<Potential>::evalPotential()
+{
+  return myPotential.evaluate(*myData);
+}
+
+template <class Potential>
+const IPotential & GenericBatchPotentialEvaluator<Potential>::getPotential() const
+{
+  return myPotential;
+}
+
+}
+}
+
+#endif /* GENERIC_BATCH_POTENTIAL_EVALUATOR_H */
@@ -0,0 +1,42 @@
+/*
+ * IBatchPotentialEvaluator.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef I_BATCH_POTENTIAL_EVALUATOR_H
+#define I_BATCH_POTENTIAL_EVALUATOR_H
+
+// INCLUDES /////////////////////////////////////////////
+#include "potential/PotentialBatchData.h"
+
+namespace sstbx {
+namespace potential {
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+class IPotential;
+
+/**
+/* Evaluates the potential for a batch of structures in one go.  Only the
+/* structures marked as active in the batch data are evaluated.
+/**/
+class IBatchPotentialEvaluator {
+public:
+  virtual ~IBatchPotentialEvaluator() {}
+
+  virtual PotentialBatchData & getData() = 0;
+
+  /**
+  /* Returns false if there was a problem evaluating any of the active structures,
+  /* which ones can be found from PotentialBatchData::evaluationOk.
+  /**/
+	virtual bool evalPotential() = 0;
+
+  virtual const IPotential & getPotential() const = 0;
+};
+
+}}
+
+#endif /* I_BATCH_POTENTIAL_EVALUATOR_H */
@@ -10,6 +10,7 @@
 #define I_GEOM_OPTIMISER_H
 
 // INCLUDES /////////////////////////////////////////////
+#include <vector>
 
 #include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
@@ -76,6 +77,7 @@ private:
 class IGeomOptimiser
 {
 public:
+  typedef ::std::vector<common::Structure *> Structures;
 
 	virtual ~IGeomOptimiser() {}
 
@@ -96,6 +98,21 @@ public:
     OptimisationData & data,
     const OptimisationSettings & options
   ) const = 0;
+
+  /**
+  /* Optimise a number of structures, by default one at a time.  Optimisers
+  /* that can do better by working on them together should override this.
+  /**/
+  virtual void optimise(
+    const Structures & structures,
+    ::std::vector<OptimisationOutcome> & outcomes,
+    const OptimisationSettings & options
+  ) const
+  {
+    outcomes.resize(structures.size());
+    for(size_t i = 0; i < structures.size(); ++i)
+      outcomes[i] = optimise(*structures[i], options);
+  }
 };
 
 inline void OptimisationData::saveToStructure(common::Structure & structure) const
@@ -11,6 +11,7 @@
 
 // INCLUDES /////////////////////////////////////////////
 #include "PotentialData.h"
+#include "PotentialBatchData.h"
 
 #include <boost/optional.hpp>
 #include <boost/smart_ptr.hpp>
@@ -28,6 +29,7 @@ namespace potential {
 class IParameterisable;
 class IPotentialInfo;
 class IPotentialEvaluator;
+class IBatchPotentialEvaluator;
 
 class IPotential
 {
@@ -49,6 +51,14 @@ public:
 
   virtual ::boost::shared_ptr<IPotentialEvaluator> createEvaluator(const sstbx::common::Structure & structure) const = 0;
 
+  /**
+  /* Create an evaluator that does all the structures together.  Potentials that
+  /* can't evaluate batches return an empty pointer in which case the structures
+  /* should be done one at a time using createEvaluator.
+  /**/
+  virtual ::boost::shared_ptr<IBatchPotentialEvaluator>
+  createBatchEvaluator(const PotentialBatchData::Structures & structures) const = 0;
+
   virtual IParameterisable * getParameterisable() = 0;
 };
 
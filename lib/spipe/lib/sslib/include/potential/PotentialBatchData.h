@@ -0,0 +1,64 @@
+/*
+ * PotentialBatchData.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef POTENTIAL_BATCH_DATA_H
+#define POTENTIAL_BATCH_DATA_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <vector>
+
+#include <armadillo>
+
+#include "common/Structure.h"
+#include "potential/PotentialData.h"
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+namespace sstbx {
+namespace potential {
+
+/**
+/* The data for a batch of structures that are evaluated together.  Rather than
+/* having one PotentialData per structure everything is packed into one array per
+/* quantity: the particles of structure i occupy columns offsets[i] to
+/* offsets[i + 1] - 1 of pos and forces while the per structure values are
+/* indexed by i directly.
+/**/
+struct PotentialBatchData
+{
+  typedef ::std::vector<const common::Structure *> Structures;
+
+	explicit PotentialBatchData(const Structures & structures);
+  virtual ~PotentialBatchData() {}
+
+  ::std::size_t getNumStructures() const;
+  ::std::size_t getNumParticles(const ::std::size_t str) const;
+  ::std::size_t getFirstParticle(const ::std::size_t str) const;
+
+  Structures                                structures;
+  ::std::vector< ::std::size_t>             offsets;
+
+  // Per structure
+  /** Only active structures are evaluated, the others keep their last values. */
+  ::std::vector<bool>                       active;
+  /** Set by the evaluation, false if there was a problem evaluating that structure. */
+  ::std::vector<bool>                       evaluationOk;
+  ::std::vector<PotentialData::Precision::Value> precision;
+  ::std::vector<double>                     internalEnergy;
+  ::std::vector< ::arma::mat33>             stressMtx;
+
+  // Per particle
+  ::std::size_t   numParticles;
+  ::arma::mat     pos;
+  ::arma::mat     forces;
+};
+
+}
+}
+
+#endif /* POTENTIAL_BATCH_DATA_H */
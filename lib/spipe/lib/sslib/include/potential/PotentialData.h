@@ -23,9 +23,24 @@ namespace potential {
 
 struct PotentialData
 {
+  /**
+  /* The arithmetic precision to evaluate with.  In MIXED precision potentials
+  /* that support it do their per-interaction terms in single precision while the
+  /* energy, forces and stress are still accumulated in double precision.
+  /**/
+  struct Precision
+  {
+    enum Value
+    {
+      DOUBLE,
+      MIXED
+    };
+  };
+
   PotentialData();
 	explicit PotentialData(const sstbx::common::Structure & structure);
 
+  Precision::Value precision;
   ::std::size_t		numParticles;
 	double					internalEnergy;
   ::arma::mat     pos;
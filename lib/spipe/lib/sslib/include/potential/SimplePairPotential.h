@@ -27,6 +27,7 @@
 #include "common/AtomSpeciesDatabase.h"
 #include "common/Structure.h"
 #include "potential/CombiningRules.h"
+#include "potential/GenericBatchPotentialEvaluator.h"
 #include "potential/GenericPotentialEvaluator.h"
 #include "potential/IParameterisable.h"
 #include "potential/IPotential.h"
@@ -52,6 +53,7 @@ public:
   /**/
   typedef SimplePairPotentialData::SpeciesList SpeciesList;
   typedef SimplePairPotentialData DataType;
+  typedef SimplePairPotentialBatchData BatchDataType;
 
   static const unsigned int MAX_INTERACTION_VECTORS = 5000;
   static const unsigned int MAX_CELL_MULTIPLES = 500;
@@ -83,17 +85,40 @@ public:
   // From IPotential /////////////
   virtual ::boost::optional<double> getPotentialRadius(const ::sstbx::common::AtomSpeciesId::Value id) const;
   virtual ::boost::shared_ptr< IPotentialEvaluator > createEvaluator(const sstbx::common::Structure & structure) const;
+  virtual ::boost::shared_ptr<IBatchPotentialEvaluator>
+  createBatchEvaluator(const PotentialBatchData::Structures & structures) const;
   virtual IParameterisable * getParameterisable();
   // End from IPotential /////////
 
   bool evaluate(const common::Structure & structure, SimplePairPotentialData & data) const;
 
+  /**
+  /* Evaluate all the active structures in the batch.  The interaction vectors of
+  /* every structure are gathered into the batch's image buffers, the pair terms
+  /* are then calculated in one pass over these and finally the results are
+  /* accumulated back into each structure's energy, forces and stress.
+  /**/
+  bool evaluate(SimplePairPotentialBatchData & data) const;
+
 private:
 
   static const double RADIUS_FACTOR;
   static const double MIN_SEPARATION_SQ;
 
   typedef GenericPotentialEvaluator<SimplePairPotential > Evaluator;
+  typedef GenericBatchPotentialEvaluator<SimplePairPotential> BatchEvaluator;
+
+  template <typename FloatType>
+  bool doEvaluate(const common::Structure & structure, SimplePairPotentialData & data) const;
+
+  template <typename FloatType>
+  void evaluateImages(
+    SimplePairPotentialBatchData::Images & images,
+    const size_t first,
+    const size_t last) const;
+
+  void gatherImages(SimplePairPotentialBatchData & data, const size_t str) const;
+  void accumulateImages(SimplePairPotentialBatchData & data, const size_t str) const;
 
 	void initCutoff(const double cutoff);
 
@@ -107,8 +132,6 @@ private:
 
 	const ::std::string		myName;
 
-	mutable ::std::string	myParamString;
-
 	/** Potential parameters */
 	size_t					myNumSpecies;
   const SpeciesList mySpeciesList;
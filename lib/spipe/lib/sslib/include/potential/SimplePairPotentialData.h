@@ -13,6 +13,7 @@
 
 #include "common/AtomSpeciesId.h"
 #include "common/Structure.h"
+#include "potential/PotentialBatchData.h"
 #include "potential/PotentialData.h"
 
 // FORWARD DECLARATIONS ////////////////////////////////////
@@ -47,6 +48,43 @@ struct SimplePairPotentialData : public PotentialData
 	std::vector<int> species;
 };
 
+struct SimplePairPotentialBatchData : public PotentialBatchData
+{
+  typedef SimplePairPotentialData::SpeciesList SpeciesList;
+
+  static const int IGNORE_ATOM = SimplePairPotentialData::IGNORE_ATOM;
+
+  SimplePairPotentialBatchData(
+    const Structures &  structures,
+    const SpeciesList & speciesList);
+
+  /** The species index of each particle in the batch. */
+	std::vector<int> species;
+
+  /**
+  /* The interaction vectors between all the particle pairs in the batch.  These
+  /* are all gathered first so that the pair terms can then be calculated in one
+  /* tight loop over contiguous arrays.  The images of structure i are
+  /* offsets[i] to offsets[i + 1] - 1.  Kept here so the buffers are reused
+  /* between evaluations.
+  /**/
+  struct Images
+  {
+    void clear();
+
+    ::std::vector< ::std::size_t> offsets;
+    ::std::vector<double> x, y, z;
+    /** Index of the species pair in the (column major) parameter matrices. */
+    ::std::vector<unsigned int> speciesPair;
+    /** Indices of the particles in the batch. */
+    ::std::vector<unsigned int> i, j;
+    /** Pair results, not including the self-interaction factor. */
+    ::std::vector<double> energy, forceOverR;
+  };
+
+  Images images;
+};
+
 
 }
 }
@@ -14,9 +14,11 @@
 
 // INCLUDES /////////////////////////////////////////////
 #include <limits>
+#include <vector>
 
 #include <armadillo>
 
+#include "potential/IBatchPotentialEvaluator.h"
 #include "potential/IGeomOptimiser.h"
 #include "potential/IPotential.h"
 #include "potential/IPotentialEvaluator.h"
@@ -51,6 +53,15 @@ public:
   unsigned int getMaxSteps() const;
   void setMaxSteps(const unsigned int maxSteps);
 
+  /**
+  /* In mixed precision mode the potential is asked to evaluate in mixed precision
+  /* (see PotentialData::Precision) until the change in energy between steps gets
+  /* close to single precision noise, then the optimisation is finished in full
+  /* double precision so the final energy is unaffected.
+  /**/
+  bool getMixedPrecision() const;
+  void setMixedPrecision(const bool mixedPrecision);
+
 	// IGeomOptimiser interface //////////////////////////////
   virtual IPotential * getPotential();
   virtual const IPotential * getPotential() const;
@@ -64,6 +75,17 @@ public:
     OptimisationData & data,
     const OptimisationSettings & options
   ) const;
+  /**
+  /* Optimise a batch of structures together.  The structures are advanced in
+  /* lockstep with the potential being evaluated for all of them at once, each
+  /* structure is retired from the batch as soon as it has converged (or failed).
+  /* If the potential can't do batches the structures are done one at a time.
+  /**/
+  virtual void optimise(
+    const Structures & structures,
+    ::std::vector<OptimisationOutcome> & outcomes,
+    const OptimisationSettings & options
+  ) const;
 
 	// End IGeomOptimiser interface
 
@@ -90,18 +112,67 @@ private:
   static const double CELL_MIN_NORM_VOLUME;
   static const double CELL_MAX_ANGLE_SUM;
   static const double MAX_STEPSIZE;
+  static const double MIXED_PRECISION_SWITCH;
+
+  /**
+  /* Matrices needed at each step of the optimisation.  These are allocated once
+  /* per structure so that the step loop itself doesn't have to allocate.
+  /**/
+  struct Workspace
+  {
+    explicit Workspace(const size_t numParticles);
+
+    ::arma::mat deltaPos;
+    ::arma::mat f0;
+    ::arma::mat fracs;
+  };
+
+  /** The state of one of the structures of a batch optimisation. */
+  struct BatchEntry;
+
+  OptimisationSettings getLocalSettings(const OptimisationSettings & options) const;
 
   bool cellReasonable(const common::UnitCell & unitCell) const;
+  bool hasConverged(
+    PotentialData::Precision::Value & precision,
+    const double h,
+    const double dH,
+    const double eTol
+  ) const;
+  bool batchStep(
+    BatchEntry & entry,
+    PotentialBatchData & data,
+    const size_t str,
+    const unsigned int iteration,
+    const OptimisationSettings & settings,
+    OptimisationOutcome & outcome
+  ) const;
+  void finishBatchEntry(
+    BatchEntry & entry,
+    const PotentialBatchData & data,
+    const size_t str,
+    const bool converged,
+    const OptimisationSettings & settings,
+    OptimisationOutcome & outcome
+  ) const;
   void populateOptimistaionData(
     OptimisationData & optData,
     const common::Structure & structure,
     const PotentialData & potData
   ) const;
+  void populateOptimistaionData(
+    OptimisationData & optData,
+    const common::Structure & structure,
+    const double internalEnergy,
+    const ::arma::mat & forces,
+    const ::arma::mat33 & stressMtx
+  ) const;
 
 	PotentialPtr myPotential;
 
 	double myTolerance;
   unsigned int myMaxSteps;
+  bool myMixedPrecision;
 };
 
 }
@@ -11,6 +11,7 @@
 
 // INCLUDES /////////////////////////////////////////////
 #include <map>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/iterator/transform_iterator.hpp>
@@ -85,6 +86,8 @@ protected:
   typedef std::pair<typename StructureMap::iterator, bool> MapInsertReturn;
 
   MapInsertReturn insertStructure(const Key & key, common::Structure & correspondingStructure);
+  MapInsertReturn insertStructure(const Key & key, ComparisonDataHandle & handle);
+  ComparisonDataHandle generateComparisonData(const common::Structure & structure);
 
 private:
 
@@ -122,6 +125,15 @@ public:
 
   // Modifiers ///////////////////////////
   insert_return_type insert(const Key & key, common::Structure & correspondingStructure);
+  /**
+  /* Insert a number of structures.  The comparison data for all of them is
+  /* generated before any comparisons are made, the results are in the same
+  /* order as the keys.
+  /**/
+  void insert(
+    const ::std::vector<Key> & keys,
+    const ::std::vector<common::Structure *> & correspondingStructures,
+    ::std::vector<insert_return_type> & results);
 private:
   typedef typename Base::MapInsertReturn MapInsertReturn;
 };
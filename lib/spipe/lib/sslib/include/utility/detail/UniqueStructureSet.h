@@ -6,6 +6,7 @@
  */
 
 // INCLUDES /////////////////////////////////////
+#include "SSLibAssert.h"
 #include "utility/IStructureComparator.h"
 
 namespace sstbx {
@@ -129,13 +130,19 @@ UniqueStructureSetBase<Key>::find(const Key key) const
 template <typename Key>
 typename UniqueStructureSetBase<Key>::MapInsertReturn
 UniqueStructureSetBase<Key>::insertStructure(const Key & key, common::Structure & correspondingStructure)
+{
+  ComparisonDataHandle handle(generateComparisonData(correspondingStructure));
+  return insertStructure(key, handle);
+}
+
+template <typename Key>
+typename UniqueStructureSetBase<Key>::MapInsertReturn
+UniqueStructureSetBase<Key>::insertStructure(const Key & key, ComparisonDataHandle & handle)
 {
   MapInsertReturn returnPair;
   // .second is used to indiate that a new structure was inserted
   returnPair.second = true;
 
-  ComparisonDataHandle handle(myComparator->generateComparisonData(correspondingStructure));
-
   // Check if we have a structure like this already
   for(typename StructureMap::iterator it = myStructures.begin(), end = myStructures.end();
     it != end; ++it)
@@ -163,6 +170,13 @@ UniqueStructureSetBase<Key>::insertStructure(const Key & key, common::Structure
   return returnPair;
 }
 
+template <typename Key>
+typename UniqueStructureSetBase<Key>::ComparisonDataHandle
+UniqueStructureSetBase<Key>::generateComparisonData(const common::Structure & structure)
+{
+  return myComparator->generateComparisonData(structure);
+}
+
 } // namespace detail
 
 template <typename Key>
@@ -183,6 +197,30 @@ UniqueStructureSet<Key>::insert(const Key & key, common::Structure & correspondi
   return insert_return_type(iterator(pair.first), pair.second);
 }
 
+template <typename Key>
+void UniqueStructureSet<Key>::insert(
+  const ::std::vector<Key> & keys,
+  const ::std::vector<common::Structure *> & correspondingStructures,
+  ::std::vector<insert_return_type> & results)
+{
+  typedef typename Base::ComparisonDataHandle ComparisonDataHandle;
+
+  SSLIB_ASSERT(keys.size() == correspondingStructures.size());
+
+  ::std::vector<ComparisonDataHandle> handles;
+  handles.reserve(correspondingStructures.size());
+  for(size_t i = 0; i < correspondingStructures.size(); ++i)
+    handles.push_back(this->generateComparisonData(*correspondingStructures[i]));
+
+  results.clear();
+  results.reserve(keys.size());
+  for(size_t i = 0; i < keys.size(); ++i)
+  {
+    MapInsertReturn pair = this->insertStructure(keys[i], handles[i]);
+    results.push_back(insert_return_type(iterator(pair.first), pair.second));
+  }
+}
+
 
 }
 }
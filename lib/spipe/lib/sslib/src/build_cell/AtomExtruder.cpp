@@ -129,10 +129,11 @@ bool AtomExtruder::extrudeAtoms(
     // Now fix-up any overlaps
     for(row = 0; row < numAtoms - 1; ++row)
     {
-      const ::arma::vec & posI = atoms[row]->getPosition();
+      // Keep track of this atom's position as it may be moved below
+      ::arma::vec3 posI = atoms[row]->getPosition();
       for(col = row + 1; col < numAtoms; ++col)
       {
-        const ::arma::vec & posJ = atoms[col]->getPosition();
+        const ::arma::vec3 posJ = atoms[col]->getPosition();
         sepVec = distanceCalc.getVecMinImg(posI, posJ);
         sepSq = ::arma::dot(sepVec, sepVec);
         if(sepSq < sepSqMtx(row, col))
@@ -151,7 +152,10 @@ bool AtomExtruder::extrudeAtoms(
           dr = prefactor * sepDiff / sep * sepVec;
           
           if(!fixedList[row])
-            atoms[row]->setPosition(posI - dr);
+          {
+            posI -= dr;
+            atoms[row]->setPosition(posI);
+          }
           if(!fixedList[col])
             atoms[col]->setPosition(posJ + dr);
         }
@@ -174,13 +178,13 @@ double AtomExtruder::calcMaxOverlapFractionSq(
   double sepSq, maxOverlapFractionSq = 0.0;
   for(row = 0; row < numAtoms - 1; ++row)
   {
-    const ::arma::vec & posI = atoms[row]->getPosition();
+    const ::arma::vec3 posI = atoms[row]->getPosition();
     for(col = row + 1; col < numAtoms; ++col)
     {
       if(fixedList[row] && fixedList[col])
         continue; // Ignore case where both atoms are fixed
 
-      const ::arma::vec & posJ = atoms[col]->getPosition();
+      const ::arma::vec3 posJ = atoms[col]->getPosition();
 
       sepSq = distanceCalc.getDistSqMinImg(posI, posJ);
       // Are they closer than the sum of the two radii?
@@ -20,6 +20,7 @@
 #include "common/AtomSpeciesDatabase.h"
 #include "common/Constants.h"
 #include "common/Structure.h"
+#include "common/UnitCell.h"
 #include "math/Matrix.h"
 #include "math/Random.h"
 #include "utility/IndexingEnums.h"
@@ -251,11 +252,27 @@ AtomsGenerator::generatePosition(
     // Do we need to apply symmetry and does the atom need to be on a 'special' position
     if(usingSymmetry)
     {
+      // With a unit cell the symmetry is a space group
+      const common::UnitCell * const unitCell = build.getStructure().getUnitCell();
+      if(unitCell)
+        position.first = unitCell->randomPoint();
+
       if(multiplicity == build.getSymmetryGroup()->numOps())
       {
         // Apply all operators (true for entire op mask)
         atomInfo.setOperatorsMask(::std::vector<bool>(build.getSymmetryGroup()->numOps(), true));
       }
+      else if(unitCell) // Wyckoff position
+      {
+        const SymmetryGroup::WyckoffPositions * const positions =
+          build.getSymmetryGroup()->getWyckoffPositions(multiplicity);
+        SSLIB_ASSERT_MSG(positions, "Space group has no Wyckoff positions with that multiplicity");
+
+        SymmetryGroup::OpMask opMask;
+        position.first = generateWyckoffPosition(opMask, *positions, *unitCell);
+        atomInfo.setOperatorsMask(opMask);
+        position.second = true; // Fix the position so it doesn't get moved when extruding atoms
+      }
       else // Special position
       {
         const SymmetryGroup::EigenspacesAndMasks * const spaces =
@@ -313,6 +330,25 @@ bool AtomsGenerator::generateSpecialPosition(
   return false; // Couldn't find one
 }
 
+::arma::vec3 AtomsGenerator::generateWyckoffPosition(
+  SymmetryGroup::OpMask & opMaskOut,
+  const SymmetryGroup::WyckoffPositions & positions,
+  const common::UnitCell & unitCell
+) const
+{
+  const SymmetryGroup::WyckoffPosition & position =
+    positions[math::randu<size_t>(positions.size())];
+
+  ::arma::vec3 frac = position.origins[math::randu<size_t>(position.origins.size())];
+  // Move anywhere along the directions that keep the site symmetry
+  for(size_t i = 0; i < position.space.n_cols; ++i)
+    frac += math::randu<double>() * position.space.col(i);
+  unitCell.wrapVecFracInplace(frac);
+
+  opMaskOut = position.opMask;
+  return unitCell.fracToCartInplace(frac);
+}
+
 OptionalArmaVec3 AtomsGenerator::generateSpeciesPosition(
   const SymmetryGroup::Eigenspace & space,
   const IGeneratorShape & genShape,
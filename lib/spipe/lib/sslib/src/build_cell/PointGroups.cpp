@@ -8,8 +8,12 @@
 // INCLUEDES /////////////
 #include "build_cell/PointGroups.h"
 
+#include <map>
+
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include "SSLibAssert.h"
 #include "build_cell/SymmetryFunctions.h"
@@ -21,6 +25,18 @@
 namespace sstbx {
 namespace build_cell {
 
+namespace {
+typedef ::std::map<PointGroup, SymmetryGroupConstPtr> PointGroupCache;
+
+::boost::mutex pointGroupCacheMutex;
+
+PointGroupCache & getPointGroupCache()
+{
+  static PointGroupCache cache;
+  return cache;
+}
+}
+
 void generatePointGroup(
   SymmetryGroup & groupOut,
   const PointGroupFamily::Value family,
@@ -202,6 +218,25 @@ void generatePointGroup(
   groupOut.generateEigenvectors();
 }
 
+SymmetryGroupConstPtr getSharedPointGroup(
+  const PointGroupFamily::Value family,
+  const unsigned int n)
+{
+  const PointGroup key(family, n);
+
+  const ::boost::lock_guard< ::boost::mutex> lock(pointGroupCacheMutex);
+  PointGroupCache & cache = getPointGroupCache();
+  const PointGroupCache::const_iterator it = cache.find(key);
+  if(it != cache.end())
+    return it->second;
+
+  // First time anyone has asked for it
+  ::boost::shared_ptr<SymmetryGroup> group(new SymmetryGroup());
+  generatePointGroup(*group, family, n);
+  cache[key] = group;
+  return group;
+}
+
 bool getPointGroup(PointGroup & groupOut, const ::std::string & groupString)
 {
   static const boost::regex pgExpression("([CSDTOI])([[:digit:]]*)([hvids]*)");
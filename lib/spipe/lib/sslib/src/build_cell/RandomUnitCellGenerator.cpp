@@ -8,17 +8,141 @@
 // INCLUDES //////////////////////////////////////
 #include "build_cell/RandomUnitCellGenerator.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <boost/foreach.hpp>
+#include <boost/thread/locks.hpp>
+
 #include "SSLibAssert.h"
 #include "build_cell/GenerationOutcome.h"
 #include "build_cell/StructureContents.h"
 #include "common/UnitCell.h"
 #include "math/Random.h"
-#include "utility/StableComparison.h"
 
 namespace sstbx {
 namespace build_cell {
 
-namespace comp = utility::StableComp;
+namespace {
+
+const double TOLERANCE = 1e-10;
+
+/** The constraint coeffs . (x0, x1, x2) <= bound on three parameters. */
+struct LinearConstraint
+{
+  double coeffs[3];
+  double bound;
+};
+typedef ::std::vector<LinearConstraint> LinearConstraints;
+
+void addConstraint(
+  LinearConstraints & constraints,
+  const double c0,
+  const double c1,
+  const double c2,
+  const double bound)
+{
+  const LinearConstraint constraint = {{c0, c1, c2}, bound};
+  constraints.push_back(constraint);
+}
+
+void addRange(LinearConstraints & constraints, const size_t var, const double min, const double max)
+{
+  LinearConstraint constraint = {{0.0, 0.0, 0.0}, max};
+  constraint.coeffs[var] = 1.0;
+  constraints.push_back(constraint);
+  constraint.coeffs[var] = -1.0;
+  constraint.bound = -min;
+  constraints.push_back(constraint);
+}
+
+/** Fourier-Motzkin elimination of var, leaving the constraints on the others. */
+LinearConstraints eliminate(const LinearConstraints & constraints, const size_t var)
+{
+  LinearConstraints upper, lower, eliminated;
+  BOOST_FOREACH(const LinearConstraint & constraint, constraints)
+  {
+    if(constraint.coeffs[var] > TOLERANCE)
+      upper.push_back(constraint);
+    else if(constraint.coeffs[var] < -TOLERANCE)
+      lower.push_back(constraint);
+    else
+      eliminated.push_back(constraint);
+  }
+
+  LinearConstraint combined;
+  BOOST_FOREACH(const LinearConstraint & up, upper)
+  {
+    BOOST_FOREACH(const LinearConstraint & low, lower)
+    {
+      const double upFactor = -low.coeffs[var];
+      const double lowFactor = up.coeffs[var];
+      for(size_t i = 0; i < 3; ++i)
+        combined.coeffs[i] = upFactor * up.coeffs[i] + lowFactor * low.coeffs[i];
+      combined.coeffs[var] = 0.0;
+      combined.bound = upFactor * up.bound + lowFactor * low.bound;
+      eliminated.push_back(combined);
+    }
+  }
+  return eliminated;
+}
+
+/** Get the range of var from constraints that involve no other free variable. */
+bool getRange(double & min, double & max, const LinearConstraints & constraints, const size_t var)
+{
+  min = -::std::numeric_limits<double>::max();
+  max = ::std::numeric_limits<double>::max();
+  BOOST_FOREACH(const LinearConstraint & constraint, constraints)
+  {
+    if(constraint.coeffs[var] > TOLERANCE)
+      max = ::std::min(max, constraint.bound / constraint.coeffs[var]);
+    else if(constraint.coeffs[var] < -TOLERANCE)
+      min = ::std::max(min, constraint.bound / constraint.coeffs[var]);
+    else if(constraint.bound < -TOLERANCE)
+      return false;
+  }
+  return min <= max + TOLERANCE;
+}
+
+void fixValue(LinearConstraints & constraints, const size_t var, const double value)
+{
+  BOOST_FOREACH(LinearConstraint & constraint, constraints)
+  {
+    constraint.bound -= constraint.coeffs[var] * value;
+    constraint.coeffs[var] = 0.0;
+  }
+}
+
+/**
+/* Draw three values that satisfy all the constraints.  Each value is uniform
+/* within the range left open by those drawn before it (found by eliminating
+/* the ones still to come) so every draw is valid.  The order is shuffled so
+/* that no parameter is favoured.  Returns false if there are no valid values.
+/**/
+bool sampleConstrained(double (&values)[3], LinearConstraints constraints)
+{
+  size_t order[3] = {0, 1, 2};
+  for(size_t i = 2; i > 0; --i)
+    ::std::swap(order[i], order[math::randu<size_t>(i + 1)]);
+
+  double min, max;
+  for(size_t i = 0; i < 3; ++i)
+  {
+    LinearConstraints remaining(constraints);
+    for(size_t j = i + 1; j < 3; ++j)
+      remaining = eliminate(remaining, order[j]);
+
+    if(!getRange(min, max, remaining, order[i]))
+      return false;
+
+    values[order[i]] = max > min ? math::randu(min, max) : min;
+    fixValue(constraints, order[i], values[order[i]]);
+  }
+  return true;
+}
+
+}
 
 const double RandomUnitCellGenerator::DEFAULT_MIN_ANGLE = 35.0;
 const double RandomUnitCellGenerator::DEFAULT_MAX_ANGLE = 135.0;
@@ -30,6 +154,52 @@ const double RandomUnitCellGenerator::DEFAULT_MAX_LENGTH_RATIO = 4.0;
 const double RandomUnitCellGenerator::DEFAULT_BULK_CONTENTS_MULTIPLIER = 4.0;
 const double RandomUnitCellGenerator::DEFAULT_CLUSTER_CONTENTS_MULTIPLIER = 10.0;
 
+RandomUnitCellGenerator::Statistics::Statistics():
+numRequested(0),
+numInvalidAngles(0),
+numLengthRatioIgnored(0),
+numSingular(0)
+{}
+
+double RandomUnitCellGenerator::Statistics::getAcceptanceRate() const
+{
+  if(numRequested == 0)
+    return 1.0;
+  return static_cast<double>(numRequested - numInvalidAngles - numSingular) /
+    static_cast<double>(numRequested);
+}
+
+RandomUnitCellGenerator::GuardedStatistics::GuardedStatistics(const GuardedStatistics & toCopy):
+myStatistics(toCopy.get())
+{}
+
+RandomUnitCellGenerator::GuardedStatistics &
+RandomUnitCellGenerator::GuardedStatistics::operator =(const GuardedStatistics & rhs)
+{
+  const Statistics statistics = rhs.get();
+  ::boost::lock_guard< ::boost::mutex> lock(myMutex);
+  myStatistics = statistics;
+  return *this;
+}
+
+RandomUnitCellGenerator::Statistics RandomUnitCellGenerator::GuardedStatistics::get() const
+{
+  ::boost::lock_guard< ::boost::mutex> lock(myMutex);
+  return myStatistics;
+}
+
+void RandomUnitCellGenerator::GuardedStatistics::reset()
+{
+  ::boost::lock_guard< ::boost::mutex> lock(myMutex);
+  myStatistics = Statistics();
+}
+
+void RandomUnitCellGenerator::GuardedStatistics::increment(size_t Statistics::* const counter)
+{
+  ::boost::lock_guard< ::boost::mutex> lock(myMutex);
+  ++(myStatistics.*counter);
+}
+
 RandomUnitCellGenerator::ParameterValueAndSpecific
 RandomUnitCellGenerator::getMin(const size_t param) const
 {
@@ -146,6 +316,16 @@ RandomUnitCellGenerator::getMaxLengthRatio() const
     return ParameterValueAndSpecific(DEFAULT_MAX_LENGTH_RATIO, false);
 }
 
+RandomUnitCellGenerator::Statistics RandomUnitCellGenerator::getStatistics() const
+{
+  return myStatistics.get();
+}
+
+void RandomUnitCellGenerator::resetStatistics()
+{
+  myStatistics.reset();
+}
+
 GenerationOutcome RandomUnitCellGenerator::generateCell(
   common::UnitCellPtr & cellOut,
   const bool structureIsCluster
@@ -177,41 +357,43 @@ GenerationOutcome RandomUnitCellGenerator::generateCell(
   return outcome;
 }
 
-IUnitCellGeneratorPtr RandomUnitCellGenerator::clone() const
+GenerationOutcome RandomUnitCellGenerator::generateCell(
+  common::UnitCellPtr & cellOut,
+  const StructureContents & structureContents,
+  const CrystalSystem::Value crystalSystem,
+  const bool structureIsCluster
+) const
 {
-  return IUnitCellGeneratorPtr(new RandomUnitCellGenerator(*this));
+  GenerationOutcome outcome = generateLatticeParameters(cellOut, crystalSystem);
+  if(!outcome.isSuccess())
+    return outcome;
+
+  const VolAndDelta volAndDelta = generateVolumeParams(cellOut->getVolume(), structureIsCluster, &structureContents);
+  cellOut->setVolume(generateVolume(volAndDelta));
+
+  return outcome;
 }
 
-double RandomUnitCellGenerator::generateParameter(const size_t param) const
+IUnitCellGeneratorPtr RandomUnitCellGenerator::clone() const
 {
-  SSLIB_ASSERT(param < 6);
-  return math::randu(getMin(param).first, getMax(param).first);
+  return IUnitCellGeneratorPtr(new RandomUnitCellGenerator(*this));
 }
 
-GenerationOutcome RandomUnitCellGenerator::generateLatticeParameters(common::UnitCellPtr & cellOut) const
+GenerationOutcome RandomUnitCellGenerator::generateLatticeParameters(
+  common::UnitCellPtr & cellOut,
+  const CrystalSystem::Value crystalSystem) const
 {
-  using namespace utility::cell_params_enum;
+  myStatistics.increment(&Statistics::numRequested);
 
   double params[6];
-  size_t i;
-  generateLengths(params);
-
-  bool anglesValid = false;
-  for(size_t iters = 0; iters < 1000 && !anglesValid; ++iters)
+  generateLengths(params, crystalSystem);
+  if(!generateAngles(params, crystalSystem))
   {
-    for(i = ALPHA; i <= GAMMA; ++i)
-      params[i] = generateParameter(i);
-
-    anglesValid = areParametersValid(params);
+    myStatistics.increment(&Statistics::numInvalidAngles);
+    return GenerationOutcome::failure("No valid cell angles within the angle ranges.");
   }
 
-  // If the angles still aren't valid then use the
-  // minimum values for all of them
-  if(!anglesValid)
-  {
-    for(i = ALPHA; i <= GAMMA; ++i)
-      params[i] = getMin(i).first;
-  }
+  applyCrystalSystem(params, crystalSystem);
 
   try
   {
@@ -219,128 +401,146 @@ GenerationOutcome RandomUnitCellGenerator::generateLatticeParameters(common::Uni
   }
   catch(const ::std::runtime_error & /*e*/)
   {
+    myStatistics.increment(&Statistics::numSingular);
     return GenerationOutcome::failure("Cell parameters caused singular orthogonalisation matrix.");
   }
   return GenerationOutcome::success();
 }
 
-void RandomUnitCellGenerator::generateLengths(double (&params)[6]) const
+void RandomUnitCellGenerator::generateLengths(
+  double (&params)[6],
+  const CrystalSystem::Value crystalSystem) const
 {
   using namespace utility::cell_params_enum;
 
-  const size_t maxIters = 10;
-
-  // Generate the lengths
+  LinearConstraints constraints;
   for(size_t i = A; i <= C; ++i)
-  {
-    params[i] = generateParameter(i);
-  }
-
-  MinMaxIndex minMax;
+    addRange(constraints, i - A, getMin(i).first, getMax(i).first);
 
-  const bool overrideLengthRatio = myMaxLengthRatio;
-  const double maxRatio = overrideLengthRatio ? *myMaxLengthRatio : DEFAULT_MAX_LENGTH_RATIO;
-  double minLength, maxLength, ratio, cFactor;
-  bool canMoveMin, canMoveMax, madeStep = true;
-  size_t i;
-  for(i = 0; i < maxIters && madeStep; ++i)
+  // No length can be more than maxRatio times any other
+  const double maxRatio = getMaxLengthRatio().first;
+  for(size_t i = 0; i < 3; ++i)
   {
-    madeStep = false;
-    minMax = getMinMaxLengths(params);
-
-    minLength = params[minMax.first];
-    maxLength = params[minMax.second];
-
-    ratio = maxLength / minLength;
-
-    if(ratio > maxRatio)
+    for(size_t j = 0; j < 3; ++j)
     {
-      // Can move if the user hasn't set the parameter or if we are still within
-      // the user set range
-      canMoveMin = !myParameters[minMax.first].first || comp::lt(minLength, *myParameters[minMax.first].second);
-      canMoveMax = !myParameters[minMax.second].second || comp::gt(maxLength, *myParameters[minMax.second].first);
-
-      // Three possibilities for movement
-      if(canMoveMin && canMoveMax) // move both
-      {
-        cFactor = (ratio - maxRatio) / (ratio + maxRatio);
-        minLength *= (1 + cFactor);
-        maxLength *= (1 - cFactor);
-
-        // Now constrain the lengths to not exceed user set min/maxf
-        if(myParameters[minMax.first].second)
-          minLength = ::std::min(minLength, *myParameters[minMax.first].second);
-        if(myParameters[minMax.second].first)
-          maxLength = ::std::max(maxLength, *myParameters[minMax.second].first);
-      }
-      else if(canMoveMin) // move minimum
-      {
-        minLength *= ratio / maxRatio;
-        if(myParameters[minMax.first].second)
-          minLength = ::std::min(minLength, *myParameters[minMax.first].second);
-      }
-      else if(canMoveMax) // move maximum
-      {
-        maxLength *= maxRatio / ratio;
-        if(myParameters[minMax.second].first)
-          maxLength = ::std::max(maxLength, *myParameters[minMax.second].first);
-      }
-
-      // Have we made any changes?
-      if(minLength != params[minMax.first] || maxLength != params[minMax.second])
-      {
-        params[minMax.first] = minLength;
-        params[minMax.second] = maxLength;
-        madeStep = true;
-      }
+      if(i == j)
+        continue;
+      LinearConstraint ratio = {{0.0, 0.0, 0.0}, 0.0};
+      ratio.coeffs[i] = 1.0;
+      ratio.coeffs[j] = -maxRatio;
+      constraints.push_back(ratio);
     }
   }
-}
 
-double RandomUnitCellGenerator::generateVolume(const VolAndDelta & volAndDelta) const
-{
-  return math::randu(
-    volAndDelta.first * (1.0 - volAndDelta.second),
-    volAndDelta.first * (1.0 + volAndDelta.second)
-  );
+  // Tie together the lengths the crystal system says are equal here rather than
+  // afterwards so the values drawn still respect the ratio
+  switch(crystalSystem)
+  {
+  case CrystalSystem::CUBIC:
+    addConstraint(constraints, 1.0, 0.0, -1.0, 0.0);
+    addConstraint(constraints, -1.0, 0.0, 1.0, 0.0);
+    // Fall through, b = a as well
+  case CrystalSystem::TETRAGONAL:
+  case CrystalSystem::TRIGONAL:
+  case CrystalSystem::HEXAGONAL:
+    addConstraint(constraints, 1.0, -1.0, 0.0, 0.0);
+    addConstraint(constraints, -1.0, 1.0, 0.0, 0.0);
+    break;
+  default:
+    break;
+  }
+
+  double lengths[3];
+  if(sampleConstrained(lengths, constraints))
+  {
+    for(size_t i = A; i <= C; ++i)
+      params[i] = lengths[i - A];
+  }
+  else
+  {
+    // The user set ranges take precedence over the ratio
+    myStatistics.increment(&Statistics::numLengthRatioIgnored);
+    for(size_t i = A; i <= C; ++i)
+      params[i] = math::randu(getMin(i).first, getMax(i).first);
+  }
 }
 
-RandomUnitCellGenerator::MinMaxIndex RandomUnitCellGenerator::getMinMaxLengths(const double (&params)[6]) const
+bool RandomUnitCellGenerator::generateAngles(
+  double (&params)[6],
+  const CrystalSystem::Value crystalSystem) const
 {
   using namespace utility::cell_params_enum;
 
-  MinMaxIndex minMax;
-  if(params[A] > params[B])
-  {
-    minMax.first  = B;
-    minMax.second = A;
-  }
-  else
+  // Find the angles the crystal system fixes (they are the ones it overwrites),
+  // these take precedence over the user's ranges so only the rest are drawn
+  double fixedParams[6] = {0.0, 0.0, 0.0, -1.0, -1.0, -1.0};
+  applyCrystalSystem(fixedParams, crystalSystem);
+
+  LinearConstraints constraints;
+  for(size_t i = ALPHA; i <= GAMMA; ++i)
   {
-    minMax.first  = A;
-    minMax.second = B;
+    if(fixedParams[i] >= 0.0)
+      addRange(constraints, i - ALPHA, fixedParams[i], fixedParams[i]);
+    else
+      addRange(constraints, i - ALPHA, getMin(i).first, getMax(i).first);
   }
 
-  if(params[minMax.first] > params[C])
-    minMax.first = C;
-  else if(params[minMax.second] < params[C])
-    minMax.second = C;
+  // For the cell to be valid the angles must sum to less than 360 and each
+  // must be less than the sum of the other two
+  addConstraint(constraints, 1.0, 1.0, 1.0, 360.0);
+  addConstraint(constraints, 1.0, -1.0, -1.0, 0.0);
+  addConstraint(constraints, -1.0, 1.0, -1.0, 0.0);
+  addConstraint(constraints, -1.0, -1.0, 1.0, 0.0);
+
+  double angles[3];
+  if(!sampleConstrained(angles, constraints))
+    return false;
 
-  return minMax;
+  for(size_t i = ALPHA; i <= GAMMA; ++i)
+    params[i] = angles[i - ALPHA];
+  return true;
 }
 
-bool RandomUnitCellGenerator::areParametersValid(const double (&params)[6]) const
+void RandomUnitCellGenerator::applyCrystalSystem(
+  double (&params)[6],
+  const CrystalSystem::Value crystalSystem) const
 {
   using namespace utility::cell_params_enum;
 
-  const double anglesSum = params[ALPHA] + params[BETA] + params[GAMMA];
-
-  if(anglesSum >= 360.0) return false;
-  if(abs(params[ALPHA]-params[BETA]) > params[GAMMA]) return false;
-  if(abs(params[BETA]-params[GAMMA]) > params[ALPHA]) return false;
-  if(abs(params[GAMMA]-params[ALPHA]) > params[BETA]) return false;
+  // The crystal system takes precedence over anything the user has set
+  switch(crystalSystem)
+  {
+  case CrystalSystem::TRICLINIC:
+    break;
+  case CrystalSystem::MONOCLINIC:
+    params[ALPHA] = params[GAMMA] = 90.0;
+    break;
+  case CrystalSystem::ORTHORHOMBIC:
+    params[ALPHA] = params[BETA] = params[GAMMA] = 90.0;
+    break;
+  case CrystalSystem::TETRAGONAL:
+    params[B] = params[A];
+    params[ALPHA] = params[BETA] = params[GAMMA] = 90.0;
+    break;
+  case CrystalSystem::TRIGONAL:
+  case CrystalSystem::HEXAGONAL:
+    params[B] = params[A];
+    params[ALPHA] = params[BETA] = 90.0;
+    params[GAMMA] = 120.0;
+    break;
+  case CrystalSystem::CUBIC:
+    params[B] = params[C] = params[A];
+    params[ALPHA] = params[BETA] = params[GAMMA] = 90.0;
+    break;
+  }
+}
 
-  return true;
+double RandomUnitCellGenerator::generateVolume(const VolAndDelta & volAndDelta) const
+{
+  return math::randu(
+    volAndDelta.first * (1.0 - volAndDelta.second),
+    volAndDelta.first * (1.0 + volAndDelta.second)
+  );
 }
 
 bool RandomUnitCellGenerator::cellFullySpecified() const
@@ -0,0 +1,322 @@
+/*
+ * SpaceGroups.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUEDES /////////////
+#include "build_cell/SpaceGroups.h"
+
+#include <cmath>
+#include <map>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <armadillo>
+
+#include "SSLibAssert.h"
+#include "build_cell/SymmetryGroup.h"
+#include "math/Random.h"
+
+namespace sstbx {
+namespace build_cell {
+
+namespace {
+
+struct SpaceGroupInfo
+{
+  unsigned int number;
+  const char * symbol;
+  // Semicolon separated generators (as in the International Tables) including
+  // any centring translations
+  const char * generators;
+};
+
+#define SSLIB_C_CENTRING "x+1/2,y+1/2,z"
+#define SSLIB_I_CENTRING "x+1/2,y+1/2,z+1/2"
+#define SSLIB_F_CENTRING "x,y+1/2,z+1/2;x+1/2,y,z+1/2"
+#define SSLIB_R_CENTRING "x+2/3,y+1/3,z+1/3"
+
+// Origin choice 2 where there is a choice, rhombohedral groups on hexagonal axes
+const SpaceGroupInfo SPACE_GROUPS[] = {
+  {1, "P1", ""},
+  {2, "P-1", "-x,-y,-z"},
+  {4, "P2_1", "-x,y+1/2,-z"},
+  {5, "C2", "-x,y,-z;" SSLIB_C_CENTRING},
+  {7, "Pc", "x,-y,z+1/2"},
+  {9, "Cc", "x,-y,z+1/2;" SSLIB_C_CENTRING},
+  {11, "P2_1/m", "-x,y+1/2,-z;-x,-y,-z"},
+  {12, "C2/m", "-x,y,-z;-x,-y,-z;" SSLIB_C_CENTRING},
+  {14, "P2_1/c", "-x,y+1/2,-z+1/2;-x,-y,-z"},
+  {15, "C2/c", "-x,y,-z+1/2;-x,-y,-z;" SSLIB_C_CENTRING},
+  {19, "P2_12_12_1", "-x+1/2,-y,z+1/2;-x,y+1/2,-z+1/2"},
+  {29, "Pca2_1", "-x,-y,z+1/2;x+1/2,-y,z"},
+  {33, "Pna2_1", "-x,-y,z+1/2;x+1/2,-y+1/2,z"},
+  {36, "Cmc2_1", "-x,-y,z+1/2;x,-y,z+1/2;" SSLIB_C_CENTRING},
+  {61, "Pbca", "-x+1/2,-y,z+1/2;-x,y+1/2,-z+1/2;-x,-y,-z"},
+  {62, "Pnma", "-x+1/2,-y,z+1/2;-x,y+1/2,-z;-x,-y,-z"},
+  {63, "Cmcm", "-x,-y,z+1/2;-x,y,-z+1/2;-x,-y,-z;" SSLIB_C_CENTRING},
+  {65, "Cmmm", "-x,-y,z;-x,y,-z;-x,-y,-z;" SSLIB_C_CENTRING},
+  {71, "Immm", "-x,-y,z;-x,y,-z;-x,-y,-z;" SSLIB_I_CENTRING},
+  {74, "Imma", "-x,-y+1/2,z;-x,y+1/2,-z;-x,-y,-z;" SSLIB_I_CENTRING},
+  {88, "I4_1/a", "-y+3/4,x+1/4,z+1/4;-x,-y,-z;" SSLIB_I_CENTRING},
+  {92, "P4_12_12", "-y+1/2,x+1/2,z+1/4;-x+1/2,y+1/2,-z+1/4"},
+  {123, "P4/mmm", "-y,x,z;-x,y,-z;-x,-y,-z"},
+  {136, "P4_2/mnm", "-y+1/2,x+1/2,z+1/2;-x+1/2,y+1/2,-z+1/2;-x,-y,-z"},
+  {139, "I4/mmm", "-y,x,z;-x,y,-z;-x,-y,-z;" SSLIB_I_CENTRING},
+  {141, "I4_1/amd", "-y+1/4,x+3/4,z+1/4;-x+1/2,y,-z+1/2;-x,-y,-z;" SSLIB_I_CENTRING},
+  {146, "R3", "-y,x-y,z;" SSLIB_R_CENTRING},
+  {148, "R-3", "-y,x-y,z;-x,-y,-z;" SSLIB_R_CENTRING},
+  {160, "R3m", "-y,x-y,z;-y,-x,z;" SSLIB_R_CENTRING},
+  {164, "P-3m1", "-y,x-y,z;y,x,-z;-x,-y,-z"},
+  {166, "R-3m", "-y,x-y,z;y,x,-z;-x,-y,-z;" SSLIB_R_CENTRING},
+  {167, "R-3c", "-y,x-y,z;y,x,-z+1/2;-x,-y,-z;" SSLIB_R_CENTRING},
+  {173, "P6_3", "x-y,x,z+1/2"},
+  {176, "P6_3/m", "x-y,x,z+1/2;-x,-y,-z"},
+  {186, "P6_3mc", "x-y,x,z+1/2;-y,-x,z"},
+  {187, "P-6m2", "-y,x-y,z;x,y,-z;-y,-x,z"},
+  {191, "P6/mmm", "x-y,x,z;y,x,-z;-x,-y,-z"},
+  {194, "P6_3/mmc", "x-y,x,z+1/2;y,x,-z;-x,-y,-z"},
+  {198, "P2_13", "z,x,y;-x+1/2,-y,z+1/2"},
+  {205, "Pa-3", "z,x,y;-x+1/2,-y,z+1/2;-x,-y,-z"},
+  {215, "P-43m", "z,x,y;-x,-y,z;y,-x,-z"},
+  {216, "F-43m", "z,x,y;-x,-y,z;y,-x,-z;" SSLIB_F_CENTRING},
+  {221, "Pm-3m", "z,x,y;-y,x,z;-x,-y,-z"},
+  {225, "Fm-3m", "z,x,y;-y,x,z;-x,-y,-z;" SSLIB_F_CENTRING},
+  {227, "Fd-3m", "z,x,y;-x+3/4,-y+1/4,z+1/2;y+3/4,x+1/4,-z+1/2;-x,-y,-z;" SSLIB_F_CENTRING},
+  {229, "Im-3m", "z,x,y;-y,x,z;-x,-y,-z;" SSLIB_I_CENTRING}
+};
+
+#undef SSLIB_C_CENTRING
+#undef SSLIB_I_CENTRING
+#undef SSLIB_F_CENTRING
+#undef SSLIB_R_CENTRING
+
+const size_t NUM_SPACE_GROUPS = sizeof(SPACE_GROUPS) / sizeof(SpaceGroupInfo);
+
+typedef ::std::map<unsigned int, SymmetryGroupConstPtr> SpaceGroupCache;
+
+::boost::mutex spaceGroupCacheMutex;
+
+SpaceGroupCache & getSpaceGroupCache()
+{
+  static SpaceGroupCache cache;
+  return cache;
+}
+
+const SpaceGroupInfo * findSpaceGroup(const unsigned int number)
+{
+  for(size_t i = 0; i < NUM_SPACE_GROUPS; ++i)
+  {
+    if(SPACE_GROUPS[i].number == number)
+      return &SPACE_GROUPS[i];
+  }
+  return NULL;
+}
+
+// Parse an operator of the form x-y,x,z+1/2
+bool parseOperator(::arma::mat44 & opOut, const ::std::string & opString)
+{
+  ::std::vector< ::std::string> rows;
+  ::boost::algorithm::split(rows, opString, ::boost::algorithm::is_any_of(","));
+  if(rows.size() != 3)
+    return false;
+
+  opOut.zeros();
+  opOut(3, 3) = 1.0;
+  for(size_t row = 0; row < 3; ++row)
+  {
+    const ::std::string & terms = rows[row];
+    size_t pos = 0;
+    while(pos < terms.size())
+    {
+      double sign = 1.0;
+      if(terms[pos] == '+' || terms[pos] == '-')
+      {
+        sign = terms[pos] == '-' ? -1.0 : 1.0;
+        ++pos;
+      }
+      if(pos == terms.size())
+        return false;
+
+      if(terms[pos] >= 'x' && terms[pos] <= 'z')
+      {
+        opOut(row, terms[pos] - 'x') += sign;
+        ++pos;
+      }
+      else
+      {
+        // A translation of the form n/d
+        const size_t end = terms.find_first_of("+-", pos);
+        const ::std::string fraction = terms.substr(pos, end - pos);
+        const size_t slash = fraction.find('/');
+        try
+        {
+          double translation = ::boost::lexical_cast<double>(fraction.substr(0, slash));
+          if(slash != ::std::string::npos)
+            translation /= ::boost::lexical_cast<double>(fraction.substr(slash + 1));
+          opOut(row, 3) += sign * translation;
+        }
+        catch(const ::boost::bad_lexical_cast & /*e*/)
+        {
+          return false;
+        }
+        pos = end == ::std::string::npos ? terms.size() : end;
+      }
+    }
+  }
+  return true;
+}
+
+// Bring the translation back into the unit cell
+void wrapTranslation(::arma::mat44 & op)
+{
+  for(size_t i = 0; i < 3; ++i)
+  {
+    op(i, 3) -= ::std::floor(op(i, 3));
+    if(op(i, 3) > 1.0 - 1e-10)
+      op(i, 3) = 0.0;
+  }
+}
+
+}
+
+CrystalSystem::Value getCrystalSystem(const unsigned int spaceGroup)
+{
+  SSLIB_ASSERT(spaceGroup >= 1 && spaceGroup <= 230);
+
+  if(spaceGroup <= 2)
+    return CrystalSystem::TRICLINIC;
+  else if(spaceGroup <= 15)
+    return CrystalSystem::MONOCLINIC;
+  else if(spaceGroup <= 74)
+    return CrystalSystem::ORTHORHOMBIC;
+  else if(spaceGroup <= 142)
+    return CrystalSystem::TETRAGONAL;
+  else if(spaceGroup <= 167)
+    return CrystalSystem::TRIGONAL;
+  else if(spaceGroup <= 194)
+    return CrystalSystem::HEXAGONAL;
+  return CrystalSystem::CUBIC;
+}
+
+bool generateSpaceGroup(SymmetryGroup & groupOut, const unsigned int number)
+{
+  const SpaceGroupInfo * const info = findSpaceGroup(number);
+  if(!info)
+    return false;
+
+  groupOut.reset();
+
+  ::arma::mat44 op;
+
+  // Start with identity
+  op.eye();
+  groupOut.addOp(op);
+
+  ::std::vector< ::std::string> generators;
+  const ::std::string generatorsString(info->generators);
+  if(!generatorsString.empty())
+    ::boost::algorithm::split(generators, generatorsString, ::boost::algorithm::is_any_of(";"));
+  BOOST_FOREACH(const ::std::string & generator, generators)
+  {
+    const bool parsed = parseOperator(op, generator);
+    SSLIB_ASSERT_MSG(parsed, "Malformed space group generator");
+    wrapTranslation(op);
+    if(!groupOut.isInGroup(op))
+      groupOut.addOp(op);
+  }
+
+  // Close the group, translations only matter up to a lattice vector
+  for(size_t i = 1; i < groupOut.numOps(); ++i)
+  {
+    for(size_t j = 1; j < groupOut.numOps(); ++j)
+    {
+      op = groupOut.getOp(i) * groupOut.getOp(j);
+      wrapTranslation(op);
+      if(!groupOut.isInGroup(op))
+        groupOut.addOp(op);
+    }
+  }
+
+  groupOut.generateWyckoffPositions();
+  return true;
+}
+
+SymmetryGroupConstPtr getSharedSpaceGroup(const unsigned int number)
+{
+  const ::boost::lock_guard< ::boost::mutex> lock(spaceGroupCacheMutex);
+  SpaceGroupCache & cache = getSpaceGroupCache();
+  const SpaceGroupCache::const_iterator it = cache.find(number);
+  if(it != cache.end())
+    return it->second;
+
+  ::boost::shared_ptr<SymmetryGroup> group(new SymmetryGroup());
+  if(!generateSpaceGroup(*group, number))
+    return SymmetryGroupConstPtr();
+
+  cache[number] = group;
+  return group;
+}
+
+bool getSpaceGroup(unsigned int & numberOut, const ::std::string & groupString)
+{
+  if(groupString.empty())
+    return false;
+
+  // Try the symbol first
+  for(size_t i = 0; i < NUM_SPACE_GROUPS; ++i)
+  {
+    if(groupString == SPACE_GROUPS[i].symbol)
+    {
+      numberOut = SPACE_GROUPS[i].number;
+      return true;
+    }
+  }
+
+  unsigned int number;
+  try
+  {
+    number = ::boost::lexical_cast<unsigned int>(groupString);
+  }
+  catch(const ::boost::bad_lexical_cast & /*e*/)
+  {
+    return false;
+  }
+  if(!findSpaceGroup(number))
+    return false;
+
+  numberOut = number;
+  return true;
+}
+
+::std::string getSpaceGroupSymbol(const unsigned int number)
+{
+  const SpaceGroupInfo * const info = findSpaceGroup(number);
+  return info ? info->symbol : "";
+}
+
+unsigned int getRandomSpaceGroup()
+{
+  // Leave out P1 as that's what you get without choosing a space group
+  return SPACE_GROUPS[math::randu<size_t>(1, NUM_SPACE_GROUPS)].number;
+}
+
+::std::vector<unsigned int> getAvailableSpaceGroups()
+{
+  ::std::vector<unsigned int> numbers;
+  numbers.reserve(NUM_SPACE_GROUPS);
+  for(size_t i = 0; i < NUM_SPACE_GROUPS; ++i)
+    numbers.push_back(SPACE_GROUPS[i].number);
+  return numbers;
+}
+
+}
+}
@@ -15,10 +15,12 @@
 #include "build_cell/IFragmentGenerator.h"
 #include "build_cell/IUnitCellGenerator.h"
 #include "build_cell/PointGroups.h"
+#include "build_cell/SpaceGroups.h"
 #include "build_cell/StructureBuild.h"
 #include "build_cell/StructureContents.h"
 #include "build_cell/SymmetryGroup.h"
 #include "common/Structure.h"
+#include "common/UnitCell.h"
 #include "utility/IndexingEnums.h"
 
 namespace sstbx {
@@ -27,16 +29,22 @@ namespace build_cell {
 StructureBuilder::StructureBuilder():
 myPointGroup(PointGroupFamily::NONE, 0),
 myNumSymOps(0),
+mySpaceGroup(1),
+myRandomSpaceGroup(false),
 myIsCluster(false)
 {}
 
 StructureBuilder::StructureBuilder(const StructureBuilder & toCopy):
 StructureBuilderCore(toCopy),
-myUnitCellGenerator(myUnitCellGenerator->clone()),
 myPointGroup(toCopy.myPointGroup),
 myNumSymOps(toCopy.myNumSymOps),
+mySpaceGroup(toCopy.mySpaceGroup),
+myRandomSpaceGroup(toCopy.myRandomSpaceGroup),
 myIsCluster(toCopy.myIsCluster)
-{}
+{
+  if(toCopy.myUnitCellGenerator.get())
+    myUnitCellGenerator = toCopy.myUnitCellGenerator->clone();
+}
 
 GenerationOutcome
 StructureBuilder::generateStructure(common::StructurePtr & structureOut, const common::AtomSpeciesDatabase & speciesDb)
@@ -57,9 +65,14 @@ StructureBuilder::generateStructure(common::StructurePtr & structureOut, const c
   }
   // TODO: Sort fragment generators by volume (largest first)
 
-  structureOut.reset(new common::Structure());
+  // Reuse the caller's structure if there is one
+  if(structureOut.get())
+    structureOut->clear();
+  else
+    structureOut.reset(new common::Structure());
   StructureBuild structureBuild(*structureOut, contents);
-  if(!chooseSymmetry(structureBuild))
+  unsigned int spaceGroup;
+  if(!chooseSymmetry(structureBuild, spaceGroup))
   {
     outcome.setFailure("Failed to generate a symmetry group");
     return outcome;
@@ -69,7 +82,7 @@ StructureBuilder::generateStructure(common::StructurePtr & structureOut, const c
   if(myUnitCellGenerator.get())
   {
     common::UnitCellPtr cell;
-    outcome = myUnitCellGenerator->generateCell(cell, contents, myIsCluster);
+    outcome = myUnitCellGenerator->generateCell(cell, contents, getCrystalSystem(spaceGroup), myIsCluster);
     
     if(!outcome.success())
       return outcome;
@@ -126,6 +139,26 @@ const PointGroup & StructureBuilder::getPointGroup() const
   return myPointGroup;
 }
 
+void StructureBuilder::setSpaceGroup(const unsigned int spaceGroup)
+{
+  mySpaceGroup = spaceGroup;
+}
+
+unsigned int StructureBuilder::getSpaceGroup() const
+{
+  return mySpaceGroup;
+}
+
+void StructureBuilder::setRandomSpaceGroup(const bool random)
+{
+  myRandomSpaceGroup = random;
+}
+
+bool StructureBuilder::isRandomSpaceGroup() const
+{
+  return myRandomSpaceGroup;
+}
+
 void StructureBuilder::setCluster(const bool isCluster)
 {
   myIsCluster = isCluster;
@@ -136,28 +169,33 @@ bool StructureBuilder::isCluster() const
   return myIsCluster;
 }
 
-bool StructureBuilder::chooseSymmetry(StructureBuild & build) const
+bool StructureBuilder::chooseSymmetry(StructureBuild & build, unsigned int & spaceGroupOut) const
 {
+  spaceGroupOut = 1; // P1
   if(myUnitCellGenerator.get())
   { // Crystal
-    // TODO
+    const unsigned int spaceGroup = myRandomSpaceGroup ? getRandomSpaceGroup() : mySpaceGroup;
+    if(spaceGroup != 1)
+    {
+      const SymmetryGroupConstPtr group(getSharedSpaceGroup(spaceGroup));
+      if(!group.get())
+        return false;
+      build.setSymmetryGroup(group);
+      spaceGroupOut = spaceGroup;
+    }
   }
   else
   { // Cluster
     if(myPointGroup.first != PointGroupFamily::NONE)
     {
-      StructureBuild::SymmetryGroupPtr group(new SymmetryGroup());
-      generatePointGroup(*group, myPointGroup.first, myPointGroup.second);
-      build.setSymmetryGroup(group);
+      build.setSymmetryGroup(getSharedPointGroup(myPointGroup.first, myPointGroup.second));
     }
     else if(myNumSymOps != 0)
     {
       const ::boost::optional<PointGroup> pointGroup(getRandomPointGroup(myNumSymOps));
       if(!pointGroup)
         return false;
-      StructureBuild::SymmetryGroupPtr group(new SymmetryGroup());
-      generatePointGroup(*group, pointGroup->first, pointGroup->second);
-      build.setSymmetryGroup(group);      
+      build.setSymmetryGroup(getSharedPointGroup(pointGroup->first, pointGroup->second));
     }
   }
   return true;
@@ -187,8 +225,13 @@ GenerationOutcome StructureBuilder::generateSymmetry(StructureBuild & build) con
         // Get the operator matrix
         ::arma::mat44 opMat(group.getOp(op));
 
-        if(unitCell) // Transform the translation from fractional to absolute      
-          opMat.col(3).rows(X, Z) = trans(unitCell->getOrthoMtx() * opMat.col(3).rows(X, Z));
+        if(unitCell)
+        {
+          // Space group operators act on fractional coordinates, transform them to absolute
+          opMat.submat(X, X, Z, Z) =
+            unitCell->getOrthoMtx() * opMat.submat(X, X, Z, Z) * unitCell->getFracMtx();
+          opMat.col(3).rows(X, Z) = unitCell->getOrthoMtx() * opMat.col(3).rows(X, Z);
+        }
 
         common::Atom & oldAtom = it->getAtom(0);
         ::arma::vec4 oldPosition;
@@ -200,7 +243,10 @@ GenerationOutcome StructureBuilder::generateSymmetry(StructureBuild & build) con
         // Make a copy of the old atom
         common::Atom & newAtom = structure.newAtom(oldAtom);
         // Set the new position
-        newAtom.setPosition(::arma::vec3(newPosition.rows(X, Z)));
+        ::arma::vec3 newPos(newPosition.rows(X, Z));
+        if(unitCell)
+          unitCell->wrapVecInplace(newPos);
+        newAtom.setPosition(newPos);
 
         // Tell the build that this is a copy of the old atom
         build.addAtom(newAtom, *it);
@@ -8,6 +8,8 @@
 // INCLUEDES /////////////
 #include "build_cell/SymmetryGroup.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <complex>
 #include <vector>
@@ -24,6 +26,43 @@ namespace build_cell {
 
 namespace comp = utility::StableComp;
 
+namespace {
+// Every special position of the space groups we generate has points on this
+// grid (in fractional coordinates) so we can find them exactly
+const int WYCKOFF_GRID = 24;
+
+struct GridOp
+{
+  int rot[3][3];
+  int trans[3];
+};
+
+int roundToInt(const double x)
+{
+  return static_cast<int>(::std::floor(x + 0.5));
+}
+
+int wrapGrid(const int x)
+{
+  const int wrapped = x % WYCKOFF_GRID;
+  return wrapped < 0 ? wrapped + WYCKOFF_GRID : wrapped;
+}
+
+void applyGridOp(int (&out)[3], const GridOp & op, const int (&point)[3])
+{
+  for(size_t i = 0; i < 3; ++i)
+  {
+    out[i] = wrapGrid(
+      op.rot[i][0] * point[0] + op.rot[i][1] * point[1] + op.rot[i][2] * point[2] + op.trans[i]);
+  }
+}
+
+bool samePoint(const int (&p1)[3], const int (&p2)[3])
+{
+  return p1[0] == p2[0] && p1[1] == p2[1] && p1[2] == p2[2];
+}
+}
+
 struct EigenvectorsData
 {
   typedef ::std::vector<bool> OpMask;
@@ -45,6 +84,7 @@ void SymmetryGroup::reset()
 {
   mySymOps.clear();
   myInvariantsMap.clear();
+  myWyckoffMap.clear();
 }
 
 void SymmetryGroup::addOp(const ::arma::mat44 & symmetryOp)
@@ -57,6 +97,122 @@ void SymmetryGroup::generateEigenvectors()
   generateMultiplicityEigenvectors2();
 }
 
+void SymmetryGroup::generateWyckoffPositions()
+{
+  typedef ::std::map<OpMask, size_t> SiteIndices;
+
+  myWyckoffMap.clear();
+
+  const size_t numOps = mySymOps.size();
+
+  // Work on the grid so that finding which operators leave a point where it is
+  // is exact
+  ::std::vector<GridOp> gridOps(numOps);
+  for(size_t op = 0; op < numOps; ++op)
+  {
+    for(size_t i = 0; i < 3; ++i)
+    {
+      for(size_t j = 0; j < 3; ++j)
+      {
+        gridOps[op].rot[i][j] = roundToInt(mySymOps[op](i, j));
+        SSLIB_ASSERT_MSG(comp::eq(mySymOps[op](i, j), static_cast<double>(gridOps[op].rot[i][j])),
+          "Space group operators must act on fractional coordinates");
+      }
+      gridOps[op].trans[i] = roundToInt(WYCKOFF_GRID * mySymOps[op](i, 3));
+      SSLIB_ASSERT_MSG(
+        comp::eq(WYCKOFF_GRID * mySymOps[op](i, 3), static_cast<double>(gridOps[op].trans[i])),
+        "Space group translation not on the Wyckoff grid");
+    }
+  }
+
+  // Group the grid points by their site symmetry (the operators that leave them where they are)
+  SiteIndices siteIndices;
+  ::std::vector<OpMask> siteSymmetries;
+  ::std::vector<WyckoffPosition> sites;
+  OpMask siteSymmetry(numOps);
+  int point[3], image[3];
+  for(point[0] = 0; point[0] < WYCKOFF_GRID; ++point[0])
+  {
+    for(point[1] = 0; point[1] < WYCKOFF_GRID; ++point[1])
+    {
+      for(point[2] = 0; point[2] < WYCKOFF_GRID; ++point[2])
+      {
+        size_t order = 0;
+        for(size_t op = 0; op < numOps; ++op)
+        {
+          applyGridOp(image, gridOps[op], point);
+          siteSymmetry[op] = samePoint(image, point);
+          if(siteSymmetry[op])
+            ++order;
+        }
+        // Only the identity, it's a general position
+        if(order == 1)
+          continue;
+
+        const ::std::pair<SiteIndices::iterator, bool> inserted =
+          siteIndices.insert(::std::make_pair(siteSymmetry, sites.size()));
+        if(inserted.second)
+        {
+          siteSymmetries.push_back(siteSymmetry);
+          sites.resize(sites.size() + 1);
+
+          // Only apply one operator from each set that takes the point to the same place
+          OpMask & opMask = sites.back().opMask;
+          opMask.resize(numOps, true);
+          ::std::vector<int> seen;
+          for(size_t op = 0; op < numOps; ++op)
+          {
+            applyGridOp(image, gridOps[op], point);
+            const int idx = (image[0] * WYCKOFF_GRID + image[1]) * WYCKOFF_GRID + image[2];
+            if(::std::find(seen.begin(), seen.end(), idx) != seen.end())
+              opMask[op] = false;
+            else
+              seen.push_back(idx);
+          }
+        }
+        ::arma::vec3 origin;
+        for(size_t i = 0; i < 3; ++i)
+          origin(i) = static_cast<double>(point[i]) / static_cast<double>(WYCKOFF_GRID);
+        sites[inserted.first->second].origins.push_back(origin);
+      }
+    }
+  }
+
+  ::arma::mat U, V;
+  ::arma::vec s;
+  for(size_t site = 0; site < sites.size(); ++site)
+  {
+    const OpMask & symmetry = siteSymmetries[site];
+    const size_t order = static_cast<size_t>(::std::count(symmetry.begin(), symmetry.end(), true));
+    SSLIB_ASSERT(numOps % order == 0);
+
+    // The position is free to move in the space left unchanged by all the site symmetry operators
+    ::arma::mat constraints(3 * order, 3);
+    size_t row = 0;
+    for(size_t op = 0; op < numOps; ++op)
+    {
+      if(symmetry[op])
+      {
+        constraints.rows(row, row + 2) =
+          mySymOps[op].submat(0, 0, 2, 2) - ::arma::eye< ::arma::mat>(3, 3);
+        row += 3;
+      }
+    }
+    svd(U, s, V, constraints);
+    size_t dims = 0;
+    for(size_t i = 0; i < s.n_rows; ++i)
+    {
+      if(comp::eq(s(i), 0.0))
+        ++dims;
+    }
+    // Singular values are in descending order so the free directions are the last ones
+    if(dims > 0)
+      sites[site].space = V.cols(3 - dims, 2);
+
+    myWyckoffMap[static_cast<unsigned int>(numOps / order)].push_back(sites[site]);
+  }
+}
+
 size_t SymmetryGroup::numOps() const
 {
   return mySymOps.size();
@@ -94,11 +250,17 @@ SymmetryGroup::Multiplicities
 SymmetryGroup::getMultiplicities() const
 {
   Multiplicities mults;
-  mults.reserve(myInvariantsMap.size());
+  mults.reserve(myInvariantsMap.size() + myWyckoffMap.size());
   BOOST_FOREACH(InvariantsMap::const_reference entry, myInvariantsMap)
   {
     mults.push_back(entry.first);
   }
+  BOOST_FOREACH(WyckoffMap::const_reference entry, myWyckoffMap)
+  {
+    if(myInvariantsMap.find(entry.first) == myInvariantsMap.end())
+      mults.push_back(entry.first);
+  }
+  ::std::sort(mults.begin(), mults.end());
   return mults;
 }
 
@@ -112,6 +274,16 @@ SymmetryGroup::getEigenspacesAndMasks(const unsigned int multiplicity) const
   return &(it->second);
 }
 
+const SymmetryGroup::WyckoffPositions *
+SymmetryGroup::getWyckoffPositions(const unsigned int multiplicity) const
+{
+  const WyckoffMap::const_iterator it = myWyckoffMap.find(multiplicity);
+  if(it == myWyckoffMap.end())
+    return NULL;
+
+  return &(it->second);
+}
+
 void SymmetryGroup::generateMultiplicityEigenvectors2()
 {
   myInvariantsMap.clear();
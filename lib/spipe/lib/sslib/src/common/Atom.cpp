@@ -24,44 +24,44 @@ Structure & Atom::getStructure()
   return myStructure;
 }
 
-const ::arma::vec3 & Atom::getPosition() const
+::arma::vec3 Atom::getPosition() const
 {
-	return myPosition;
+  ::arma::vec3 pos;
+  pos = myStructure.myAtomsData->positions->col(myIndex);
+	return pos;
 }
 
 void Atom::setPosition(const ::arma::vec3 & pos)
 {
-	myPosition = pos;
-  myStructure.atomMoved(*this);
+	myStructure.getWritableAtomsData().positions->col(myIndex) = pos;
 }
 
 void Atom::setPosition(const double x, const double y, const double z)
 {
-	myPosition(0) = x;
-  myPosition(1) = y;
-  myPosition(2) = z;
-  myStructure.atomMoved(*this);
+  double * const pos = myStructure.getWritableAtomsData().positions->colptr(myIndex);
+	pos[0] = x;
+  pos[1] = y;
+  pos[2] = z;
 }
 
 void Atom::moveBy(const ::arma::vec3 & dr)
 {
-  myPosition += dr;
-  myStructure.atomMoved(*this);
+  myStructure.getWritableAtomsData().positions->col(myIndex) += dr;
 }
 
 double Atom::getRadius() const
 {
-  return myRadius;
+  return myStructure.myAtomsData->radii[myIndex];
 }
 
 void Atom::setRadius(const double radius)
 {
-  myRadius = radius;
+  myStructure.getWritableAtomsData().radii[myIndex] = radius;
 }
 
 const AtomSpeciesId::Value  Atom::getSpecies() const
 {
-	return mySpecies;
+	return myStructure.myAtomsData->species[myIndex];
 }
 
 size_t Atom::getIndex() const
@@ -69,19 +69,9 @@ size_t Atom::getIndex() const
   return myIndex;
 }
 
-Atom::Atom(const AtomSpeciesId::Value species, Structure & structure, const size_t index):
+Atom::Atom(Structure & structure, const size_t index):
 myStructure(structure),
-myIndex(index),
-mySpecies(species),
-myRadius(-1.0)
-{}
-
-Atom::Atom(const Atom & toCopy, Structure & structure, const size_t index):
-myStructure(structure),
-myIndex(index),
-mySpecies(toCopy.getSpecies()),
-myPosition(toCopy.getPosition()),
-myRadius(toCopy.getRadius())
+myIndex(index)
 {}
 
 void Atom::setIndex(const size_t index)
@@ -10,6 +10,11 @@
 
 #include <boost/assert.hpp>
 
+#include "common/LatticeStencils.h"
+#include "common/PairImages.h"
+#include "common/Structure.h"
+#include "common/UnitCell.h"
+
 
 namespace sstbx {
 namespace common {
@@ -22,5 +27,14 @@ DistanceCalculator::DistanceCalculator(const Structure & structure):
 myStructure(structure)
 {}
 
+void DistanceCalculator::getPairImages(PairImages & imagesOut, const double cutoff) const
+{
+  const UnitCell * const cell = myStructure.getUnitCell();
+  if(cell)
+    imagesOut.reset(*cell, LatticeStencils().getStencil(*cell, cutoff), cutoff);
+  else
+    imagesOut.reset(cutoff);
+}
+
 }
 }
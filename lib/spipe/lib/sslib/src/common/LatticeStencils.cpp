@@ -0,0 +1,175 @@
+/*
+ * LatticeStencils.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES /////////////////////////////////////
+#include "common/LatticeStencils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "common/UnitCell.h"
+
+namespace sstbx {
+namespace common {
+
+namespace {
+
+typedef ::std::pair<double, size_t> LengthAndIndex;
+
+class DistanceAppender
+{
+public:
+  explicit DistanceAppender(::std::vector<double> & distances):
+  myDistances(distances)
+  {}
+
+  inline void operator()(const ::arma::vec3 & /*dr*/, const double drSq)
+  { myDistances.push_back(::std::sqrt(drSq)); }
+
+private:
+  ::std::vector<double> & myDistances;
+};
+
+class VectorAppender
+{
+public:
+  explicit VectorAppender(::std::vector< ::arma::vec3> & vectors):
+  myVectors(vectors)
+  {}
+
+  inline void operator()(const ::arma::vec3 & dr, const double /*drSq*/)
+  { myVectors.push_back(dr); }
+
+private:
+  ::std::vector< ::arma::vec3> & myVectors;
+};
+
+}
+
+// Potentials and comparators only ever use a handful of different cutoffs
+const size_t LatticeStencils::DEFAULT_MAX_STENCILS = 8;
+
+LatticeStencils::LatticeStencils(const size_t maxStencils):
+myMaxStencils(maxStencils)
+{}
+
+bool LatticeStencils::getDistsBetween(
+  const Stencil & stencil,
+  const ::arma::vec3 & dR,
+  const double cutoff,
+  ::std::vector<double> & outDistances,
+  const size_t maxDistances)
+{
+  DistanceAppender appender(outDistances);
+  return forEachImage(stencil, dR, cutoff, appender, maxDistances);
+}
+
+bool LatticeStencils::getVecsBetween(
+  const Stencil & stencil,
+  const ::arma::vec3 & dR,
+  const double cutoff,
+  ::std::vector< ::arma::vec3> & outVectors,
+  const size_t maxVectors)
+{
+  VectorAppender appender(outVectors);
+  return forEachImage(stencil, dR, cutoff, appender, maxVectors);
+}
+
+LatticeStencils::StencilPtr
+LatticeStencils::getStencil(const UnitCell & cell, const double cutoff) const
+{
+  const Stencils::const_iterator it = myStencils.find(cutoff);
+  if(it != myStencils.end())
+    return it->second;
+
+  // Don't let someone who uses lots of different cutoffs fill up the memory
+  if(myStencils.size() >= myMaxStencils)
+    myStencils.clear();
+
+  ::boost::shared_ptr<Stencil> stencil(new Stencil());
+  generateStencil(*stencil, cell, cutoff);
+  myStencils[cutoff] = stencil;
+  return stencil;
+}
+
+void LatticeStencils::clear()
+{
+  myStencils.clear();
+}
+
+void LatticeStencils::generateStencil(Stencil & stencil, const UnitCell & cell, const double cutoff) const
+{
+  const ::arma::vec3 A(cell.getAVec());
+  const ::arma::vec3 B(cell.getBVec());
+  const ::arma::vec3 C(cell.getCVec());
+
+  // The longest vector within the cell is to one of the corners
+  double maxDisplacementSq = 0.0;
+  ::arma::vec3 corner;
+  for(int a = 0; a <= 1; ++a)
+  {
+    for(int b = 0; b <= 1; ++b)
+    {
+      for(int c = 0; c <= 1; ++c)
+      {
+        corner = a * A + b * B + c * C;
+        maxDisplacementSq = ::std::max(maxDisplacementSq, ::arma::dot(corner, corner));
+      }
+    }
+  }
+
+  // Any translation that takes a vector in the cell to within the cutoff is at
+  // most this long
+  const double radius = ::std::abs(cutoff) + ::std::sqrt(maxDisplacementSq);
+  const double radiusSq = radius * radius;
+
+  // The number of plane repetitions needed to bound the sphere
+  const double volume = cell.getVolume();
+  const ::arma::vec3 bCrossC = ::arma::cross(B, C);
+  const ::arma::vec3 aCrossC = ::arma::cross(A, C);
+  const ::arma::vec3 aCrossB = ::arma::cross(A, B);
+  const int A_max = (int)::std::ceil(radius * ::std::sqrt(::arma::dot(bCrossC, bCrossC)) / volume);
+  const int B_max = (int)::std::ceil(radius * ::std::sqrt(::arma::dot(aCrossC, aCrossC)) / volume);
+  const int C_max = (int)::std::ceil(radius * ::std::sqrt(::arma::dot(aCrossB, aCrossB)) / volume);
+  stencil.maxMultiple = static_cast<unsigned int>(::std::max(A_max, ::std::max(B_max, C_max)));
+
+  ::std::vector< ::arma::vec3> translations;
+  ::std::vector<LengthAndIndex> lengths;
+  ::arma::vec3 rA, rAB, translation;
+  double lengthSq;
+  for(int a = -A_max; a <= A_max; ++a)
+  {
+    rA = a * A;
+    for(int b = -B_max; b <= B_max; ++b)
+    {
+      rAB = rA + b * B;
+      for(int c = -C_max; c <= C_max; ++c)
+      {
+        translation = rAB + c * C;
+        lengthSq = ::arma::dot(translation, translation);
+        if(lengthSq <= radiusSq)
+        {
+          lengths.push_back(LengthAndIndex(::std::sqrt(lengthSq), translations.size()));
+          translations.push_back(translation);
+        }
+      }
+    }
+  }
+  ::std::sort(lengths.begin(), lengths.end());
+
+  stencil.translations.resize(lengths.size());
+  stencil.lengths.resize(lengths.size());
+  for(size_t i = 0; i < lengths.size(); ++i)
+  {
+    stencil.lengths[i] = lengths[i].first;
+    stencil.translations[i] = translations[lengths[i].second];
+  }
+}
+
+}
+}
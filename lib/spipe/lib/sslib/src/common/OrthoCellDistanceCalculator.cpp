@@ -8,6 +8,7 @@
 // INCLUDES /////////////////////////////////////
 #include "common/OrthoCellDistanceCalculator.h"
 
+#include "common/PairImages.h"
 #include "common/Structure.h"
 #include "common/UnitCell.h"
 #include "utility/IndexingEnums.h"
@@ -42,6 +43,11 @@ bool OrthoCellDistanceCalculator::getDistsBetween(
   cutoff = abs(cutoff);
   const UnitCell & cell = *myStructure.getUnitCell();
 
+  // Use the cached translations unless the caller wants fewer multiples than they cover
+  const LatticeStencils::StencilPtr stencil = myStencils.getStencil(cell, cutoff);
+  if(stencil->maxMultiple <= maxCellMultiples)
+    return LatticeStencils::getDistsBetween(*stencil, cell.wrapVec(r2 - r1), cutoff, outDistances, maxDistances);
+
 	// Get the lattice vectors
   const ::arma::vec3 A(cell.getAVec());
   const ::arma::vec3 B(cell.getBVec());
@@ -181,6 +187,11 @@ bool OrthoCellDistanceCalculator::getVecsBetween(
   cutoff = abs(cutoff);
   const UnitCell & cell = *myStructure.getUnitCell();
 
+  // Use the cached translations unless the caller wants fewer multiples than they cover
+  const LatticeStencils::StencilPtr stencil = myStencils.getStencil(cell, cutoff);
+  if(stencil->maxMultiple <= maxCellMultiples)
+    return LatticeStencils::getVecsBetween(*stencil, cell.wrapVec(r2 - r1), cutoff, outVectors, maxValues);
+
   const ::arma::vec3 r12 = cell.wrapVec(r2) - cell.wrapVec(r1);
   const double (&params)[6] = cell.getLatticeParams();
 
@@ -275,6 +286,12 @@ bool OrthoCellDistanceCalculator::getVecsBetween(
 	//}
 }
 
+void OrthoCellDistanceCalculator::getPairImages(PairImages & imagesOut, const double cutoff) const
+{
+  const UnitCell & cell = *myStructure.getUnitCell();
+  imagesOut.reset(cell, myStencils.getStencil(cell, cutoff), cutoff);
+}
+
 bool OrthoCellDistanceCalculator::isValid() const
 {
   using namespace utility::cell_params_enum;
@@ -294,6 +311,7 @@ bool OrthoCellDistanceCalculator::isValid() const
 void OrthoCellDistanceCalculator::unitCellChanged()
 {
   updateBufferedValues();
+  myStencils.clear();
 }
 
 void OrthoCellDistanceCalculator::updateBufferedValues()
@@ -0,0 +1,43 @@
+/*
+ * PairImages.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES /////////////////////////////////////
+#include "common/PairImages.h"
+
+#include "common/UnitCell.h"
+
+namespace sstbx {
+namespace common {
+
+PairImages::PairImages():
+myCutoff(0.0),
+myCutoffSq(0.0)
+{}
+
+void PairImages::reset(const double cutoff)
+{
+  myStencil.reset();
+  myCutoff = ::std::abs(cutoff);
+  myCutoffSq = myCutoff * myCutoff;
+}
+
+void PairImages::reset(const UnitCell & cell, const LatticeStencils::StencilPtr & stencil, const double cutoff)
+{
+  myStencil = stencil;
+  myOrthoMtx = cell.getOrthoMtx();
+  myFracMtx = cell.getFracMtx();
+  myCutoff = ::std::abs(cutoff);
+  myCutoffSq = myCutoff * myCutoff;
+}
+
+double PairImages::getCutoff() const
+{
+  return myCutoff;
+}
+
+}
+}
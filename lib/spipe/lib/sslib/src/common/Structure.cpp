@@ -8,9 +8,11 @@
 // INCLUDES /////////////////////////////////////
 #include "common/Structure.h"
 
+#include <algorithm>
 #include <vector>
 
-#include <boost/foreach.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/scoped_array.hpp>
 
 extern "C"
 {
@@ -32,27 +34,111 @@ extern "C"
 namespace sstbx {
 namespace common {
 
-class MatchSpecies : public std::unary_function<const Atom &, bool>
+namespace {
+
+/**
+/* A structure in the form that spglib expects, fractional positions and
+/* integer species.  Row-major = column-major so matrices can be copied
+/* straight over.
+/**/
+class SpglibStructure
 {
 public:
-  MatchSpecies(const AtomSpeciesId::Value toMatch):
-  mySpecies(toMatch) {}
+  explicit SpglibStructure(const Structure & structure):
+  numAtoms(structure.getNumAtoms()),
+  positions(new double[structure.getNumAtoms()][3]),
+  species(new int[structure.getNumAtoms()])
+  {
+    const UnitCell * const cell = structure.getUnitCell();
+    SSLIB_ASSERT(cell);
+
+    const ::arma::mat33 & orthoMtx = cell->getOrthoMtx();
+    for(size_t i = 0; i < 3; ++i)
+    {
+      for(size_t j = 0; j < 3; ++j)
+        lattice[i][j] = orthoMtx(i, j);
+    }
 
-  bool operator() (const Atom & atom) {return atom.getSpecies() == mySpecies;}
+    ::arma::mat posMtx;
+    structure.getAtomPositions(posMtx);
+    cell->cartsToFracInplace(posMtx);
+    cell->wrapVecsFracInplace(posMtx);
+    for(size_t i = 0; i < numAtoms; ++i)
+    {
+      for(size_t j = 0; j < 3; ++j)
+        positions[i][j] = posMtx(j, i);
+    }
+
+    const ::std::vector<AtomSpeciesId::Value> & speciesVec = structure.getAtomSpecies();
+    for(size_t i = 0; i < numAtoms; ++i)
+      species[i] = speciesVec[i].ordinal();
+  }
 
-private:
-  const AtomSpeciesId::Value mySpecies;
+  size_t numAtoms;
+  double lattice[3][3];
+  ::boost::scoped_array<double[3]> positions;
+  ::boost::scoped_array<int> species;
 };
 
+}
+
+const double Structure::DEFAULT_SYMMETRY_PRECISION = 0.05;
+
+Structure::AtomsData::AtomsData():
+storage(3, 0)
+{
+  setNumAtoms(0);
+}
+
+Structure::AtomsData::AtomsData(const AtomsData & toCopy):
+storage(*toCopy.positions),
+species(toCopy.species),
+radii(toCopy.radii)
+{
+  setNumAtoms(toCopy.positions->n_cols);
+}
+
+void Structure::AtomsData::setNumAtoms(const size_t numAtoms)
+{
+  // Grow the storage geometrically so adding atoms one by one stays cheap
+  if(storage.n_cols < numAtoms)
+    storage.resize(3, ::std::max(2 * static_cast<size_t>(storage.n_cols), numAtoms));
+
+  if(numAtoms == 0)
+    positions.reset(new ::arma::mat(3, 0));
+  else
+    positions.reset(new ::arma::mat(storage.memptr(), 3, numAtoms, false, true));
+}
+
+void Structure::AtomsData::reserve(const size_t numAtoms)
+{
+  if(storage.n_cols < numAtoms)
+  {
+    storage.resize(3, numAtoms);
+    // The storage has moved
+    setNumAtoms(positions->n_cols);
+  }
+}
+
+Structure::SymmetryCache::SymmetryCache():
+datasetSearched(false)
+{}
+
 Structure::Structure(UnitCellPtr cell):
-myAtomPositionsCurrent(false),
 myNumAtoms(0),
+myAtomsData(new AtomsData()),
+myGeometryVersion(0),
+mySymmetryVersion(0),
 myDistanceCalculator(*this)
 {
   setUnitCell(cell);
 }
 
 Structure::Structure(const Structure & toCopy):
+myNumAtoms(0),
+myAtomsData(new AtomsData()),
+myGeometryVersion(0),
+mySymmetryVersion(0),
 myDistanceCalculator(*this)
 {
   // Use the equals operator so we don't duplicate code
@@ -66,16 +152,17 @@ Structure & Structure::operator =(const Structure & rhs)
   // Copy over the unit cell (if exists)
   if(rhs.myCell.get())
     setUnitCell(rhs.myCell->clone());
+  else
+    setUnitCell(UnitCellPtr());
 
   // Copy over properties
   myTypedProperties = rhs.myTypedProperties;
 
-  // Copy over the atoms
-  clearAtoms();
-  BOOST_FOREACH(const Atom & atom, rhs.myAtoms)
-  {
-    newAtom(atom);
-  }
+  // Share the atoms until one of us changes them
+  setAtomsData(rhs.myAtomsData);
+
+  // Same geometry so the same symmetry
+  copySymmetryCaches(rhs);
 
   return *this;
 }
@@ -94,16 +181,21 @@ void Structure::updateWith(const Structure & structure)
     setUnitCell(UnitCellPtr());
 
   // Update the atoms
-  clearAtoms();
-  BOOST_FOREACH(const Atom & atom, structure.myAtoms)
-  {
-    newAtom(atom);
-  }
+  setAtomsData(structure.myAtomsData);
+  copySymmetryCaches(structure);
 
   // Update the properties
   myTypedProperties.insert(structure.myTypedProperties, true);
 }
 
+void Structure::clear()
+{
+  myName.clear();
+  setUnitCell(UnitCellPtr());
+  clearAtoms();
+  myTypedProperties.clear();
+}
+
 const std::string & Structure::getName() const
 {
 	return myName;
@@ -133,8 +225,9 @@ void Structure::setUnitCell(UnitCellPtr cell)
     myCell->setStructure(NULL);
 
 	myCell = cell;
-  myCell->setStructure(this);
-  myDistanceCalculator.unitCellChanged();
+  if(myCell.get())
+    myCell->setStructure(this);
+  unitCellChanged();
 }
 
 size_t Structure::getNumAtoms() const
@@ -158,16 +251,16 @@ const Atom & Structure::getAtom(const size_t idx) const
 
 Atom & Structure::newAtom(const AtomSpeciesId::Value species)
 {
-  myAtomPositionsCurrent = false;
-  Atom * const atom = new Atom(species, *this, myNumAtoms++);
-  myAtoms.push_back(atom);
-  return *atom;
+  return addAtom(species, -1.0);
 }
 
 Atom & Structure::newAtom(const Atom & toCopy)
 {
-  myAtomPositionsCurrent = false;
-  return *myAtoms.insert(myAtoms.end(), new Atom(toCopy, *this, ++myNumAtoms));
+  // Take a copy of the position first as the atom could be from this structure
+  const ::arma::vec3 pos = toCopy.getPosition();
+  Atom & atom = addAtom(toCopy.getSpecies(), toCopy.getRadius());
+  atom.setPosition(pos);
+  return atom;
 }
 
 bool Structure::removeAtom(const Atom & atom)
@@ -177,15 +270,22 @@ bool Structure::removeAtom(const Atom & atom)
 
   const size_t index = atom.getIndex();
 
-  myAtoms.erase(myAtoms.begin() + index);
+  // Shuffle the data of the following atoms down by one
+  AtomsData & atoms = getWritableAtomsData();
+  double * const positions = atoms.storage.memptr();
+  ::std::copy(positions + 3 * (index + 1), positions + 3 * myNumAtoms, positions + 3 * index);
+  atoms.species.erase(atoms.species.begin() + index);
+  atoms.radii.erase(atoms.radii.begin() + index);
+
+  mySpareAtoms.transfer(mySpareAtoms.end(), myAtoms.begin() + index, myAtoms);
   --myNumAtoms;
+  atoms.setNumAtoms(myNumAtoms);
 
   for(size_t i = index; i < myNumAtoms; ++i)
   {
     myAtoms[i].setIndex(i);
   }
 
-  myAtomPositionsCurrent = false;
   return true;
 }
 
@@ -193,60 +293,68 @@ size_t Structure::clearAtoms()
 {
   const size_t previousNumAtoms = myNumAtoms;
 
-  myAtoms.clear();
+  // Keep the atoms so they can be reused
+  mySpareAtoms.transfer(mySpareAtoms.end(), myAtoms);
+
+  geometryChanged();
+  if(myAtomsData.unique())
+  {
+    myAtomsData->species.clear();
+    myAtomsData->radii.clear();
+    myAtomsData->setNumAtoms(0);
+  }
+  else
+    myAtomsData.reset(new AtomsData());
 
   myNumAtoms = 0;
-  myAtomPositionsCurrent = false;
   return previousNumAtoms;
 }
 
-void Structure::getAtomPositions(::arma::mat & posMtx) const
+void Structure::reserveAtoms(const size_t numAtoms)
 {
-	// Do we need to update the buffer?
-	if(!myAtomPositionsCurrent)
-    updatePosBuffer();
+  myAtoms.reserve(numAtoms);
 
-	posMtx = myAtomPositionsBuffer;
+  AtomsData & atoms = getWritableAtomsData();
+  atoms.species.reserve(numAtoms);
+  atoms.radii.reserve(numAtoms);
+  atoms.reserve(numAtoms);
 }
 
-void Structure::getAtomPositions(::arma::subview<double> & posMtx) const
+const ::arma::mat & Structure::getAtomPositions() const
+{
+  return *myAtomsData->positions;
+}
+
+void Structure::getAtomPositions(::arma::mat & posMtx) const
 {
-	// Do we need to update the buffer?
-	if(!myAtomPositionsCurrent)
-    updatePosBuffer();
+	posMtx = getAtomPositions();
+}
 
-  posMtx = myAtomPositionsBuffer;
+void Structure::getAtomPositions(::arma::subview<double> & posMtx) const
+{
+  posMtx = getAtomPositions();
 }
 
 void Structure::setAtomPositions(const ::arma::mat & posMtx)
 {
-  const size_t numAtoms = getNumAtoms();
-  SSLIB_ASSERT(posMtx.n_rows == 3 && posMtx.n_cols == numAtoms);
+  SSLIB_ASSERT(posMtx.n_rows == 3 && posMtx.n_cols == getNumAtoms());
 
-  for(size_t i = 0; i < numAtoms; ++i)
-  {
-    myAtoms[i].setPosition(posMtx.col(i));
-  }
+	*getWritableAtomsData().positions = posMtx;
+}
 
-	// Save the new positions in the buffer
-	myAtomPositionsBuffer	= posMtx;
-	myAtomPositionsCurrent	= true;
+const ::std::vector<AtomSpeciesId::Value> & Structure::getAtomSpecies() const
+{
+  return myAtomsData->species;
 }
 
 void Structure::getAtomSpecies(::std::vector<AtomSpeciesId::Value> & species) const
 {
-  const size_t numAtoms = getNumAtoms();
-  species.resize(numAtoms);
-
-  for(size_t i = 0; i < numAtoms; ++i)
-  {
-    species[i] = myAtoms[i].getSpecies();
-  }
+  species = myAtomsData->species;
 }
 
 size_t Structure::getNumAtomsOfSpecies(const AtomSpeciesId::Value species) const
 {
-  return ::std::count_if(myAtoms.begin(), myAtoms.end(), MatchSpecies(species));
+  return ::std::count(myAtomsData->species.begin(), myAtomsData->species.end(), species);
 }
 
 const DistanceCalculator & Structure::getDistanceCalculator() const
@@ -265,160 +373,61 @@ void Structure::setVisibleProperty(VisibleProperty & property, const ::std::stri
   property.setValue(myTypedProperties, value);
 }
 
-bool Structure::makePrimitive()
+UniquePtr<Structure>::Type Structure::getGeometryCopy() const
 {
-  if(myNumAtoms > 0 && myCell.get())
-  {
-    double lattice[3][3];
-    const::arma::mat33 & orthoMtx = myCell->getOrthoMtx();
-    for(size_t i = 0; i < 3; ++i)
-    {
-      for(size_t j = 0; j < 3; ++j)
-      {
-        // Row-major = column-major
-        lattice[i][j] = orthoMtx(i, j);
-      }
-    }
-
-    double (*positions)[3] = new double[myNumAtoms][3];
-    ::arma::mat posMtx;
-    getAtomPositions(posMtx);
-    myCell->cartsToFracInplace(posMtx);
-    for(size_t i = 0; i < myNumAtoms; ++i)
-    {
-      for(size_t j = 0; j < 3; ++j)
-      {
-        // Row-major = column-major
-        positions[i][j] = posMtx(j, i);
-      }
-    }
-
-    ::std::vector<AtomSpeciesId::Value> speciesVec;
-    getAtomSpecies(speciesVec);
-    ::boost::scoped_array<int> species(new int[speciesVec.size()]);
-    for(size_t i = 0; i < speciesVec.size(); ++i)
-    {
-      species[i] = speciesVec[i].ordinal();
-    }
-
-    // Try to find the primitive unit cell
-    const size_t newNumAtoms = (size_t)spg_find_primitive(lattice, positions, species.get(), myNumAtoms, 0.05);
-
-    if(newNumAtoms != 0 && newNumAtoms < myNumAtoms)
-    {
-      // First deal with lattice
-      ::arma::mat33 newLattice;
-      for(size_t i = 0; i < 3; ++i)
-      {
-        for(size_t j = 0; j < 3; ++j)
-        {
-          newLattice(i, j) = lattice[i][j];
-        }
-      }
-
-      myCell->setOrthoMtx(newLattice);
-
-      // Now deal with atoms
-      clearAtoms();
-
-      Atom * atom;
-      ::arma::vec3 pos;
-      for(size_t i = 0; i < newNumAtoms; ++i)
-      {
-        atom = &newAtom(*AtomSpeciesId::values()[species[i]]);
-        pos << positions[i][0] << ::arma::endr
-          << positions[i][1] << ::arma::endr
-          << positions[i][2] << ::arma::endr;
-        atom->setPosition(myCell->fracWrapToCartInplace(pos));
-      }
-      delete [] positions;
-      return true;
-    }
-  }
-
-  return false;
+  UniquePtr<Structure>::Type structure(new Structure());
+  if(myCell.get())
+    structure->setUnitCell(myCell->clone());
+  structure->setAtomsData(myAtomsData);
+  structure->copySymmetryCaches(*this);
+  return structure;
 }
 
-UniquePtr<Structure>::Type Structure::getPrimitiveCopy() const
+SymmetryDatasetConstPtr Structure::getSymmetryDataset(const double precision) const
 {
-  UniquePtr<Structure>::Type structure;
-
-  if(myNumAtoms > 0 && myCell.get())
+  SymmetryCache & cache = getSymmetryCache(precision);
+  if(!cache.datasetSearched)
   {
-    // Get the lattice
-    double lattice[3][3];
-    const::arma::mat33 & orthoMtx = myCell->getOrthoMtx();
-    for(size_t i = 0; i < 3; ++i)
-    {
-      for(size_t j = 0; j < 3; ++j)
-      {
-        // Row-major = column-major
-        lattice[i][j] = orthoMtx(i, j);
-      }
-    }
-
-    // Get the atom positions
-    double (*positions)[3] = new double[myNumAtoms][3];
-    ::arma::mat posMtx;
-    getAtomPositions(posMtx);
-    myCell->cartsToFracInplace(posMtx);
-    for(size_t i = 0; i < myNumAtoms; ++i)
-    {
-      for(size_t j = 0; j < 3; ++j)
-      {
-        // Row-major = column-major
-        positions[i][j] = posMtx(j, i);
-      }
-    }
+    cache.dataset = findSymmetryDataset(precision);
+    cache.datasetSearched = true;
+  }
+  return cache.dataset;
+}
 
-    // Get the atom species
-    ::std::vector<AtomSpeciesId::Value> speciesVec;
-    getAtomSpecies(speciesVec);
-    ::boost::scoped_array<int> species(new int[speciesVec.size()]);
-    for(size_t i = 0; i < speciesVec.size(); ++i)
-    {
-      species[i] = speciesVec[i].ordinal();
-    }
+bool Structure::makePrimitive(const double precision)
+{
+  const StructureConstPtr primitive = getPrimitive(precision);
 
-    // Try to find the primitive unit cell
-    const size_t newNumAtoms = (size_t)spg_find_primitive(lattice, positions, species.get(), myNumAtoms, 0.05);
+  // Are we primitive already?
+  if(primitive->myAtomsData == myAtomsData)
+    return false;
 
-    if(newNumAtoms != 0 && newNumAtoms < myNumAtoms)
-    {
-      structure.reset(new Structure());
+  myCell->setOrthoMtx(primitive->getUnitCell()->getOrthoMtx());
+  setAtomsData(primitive->myAtomsData);
 
-      // First deal with lattice
-      ::arma::mat33 newLattice;
-      for(size_t i = 0; i < 3; ++i)
-      {
-        for(size_t j = 0; j < 3; ++j)
-        {
-          newLattice(i, j) = lattice[i][j];
-        }
-      }
+  // We are now the primitive structure
+  getSymmetryCache(precision).primitive = primitive;
+  return true;
+}
 
-      structure->setUnitCell(UnitCellPtr(new UnitCell(newLattice)));
-      const UnitCell * const unitCell = structure->getUnitCell();
+StructureConstPtr Structure::getPrimitive(const double precision) const
+{
+  SymmetryCache & cache = getSymmetryCache(precision);
+  if(!cache.primitive.get())
+    cache.primitive = findPrimitive(precision);
 
-      Atom * atom;
-      ::arma::vec3 pos;
-      for(size_t i = 0; i < newNumAtoms; ++i)
-      {
-        atom = &structure->newAtom(*AtomSpeciesId::values()[species[i]]);
-        pos << positions[i][0] << ::arma::endr
-          << positions[i][1] << ::arma::endr
-          << positions[i][2] << ::arma::endr;
-        atom->setPosition(unitCell->fracWrapToCartInplace(pos));
-      }
+  return cache.primitive;
+}
 
-    }
-    delete [] positions;
-  } // if(myCell)
+UniquePtr<Structure>::Type Structure::getPrimitiveCopy(const double precision) const
+{
+  const StructureConstPtr primitive = getPrimitive(precision);
 
-  if(!structure.get())
-    structure.reset(new Structure(*this));
+  // If we are primitive already then the copy is of us, name, properties and all
+  if(primitive->myAtomsData == myAtomsData)
+    return UniquePtr<Structure>::Type(new Structure(*this));
 
-  return structure;
+  return primitive->getGeometryCopy();
 }
 
 void Structure::scale(const double scaleFactor)
@@ -427,12 +436,36 @@ void Structure::scale(const double scaleFactor)
 
   if(unitCell)
   {
+    // Scaling doesn't change the symmetry so hold on to the primitives and
+    // scale those rather than searching for them again
+    SymmetryCaches previousCaches;
+    if(mySymmetryVersion == myGeometryVersion)
+      previousCaches.swap(mySymmetryCaches);
+    const AtomsData * const previousAtoms = myAtomsData.get();
+
     const double volume = unitCell->getVolume();
     ::arma::mat atomPositions;
     getAtomPositions(atomPositions);
     unitCell->cartsToFracInplace(atomPositions);                    // Generate fractional positions
     unitCell->setVolume(volume * scaleFactor);                      // Scale the unit cell
     setAtomPositions(unitCell->fracsToCartInplace(atomPositions));  // Use the scaled cell to convert back to cart
+
+    for(SymmetryCaches::const_iterator it = previousCaches.begin(), end = previousCaches.end();
+      it != end; ++it)
+    {
+      const StructureConstPtr & primitive = it->second.primitive;
+      if(!primitive.get())
+        continue;
+
+      if(primitive->myAtomsData.get() == previousAtoms)
+        getSymmetryCache(it->first).primitive = StructureConstPtr(getGeometryCopy().release());
+      else
+      {
+        UniquePtr<Structure>::Type scaledPrimitive = primitive->getGeometryCopy();
+        scaledPrimitive->scale(scaleFactor);
+        getSymmetryCache(it->first).primitive = StructureConstPtr(scaledPrimitive.release());
+      }
+    }
   }
   else
   {
@@ -472,21 +505,186 @@ void Structure::print(::std::ostream & os) const
   }
 }
 
-void Structure::atomMoved(const Atom & atom) const
+Structure::AtomsData & Structure::getWritableAtomsData()
+{
+  geometryChanged();
+
+  if(!myAtomsData.unique())
+  {
+    // It could be our own (now out of date) primitive that's sharing the atoms
+    mySymmetryCaches.clear();
+    if(!myAtomsData.unique())
+      myAtomsData.reset(new AtomsData(*myAtomsData));
+  }
+
+  return *myAtomsData;
+}
+
+void Structure::setAtomsData(const AtomsDataPtr & data)
+{
+  geometryChanged();
+  myAtomsData = data;
+
+  // Match up the atoms with the new data
+  const size_t numAtoms = myAtomsData->species.size();
+  if(myNumAtoms > numAtoms)
+  {
+    mySpareAtoms.transfer(mySpareAtoms.end(), myAtoms.begin() + numAtoms, myAtoms.end(), myAtoms);
+    myNumAtoms = numAtoms;
+  }
+  while(myNumAtoms < numAtoms)
+    addAtomView();
+}
+
+Atom & Structure::addAtom(const AtomSpeciesId::Value species, const double radius)
+{
+  AtomsData & atoms = getWritableAtomsData();
+
+  atoms.setNumAtoms(myNumAtoms + 1);
+  atoms.positions->col(myNumAtoms).zeros();
+  atoms.species.push_back(species);
+  atoms.radii.push_back(radius);
+
+  return addAtomView();
+}
+
+Atom & Structure::addAtomView()
+{
+  Atom * atom = reuseAtom();
+  if(atom)
+    atom->setIndex(myNumAtoms);
+  else
+  {
+    atom = new Atom(*this, myNumAtoms);
+    myAtoms.push_back(atom);
+  }
+  ++myNumAtoms;
+  return *atom;
+}
+
+Atom * Structure::reuseAtom()
+{
+  if(mySpareAtoms.empty())
+    return NULL;
+
+  myAtoms.transfer(myAtoms.end(), mySpareAtoms.end() - 1, mySpareAtoms);
+  return &myAtoms.back();
+}
+
+Structure::SymmetryCache & Structure::getSymmetryCache(const double precision) const
 {
-  // Atom has moved so the buffer is not longer current
-  myAtomPositionsCurrent = false;
+  if(mySymmetryVersion != myGeometryVersion)
+  {
+    mySymmetryCaches.clear();
+    mySymmetryVersion = myGeometryVersion;
+  }
+  return mySymmetryCaches[precision];
+}
+
+void Structure::copySymmetryCaches(const Structure & structure)
+{
+  if(structure.mySymmetryVersion != structure.myGeometryVersion)
+    return;
+
+  mySymmetryCaches = structure.mySymmetryCaches;
+  mySymmetryVersion = myGeometryVersion;
+}
+
+SymmetryDatasetConstPtr Structure::findSymmetryDataset(const double precision) const
+{
+  SymmetryDatasetConstPtr dataset;
+  if(myNumAtoms == 0 || !myCell.get())
+    return dataset;
+
+  const SpglibStructure spgStructure(*this);
+  SpglibDataset * const spgData = spg_get_dataset(
+    spgStructure.lattice,
+    spgStructure.positions.get(),
+    spgStructure.species.get(),
+    spgStructure.numAtoms,
+    precision
+  );
+  if(!spgData)
+    return dataset;
+
+  SymmetryDataset * const symmetry = new SymmetryDataset();
+  dataset.reset(symmetry);
+
+  symmetry->spacegroupNumber = static_cast<unsigned int>(spgData->spacegroup_number);
+  symmetry->iucSymbol = spgData->international_symbol;
+  ::boost::algorithm::trim(symmetry->iucSymbol);
+  symmetry->hallSymbol = spgData->hall_symbol;
+  ::boost::algorithm::trim(symmetry->hallSymbol);
+
+  symmetry->operations.resize(spgData->n_operations);
+  for(int op = 0; op < spgData->n_operations; ++op)
+  {
+    SymmetryDataset::Operation & operation = symmetry->operations[op];
+    for(size_t i = 0; i < 3; ++i)
+    {
+      for(size_t j = 0; j < 3; ++j)
+        operation.rotation(i, j) = spgData->rotations[op][i][j];
+      operation.translation(i) = spgData->translations[op][i];
+    }
+  }
+
+  symmetry->equivalentAtoms.resize(spgData->n_atoms);
+  for(int i = 0; i < spgData->n_atoms; ++i)
+    symmetry->equivalentAtoms[i] = static_cast<size_t>(spgData->equivalent_atoms[i]);
+
+  spg_free_dataset(spgData);
+
+  return dataset;
 }
 
-void Structure::updatePosBuffer() const
+StructureConstPtr Structure::findPrimitive(const double precision) const
 {
-	myAtomPositionsBuffer.reset();
-  myAtomPositionsBuffer.set_size(3, getNumAtoms());
-	for(size_t i = 0; i < getNumAtoms(); ++i)
+  if(myNumAtoms > 0 && myCell.get())
   {
-    myAtomPositionsBuffer.col(i) = myAtoms[i].getPosition();
+    SpglibStructure spgStructure(*this);
+
+    // Try to find the primitive unit cell, spglib overwrites the structure with it
+    const size_t newNumAtoms = static_cast<size_t>(spg_find_primitive(
+      spgStructure.lattice,
+      spgStructure.positions.get(),
+      spgStructure.species.get(),
+      spgStructure.numAtoms,
+      precision
+    ));
+
+    if(newNumAtoms != 0 && newNumAtoms < myNumAtoms)
+    {
+      // First deal with lattice
+      ::arma::mat33 newLattice;
+      for(size_t i = 0; i < 3; ++i)
+      {
+        for(size_t j = 0; j < 3; ++j)
+        {
+          newLattice(i, j) = spgStructure.lattice[i][j];
+        }
+      }
+
+      Structure * const structure = new Structure(UnitCellPtr(new UnitCell(newLattice)));
+      const StructureConstPtr primitive(structure);
+      const UnitCell * const unitCell = structure->getUnitCell();
+
+      // Now deal with atoms
+      structure->reserveAtoms(newNumAtoms);
+      ::arma::vec3 pos;
+      for(size_t i = 0; i < newNumAtoms; ++i)
+      {
+        pos << spgStructure.positions[i][0] << ::arma::endr
+          << spgStructure.positions[i][1] << ::arma::endr
+          << spgStructure.positions[i][2] << ::arma::endr;
+        structure->newAtom(*AtomSpeciesId::values()[spgStructure.species[i]]).setPosition(unitCell->fracWrapToCartInplace(pos));
+      }
+
+      return primitive;
+    }
   }
-	myAtomPositionsCurrent = true;
+
+  // Already primitive, just share our atoms
+  return StructureConstPtr(getGeometryCopy().release());
 }
 
 } // namespace common
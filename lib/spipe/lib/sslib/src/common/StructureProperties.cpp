@@ -24,6 +24,7 @@ utility::Key< ::arma::mat33>          STRESS_TENSOR;
 
 namespace searching {
 utility::NamedKey<unsigned int>       TIMES_FOUND("timesFound");
+utility::NamedKey<double>             HULL_DISTANCE("hullDistance");
 }
 
 namespace io {
@@ -48,6 +49,7 @@ InitialiseVisibleProperties::InitialiseVisibleProperties()
   add(general::ENERGY_INTERNAL);
   add(general::ENTHALPY);
   add(searching::TIMES_FOUND);
+  add(searching::HULL_DISTANCE);
 }
 
 
@@ -69,6 +69,8 @@ void UnitCell::setLatticeParams(const double (&params)[6])
   using namespace utility::cell_params_enum;
 
   init(params[A], params[B], params[C], params[ALPHA], params[BETA], params[GAMMA]);
+  if(myStructure)
+    myStructure->unitCellChanged();
 }
 
 double UnitCell::getLongestCellVectorLength() const
@@ -109,6 +111,8 @@ double UnitCell::setVolume(const double volume)
 
 	const double scale = pow(volume / getVolume(), 1.0 / 3.0);
 	init(scale * myOrthoMtx);
+  if(myStructure)
+    myStructure->unitCellChanged();
   return scale;
 }
 
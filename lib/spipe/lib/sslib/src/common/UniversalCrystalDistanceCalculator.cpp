@@ -8,6 +8,7 @@
 // INCLUDES ///////////////
 #include "common/UniversalCrystalDistanceCalculator.h"
 
+#include "common/PairImages.h"
 #include "common/Structure.h"
 #include "common/UnitCell.h"
 
@@ -17,11 +18,13 @@ namespace common {
 
 UniversalCrystalDistanceCalculator::UniversalCrystalDistanceCalculator(const Structure & structure):
 DistanceCalculator(structure)
-{}
+{
+  updateReducedCell();
+}
 
 ::arma::vec3 UniversalCrystalDistanceCalculator::getVecMinImg(const ::arma::vec3 & a, const ::arma::vec3 & b, const unsigned int maxCellMultiples) const
 {
-  const UnitCell & cell = *myStructure.getUnitCell();
+  const UnitCell & cell = myReducedCell;
 
 	// Make sure cart1 and 2 are in the unit cell at the origin
   const ::arma::vec3		dR		= cell.wrapVec(b) - cell.wrapVec(a);
@@ -80,7 +83,12 @@ bool UniversalCrystalDistanceCalculator::getDistsBetween(
     const size_t maxValues,
     const unsigned int maxCellMultiples) const
 {
-  const UnitCell & cell = *myStructure.getUnitCell();
+  const UnitCell & cell = myReducedCell;
+
+  // Use the cached translations unless the caller wants fewer multiples than they cover
+  const LatticeStencils::StencilPtr stencil = myStencils.getStencil(cell, cutoff);
+  if(stencil->maxMultiple <= maxCellMultiples)
+    return LatticeStencils::getDistsBetween(*stencil, cell.wrapVec(b - a), cutoff, outValues, maxValues);
 
 	// Make sure a and b are in the unit cell at the origin
   const ::arma::vec3		dR		= cell.wrapVec(b) - cell.wrapVec(a);
@@ -139,7 +147,12 @@ bool UniversalCrystalDistanceCalculator::getVecsBetween(
   const size_t maxValues,
   const unsigned int maxCellMultiples) const
 {
-  const UnitCell & cell = *myStructure.getUnitCell();
+  const UnitCell & cell = myReducedCell;
+
+  // Use the cached translations unless the caller wants fewer multiples than they cover
+  const LatticeStencils::StencilPtr stencil = myStencils.getStencil(cell, cutoff);
+  if(stencil->maxMultiple <= maxCellMultiples)
+    return LatticeStencils::getVecsBetween(*stencil, cell.wrapVec(b - a), cutoff, outValues, maxValues);
 
 	// Make sure a and b are in the unit cell at the origin
   const ::arma::vec3		dR		= cell.wrapVec(b) - cell.wrapVec(a);
@@ -196,11 +209,35 @@ bool UniversalCrystalDistanceCalculator::getVecsBetween(
   return !problemDuringCalculation;
 }
 
+void UniversalCrystalDistanceCalculator::getPairImages(PairImages & imagesOut, const double cutoff) const
+{
+  const UnitCell & cell = myReducedCell;
+  imagesOut.reset(cell, myStencils.getStencil(cell, cutoff), cutoff);
+}
+
 bool UniversalCrystalDistanceCalculator::isValid() const
 {
   return myStructure.getUnitCell() != NULL;
 }
 
+void UniversalCrystalDistanceCalculator::unitCellChanged()
+{
+  updateReducedCell();
+  myStencils.clear();
+}
+
+void UniversalCrystalDistanceCalculator::updateReducedCell()
+{
+  const UnitCell * const cell = myStructure.getUnitCell();
+  if(!cell)
+    return;
+
+  // If the reduction fails the cell is left as it was, which is still correct
+  // just slower
+  myReducedCell.setOrthoMtx(cell->getOrthoMtx());
+  myReducedCell.niggliReduce();
+}
+
 double UniversalCrystalDistanceCalculator::getNumPlaneRepetitionsToBoundSphere(
   const ::arma::vec3 & planeVec1,
   const ::arma::vec3 & planeVec2,
@@ -208,7 +245,7 @@ double UniversalCrystalDistanceCalculator::getNumPlaneRepetitionsToBoundSphere(
 {
 	// The vector normal to the plane
   const ::arma::vec3 normal = ::arma::cross(planeVec1, planeVec2);
-  const double unitCellVolume = myStructure.getUnitCell()->getVolume(); // = a . |b x c|
+  const double unitCellVolume = myReducedCell.getVolume(); // = a . |b x c|
 
   return radius / unitCellVolume * ::std::sqrt(::arma::dot(normal, normal));
 }
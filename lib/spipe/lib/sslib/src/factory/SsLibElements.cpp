@@ -35,6 +35,7 @@ utility::Key<int> CASTEP_NUM_SELF_CONSISTENT;
 utility::Key<int> CASTEP_NUM_ROUGH_STEPS;
 utility::Key<double> PRESSURE;
 utility::Key<int> MAX_STEPS;
+utility::Key<bool> MIXED_PRECISION;
 
 // POTENTIALS //////////////////////////////////////////////
 utility::Key<utility::HeterogeneousMap> POTENTIAL;
@@ -75,6 +76,7 @@ utility::Key<double> DEPTH;
 utility::Key<utility::HeterogeneousMap> SYMMETRY;
 utility::Key<MinMax> SYM_OPS;
 utility::Key< ::std::string> POINT_GROUP;
+utility::Key< ::std::string> SPACE_GROUP;
 
 // STRUCTURE COMPARATORS //////////////////////////
 utility::Key<utility::HeterogeneousMap> COMPARATOR;
@@ -24,6 +24,7 @@
 #include "build_cell/AtomsGenerator.h"
 #include "build_cell/PointGroups.h"
 #include "build_cell/RandomUnitCellGenerator.h"
+#include "build_cell/SpaceGroups.h"
 #include "common/AtomSpeciesDatabase.h"
 #include "common/AtomSpeciesId.h"
 #include "factory/FactoryError.h"
@@ -237,6 +238,9 @@ SsLibFactoryYaml::createGeometryOptimiser(
     UniquePtr<potential::TpsdGeomOptimiser>::Type tpsd(new potential::TpsdGeomOptimiser(potential));
     if(tolerance)
       tpsd->setTolerance(*tolerance);
+    const bool * const mixedPrecision = tpsdOptions->find(MIXED_PRECISION);
+    if(mixedPrecision)
+      tpsd->setMixedPrecision(*mixedPrecision);
 
     opt = tpsd;      
   }
@@ -401,6 +405,16 @@ SsLibFactoryYaml::createStructureBuilder(const OptionsMap & map) const
       if(build_cell::getPointGroup(group, *pointGroup))
         builder->setPointGroup(group);
     }
+    // Either the space group (number or symbol) or random
+    const ::std::string * const spaceGroup = symmetry->find(SPACE_GROUP);
+    if(spaceGroup)
+    {
+      unsigned int number;
+      if(*spaceGroup == "random")
+        builder->setRandomSpaceGroup(true);
+      else if(build_cell::getSpaceGroup(number, *spaceGroup))
+        builder->setSpaceGroup(number);
+    }
   }
 
   // Cluster mode
@@ -164,8 +164,7 @@ void ResReaderWriter::writeStructure(
     cell->wrapVecsFracInplace(positions);
   }
 
-  vector<AtomSpeciesId::Value> species;
-	str.getAtomSpecies(species);
+  const vector<AtomSpeciesId::Value> & species = str.getAtomSpecies();
 
   set<AtomSpeciesId::Value> uniqueSpecies(species.begin(), species.end());
 
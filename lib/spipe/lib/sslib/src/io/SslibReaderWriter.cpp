@@ -22,6 +22,7 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include "SSLibAssert.h"
 #include "common/Atom.h"
 #include "common/AtomSpeciesDatabase.h"
 #include "common/AtomSpeciesId.h"
@@ -58,62 +59,88 @@ void SslibReaderWriter::writeStructure(
 	const ResourceLocator & locator,
 	const common::AtomSpeciesDatabase & speciesDb) const
 {
-  const fs::path filepath(locator.path());
-	if(!filepath.has_filename())
-		throw "Cannot write out structure without filepath";
+  writeStructures(Structures(1, &str), Locators(1, locator), speciesDb);
+}
 
-  const io::StructureYamlGenerator generator(speciesDb);
+void SslibReaderWriter::writeStructures(
+  const Structures & structures,
+  const Locators & locators,
+	const common::AtomSpeciesDatabase & speciesDb) const
+{
+  SSLIB_ASSERT(structures.size() == locators.size());
 
-  const fs::path dir = filepath.parent_path();
-	if(!dir.empty() && !exists(dir))
-	{
-		create_directories(dir);
-	}
+  const io::StructureYamlGenerator generator(speciesDb);
 
-  // First open and parse the file to get the current contents (if any)
-  YAML::Node doc;
-  fs::fstream strFile;
-  if(fs::exists(filepath))
+  size_t first = 0;
+  while(first < structures.size())
   {
-    strFile.open(filepath, ::std::ios_base::in | ::std::ios_base::out);
-    try
+    const fs::path filepath(locators[first].path());
+	  if(!filepath.has_filename())
+		  throw "Cannot write out structure without filepath";
+
+    // Find all the structures going to this file
+    size_t last = first + 1;
+    while(last < structures.size() && locators[last].path() == filepath)
+      ++last;
+
+    const fs::path dir = filepath.parent_path();
+	  if(!dir.empty() && !exists(dir))
+	  {
+		  create_directories(dir);
+	  }
+
+    // First open and parse the file to get the current contents (if any)
+    YAML::Node doc;
+    fs::fstream strFile;
+    if(fs::exists(filepath))
     {
-      doc = YAML::Load(strFile);
+      strFile.open(filepath, ::std::ios_base::in | ::std::ios_base::out);
+      try
+      {
+        doc = YAML::Load(strFile);
+      }
+      catch(const YAML::Exception & /*e*/)
+      {
+        // The file is dodgy, so happily overwrite it
+      }
+      // Go back to the start of the file
+      strFile.clear(); // Clear the EoF flag
+      strFile.seekg(0, ::std::ios::beg);
     }
-    catch(const YAML::Exception & /*e*/)
+    else
     {
-      // The file is dodgy, so happily overwrite it
+      strFile.open(filepath, ::std::ios_base::out);
     }
-    // Go back to the start of the file
-    strFile.clear(); // Clear the EoF flag
-    strFile.seekg(0, ::std::ios::beg);
-  }
-  else
-  {
-    strFile.open(filepath, ::std::ios_base::out);
-  }
 
-  ResourceLocator uniqueLoc = locator;
-  if(uniqueLoc.id().empty())
-  {
-    ::std::string newId = str.getName();
-    if(newId.empty())
+    ::std::vector<ResourceLocator> uniqueLocs(locators.begin() + first, locators.begin() + last);
+    for(size_t i = first; i < last; ++i)
     {
-      newId = utility::generateUniqueName();
+      ResourceLocator & uniqueLoc = uniqueLocs[i - first];
+      if(uniqueLoc.id().empty())
+      {
+        ::std::string newId = structures[i]->getName();
+        if(newId.empty())
+        {
+          newId = utility::generateUniqueName();
+        }
+        uniqueLoc.setId(newId);
+      }
+
+      doc[kw::STRUCTURES][uniqueLoc.id()] = generator.generateNode(*structures[i]);
     }
-    uniqueLoc.setId(newId);
-  }
 
-  doc[kw::STRUCTURES][uniqueLoc.id()] = generator.generateNode(str);
+    if(strFile.is_open())
+    {
+      YAML::Emitter out;
+      out << doc;
+      strFile << out.c_str() << ::std::endl;
+      strFile.close();
 
-  if(strFile.is_open())
-  {
-    YAML::Emitter out;
-    out << doc;
-    strFile << out.c_str() << ::std::endl;
-    strFile.close();
+      for(size_t i = first; i < last; ++i)
+        structures[i]->setProperty(properties::io::LAST_ABS_FILE_PATH, uniqueLocs[i - first]);
+    }
 
-    str.setProperty(properties::io::LAST_ABS_FILE_PATH, uniqueLoc);
+    first = last;
   }
 }
 
@@ -8,6 +8,7 @@
 // INCLUDES //////////////////////////////////
 #include "io/StructureReadWriteManager.h"
 
+#include "SSLibAssert.h"
 #include "common/Structure.h"
 #include "io/BoostFilesystem.h"
 #include "io/ResourceLocator.h"
@@ -204,6 +205,65 @@ bool StructureReadWriteManager::writeStructure(
   return true;
 }
 
+bool StructureReadWriteManager::writeStructures(
+  const IStructureWriter::Structures & structures,
+  IStructureWriter::Locators locators,
+  const common::AtomSpeciesDatabase & atomSpeciesDb) const
+{
+  SSLIB_ASSERT(structures.size() == locators.size());
+
+  ::std::vector< ::std::string> extensions(locators.size());
+  for(size_t i = 0; i < locators.size(); ++i)
+  {
+    if(!getExtension(extensions[i], locators[i]))
+    {
+      // No extension: try default writer
+      if(myDefaultWriteExtension.empty())
+        return false; // don't know which output format to use
+
+      extensions[i] = myDefaultWriteExtension;
+      locators[i].setPath(locators[i].path().string() + "." + extensions[i]);
+    }
+  }
+
+  bool allWritten = true;
+  size_t first = 0;
+  while(first < structures.size())
+  {
+    size_t last = first + 1;
+    while(last < structures.size() && extensions[last] == extensions[first])
+      ++last;
+
+    const IStructureWriter::Structures sameType(structures.begin() + first, structures.begin() + last);
+    const IStructureWriter::Locators sameTypeLocs(locators.begin() + first, locators.begin() + last);
+    allWritten &= writeStructures(sameType, sameTypeLocs, atomSpeciesDb, extensions[first]);
+
+    first = last;
+  }
+  return allWritten;
+}
+
+bool StructureReadWriteManager::writeStructures(
+  const IStructureWriter::Structures & structures,
+  const IStructureWriter::Locators & locators,
+  const common::AtomSpeciesDatabase & atomSpeciesDb,
+  const ::std::string & fileType) const
+{
+  SSLIB_ASSERT(structures.size() == locators.size());
+
+	const WritersMap::const_iterator it = myWriters.find(fileType);
+
+	if(it == myWriters.end())
+		return false; // unknown extension
+
+	it->second->writeStructures(structures, locators, atomSpeciesDb);
+
+  for(size_t i = 0; i < structures.size(); ++i)
+    postWrite(*structures[i], locators[i]);
+
+  return true;
+}
+
 common::types::StructurePtr StructureReadWriteManager::readStructure(
   const ResourceLocator & locator,
   const common::AtomSpeciesDatabase & speciesDb) const
@@ -8,25 +8,63 @@
 // INCLUDES //////////////////////////////////
 #include "math/Random.h"
 
+#include <istream>
+#include <ostream>
+
+#include <boost/thread/tss.hpp>
+
 // NAMESPACES ////////////////////////////////
 
 namespace sstbx {
 namespace math {
 namespace detail {
-::boost::mt19937 mt19937;
 
-::boost::normal_distribution<> Rand<double>::normal(0.0, 1.0);
+namespace {
+RandomState processState;
+::boost::thread_specific_ptr<RandomState> threadState;
+}
+
+RandomState::RandomState():
+normal(0.0, 1.0)
+{}
+
+RandomState & state()
+{
+  RandomState * const rs = threadState.get();
+  return rs ? *rs : processState;
+}
+
 #ifdef SSLIB_USE_BOOST_OLD_RANDOM
 const ::boost::uniform_real<> Rand<double>::uniform(0.0, 1.0);
-::boost::variate_generator< ::boost::mt19937 &, ::boost::uniform_real<> >
-  Rand<double>::uniformGenerator(mt19937, uniform);
-boost::variate_generator< ::boost::mt19937 &, ::boost::normal_distribution<> >
-  Rand<double>::normalGenerator(mt19937, normal);
 #else
 const ::boost::random::uniform_real_distribution<> Rand<double>::uniform(0.0, 1.0);
 #endif
 
 }
+
+void seedThread(const unsigned int randSeed)
+{
+  detail::threadState.reset(new detail::RandomState());
+  detail::threadState->engine.seed(randSeed);
 }
+
+void saveState(::std::ostream & os)
+{
+  const detail::RandomState & rs = detail::state();
+  os << rs.engine << ::std::endl;
+  os << rs.normal << ::std::endl;
 }
 
+bool loadState(::std::istream & is)
+{
+  detail::RandomState loaded;
+  is >> loaded.engine >> loaded.normal;
+  if(is.fail())
+    return false;
+
+  detail::state() = loaded;
+  return true;
+}
+
+}
+}
@@ -0,0 +1,64 @@
+/*
+ * PotentialBatchData.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "potential/PotentialBatchData.h"
+
+// NAMESPACES ////////////////////////////////
+
+
+namespace sstbx {
+namespace potential {
+
+PotentialBatchData::PotentialBatchData(const Structures & structures_):
+structures(structures_),
+offsets(structures_.size() + 1, 0),
+active(structures_.size(), true),
+evaluationOk(structures_.size(), true),
+precision(structures_.size(), PotentialData::Precision::DOUBLE),
+internalEnergy(structures_.size(), 0.0),
+stressMtx(structures_.size()),
+numParticles(0)
+{
+  for(size_t i = 0; i < structures.size(); ++i)
+  {
+    offsets[i] = numParticles;
+    numParticles += structures[i]->getNumAtoms();
+  }
+  offsets[structures.size()] = numParticles;
+
+  pos.set_size(3, numParticles);
+  forces.set_size(3, numParticles);
+  forces.zeros();
+  for(size_t i = 0; i < structures.size(); ++i)
+  {
+    stressMtx[i].zeros();
+    if(getNumParticles(i) != 0)
+    {
+      ::arma::subview<double> strPos = pos.cols(offsets[i], offsets[i + 1] - 1);
+      structures[i]->getAtomPositions(strPos);
+    }
+  }
+}
+
+size_t PotentialBatchData::getNumStructures() const
+{
+  return structures.size();
+}
+
+size_t PotentialBatchData::getNumParticles(const size_t str) const
+{
+  return offsets[str + 1] - offsets[str];
+}
+
+size_t PotentialBatchData::getFirstParticle(const size_t str) const
+{
+  return offsets[str];
+}
+
+}
+}
@@ -15,12 +15,14 @@ namespace sstbx {
 namespace potential {
 
 PotentialData::PotentialData():
+precision(Precision::DOUBLE),
 numParticles(0),
 internalEnergy(0.0)
 {
 }
 
-PotentialData::PotentialData(const sstbx::common::Structure & structure)
+PotentialData::PotentialData(const sstbx::common::Structure & structure):
+precision(Precision::DOUBLE)
 {
 	numParticles = structure.getNumAtoms();
 	internalEnergy = 0.0;
@@ -8,9 +8,11 @@
 // INCLUDES //////////////////////////////////
 #include "potential/SimplePairPotential.h"
 
+#include <cmath>
 #include <memory>
 
 #include "common/DistanceCalculator.h"
+#include "common/PairImages.h"
 #include "common/UnitCell.h"
 
 // NAMESPACES ////////////////////////////////
@@ -18,6 +20,129 @@
 namespace sstbx {
 namespace potential {
 
+namespace {
+
+/** Adds the energy, force and stress from each image of the pair (i, j). */
+template <typename FloatType>
+class PairTermAccumulator
+{
+public:
+  PairTermAccumulator(
+    SimplePairPotentialData & data,
+    const FloatType m,
+    const FloatType n,
+    const double minSeparationSq):
+  myData(data),
+  myM(m),
+  myN(n),
+  myMinSeparationSq(minSeparationSq)
+  {}
+
+  void setPair(
+    const size_t i,
+    const size_t j,
+    const FloatType epsilon,
+    const FloatType sigma,
+    const FloatType beta,
+    const FloatType rCut,
+    const FloatType eShift,
+    const FloatType fShift)
+  {
+    myI = i;
+    myJ = j;
+    myEpsilon = epsilon;
+    mySigma = sigma;
+    myBeta = beta;
+    myRCut = rCut;
+    myEShift = eShift;
+    myFShift = fShift;
+  }
+
+  inline void operator()(const ::arma::vec3 & r, const double rSq)
+  {
+    // Check that distance isn't near the 0 as this will cause near-singular values
+    if(rSq <= myMinSeparationSq)
+      return;
+
+    const FloatType modR = ::std::sqrt(static_cast<FloatType>(rSq));
+    const FloatType sigmaOModR = mySigma / modR;
+    const FloatType invRM = ::std::pow(sigmaOModR, myM);
+    const FloatType invRN = ::std::pow(sigmaOModR, myN) * myBeta;
+
+    // Calculate the energy delta
+    double dE = 2 * myEpsilon * (invRM - invRN) - myEShift + (modR - myRCut) * myFShift;
+
+    // Magnitude of the force
+    const double modF = 2 * myEpsilon * (myM * invRM - myN * invRN) / modR - myFShift;
+    myF = modF / modR * r;
+
+    // Make sure we get energy/force correct for self-interaction
+    if(myI != myJ)
+    {
+      myF *= 2.0;
+      dE *= 2.0;
+    }
+
+    // Update system values
+    // energy
+    myData.internalEnergy += dE;
+    // force
+    myData.forces.col(myI) -= myF;
+    if(myI != myJ)
+      myData.forces.col(myJ) += myF;
+
+    // stress, diagonal is element wise multiplication of force and position
+    // vector components
+    myData.stressMtx.diag() += myF % r;
+
+    myData.stressMtx(1, 2) += 0.5 * (myF(1)*r(2)+myF(2)*r(1));
+    myData.stressMtx(2, 0) += 0.5 * (myF(2)*r(0)+myF(0)*r(2));
+    myData.stressMtx(0, 1) += 0.5 * (myF(0)*r(1)+myF(1)*r(0));
+  }
+
+private:
+  SimplePairPotentialData & myData;
+  const FloatType myM;
+  const FloatType myN;
+  const double myMinSeparationSq;
+
+  size_t myI, myJ;
+  FloatType myEpsilon, mySigma, myBeta, myRCut, myEShift, myFShift;
+  ::arma::vec3 myF;
+};
+
+/** Appends each image of the pair (i, j) to the batch image buffers. */
+class ImageGatherer
+{
+public:
+  explicit ImageGatherer(SimplePairPotentialBatchData::Images & images):
+  myImages(images)
+  {}
+
+  void setPair(const unsigned int i, const unsigned int j, const unsigned int speciesPair)
+  {
+    myI = i;
+    myJ = j;
+    mySpeciesPair = speciesPair;
+  }
+
+  inline void operator()(const ::arma::vec3 & r, const double /*rSq*/)
+  {
+    myImages.x.push_back(r(0));
+    myImages.y.push_back(r(1));
+    myImages.z.push_back(r(2));
+    myImages.speciesPair.push_back(mySpeciesPair);
+    myImages.i.push_back(myI);
+    myImages.j.push_back(myJ);
+  }
+
+private:
+  SimplePairPotentialBatchData::Images & myImages;
+  unsigned int myI, myJ, mySpeciesPair;
+};
+
+}
+
 // Using 0.5 prefactor as 2^(1/6) s is the equilibrium separation of the centres.
 // i.e. the diameter
 const double SimplePairPotential::RADIUS_FACTOR = 0.5 * ::std::pow(2, 1.0/6.0);
@@ -187,28 +312,42 @@ void SimplePairPotential::setParams(const IParameterisable::PotentialParams & pa
   // Initialise the cutoff matrices
   initCutoff(myCutoffFactor);
 
-	// Reset the parameter string
-	myParamString.clear();
   // Update the species database
   updateSpeciesDb();
 }
 
 bool SimplePairPotential::evaluate(const common::Structure & structure, SimplePairPotentialData & data) const
 {
-	using ::std::vector;
+  if(data.precision == PotentialData::Precision::MIXED)
+    return doEvaluate<float>(structure, data);
+  else
+    return doEvaluate<double>(structure, data);
+}
+
+template <typename FloatType>
+bool SimplePairPotential::doEvaluate(const common::Structure & structure, SimplePairPotentialData & data) const
+{
+  // The pair terms are calculated using FloatType but the system values are
+  // always accumulated in double precision
+  const FloatType m = static_cast<FloatType>(myM);
+  const FloatType n = static_cast<FloatType>(myN);
 
-	double rSq;
-	double sigmaOModR, invRM, invRN;
-	double dE, modR, modF;
   size_t speciesI, speciesJ;  // Species indices
-	::arma::vec3 r, f;        // Displacement and force vectors
   ::arma::vec3 posI, posJ;  // Position vectors
 
 	resetAccumulators(data);
 
-	vector< ::arma::vec3> imageVectors;
-
+  // Get the images of each species pair once, after that each pair of
+  // particles is visited without any virtual calls or allocations
   const common::DistanceCalculator & distCalc = structure.getDistanceCalculator();
+  ::std::vector<common::PairImages> pairImages(myNumSpecies * myNumSpecies);
+  for(size_t sI = 0; sI < myNumSpecies; ++sI)
+  {
+    for(size_t sJ = 0; sJ < myNumSpecies; ++sJ)
+      distCalc.getPairImages(pairImages[sI + sJ * myNumSpecies], rCutoff(sI, sJ));
+  }
+
+  PairTermAccumulator<FloatType> accumulator(data, m, n, MIN_SEPARATION_SQ);
 	
   bool problemDuringCalculation = false;
 
@@ -229,63 +368,21 @@ bool SimplePairPotential::evaluate(const common::Structure & structure, SimplePa
 
 			posJ = data.pos.col(j);
 
-      // TODO: Buffer rSqs as getAllVectorsWithinCutoff needs to calculate it anyway!
-			imageVectors.clear();
-      if(!distCalc.getVecsBetween(posI, posJ, rCutoff(speciesI, speciesJ), imageVectors, MAX_INTERACTION_VECTORS, MAX_CELL_MULTIPLES))
+      accumulator.setPair(
+        i,
+        j,
+        static_cast<FloatType>(myEpsilon(speciesI, speciesJ)),
+        static_cast<FloatType>(mySigma(speciesI, speciesJ)),
+        static_cast<FloatType>(myBeta(speciesI, speciesJ)),
+        static_cast<FloatType>(rCutoff(speciesI, speciesJ)),
+        static_cast<FloatType>(eShift(speciesI, speciesJ)),
+        static_cast<FloatType>(fShift(speciesI, speciesJ))
+      );
+      if(!pairImages[speciesI + speciesJ * myNumSpecies].forEachImage(posI, posJ, accumulator, MAX_INTERACTION_VECTORS))
       {
         // We reached the maximum number of interaction vectors so indicate that there was a problem
         problemDuringCalculation = true;
       }
-
-      BOOST_FOREACH(r, imageVectors)
-			{			
-				// Get the distance squared
-				rSq = dot(r, r);
-
-				// Check that distance isn't near the 0 as this will cause near-singular values
-				if(rSq > MIN_SEPARATION_SQ)
-				{
-					modR = sqrt(rSq);
-
-					sigmaOModR = mySigma(speciesI, speciesJ) / modR;
-
-					invRM = pow(sigmaOModR, myM);
-					invRN = pow(sigmaOModR, myN) * myBeta(speciesI, speciesJ);
-
-					// Calculate the energy delta
-					dE = 2.0 * myEpsilon(speciesI, speciesJ) * (invRM - invRN) -
-						eShift(speciesI, speciesJ) + (modR - rCutoff(speciesI, speciesJ)) * fShift(speciesI, speciesJ);
-
-					// Magnitude of the force
-					modF = 2.0 *  myEpsilon(speciesI, speciesJ) *
-						(myM * invRM - myN * invRN) / modR - fShift(speciesI, speciesJ);
-					f = modF / modR * r;
-
-					// Make sure we get energy/force correct for self-interaction
-					if(i != j)
-					{
-						f *= 2.0;
-						dE *= 2.0;
-					}
-
-					// Update system values
-					// energy
-					data.internalEnergy += dE;
-					// force
-					data.forces.col(i) -= f;
-					if(i != j)
-						data.forces.col(j) += f;
-					
-					// stress, diagonal is element wise multiplication of force and position
-					// vector components
-					data.stressMtx.diag() += f % r;
-					
-					data.stressMtx(1, 2) += 0.5 * (f(1)*r(2)+f(2)*r(1));
-					data.stressMtx(2, 0) += 0.5 * (f(2)*r(0)+f(0)*r(2));
-					data.stressMtx(0, 1) += 0.5 * (f(0)*r(1)+f(1)*r(0));
-
-				}
-			}
 		}
 	}
 
@@ -308,6 +405,205 @@ bool SimplePairPotential::evaluate(const common::Structure & structure, SimplePa
 }
 
 
+bool SimplePairPotential::evaluate(SimplePairPotentialBatchData & data) const
+{
+  SimplePairPotentialBatchData::Images & images = data.images;
+  const size_t numStructures = data.getNumStructures();
+
+  // Gather the interaction vectors of all the active structures
+  images.clear();
+  images.offsets.resize(numStructures + 1);
+  for(size_t str = 0; str < numStructures; ++str)
+  {
+    images.offsets[str] = images.x.size();
+    if(data.active[str])
+      gatherImages(data, str);
+  }
+  images.offsets[numStructures] = images.x.size();
+  images.energy.resize(images.x.size());
+  images.forceOverR.resize(images.x.size());
+
+  // Calculate the pair terms, the images of each structure are contiguous so
+  // this is one pass through the buffers done at each structure's precision
+  for(size_t str = 0; str < numStructures; ++str)
+  {
+    if(!data.active[str])
+      continue;
+
+    if(data.precision[str] == PotentialData::Precision::MIXED)
+      evaluateImages<float>(images, images.offsets[str], images.offsets[str + 1]);
+    else
+      evaluateImages<double>(images, images.offsets[str], images.offsets[str + 1]);
+  }
+
+  // Finally accumulate the system values
+  bool allOk = true;
+  for(size_t str = 0; str < numStructures; ++str)
+  {
+    if(!data.active[str])
+      continue;
+
+    accumulateImages(data, str);
+    allOk = allOk && data.evaluationOk[str];
+  }
+  return allOk;
+}
+
+template <typename FloatType>
+void SimplePairPotential::evaluateImages(
+  SimplePairPotentialBatchData::Images & images,
+  const size_t first,
+  const size_t last) const
+{
+  if(first == last)
+    return;
+
+  // As for doEvaluate the pair terms are calculated using FloatType
+  const FloatType m = static_cast<FloatType>(myM);
+  const FloatType n = static_cast<FloatType>(myN);
+
+  // The parameter matrices are indexed directly using the species pair index
+  const double * const epsilon = myEpsilon.memptr();
+  const double * const sigma = mySigma.memptr();
+  const double * const beta = myBeta.memptr();
+  const double * const rCut = rCutoff.memptr();
+  const double * const eShiftIJ = eShift.memptr();
+  const double * const fShiftIJ = fShift.memptr();
+
+  const double * const x = &images.x[0];
+  const double * const y = &images.y[0];
+  const double * const z = &images.z[0];
+  const unsigned int * const pair = &images.speciesPair[0];
+  double * const energy = &images.energy[0];
+  double * const forceOverR = &images.forceOverR[0];
+
+  unsigned int p;
+  double rSq;
+	FloatType modR, sigmaOModR, invRM, invRN, eps;
+  for(size_t k = first; k < last; ++k)
+  {
+    p = pair[k];
+    rSq = x[k] * x[k] + y[k] * y[k] + z[k] * z[k];
+
+		// Check that distance isn't near the 0 as this will cause near-singular values
+    if(rSq > MIN_SEPARATION_SQ)
+    {
+      modR = ::std::sqrt(static_cast<FloatType>(rSq));
+      sigmaOModR = static_cast<FloatType>(sigma[p]) / modR;
+      eps = static_cast<FloatType>(epsilon[p]);
+
+      invRM = ::std::pow(sigmaOModR, m);
+      invRN = ::std::pow(sigmaOModR, n) * static_cast<FloatType>(beta[p]);
+
+      energy[k] = 2 * eps * (invRM - invRN) - static_cast<FloatType>(eShiftIJ[p]) +
+        (modR - static_cast<FloatType>(rCut[p])) * static_cast<FloatType>(fShiftIJ[p]);
+      forceOverR[k] = (2 * eps * (m * invRM - n * invRN) / modR - static_cast<FloatType>(fShiftIJ[p])) / modR;
+    }
+    else
+    {
+      energy[k] = 0.0;
+      forceOverR[k] = 0.0;
+    }
+  }
+}
+
+void SimplePairPotential::gatherImages(SimplePairPotentialBatchData & data, const size_t str) const
+{
+  SimplePairPotentialBatchData::Images & images = data.images;
+  const common::DistanceCalculator & distCalc = data.structures[str]->getDistanceCalculator();
+  const size_t first = data.getFirstParticle(str);
+  const size_t last = first + data.getNumParticles(str);
+
+  int speciesI, speciesJ;
+  ::arma::vec3 posI, posJ;
+
+  ::std::vector<common::PairImages> pairImages(myNumSpecies * myNumSpecies);
+  for(size_t sI = 0; sI < myNumSpecies; ++sI)
+  {
+    for(size_t sJ = 0; sJ < myNumSpecies; ++sJ)
+      distCalc.getPairImages(pairImages[sI + sJ * myNumSpecies], rCutoff(sI, sJ));
+  }
+  ImageGatherer gatherer(images);
+
+  data.evaluationOk[str] = true;
+	for(size_t i = first; i < last; ++i)
+	{
+		speciesI = data.species[i];
+    if(speciesI == SimplePairPotentialBatchData::IGNORE_ATOM)
+      continue;
+
+		posI = data.pos.col(i);
+
+		for(size_t j = i; j < last; ++j)
+		{
+			speciesJ = data.species[j];
+      if(speciesJ == SimplePairPotentialBatchData::IGNORE_ATOM)
+        continue;
+
+			posJ = data.pos.col(j);
+
+      const unsigned int pair = speciesI + speciesJ * myNumSpecies;
+      gatherer.setPair(i, j, pair);
+      if(!pairImages[pair].forEachImage(posI, posJ, gatherer, MAX_INTERACTION_VECTORS))
+        data.evaluationOk[str] = false;
+    }
+  }
+}
+
+void SimplePairPotential::accumulateImages(SimplePairPotentialBatchData & data, const size_t str) const
+{
+  const SimplePairPotentialBatchData::Images & images = data.images;
+
+  double & internalEnergy = data.internalEnergy[str];
+  ::arma::mat33 & stressMtx = data.stressMtx[str];
+  double * const forces = data.forces.memptr();
+
+  internalEnergy = 0.0;
+  stressMtx.zeros();
+  for(size_t i = 3 * data.getFirstParticle(str); i < 3 * data.offsets[str + 1]; ++i)
+    forces[i] = 0.0;
+
+  size_t i, j;
+  double factor, dE, f[3], r[3];
+  for(size_t k = images.offsets[str]; k < images.offsets[str + 1]; ++k)
+  {
+    i = images.i[k];
+    j = images.j[k];
+
+		// Make sure we get energy/force correct for self-interaction
+    factor = i == j ? 1.0 : 2.0;
+
+    r[0] = images.x[k];
+    r[1] = images.y[k];
+    r[2] = images.z[k];
+    dE = factor * images.energy[k];
+    for(size_t d = 0; d < 3; ++d)
+      f[d] = factor * images.forceOverR[k] * r[d];
+
+    internalEnergy += dE;
+    for(size_t d = 0; d < 3; ++d)
+    {
+      forces[3 * i + d] -= f[d];
+      if(i != j)
+        forces[3 * j + d] += f[d];
+      stressMtx(d, d) += f[d] * r[d];
+    }
+		stressMtx(1, 2) += 0.5 * (f[1]*r[2]+f[2]*r[1]);
+		stressMtx(2, 0) += 0.5 * (f[2]*r[0]+f[0]*r[2]);
+		stressMtx(0, 1) += 0.5 * (f[0]*r[1]+f[1]*r[0]);
+  }
+
+	// Symmetrise stress matrix
+	stressMtx(2, 1) = stressMtx(1, 2);
+	stressMtx(0, 2) = stressMtx(2, 0);
+	stressMtx(1, 0) = stressMtx(0, 1);
+
+  const common::UnitCell * const unitCell = data.structures[str]->getUnitCell();
+  if(unitCell)
+	  stressMtx *= 1.0 / unitCell->getVolume();
+}
+
+
 ::boost::optional<double>
 SimplePairPotential::getPotentialRadius(const ::sstbx::common::AtomSpeciesId::Value id) const
 {
@@ -334,6 +630,14 @@ SimplePairPotential::createEvaluator(const sstbx::common::Structure & structure)
   return ::boost::shared_ptr<IPotentialEvaluator>(new Evaluator(*this, structure, data));
 }
 
+::boost::shared_ptr<IBatchPotentialEvaluator>
+SimplePairPotential::createBatchEvaluator(const PotentialBatchData::Structures & structures) const
+{
+  ::std::auto_ptr<SimplePairPotentialBatchData> data(new SimplePairPotentialBatchData(structures, mySpeciesList));
+
+  return ::boost::shared_ptr<IBatchPotentialEvaluator>(new BatchEvaluator(*this, data));
+}
+
 IParameterisable * SimplePairPotential::getParameterisable()
 {
   return this;
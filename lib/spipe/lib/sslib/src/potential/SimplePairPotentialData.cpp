@@ -16,20 +16,22 @@
 namespace sstbx {
 namespace potential {
 
-SimplePairPotentialData::SimplePairPotentialData(
+namespace {
+
+// Put the index in the species list of each atom of the structure into species,
+// starting at first
+void mapSpecies(
   const sstbx::common::Structure & structure,
-  const SimplePairPotentialData::SpeciesList & speciesList):
-PotentialData(structure)
+  const SimplePairPotentialData::SpeciesList & speciesList,
+  ::std::vector<int> & species,
+  const size_t first)
 {
   using sstbx::common::AtomSpeciesId;
 
 	// Get the atom species
-  std::vector<AtomSpeciesId::Value> strSpecies;
-	structure.getAtomSpecies(strSpecies);
+  const std::vector<AtomSpeciesId::Value> & strSpecies = structure.getAtomSpecies();
 
-	// Now populate our species vector
   const size_t numAtoms = strSpecies.size();
-	species.resize(numAtoms);
 
   bool found;
   const size_t numSpecies = speciesList.size();
@@ -43,18 +45,51 @@ PotentialData(structure)
       if(currentSpecies == speciesList[j])
       {
         found = true;
-        species[i] = j;
+        species[first + i] = j;
         break;
       }
     }
     if(!found)
     {
-      species[i] = IGNORE_ATOM;
+      species[first + i] = SimplePairPotentialData::IGNORE_ATOM;
     }
   }
+}
 
 }
 
+SimplePairPotentialData::SimplePairPotentialData(
+  const sstbx::common::Structure & structure,
+  const SimplePairPotentialData::SpeciesList & speciesList):
+PotentialData(structure)
+{
+	// Now populate our species vector
+	species.resize(numParticles);
+  mapSpecies(structure, speciesList, species, 0);
+}
+
+SimplePairPotentialBatchData::SimplePairPotentialBatchData(
+  const Structures & structures,
+  const SpeciesList & speciesList):
+PotentialBatchData(structures)
+{
+  species.resize(numParticles);
+  for(size_t i = 0; i < getNumStructures(); ++i)
+    mapSpecies(*structures[i], speciesList, species, getFirstParticle(i));
+}
+
+void SimplePairPotentialBatchData::Images::clear()
+{
+  offsets.clear();
+  x.clear();
+  y.clear();
+  z.clear();
+  speciesPair.clear();
+  i.clear();
+  j.clear();
+  energy.clear();
+  forceOverR.clear();
+}
 
 }
 }
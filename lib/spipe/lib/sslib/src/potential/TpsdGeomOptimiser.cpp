@@ -8,8 +8,11 @@
 // INCLUDES //////////////////////////////////
 #include "potential/TpsdGeomOptimiser.h"
 
+#include <algorithm>
 #include <sstream>
 
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include "SSLib.h"
 #include "common/UnitCell.h"
 #include "potential/OptimisationSettings.h"
@@ -50,6 +53,96 @@ private:
 #endif
 
 
+namespace {
+
+// Add the mean force to each particle, operates on the raw 3xN force data
+void balanceForces(double * const f, const size_t numParticles)
+{
+  if(numParticles == 0)
+    return;
+
+  double mean[3] = {0.0, 0.0, 0.0};
+  for(size_t i = 0; i < numParticles; ++i)
+  {
+    mean[0] += f[3 * i];
+    mean[1] += f[3 * i + 1];
+    mean[2] += f[3 * i + 2];
+  }
+  for(size_t j = 0; j < 3; ++j)
+    mean[j] /= static_cast<double>(numParticles);
+
+  for(size_t i = 0; i < numParticles; ++i)
+  {
+    f[3 * i]     += mean[0];
+    f[3 * i + 1] += mean[1];
+    f[3 * i + 2] += mean[2];
+  }
+}
+
+void balanceForces(::arma::mat & forces)
+{
+  balanceForces(forces.memptr(), forces.n_cols);
+}
+
+// Accumulate sum(deltaPos . deltaF) and sum(deltaF . deltaF), where deltaF = forces - f0,
+// in one pass without creating deltaF
+void accumulateStepTerms(
+  double & xg,
+  double & gg,
+  const double * const dPos,
+  const double * const f,
+  const double * const fOld,
+  const size_t numElements)
+{
+  double deltaF;
+  for(size_t i = 0; i < numElements; ++i)
+  {
+    deltaF = f[i] - fOld[i];
+    xg += dPos[i] * deltaF;
+    gg += deltaF * deltaF;
+  }
+}
+
+void accumulateStepTerms(
+  double & xg,
+  double & gg,
+  const ::arma::mat & deltaPos,
+  const ::arma::mat & forces,
+  const ::arma::mat & f0)
+{
+  accumulateStepTerms(xg, gg, deltaPos.memptr(), forces.memptr(), f0.memptr(), forces.n_elem);
+}
+
+// Move the particles along the forces by step, saving the displacement and the
+// forces used for the next step's differences
+void takeStep(
+  const double step,
+  double * const p,
+  double * const dPos,
+  double * const fOld,
+  const double * const f,
+  const size_t numElements)
+{
+  for(size_t i = 0; i < numElements; ++i)
+  {
+    dPos[i] = step * f[i];
+    p[i] += dPos[i];
+    fOld[i] = f[i];
+  }
+}
+
+void takeStep(
+  const double step,
+  ::arma::mat & pos,
+  ::arma::mat & deltaPos,
+  ::arma::mat & f0,
+  const ::arma::mat & forces)
+{
+  takeStep(step, pos.memptr(), deltaPos.memptr(), f0.memptr(), forces.memptr(), forces.n_elem);
+}
+
+}
+
 // CONSTANTS ////////////////////////////////////////////////
 
 const unsigned int TpsdGeomOptimiser::DEFAULT_MAX_STEPS = 50000;
@@ -58,6 +151,9 @@ const unsigned int TpsdGeomOptimiser::CHECK_CELL_EVERY_N_STEPS = 20;
 const double TpsdGeomOptimiser::CELL_MIN_NORM_VOLUME = 0.02;
 const double TpsdGeomOptimiser::CELL_MAX_ANGLE_SUM = 355.0;
 const double TpsdGeomOptimiser::MAX_STEPSIZE = 10.0;
+// Relative energy change below which mixed precision is switched to double,
+// roughly two orders of magnitude above single precision epsilon
+const double TpsdGeomOptimiser::MIXED_PRECISION_SWITCH = 1e-5;
 
 // IMPLEMENTATION //////////////////////////////////////////////////////////
 
@@ -65,7 +161,8 @@ const double TpsdGeomOptimiser::MAX_STEPSIZE = 10.0;
 TpsdGeomOptimiser::TpsdGeomOptimiser(PotentialPtr potential):
 myPotential(potential),
 myTolerance(DEFAULT_TOLERANCE),
-myMaxSteps(DEFAULT_MAX_STEPS)
+myMaxSteps(DEFAULT_MAX_STEPS),
+myMixedPrecision(false)
 {}
 
 double TpsdGeomOptimiser::getTolerance() const
@@ -88,6 +185,16 @@ void TpsdGeomOptimiser::setMaxSteps(const unsigned int maxSteps)
   myMaxSteps = maxSteps;
 }
 
+bool TpsdGeomOptimiser::getMixedPrecision() const
+{
+  return myMixedPrecision;
+}
+
+void TpsdGeomOptimiser::setMixedPrecision(const bool mixedPrecision)
+{
+  myMixedPrecision = mixedPrecision;
+}
+
 IPotential * TpsdGeomOptimiser::getPotential()
 {
 	return myPotential.get();
@@ -115,15 +222,8 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
   ::boost::shared_ptr<IPotentialEvaluator> evaluator = myPotential->createEvaluator(structure);
 
   common::UnitCell * const unitCell = structure.getUnitCell();
-  OptimisationSettings localSettings = options;
-  
-  if(!localSettings.maxSteps)
-    localSettings.maxSteps.reset(myMaxSteps);
-  if(!localSettings.pressure)
-    localSettings.pressure.reset(::arma::zeros< ::arma::mat>(3, 3));
-  if(!localSettings.optimisationType)
-    localSettings.optimisationType.reset(OptimisationSettings::Optimise::ATOMS_AND_LATTICE);
-  
+  const OptimisationSettings localSettings = getLocalSettings(options);
+
   OptimisationOutcome outcome;
   if(unitCell)
   {
@@ -166,16 +266,13 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
 
 	double h, h0, dH;
 
-	// Position matrices, current are in data.myPos
-  ::arma::mat deltaPos(3, data.numParticles);
-	// Forces, current are in data.myForces
-  ::arma::mat f0(3, data.numParticles), deltaF(3, data.numParticles);
+  // Position changes and the forces from the last step
+  Workspace work(data.numParticles);
 
 	double xg, gg;
-  ::arma::vec3 f;
 
 	data.forces.ones();
-	deltaPos.zeros();
+  data.precision = myMixedPrecision ? PotentialData::Precision::MIXED : PotentialData::Precision::DOUBLE;
 
 	// Initialisation of variables
 	dH	= std::numeric_limits<double>::max();
@@ -188,9 +285,8 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
 	double step = 0.2;
 	for(size_t i = 0; !converged && i < *settings.maxSteps; ++i)
 	{
-    // Save the energy and forces from last time around
+    // Save the energy from last time around, the forces are saved when taking the step
 		h0 = h;
-		f0 = data.forces;
 
 		// Evaluate the potential
 		if(!evaluator.evalPotential().second)
@@ -207,37 +303,28 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
 
 		// Now balance forces
 		// (do sum of values for each component and divide by number of particles)
-		f = sum(data.forces, 1) / data.numParticles;
-
-		data.forces.row(0) += f(0);
-		data.forces.row(1) += f(1);
-		data.forces.row(2) += f(2);
+    balanceForces(data.forces);
 
 		h = data.internalEnergy;
 
-		deltaF = data.forces - f0;
-
-    // The accu function will do the sum of all elements
-    // and the % operator does the Shure product i.e.
-    // element wise multiplication of two matrices
-	  xg		= accu(deltaPos % deltaF);
-	  gg		= accu(deltaF % deltaF);
+    // Sum of the element wise products of the position and force changes
+    xg = gg = 0.0;
+    accumulateStepTerms(xg, gg, work.deltaPos, data.forces, work.f0);
 
 		if(fabs(xg) > 0.0)
       step = ::std::min(fabs(xg / gg), MAX_STEPSIZE);
 
 		// Move the particles on by a step, saving the old positions
-		deltaPos		= step * data.forces;
-		data.pos		+= deltaPos;
-
-    // Tell the structure about the new positions
-    structure.setAtomPositions(data.pos);
+    takeStep(step, data.pos, work.deltaPos, work.f0, data.forces);
 
 		dH = h - h0;
 
-		converged = fabs(dH) < eTol;
+		converged = hasConverged(data.precision, h, dH, eTol);
 	}
 
+  // Tell the structure about the new positions
+  structure.setAtomPositions(data.pos);
+
   // Only a successful optimisation if it has converged
   // and the last potential evaluation had no problems
   if(numLastEvaluationsWithProblem != 0)
@@ -279,18 +366,15 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
 
 	// Stress matrices
   ::arma::mat33	s, s0, deltaS, deltaLatticeCar;
-	// Position matrices, current are in data.myPos
-  ::arma::mat deltaPos(3, data.numParticles);
-	// Forces, current are in data.myForces
-  ::arma::mat f0(3, data.numParticles), deltaF(3, data.numParticles);
+  // Position changes, the forces from the last step and fractional positions
+  Workspace work(data.numParticles);
 
   ::arma::mat33 latticeCar;
 	double gamma, volume, volumeSq/*, gammaNumIonsOVolume*/;
 	double xg, gg;
-  ::arma::vec3 f;
 
 	data.forces.ones();
-	deltaPos.zeros();
+  data.precision = myMixedPrecision ? PotentialData::Precision::MIXED : PotentialData::Precision::DOUBLE;
 	deltaLatticeCar.zeros();
 	latticeCar = unitCell.getOrthoMtx();
 
@@ -308,7 +392,6 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
 	for(unsigned int i = 0; !converged && i < *settings.maxSteps; ++i)
 	{
 		h0 = h;
-		f0 = data.forces;
 		s0 = s;
 
 		volume		= unitCell.getVolume();
@@ -329,11 +412,7 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
 
 		// Now balance forces
 		// (do sum of values for each component and divide by number of particles)
-		f = sum(data.forces, 1) / data.numParticles;
-
-		data.forces.row(0) += f(0);
-		data.forces.row(1) += f(1);
-		data.forces.row(2) += f(2);
+    balanceForces(data.forces);
 
 		// TODO: Check this gamma = 0 as it seems a little odd
 		gamma = 0.0;
@@ -347,16 +426,11 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
     // Calculate the enthalpy
 		h = data.internalEnergy + pressureMean * volume;
 
-		deltaF	= data.forces - f0;
-
     xg = gg = 0.0;
     if(*settings.optimisationType & OptimisationSettings::Optimise::ATOMS)
     {
-		  // The accu function will do the sum of all elements
-		  // and the % operator does the Shure product i.e.
-		  // element wise multiplication of two matrices
-		  xg		= accu(deltaPos % deltaF);
-		  gg		= accu(deltaF % deltaF);
+      // Sum of the element wise products of the position and force changes
+      accumulateStepTerms(xg, gg, work.deltaPos, data.forces, work.f0);
     }
 
 		deltaS	= s - s0;
@@ -373,13 +447,15 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
     if(*settings.optimisationType & OptimisationSettings::Optimise::ATOMS)
     {
 		  // Move the particles on by a step, saving the old positions
-		  deltaPos		= step * data.forces;
-		  data.pos		+= deltaPos;
+      takeStep(step, data.pos, work.deltaPos, work.f0, data.forces);
     }
+    else
+      work.f0 = data.forces;
 
-		// Fractionalise coordinates and wrap coordinates
-    unitCell.cartsToFracInplace(data.pos);
-    unitCell.wrapVecsFracInplace(data.pos);
+		// Fractionalise coordinates and wrap coordinates, the workspace is used as
+    // the destination so the multiplication doesn't need a temporary
+    work.fracs = unitCell.getFracMtx() * data.pos;
+    unitCell.wrapVecsFracInplace(work.fracs);
 
     if(*settings.optimisationType & OptimisationSettings::Optimise::LATTICE)
     {
@@ -397,21 +473,21 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
     }
 
 		// Finally re-orthogonalise the ion positions
-    unitCell.fracsToCartInplace(data.pos);
-
-    // Tell the structure about the new positions
-    structure.setAtomPositions(data.pos);
+    data.pos = unitCell.getOrthoMtx() * work.fracs;
 
 		dH = h - h0;
 
-		converged = fabs(dH) < eTol;
+		converged = hasConverged(data.precision, h, dH, eTol);
 
 #if TPSD_GEOM_OPTIMISER_DEBUG
+    // The debugger looks at the structure so it needs the current positions
+    structure.setAtomPositions(data.pos);
     debugger.postOptStepDebugHook(structure, i);
 #endif
 
 		if((i % CHECK_CELL_EVERY_N_STEPS == 0) && !cellReasonable(unitCell))
     {
+      structure.setAtomPositions(data.pos);
       return OptimisationOutcome::failure(
         OptimisationError::PROBLEM_WITH_STRUCTURE,
         "Unit cell has collapsed."
@@ -422,6 +498,10 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
 	// Wrap the particle positions so they stay in the central unit cell
 	unitCell.wrapVecsInplace(data.pos);
 
+  // Tell the structure about the new positions, this is only done once at the end
+  // as nothing looks at the structure during the optimisation
+  structure.setAtomPositions(data.pos);
+
   // Only a successful optimisation if it has converged
   // and the last potential evaluation had no problems
   if(numLastEvaluationsWithProblem != 0)
@@ -437,6 +517,292 @@ OptimisationOutcome TpsdGeomOptimiser::optimise(
   return OptimisationOutcome::success();
 }
 
+struct TpsdGeomOptimiser::BatchEntry
+{
+  BatchEntry(common::Structure & structure, const size_t numParticles, const double eTol);
+
+  common::Structure & structure;
+  common::UnitCell * const unitCell;
+  Workspace work;
+  double h;
+  double step;
+  // Strain and lattice, only used for periodic structures
+  ::arma::mat33 s;
+  ::arma::mat33 latticeCar;
+  ::arma::mat33 deltaLatticeCar;
+  size_t numLastEvaluationsWithProblem;
+};
+
+TpsdGeomOptimiser::BatchEntry::BatchEntry(
+  common::Structure & structure_,
+  const size_t numParticles,
+  const double eTol):
+structure(structure_),
+unitCell(structure_.getUnitCell()),
+work(numParticles),
+h(1.0),
+// Same initial step sizes as the single structure optimisations
+step(unitCell ? eTol * 1e8 : 0.2),
+numLastEvaluationsWithProblem(0)
+{
+  s.ones();
+  deltaLatticeCar.zeros();
+  if(unitCell)
+    latticeCar = unitCell->getOrthoMtx();
+}
+
+void TpsdGeomOptimiser::optimise(
+  const Structures & structures,
+  ::std::vector<OptimisationOutcome> & outcomes,
+  const OptimisationSettings & options) const
+{
+  outcomes.resize(structures.size());
+
+  const PotentialBatchData::Structures batchStructures(structures.begin(), structures.end());
+  ::boost::shared_ptr<IBatchPotentialEvaluator> evaluator =
+    myPotential->createBatchEvaluator(batchStructures);
+  if(!evaluator.get())
+  {
+    for(size_t i = 0; i < structures.size(); ++i)
+      outcomes[i] = optimise(*structures[i], options);
+    return;
+  }
+
+  const OptimisationSettings localSettings = getLocalSettings(options);
+
+  PotentialBatchData & data = evaluator->getData();
+
+  ::boost::ptr_vector<BatchEntry> entries;
+	data.forces.ones();
+  for(size_t i = 0; i < structures.size(); ++i)
+  {
+    entries.push_back(new BatchEntry(*structures[i], data.getNumParticles(i), myTolerance));
+    data.precision[i] = myMixedPrecision ? PotentialData::Precision::MIXED : PotentialData::Precision::DOUBLE;
+  }
+
+  size_t numActive = structures.size();
+  for(unsigned int i = 0; numActive != 0 && i < *localSettings.maxSteps; ++i)
+  {
+    evaluator->evalPotential();
+
+    for(size_t str = 0; str < structures.size(); ++str)
+    {
+      if(data.active[str] && batchStep(entries[str], data, str, i, localSettings, outcomes[str]))
+      {
+        // Retire the structure so it isn't evaluated any more
+        data.active[str] = false;
+        --numActive;
+      }
+    }
+  }
+
+  // Any structures left have run out of steps
+  for(size_t str = 0; str < structures.size(); ++str)
+  {
+    if(data.active[str])
+      finishBatchEntry(entries[str], data, str, false, localSettings, outcomes[str]);
+  }
+}
+
+OptimisationSettings TpsdGeomOptimiser::getLocalSettings(const OptimisationSettings & options) const
+{
+  OptimisationSettings localSettings = options;
+
+  if(!localSettings.maxSteps)
+    localSettings.maxSteps.reset(myMaxSteps);
+  if(!localSettings.pressure)
+    localSettings.pressure.reset(::arma::zeros< ::arma::mat>(3, 3));
+  if(!localSettings.optimisationType)
+    localSettings.optimisationType.reset(OptimisationSettings::Optimise::ATOMS_AND_LATTICE);
+
+  return localSettings;
+}
+
+bool TpsdGeomOptimiser::hasConverged(
+  PotentialData::Precision::Value & precision,
+  const double h,
+  const double dH,
+  const double eTol) const
+{
+  if(precision == PotentialData::Precision::DOUBLE)
+    return fabs(dH) < eTol;
+
+  // Can't converge in mixed precision, switch to double once the energy
+  // changes are getting down to the level of single precision noise.  The
+  // tolerance is a floor for when the energy itself is (close to) zero.
+  if(fabs(dH) < ::std::max(MIXED_PRECISION_SWITCH * fabs(h), eTol))
+    precision = PotentialData::Precision::DOUBLE;
+  return false;
+}
+
+// Does one step for one of the structures in a batch, this is the same as one
+// iteration of the single structure optimise loops.  Returns true if the structure
+// has finished in which case outcome is set.
+bool TpsdGeomOptimiser::batchStep(
+  BatchEntry & entry,
+  PotentialBatchData & data,
+  const size_t str,
+  const unsigned int iteration,
+  const OptimisationSettings & settings,
+  OptimisationOutcome & outcome) const
+{
+  common::UnitCell * const unitCell = entry.unitCell;
+  const size_t numParticles = data.getNumParticles(str);
+  const size_t first = data.getFirstParticle(str);
+  double * const pos = numParticles == 0 ? NULL : data.pos.colptr(first);
+  double * const forces = numParticles == 0 ? NULL : data.forces.colptr(first);
+
+  // Clusters always have their atoms optimised
+  const bool optimiseAtoms =
+    !unitCell || (*settings.optimisationType & OptimisationSettings::Optimise::ATOMS);
+  const bool optimiseLattice =
+    unitCell && (*settings.optimisationType & OptimisationSettings::Optimise::LATTICE);
+
+  if(!data.evaluationOk[str])
+    ++entry.numLastEvaluationsWithProblem;
+  else
+    entry.numLastEvaluationsWithProblem = 0;
+
+  balanceForces(forces, numParticles);
+
+  const double h0 = entry.h;
+  entry.h = data.internalEnergy[str];
+
+  ::arma::mat33 s0;
+  if(unitCell)
+  {
+    s0 = entry.s;
+    entry.s = data.stressMtx[str] * entry.latticeCar;
+    entry.h += ::arma::trace(*settings.pressure) / 3.0 * unitCell->getVolume();
+  }
+
+  double xg = 0.0, gg = 0.0;
+  if(optimiseAtoms)
+  {
+    accumulateStepTerms(
+      xg, gg, entry.work.deltaPos.memptr(), forces, entry.work.f0.memptr(), 3 * numParticles
+    );
+  }
+  if(optimiseLattice)
+  {
+    const ::arma::mat33 deltaS = entry.s - s0;
+    xg += accu(entry.deltaLatticeCar % deltaS);
+    gg += accu(deltaS % deltaS);
+  }
+
+  if(fabs(xg) > 0.0)
+    entry.step = ::std::min(fabs(xg / gg), MAX_STEPSIZE);
+
+  if(optimiseAtoms)
+  {
+    takeStep(
+      entry.step, pos, entry.work.deltaPos.memptr(), entry.work.f0.memptr(), forces, 3 * numParticles
+    );
+  }
+  else
+    ::std::copy(forces, forces + 3 * numParticles, entry.work.f0.memptr());
+
+  if(unitCell && numParticles != 0)
+  {
+    entry.work.fracs = unitCell->getFracMtx() * data.pos.cols(first, first + numParticles - 1);
+    unitCell->wrapVecsFracInplace(entry.work.fracs);
+  }
+
+  if(optimiseLattice)
+  {
+    entry.deltaLatticeCar = entry.step * (entry.s - *settings.pressure * entry.latticeCar);
+    settings.applyLatticeConstraints(entry.structure, entry.latticeCar, entry.deltaLatticeCar);
+    entry.latticeCar += entry.deltaLatticeCar;
+
+    if(!unitCell->setOrthoMtx(entry.latticeCar))
+    {
+      // The unit cell matrix has become singular
+      finishBatchEntry(entry, data, str, false, settings, outcome);
+      return true;
+    }
+  }
+
+  if(unitCell && numParticles != 0)
+    data.pos.cols(first, first + numParticles - 1) = unitCell->getOrthoMtx() * entry.work.fracs;
+
+  const bool converged = hasConverged(data.precision[str], entry.h, entry.h - h0, myTolerance);
+
+  if(unitCell && (iteration % CHECK_CELL_EVERY_N_STEPS == 0) && !cellReasonable(*unitCell))
+  {
+    if(numParticles != 0)
+      entry.structure.setAtomPositions(data.pos.cols(first, first + numParticles - 1));
+    OptimisationData().saveToStructure(entry.structure);
+    outcome = OptimisationOutcome::failure(
+      OptimisationError::PROBLEM_WITH_STRUCTURE,
+      "Unit cell has collapsed."
+    );
+    return true;
+  }
+
+  if(converged)
+  {
+    finishBatchEntry(entry, data, str, true, settings, outcome);
+    return true;
+  }
+
+  return false;
+}
+
+void TpsdGeomOptimiser::finishBatchEntry(
+  BatchEntry & entry,
+  const PotentialBatchData & data,
+  const size_t str,
+  const bool converged,
+  const OptimisationSettings & settings,
+  OptimisationOutcome & outcome) const
+{
+  const size_t numParticles = data.getNumParticles(str);
+  const size_t first = data.getFirstParticle(str);
+
+  OptimisationData optimisationData;
+  if(numParticles != 0)
+  {
+    ::arma::mat pos = data.pos.cols(first, first + numParticles - 1);
+    if(entry.unitCell)
+      entry.unitCell->wrapVecsInplace(pos);
+    entry.structure.setAtomPositions(pos);
+  }
+
+  if(entry.numLastEvaluationsWithProblem != 0)
+    outcome = OptimisationOutcome::failure(OptimisationError::ERROR_EVALUATING_POTENTIAL, "Potential evaluation errors during optimisation");
+  else if(!converged)
+  {
+    ::std::stringstream ss;
+    ss << "Failed to converge after " << *settings.maxSteps << "steps";
+    outcome = OptimisationOutcome::failure(OptimisationError::FAILED_TO_CONVERGE, ss.str());
+  }
+  else
+  {
+    const ::arma::mat forces = numParticles == 0 ? ::arma::mat(3, 0) :
+      ::arma::mat(data.forces.cols(first, first + numParticles - 1));
+    populateOptimistaionData(
+      optimisationData,
+      entry.structure,
+      data.internalEnergy[str],
+      forces,
+      data.stressMtx[str]
+    );
+    outcome = OptimisationOutcome::success();
+  }
+
+  optimisationData.saveToStructure(entry.structure);
+}
+
+TpsdGeomOptimiser::Workspace::Workspace(const size_t numParticles):
+deltaPos(3, numParticles),
+f0(3, numParticles),
+fracs(3, numParticles)
+{
+  deltaPos.zeros();
+  // Matches the initial forces
+  f0.ones();
+}
+
 bool TpsdGeomOptimiser::cellReasonable(const sstbx::common::UnitCell & unitCell) const
 {
   // Do a few checks to see if the cell has collapsed
@@ -456,20 +822,31 @@ void TpsdGeomOptimiser::populateOptimistaionData(
   const common::Structure & structure,
   const PotentialData & potData
 ) const
+{
+  populateOptimistaionData(optData, structure, potData.internalEnergy, potData.forces, potData.stressMtx);
+}
+
+void TpsdGeomOptimiser::populateOptimistaionData(
+  OptimisationData & optData,
+  const common::Structure & structure,
+  const double internalEnergy,
+  const ::arma::mat & forces,
+  const ::arma::mat33 & stressMtx
+) const
 {
   const common::UnitCell * const unitCell = structure.getUnitCell();
 
-  optData.internalEnergy.reset(potData.internalEnergy);
-  const double pressure = -::arma::trace(potData.stressMtx) / 3.0;
+  optData.internalEnergy.reset(internalEnergy);
+  const double pressure = -::arma::trace(stressMtx) / 3.0;
   optData.pressure.reset(pressure);
   if(unitCell)
   {
     optData.enthalpy.reset(
-      potData.internalEnergy + *optData.pressure * unitCell->getVolume()
+      internalEnergy + *optData.pressure * unitCell->getVolume()
     );
   }
-  optData.ionicForces.reset(potData.forces);
-  optData.stressMtx.reset(potData.stressMtx);
+  optData.ionicForces.reset(forces);
+  optData.stressMtx.reset(stressMtx);
 }
 
 }
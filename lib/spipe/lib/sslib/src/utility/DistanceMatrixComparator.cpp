@@ -35,7 +35,7 @@ bool indexDoubleLessThan(const IndexDoublePair & p1, const IndexDoublePair & p2)
 DistanceMatrixComparisonData::DistanceMatrixComparisonData(const common::Structure & _structure)
 {
   // Get a primitive setting version of the structure, otherwise the algorithm could get confused
-  const UniquePtr<const common::Structure>::Type primitive(_structure.getPrimitiveCopy());
+  const common::StructureConstPtr primitive = _structure.getPrimitive();
 
   const common::DistanceCalculator & distCalc = primitive->getDistanceCalculator(); 
 
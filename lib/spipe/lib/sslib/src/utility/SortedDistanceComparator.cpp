@@ -16,6 +16,7 @@
 #include <armadillo>
 
 #include "common/DistanceCalculator.h"
+#include "common/PairImages.h"
 #include "common/Structure.h"
 #include "common/UnitCell.h"
 #include "math/RunningStats.h"
@@ -34,17 +35,26 @@ const double SortedDistanceComparator::CUTOFF_FACTOR        = 1.5;
 
 SortedDistanceComparisonData::SortedDistanceComparisonData(const common::Structure & structure, const bool volumeAgnostic, const bool usePrimitive)
 {
-  // This needs to be in this scope so it lasts until we return
-  common::StructurePtr primitive(new common::Structure(structure));
+  // These need to be in this scope so they last until we return
+  common::StructureConstPtr sharedPrimitive;
+  common::StructurePtr scaled;
+
+  const common::Structure * primitive = &structure;
   if(usePrimitive)
-    primitive->makePrimitive();
+  {
+    sharedPrimitive = structure.getPrimitive();
+    primitive = sharedPrimitive.get();
+  }
 
-  const common::UnitCell * const unitCell = primitive->getUnitCell();
-  if(volumeAgnostic)
+  const common::UnitCell * unitCell = primitive->getUnitCell();
+  if(volumeAgnostic && unitCell)
   {
-    // If we are to be volume agnostic then set the volume to 1.0 per atom
-    const double scaleFactor = primitive->getNumAtoms() / unitCell->getVolume();
-    primitive->scale(scaleFactor);
+    // If we are to be volume agnostic then set the volume to 1.0 per atom, the
+    // copy shares the atoms until they are scaled
+    scaled = primitive->getGeometryCopy();
+    scaled->scale(primitive->getNumAtoms() / unitCell->getVolume());
+    primitive = scaled.get();
+    unitCell = primitive->getUnitCell();
   }
 
   // Get the unit cell and number of atoms, need to do this as making the
@@ -65,7 +75,8 @@ SortedDistanceComparisonData::SortedDistanceComparisonData(const common::Structu
     volume = static_cast<double>(primitive->getNumAtoms());
   }
 
-  const common::DistanceCalculator & distCalc = primitive->getDistanceCalculator();
+  common::PairImages pairImages;
+  primitive->getDistanceCalculator().getPairImages(pairImages, cutoff);
 
   primitive->getAtomSpecies(species);
   ::std::set<common::AtomSpeciesId::Value> speciesSet(species.begin(), species.end());
@@ -91,7 +102,8 @@ SortedDistanceComparisonData::SortedDistanceComparisonData(const common::Structu
       specJ = atomJ.getSpecies();
       distVecIJ = iDistMap[specJ];
 
-      distCalc.getDistsBetween(atomI, atomJ, cutoff, *distVecIJ);
+      common::ImageDistancesAppender appendDistances(*distVecIJ);
+      pairImages.forEachImage(atomI.getPosition(), atomJ.getPosition(), appendDistances, common::DistanceCalculator::DEFAULT_MAX_OUTPUTS);
     }
   }
 
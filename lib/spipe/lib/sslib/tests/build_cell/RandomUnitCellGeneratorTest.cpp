@@ -0,0 +1,129 @@
+/*
+ * RandomUnitCellGeneratorTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "sslibtest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <build_cell/GenerationOutcome.h>
+#include <build_cell/RandomUnitCellGenerator.h>
+#include <build_cell/StructureContents.h>
+#include <common/UnitCell.h>
+#include <utility/IndexingEnums.h>
+
+namespace ssbc = ::sstbx::build_cell;
+namespace ssc = ::sstbx::common;
+using namespace ::sstbx::utility::cell_params_enum;
+
+BOOST_AUTO_TEST_CASE(RandomUnitCellValidParametersTest)
+{
+  const size_t numCells = 200;
+
+  ssbc::RandomUnitCellGenerator cellGen;
+  // Narrow angle ranges that are mostly invalid if drawn independently
+  cellGen.setMinAngles(100.0);
+  cellGen.setMaxAngles(125.0);
+  cellGen.setMin(A, 1.0);
+  cellGen.setMax(A, 1.0);
+
+  ssc::UnitCellPtr cell;
+  for(size_t i = 0; i < numCells; ++i)
+  {
+    BOOST_REQUIRE(cellGen.generateCell(cell).isSuccess());
+
+    const double (&params)[6] = cell->getLatticeParams();
+    BOOST_REQUIRE(params[ALPHA] + params[BETA] + params[GAMMA] < 360.0 + 1e-5);
+    for(size_t j = ALPHA; j <= GAMMA; ++j)
+    {
+      BOOST_REQUIRE(params[j] > 100.0 - 1e-5 && params[j] < 125.0 + 1e-5);
+    }
+
+    double minLength = params[A], maxLength = params[A];
+    for(size_t j = B; j <= C; ++j)
+    {
+      minLength = ::std::min(minLength, params[j]);
+      maxLength = ::std::max(maxLength, params[j]);
+    }
+    BOOST_REQUIRE(maxLength / minLength <= ssbc::RandomUnitCellGenerator::DEFAULT_MAX_LENGTH_RATIO + 1e-5);
+  }
+  BOOST_REQUIRE(cellGen.getStatistics().numRequested == numCells);
+  BOOST_REQUIRE(cellGen.getStatistics().getAcceptanceRate() == 1.0);
+
+  // No valid cell has all its angles above 120 degrees
+  cellGen.resetStatistics();
+  cellGen.setMinAngles(125.0);
+  cellGen.setMaxAngles(135.0);
+  BOOST_REQUIRE(!cellGen.generateCell(cell).isSuccess());
+  BOOST_REQUIRE(cellGen.getStatistics().numInvalidAngles == 1);
+  BOOST_REQUIRE(cellGen.getStatistics().getAcceptanceRate() == 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(RandomUnitCellCrystalSystemTest)
+{
+  const size_t numCells = 200;
+  const double maxRatio = 1.5;
+
+  ssbc::RandomUnitCellGenerator cellGen;
+  // Fully specify the cell and keep the volume so the lengths aren't rescaled
+  cellGen.setMin(A, 1.0);
+  cellGen.setMax(A, 2.0);
+  cellGen.setMin(B, 1.5);
+  cellGen.setMax(B, 3.0);
+  cellGen.setMin(C, 1.0);
+  cellGen.setMax(C, 4.0);
+  for(size_t i = ALPHA; i <= GAMMA; ++i)
+  {
+    cellGen.setMin(i, 90.0);
+    cellGen.setMax(i, 90.0);
+  }
+  cellGen.setVolumeDelta(0.0);
+  cellGen.setMaxLengthRatio(maxRatio);
+
+  // Tetragonal makes b = a so both have to come from where their ranges overlap
+  const ssbc::StructureContents contents;
+  ssc::UnitCellPtr cell;
+  for(size_t i = 0; i < numCells; ++i)
+  {
+    BOOST_REQUIRE(cellGen.generateCell(cell, contents, ssbc::CrystalSystem::TETRAGONAL).isSuccess());
+
+    const double (&params)[6] = cell->getLatticeParams();
+    BOOST_REQUIRE(::std::abs(params[A] - params[B]) < 1e-5);
+    BOOST_REQUIRE(params[A] > 1.5 - 1e-5 && params[A] < 2.0 + 1e-5);
+    BOOST_REQUIRE(params[C] / params[A] < maxRatio + 1e-5);
+    BOOST_REQUIRE(params[A] / params[C] < maxRatio + 1e-5);
+  }
+  BOOST_REQUIRE(cellGen.getStatistics().numLengthRatioIgnored == 0);
+}
+
+BOOST_AUTO_TEST_CASE(RandomUnitCellFixedAnglesTest)
+{
+  const size_t numCells = 50;
+
+  ssbc::RandomUnitCellGenerator cellGen;
+  // No valid cell has all its angles in this range but the crystal systems
+  // below fix enough of them that it doesn't matter
+  cellGen.setMinAngles(125.0);
+  cellGen.setMaxAngles(135.0);
+  cellGen.setTargetVolume(20.0);
+
+  const ssbc::StructureContents contents;
+  ssc::UnitCellPtr cell;
+  for(size_t i = 0; i < numCells; ++i)
+  {
+    BOOST_REQUIRE(cellGen.generateCell(cell, contents, ssbc::CrystalSystem::MONOCLINIC).isSuccess());
+    const double (&params)[6] = cell->getLatticeParams();
+    BOOST_REQUIRE(::std::abs(params[ALPHA] - 90.0) < 1e-5);
+    BOOST_REQUIRE(::std::abs(params[GAMMA] - 90.0) < 1e-5);
+    BOOST_REQUIRE(params[BETA] > 125.0 - 1e-5 && params[BETA] < 135.0 + 1e-5);
+
+    BOOST_REQUIRE(cellGen.generateCell(cell, contents, ssbc::CrystalSystem::ORTHORHOMBIC).isSuccess());
+    BOOST_REQUIRE(cellGen.generateCell(cell, contents, ssbc::CrystalSystem::HEXAGONAL).isSuccess());
+  }
+  BOOST_REQUIRE(cellGen.getStatistics().numInvalidAngles == 0);
+}
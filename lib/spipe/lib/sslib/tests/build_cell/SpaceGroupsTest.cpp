@@ -0,0 +1,73 @@
+/*
+ * SpaceGroupsTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "sslibtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include <build_cell/SpaceGroups.h>
+#include <build_cell/SymmetryGroup.h>
+
+namespace ssbc = ::sstbx::build_cell;
+
+BOOST_AUTO_TEST_CASE(SpaceGroupLookupTest)
+{
+  unsigned int number = 0;
+  BOOST_REQUIRE(ssbc::getSpaceGroup(number, "Fm-3m"));
+  BOOST_REQUIRE(number == 225);
+  BOOST_REQUIRE(ssbc::getSpaceGroup(number, "194"));
+  BOOST_REQUIRE(number == 194);
+  BOOST_REQUIRE(ssbc::getSpaceGroupSymbol(number) == "P6_3/mmc");
+
+  // Not one we have
+  BOOST_REQUIRE(!ssbc::getSpaceGroup(number, "P4/nmm"));
+  BOOST_REQUIRE(!ssbc::getSharedSpaceGroup(3).get());
+
+  BOOST_REQUIRE(ssbc::getCrystalSystem(14) == ssbc::CrystalSystem::MONOCLINIC);
+  BOOST_REQUIRE(ssbc::getCrystalSystem(166) == ssbc::CrystalSystem::TRIGONAL);
+  BOOST_REQUIRE(ssbc::getCrystalSystem(229) == ssbc::CrystalSystem::CUBIC);
+}
+
+BOOST_AUTO_TEST_CASE(SpaceGroupWyckoffTest)
+{
+  // Pm-3m: 1a/b, 3c/d, 6e/f, 8g, 12h/i/j, 24k/l/m and the general position 48n
+  const ssbc::SymmetryGroupConstPtr pm3m = ssbc::getSharedSpaceGroup(221);
+  BOOST_REQUIRE(pm3m.get());
+  BOOST_REQUIRE(pm3m->numOps() == 48);
+
+  const unsigned int expected[] = {1, 3, 6, 8, 12, 24};
+  const ssbc::SymmetryGroup::Multiplicities multiplicities = pm3m->getMultiplicities();
+  BOOST_REQUIRE(multiplicities ==
+    ssbc::SymmetryGroup::Multiplicities(expected, expected + sizeof(expected) / sizeof(unsigned int)));
+
+  // Each position should map onto as many points as its multiplicity
+  BOOST_FOREACH(const unsigned int multiplicity, multiplicities)
+  {
+    const ssbc::SymmetryGroup::WyckoffPositions * const positions = pm3m->getWyckoffPositions(multiplicity);
+    BOOST_REQUIRE(positions);
+    BOOST_FOREACH(const ssbc::SymmetryGroup::WyckoffPosition & position, *positions)
+    {
+      BOOST_REQUIRE(!position.origins.empty());
+      BOOST_REQUIRE(
+        static_cast<unsigned int>(::std::count(position.opMask.begin(), position.opMask.end(), true)) ==
+        multiplicity);
+    }
+  }
+
+  // The conventional cell of the centred groups includes the centring translations
+  const ssbc::SymmetryGroupConstPtr fm3m = ssbc::getSharedSpaceGroup(225);
+  BOOST_REQUIRE(fm3m.get());
+  BOOST_REQUIRE(fm3m->numOps() == 192);
+  BOOST_REQUIRE(fm3m->getMultiplicities().front() == 4);
+
+  // Same group back the second time
+  BOOST_REQUIRE(ssbc::getSharedSpaceGroup(225) == fm3m);
+}
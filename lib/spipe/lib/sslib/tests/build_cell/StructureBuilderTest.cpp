@@ -15,11 +15,15 @@
 #include <build_cell/AtomsGenerator.h>
 #include <build_cell/IUnitCellGenerator.h>
 #include <build_cell/GenerationOutcome.h>
+#include <build_cell/RandomUnitCellGenerator.h>
 #include <build_cell/StructureBuilder.h>
 #include <common/AtomSpeciesDatabase.h>
 #include <common/AtomSpeciesId.h>
 #include <common/Structure.h>
 #include <common/Types.h>
+#include <common/UnitCell.h>
+#include <utility/IndexingEnums.h>
+#include <utility/StableComparison.h>
 
 namespace ssbc = ::sstbx::build_cell;
 namespace ssc  = ::sstbx::common;
@@ -61,3 +65,71 @@ BOOST_AUTO_TEST_CASE(StructureBuilderClusterTest)
 
 
 }
+
+BOOST_AUTO_TEST_CASE(StructureBuilderSpaceGroupTest)
+{
+  using namespace ::sstbx::utility::cell_params_enum;
+  namespace comp = ::sstbx::utility::StableComp;
+
+  //// Settings ////////////////
+  const unsigned int TIMES_TO_GENERATE = 10;
+
+  // A single site in each so nothing can end up on top of anything else
+  ssbc::StructureBuilder fccBuilder;
+  {
+    ssbc::AtomsGeneratorConstructionInfo constructionInfo;
+    constructionInfo.atoms.push_back(ssbc::AtomsDescription(ssc::AtomSpeciesId::NA, 4));
+    fccBuilder.addGenerator(::sstbx::makeUniquePtr(new ssbc::AtomsGenerator(constructionInfo)));
+  }
+  fccBuilder.setUnitCellGenerator(
+    ssbc::IUnitCellGeneratorPtr(new ssbc::RandomUnitCellGenerator()));
+  fccBuilder.setSpaceGroup(225); // Fm-3m
+
+  ssc::AtomSpeciesDatabase speciesDb;
+  ssc::StructurePtr structure;
+  ssbc::GenerationOutcome outcome;
+  for(unsigned int i = 0; i < TIMES_TO_GENERATE; ++i)
+  {
+    outcome = fccBuilder.generateStructure(structure, speciesDb);
+    BOOST_REQUIRE(outcome.success());
+    BOOST_REQUIRE(structure->getNumAtoms() == 4);
+
+    // Cubic lattice
+    const double * const params = structure->getUnitCell()->getLatticeParams();
+    BOOST_REQUIRE(comp::eq(params[A], params[B]));
+    BOOST_REQUIRE(comp::eq(params[A], params[C]));
+    BOOST_REQUIRE(comp::eq(params[ALPHA], 90.0));
+    BOOST_REQUIRE(comp::eq(params[BETA], 90.0));
+    BOOST_REQUIRE(comp::eq(params[GAMMA], 90.0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StructureBuilderCopyTest)
+{
+  using namespace ::sstbx::utility::cell_params_enum;
+  namespace comp = ::sstbx::utility::StableComp;
+
+  ssbc::StructureBuilder builder;
+  {
+    ssbc::AtomsGeneratorConstructionInfo constructionInfo;
+    constructionInfo.atoms.push_back(ssbc::AtomsDescription(ssc::AtomSpeciesId::NA, 4));
+    builder.addGenerator(::sstbx::makeUniquePtr(new ssbc::AtomsGenerator(constructionInfo)));
+  }
+  builder.setUnitCellGenerator(
+    ssbc::IUnitCellGeneratorPtr(new ssbc::RandomUnitCellGenerator()));
+  builder.setSpaceGroup(225); // Fm-3m
+
+  // The copy should have its own unit cell generator and the same symmetry
+  const ssbc::StructureBuilder copy(builder);
+  ssbc::StructureBuilder copyOfCopy(copy);
+
+  ssc::AtomSpeciesDatabase speciesDb;
+  ssc::StructurePtr structure;
+  BOOST_REQUIRE(copyOfCopy.generateStructure(structure, speciesDb).success());
+  BOOST_REQUIRE(structure->getNumAtoms() == 4);
+  BOOST_REQUIRE(structure->getUnitCell());
+
+  const double * const params = structure->getUnitCell()->getLatticeParams();
+  BOOST_REQUIRE(comp::eq(params[A], params[B]));
+  BOOST_REQUIRE(comp::eq(params[A], params[C]));
+}
@@ -8,6 +8,7 @@
 // INCLUDES //////////////////////////////////
 #include "sslibtest.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -18,7 +19,9 @@
 #include <build_cell/GenerationOutcome.h>
 #include <build_cell/RandomUnitCellGenerator.h>
 #include <common/Atom.h>
+#include <common/LatticeStencils.h>
 #include <common/OrthoCellDistanceCalculator.h>
+#include <common/PairImages.h>
 #include <common/ReferenceDistanceCalculator.h>
 #include <common/Structure.h>
 #include <common/Types.h>
@@ -34,6 +37,47 @@ namespace ssc = ::sstbx::common;
 namespace ssm = ::sstbx::math;
 namespace ssu = ::sstbx::utility;
 
+void requireSameImages(
+  const ssc::DistanceCalculator & calc,
+  const ssc::DistanceCalculator & expectedCalc,
+  const ssc::Structure & structure,
+  const double cutoff)
+{
+  const double tolerance = 1e-10;
+
+  ::std::vector<double> dists, expectedDists;
+  ::std::vector< ::arma::vec3> vecs, expectedVecs;
+  ::arma::vec3 vecSum, expectedVecSum;
+  for(size_t i = 0; i < structure.getNumAtoms(); ++i)
+  {
+    for(size_t j = i; j < structure.getNumAtoms(); ++j)
+    {
+      dists.clear(); expectedDists.clear();
+      vecs.clear(); expectedVecs.clear();
+      BOOST_REQUIRE(calc.getDistsBetween(structure.getAtom(i), structure.getAtom(j), cutoff, dists));
+      BOOST_REQUIRE(expectedCalc.getDistsBetween(structure.getAtom(i), structure.getAtom(j), cutoff, expectedDists));
+      BOOST_REQUIRE(calc.getVecsBetween(structure.getAtom(i), structure.getAtom(j), cutoff, vecs));
+      BOOST_REQUIRE(expectedCalc.getVecsBetween(structure.getAtom(i), structure.getAtom(j), cutoff, expectedVecs));
+
+      BOOST_REQUIRE(dists.size() == expectedDists.size());
+      ::std::sort(dists.begin(), dists.end());
+      ::std::sort(expectedDists.begin(), expectedDists.end());
+      for(size_t k = 0; k < dists.size(); ++k)
+        BOOST_REQUIRE(ssu::StableComp::eq(dists[k], expectedDists[k], tolerance));
+
+      BOOST_REQUIRE(vecs.size() == expectedVecs.size());
+      vecSum.zeros(); expectedVecSum.zeros();
+      for(size_t k = 0; k < vecs.size(); ++k)
+      {
+        vecSum += vecs[k];
+        expectedVecSum += expectedVecs[k];
+      }
+      for(size_t k = 0; k < 3; ++k)
+        BOOST_REQUIRE(ssu::StableComp::eq(vecSum(k), expectedVecSum(k), tolerance));
+    }
+  }
+}
+
 
 BOOST_AUTO_TEST_CASE(OrthogonalUnitCellComparison)
 {
@@ -287,6 +331,108 @@ BOOST_AUTO_TEST_CASE(NonOrthogonalComparison)
 }
 
 
+BOOST_AUTO_TEST_CASE(SkewedCellComparison)
+{
+  // SETTINGS ////////////////
+  const size_t numAtoms = 10;
+  const double tolerance = 1e-10;
+  const double cutoff = 2.0;
+
+  // A unit volume cell that is very far from reduced
+  ::arma::mat33 orthoMtx;
+  orthoMtx
+    << 1.0 << 5.0 << 3.0 << ::arma::endr
+    << 0.0 << 1.0 << 7.0 << ::arma::endr
+    << 0.0 << 0.0 << 1.0 << ::arma::endr;
+
+  ssc::Structure structure;
+  structure.setUnitCell(ssc::UnitCellPtr(new ssc::UnitCell(orthoMtx)));
+  for(size_t i = 0; i < numAtoms; ++i)
+    structure.newAtom(ssc::AtomSpeciesId::CUSTOM_1).setPosition(structure.getUnitCell()->randomPoint());
+
+  ssc::ReferenceDistanceCalculator referenceCalc(structure);
+  const ssc::DistanceCalculator & univCalc = structure.getDistanceCalculator();
+
+  ::std::vector<double> referenceDists, univDists;
+  for(size_t volume = 1; volume <= 2; ++volume)
+  {
+    // Make sure the structure's calculator hears about the change in cell
+    structure.getUnitCell()->setVolume(static_cast<double>(volume));
+
+    for(size_t i = 0; i < numAtoms; ++i)
+    {
+      const ssc::Atom & atom1 = structure.getAtom(i);
+      for(size_t j = i; j < numAtoms; ++j)
+      {
+        const ssc::Atom & atom2 = structure.getAtom(j);
+        BOOST_REQUIRE(ssu::StableComp::eq(
+          referenceCalc.getDistMinImg(atom1, atom2), univCalc.getDistMinImg(atom1, atom2), tolerance));
+
+        referenceDists.clear();
+        univDists.clear();
+        referenceCalc.getDistsBetween(atom1, atom2, cutoff, referenceDists);
+        univCalc.getDistsBetween(atom1, atom2, cutoff, univDists);
+
+        BOOST_REQUIRE(referenceDists.size() == univDists.size());
+        ::std::sort(referenceDists.begin(), referenceDists.end());
+        ::std::sort(univDists.begin(), univDists.end());
+        for(size_t k = 0; k < referenceDists.size(); ++k)
+          BOOST_REQUIRE(ssu::StableComp::eq(referenceDists[k], univDists[k], tolerance));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PairImagesComparison)
+{
+  // SETTINGS ////////////////
+  const size_t numAtoms = 10;
+  const size_t numAttempts = 20;
+  const double tolerance = 1e-10;
+
+  ::ssbc::RandomUnitCellGenerator randomCell;
+
+  ::std::vector<double> referenceDists, imageDists;
+  for(size_t attempt = 0; attempt < numAttempts; ++attempt)
+  {
+    ssc::Structure structure;
+    {
+      ssc::UnitCellPtr cell;
+      BOOST_REQUIRE(randomCell.generateCell(cell).success());
+      structure.setUnitCell(cell);
+    }
+    for(size_t i = 0; i < numAtoms; ++i)
+      structure.newAtom(ssc::AtomSpeciesId::CUSTOM_1).setPosition(structure.getUnitCell()->randomPoint());
+
+    const double cutoff = ssm::randu<double>() * 4.0;
+    ssc::ReferenceDistanceCalculator referenceCalc(structure);
+    ssc::PairImages pairImages;
+    structure.getDistanceCalculator().getPairImages(pairImages, cutoff);
+
+    for(size_t i = 0; i < numAtoms; ++i)
+    {
+      for(size_t j = i; j < numAtoms; ++j)
+      {
+        referenceDists.clear();
+        imageDists.clear();
+        referenceCalc.getDistsBetween(structure.getAtom(i), structure.getAtom(j), cutoff, referenceDists);
+        ssc::ImageDistancesAppender appendDistances(imageDists);
+        BOOST_REQUIRE(pairImages.forEachImage(
+          structure.getAtom(i).getPosition(),
+          structure.getAtom(j).getPosition(),
+          appendDistances,
+          ssc::DistanceCalculator::DEFAULT_MAX_OUTPUTS));
+
+        BOOST_REQUIRE(referenceDists.size() == imageDists.size());
+        ::std::sort(referenceDists.begin(), referenceDists.end());
+        ::std::sort(imageDists.begin(), imageDists.end());
+        for(size_t k = 0; k < referenceDists.size(); ++k)
+          BOOST_REQUIRE(ssu::StableComp::eq(referenceDists[k], imageDists[k], tolerance));
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(DistanceComparisonPathological)
 {
   // SETTINGS ////////////////
@@ -353,3 +499,143 @@ BOOST_AUTO_TEST_CASE(DistanceComparisonPathological)
     BOOST_REQUIRE(ssu::StableComp::eq(univDist[i], referenceDists[i], tolerance));
   }
 }
+
+BOOST_AUTO_TEST_CASE(StencilCacheCellChange)
+{
+  // SETTINGS ////////////////
+  const size_t numAtoms = 8;
+  const double cutoffs[] = { 2.5, 6.0 };
+  const size_t numCutoffs = sizeof(cutoffs) / sizeof(cutoffs[0]);
+  // An orthorhombic cell for the ortho calculator and a triclinic one for the
+  // universal one, each goes to a cell of the same lattice system so the
+  // structure keeps the same calculator (and cache)
+  const double cellParams[][6] = {
+    { 3.0, 4.0, 5.0, 90.0, 90.0, 90.0 },
+    { 4.0, 5.0, 6.0, 70.0, 80.0, 100.0 }
+  };
+  const double changedCellParams[][6] = {
+    { 2.0, 5.5, 3.5, 90.0, 90.0, 90.0 },
+    { 3.0, 4.5, 6.5, 75.0, 65.0, 110.0 }
+  };
+
+  for(size_t cellIdx = 0; cellIdx < 2; ++cellIdx)
+  {
+    ssc::Structure structure;
+    structure.setUnitCell(ssc::UnitCellPtr(new ssc::UnitCell(cellParams[cellIdx])));
+    for(size_t i = 0; i < numAtoms; ++i)
+      structure.newAtom(ssc::AtomSpeciesId::CUSTOM_1).setPosition(structure.getUnitCell()->randomPoint());
+
+    // The structure's calculator keeps its stencils between calls
+    const ssc::DistanceCalculator & cachedCalc = structure.getDistanceCalculator();
+    {
+      ssc::ReferenceDistanceCalculator referenceCalc(structure);
+      for(size_t i = 0; i < numCutoffs; ++i)
+      {
+        requireSameImages(cachedCalc, referenceCalc, structure, cutoffs[i]);
+        // Again, this time from the cache
+        requireSameImages(cachedCalc, referenceCalc, structure, cutoffs[i]);
+      }
+    }
+
+    structure.getUnitCell()->setLatticeParams(changedCellParams[cellIdx]);
+
+    // Stale stencils would give the images in the old lattice
+    ssc::ReferenceDistanceCalculator referenceCalc(structure);
+    ssc::UniversalCrystalDistanceCalculator uncachedCalc(structure);
+    for(size_t i = 0; i < numCutoffs; ++i)
+    {
+      requireSameImages(cachedCalc, referenceCalc, structure, cutoffs[i]);
+      requireSameImages(cachedCalc, uncachedCalc, structure, cutoffs[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StencilCacheCutoffs)
+{
+  const ssc::UnitCell cell(3.0, 4.0, 5.0, 80.0, 85.0, 95.0);
+
+  ssc::LatticeStencils stencils;
+  const ssc::LatticeStencils::StencilPtr small = stencils.getStencil(cell, 2.0);
+  BOOST_REQUIRE(stencils.getStencil(cell, 2.0) == small);
+
+  // A different cutoff gets its own, bigger, stencil
+  const ssc::LatticeStencils::StencilPtr large = stencils.getStencil(cell, 8.0);
+  BOOST_REQUIRE(large != small);
+  BOOST_REQUIRE(large->translations.size() > small->translations.size());
+  BOOST_REQUIRE(large->maxMultiple >= small->maxMultiple);
+  BOOST_REQUIRE(stencils.getStencil(cell, 2.0) == small);
+  BOOST_REQUIRE(stencils.getStencil(cell, 8.0) == large);
+
+  // The translations are sorted by length
+  for(size_t i = 1; i < large->lengths.size(); ++i)
+    BOOST_REQUIRE(large->lengths[i - 1] <= large->lengths[i]);
+
+  stencils.clear();
+  const ssc::LatticeStencils::StencilPtr regenerated = stencils.getStencil(cell, 2.0);
+  BOOST_REQUIRE(regenerated != small);
+  BOOST_REQUIRE(regenerated->translations.size() == small->translations.size());
+}
+
+BOOST_AUTO_TEST_CASE(StencilCacheLimit)
+{
+  const ssc::UnitCell cell(3.0, 3.0, 3.0, 90.0, 90.0, 90.0);
+  const size_t maxStencils = ssc::LatticeStencils::DEFAULT_MAX_STENCILS;
+
+  ssc::LatticeStencils stencils;
+  ::std::vector<ssc::LatticeStencils::StencilPtr> cached;
+  for(size_t i = 0; i < maxStencils; ++i)
+    cached.push_back(stencils.getStencil(cell, 1.0 + 0.5 * i));
+
+  // Up to the limit everything stays in the cache
+  for(size_t i = 0; i < maxStencils; ++i)
+    BOOST_REQUIRE(stencils.getStencil(cell, 1.0 + 0.5 * i) == cached[i]);
+
+  // One more empties it, but the stencils already handed out are still good
+  stencils.getStencil(cell, 1.0 + 0.5 * maxStencils);
+  for(size_t i = 0; i < maxStencils; ++i)
+  {
+    const ssc::LatticeStencils::StencilPtr stencil = stencils.getStencil(cell, 1.0 + 0.5 * i);
+    BOOST_REQUIRE(stencil != cached[i]);
+    BOOST_REQUIRE(stencil->translations.size() == cached[i]->translations.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StencilMaxMultiplesFallback)
+{
+  // SETTINGS ////////////////
+  const size_t numAtoms = 4;
+  const double cutoff = 3.5;
+  const double cellParams[][6] = {
+    { 1.0, 1.0, 1.0, 90.0, 90.0, 90.0 },
+    { 1.0, 1.2, 1.1, 80.0, 85.0, 95.0 }
+  };
+
+  for(size_t cellIdx = 0; cellIdx < 2; ++cellIdx)
+  {
+    ssc::Structure structure;
+    structure.setUnitCell(ssc::UnitCellPtr(new ssc::UnitCell(cellParams[cellIdx])));
+    for(size_t i = 0; i < numAtoms; ++i)
+      structure.newAtom(ssc::AtomSpeciesId::CUSTOM_1).setPosition(structure.getUnitCell()->randomPoint());
+
+    const ssc::DistanceCalculator & calc = structure.getDistanceCalculator();
+    ssc::ReferenceDistanceCalculator referenceCalc(structure);
+    requireSameImages(calc, referenceCalc, structure, cutoff);
+
+    // Asking for fewer multiples than the stencil covers must not use it
+    ::std::vector<double> dists, referenceDists;
+    for(size_t i = 0; i < numAtoms; ++i)
+    {
+      for(size_t j = i; j < numAtoms; ++j)
+      {
+        dists.clear();
+        referenceDists.clear();
+        BOOST_REQUIRE(!calc.getDistsBetween(structure.getAtom(i), structure.getAtom(j), cutoff, dists,
+          ssc::DistanceCalculator::DEFAULT_MAX_OUTPUTS, 1));
+        referenceCalc.getDistsBetween(structure.getAtom(i), structure.getAtom(j), cutoff, referenceDists);
+        BOOST_REQUIRE(dists.size() < referenceDists.size());
+        for(size_t k = 0; k < dists.size(); ++k)
+          BOOST_REQUIRE(dists[k] < cutoff);
+      }
+    }
+  }
+}
@@ -0,0 +1,209 @@
+/*
+ * StructureTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "sslibtest.h"
+
+#include <cmath>
+#include <set>
+
+#include <common/Atom.h>
+#include <common/AtomSpeciesId.h>
+#include <common/Structure.h>
+#include <common/UnitCell.h>
+
+namespace ssc = ::sstbx::common;
+
+BOOST_AUTO_TEST_CASE(AtomReuse)
+{
+  // SETTINGS //////////////
+  const size_t numAtoms = 10;
+
+  ssc::Structure structure;
+
+  ::std::set<const ssc::Atom *> originalAtoms;
+  for(size_t i = 0; i < numAtoms; ++i)
+    originalAtoms.insert(&structure.newAtom(ssc::AtomSpeciesId::NA));
+
+  BOOST_REQUIRE(structure.clearAtoms() == numAtoms);
+  BOOST_REQUIRE(structure.getNumAtoms() == 0);
+
+  // The new atoms should be the ones that were cleared, set up as if they were new
+  for(size_t i = 0; i < numAtoms; ++i)
+  {
+    const ssc::Atom & atom = structure.newAtom(ssc::AtomSpeciesId::CL);
+    BOOST_REQUIRE(originalAtoms.find(&atom) != originalAtoms.end());
+    BOOST_REQUIRE(atom.getIndex() == i);
+    BOOST_REQUIRE(atom.getSpecies() == ssc::AtomSpeciesId::CL);
+    BOOST_REQUIRE(atom.getRadius() < 0.0);
+  }
+
+  // Removing an atom should keep the indices of the rest in order and the
+  // removed one should be the next to be reused
+  const ssc::Atom * const removed = &structure.getAtom(3);
+  BOOST_REQUIRE(structure.removeAtom(*removed));
+  BOOST_REQUIRE(structure.getNumAtoms() == numAtoms - 1);
+  for(size_t i = 0; i < structure.getNumAtoms(); ++i)
+    BOOST_REQUIRE(structure.getAtom(i).getIndex() == i);
+
+  const ssc::Atom & copy = structure.newAtom(structure.getAtom(0));
+  BOOST_REQUIRE(&copy == removed);
+  BOOST_REQUIRE(copy.getIndex() == numAtoms - 1);
+  BOOST_REQUIRE(copy.getSpecies() == ssc::AtomSpeciesId::CL);
+
+  // Clearing the whole structure should leave it empty
+  structure.setName("test");
+  structure.clear();
+  BOOST_REQUIRE(structure.getNumAtoms() == 0);
+  BOOST_REQUIRE(structure.getName().empty());
+  BOOST_REQUIRE(!structure.getUnitCell());
+}
+
+BOOST_AUTO_TEST_CASE(AtomStorage)
+{
+  // SETTINGS //////////////
+  const size_t numAtoms = 7;
+
+  ssc::Structure structure;
+  for(size_t i = 0; i < numAtoms; ++i)
+  {
+    ssc::Atom & atom = structure.newAtom(i % 2 == 0 ? ssc::AtomSpeciesId::NA : ssc::AtomSpeciesId::CL);
+    atom.setPosition(i, 2.0 * i, 3.0 * i);
+    atom.setRadius(0.1 * i);
+  }
+
+  // The bulk positions should be the same as those of the individual atoms
+  const ::arma::mat & positions = structure.getAtomPositions();
+  BOOST_REQUIRE(positions.n_rows == 3);
+  BOOST_REQUIRE(positions.n_cols == numAtoms);
+  for(size_t i = 0; i < numAtoms; ++i)
+  {
+    BOOST_REQUIRE(positions(0, i) == static_cast<double>(i));
+    BOOST_REQUIRE(positions(2, i) == 3.0 * i);
+    BOOST_REQUIRE(::arma::norm(positions.col(i) - structure.getAtom(i).getPosition(), 2) == 0.0);
+  }
+  BOOST_REQUIRE(structure.getAtomSpecies().size() == numAtoms);
+  BOOST_REQUIRE(structure.getNumAtomsOfSpecies(ssc::AtomSpeciesId::NA) == 4);
+
+  // Moving an atom should show up in the bulk positions
+  ::arma::vec3 dr;
+  dr.ones();
+  structure.getAtom(2).moveBy(dr);
+  BOOST_REQUIRE(structure.getAtomPositions()(1, 2) == 5.0);
+
+  // Removing an atom should shift the data of those after it
+  BOOST_REQUIRE(structure.removeAtom(structure.getAtom(1)));
+  BOOST_REQUIRE(structure.getAtomPositions().n_cols == numAtoms - 1);
+  for(size_t i = 1; i < numAtoms - 1; ++i)
+  {
+    const ssc::Atom & atom = structure.getAtom(i);
+    BOOST_REQUIRE(atom.getRadius() == 0.1 * (i + 1));
+    BOOST_REQUIRE(atom.getSpecies() == (i % 2 == 0 ? ssc::AtomSpeciesId::CL : ssc::AtomSpeciesId::NA));
+    BOOST_REQUIRE(atom.getPosition()(0) == (i == 1 ? 3.0 : static_cast<double>(i + 1)));
+  }
+
+  // Setting all the positions at once should be seen by each atom
+  ::arma::mat newPositions(3, numAtoms - 1);
+  newPositions.randu();
+  structure.setAtomPositions(newPositions);
+  for(size_t i = 0; i < numAtoms - 1; ++i)
+    BOOST_REQUIRE(::arma::norm(structure.getAtom(i).getPosition() - newPositions.col(i), 2) == 0.0);
+
+  // Copies should have the same data but their own storage
+  ssc::Structure copy(structure);
+  BOOST_REQUIRE(copy.getNumAtoms() == numAtoms - 1);
+  BOOST_REQUIRE(::arma::norm(copy.getAtomPositions() - newPositions, 2) == 0.0);
+  copy.getAtom(0).setPosition(-1.0, -1.0, -1.0);
+  BOOST_REQUIRE(structure.getAtom(0).getPosition()(0) == newPositions(0, 0));
+  BOOST_REQUIRE(copy.getAtom(numAtoms - 2).getRadius() == structure.getAtom(numAtoms - 2).getRadius());
+}
+
+BOOST_AUTO_TEST_CASE(GeometrySharing)
+{
+  ssc::Structure structure(ssc::UnitCellPtr(new ssc::UnitCell(2.0, 1.0, 1.0, 90.0, 90.0, 90.0)));
+  structure.setName("original");
+  structure.newAtom(ssc::AtomSpeciesId::NA).setPosition(0.0, 0.0, 0.0);
+  structure.newAtom(ssc::AtomSpeciesId::NA).setPosition(1.0, 0.0, 0.0);
+
+  // A geometry copy has the atoms but nothing else
+  const ssc::StructurePtr copy = structure.getGeometryCopy();
+  BOOST_REQUIRE(copy->getName().empty());
+  BOOST_REQUIRE(copy->getNumAtoms() == 2);
+  BOOST_REQUIRE(copy->getAtom(1).getPosition()(0) == 1.0);
+
+  // Changing one shouldn't affect the other
+  copy->getAtom(1).setPosition(0.5, 0.5, 0.5);
+  BOOST_REQUIRE(structure.getAtom(1).getPosition()(0) == 1.0);
+  structure.getAtom(0).setRadius(1.0);
+  BOOST_REQUIRE(copy->getAtom(0).getRadius() < 0.0);
+  copy->removeAtom(copy->getAtom(0));
+  BOOST_REQUIRE(structure.getNumAtoms() == 2);
+
+  // The two atoms are the same under a translation by half the cell so the
+  // primitive should have one, and it should only be found once
+  const ssc::StructureConstPtr primitive = structure.getPrimitive();
+  BOOST_REQUIRE(primitive->getNumAtoms() == 1);
+  BOOST_REQUIRE(::std::abs(primitive->getUnitCell()->getVolume() - 1.0) < 1e-10);
+  BOOST_REQUIRE(structure.getPrimitive() == primitive);
+  const ssc::Structure structureCopy(structure);
+  BOOST_REQUIRE(structureCopy.getPrimitive() == primitive);
+
+  // Scaling keeps it primitive
+  structure.scale(2.0);
+  BOOST_REQUIRE(structure.getPrimitive() != primitive);
+  BOOST_REQUIRE(::std::abs(structure.getPrimitive()->getUnitCell()->getVolume() - 2.0) < 1e-10);
+
+  // Any change should mean the primitive is found again
+  const ssc::StructureConstPtr scaledPrimitive = structure.getPrimitive();
+  ::arma::vec3 dr;
+  dr.zeros();
+  structure.getAtom(1).moveBy(dr);
+  BOOST_REQUIRE(structure.getPrimitive() != scaledPrimitive);
+
+  // A primitive copy of a structure that isn't primitive is just the geometry
+  BOOST_REQUIRE(structure.getPrimitiveCopy()->getName().empty());
+
+  // Making it primitive in place should leave it as its own primitive
+  BOOST_REQUIRE(structure.makePrimitive());
+  BOOST_REQUIRE(structure.getNumAtoms() == 1);
+  BOOST_REQUIRE(!structure.makePrimitive());
+  BOOST_REQUIRE(structure.getName() == "original");
+
+  // ..now the primitive copy is a full copy
+  const ssc::StructurePtr primitiveCopy = structure.getPrimitiveCopy();
+  BOOST_REQUIRE(primitiveCopy->getName() == "original");
+  BOOST_REQUIRE(primitiveCopy->getNumAtoms() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(SymmetryCaching)
+{
+  ssc::Structure structure(ssc::UnitCellPtr(new ssc::UnitCell(1.0, 1.0, 1.0, 90.0, 90.0, 90.0)));
+  structure.newAtom(ssc::AtomSpeciesId::NA).setPosition(0.0, 0.0, 0.0);
+
+  // Simple cubic, Pm-3m
+  const ssc::SymmetryDatasetConstPtr dataset = structure.getSymmetryDataset();
+  BOOST_REQUIRE(dataset.get());
+  BOOST_REQUIRE(dataset->spacegroupNumber == 221);
+  BOOST_REQUIRE(dataset->operations.size() == 48);
+  BOOST_REQUIRE(dataset->equivalentAtoms.size() == 1);
+
+  // It should only be found once for each precision
+  BOOST_REQUIRE(structure.getSymmetryDataset() == dataset);
+  BOOST_REQUIRE(structure.getSymmetryDataset(0.01) != dataset);
+  BOOST_REQUIRE(structure.getSymmetryDataset(0.01)->spacegroupNumber == 221);
+
+  // Stretching the cell makes it tetragonal, P4/mmm
+  const double tetragonal[] = {1.0, 1.0, 2.0, 90.0, 90.0, 90.0};
+  structure.getUnitCell()->setLatticeParams(tetragonal);
+  BOOST_REQUIRE(structure.getSymmetryDataset() != dataset);
+  BOOST_REQUIRE(structure.getSymmetryDataset()->spacegroupNumber == 123);
+
+  // Clusters don't have a space group
+  ssc::Structure cluster;
+  cluster.newAtom(ssc::AtomSpeciesId::NA);
+  BOOST_REQUIRE(!cluster.getSymmetryDataset().get());
+}
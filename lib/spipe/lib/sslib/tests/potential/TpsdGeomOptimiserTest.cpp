@@ -0,0 +1,167 @@
+/*
+ * TpsdGeomOptimiserTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "sslibtest.h"
+
+#include <cmath>
+#include <vector>
+
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <armadillo>
+
+#include <common/AtomSpeciesDatabase.h>
+#include <common/Structure.h>
+#include <common/StructureProperties.h>
+#include <common/Types.h>
+#include <common/UnitCell.h>
+#include <math/Random.h>
+#include <potential/IBatchPotentialEvaluator.h>
+#include <potential/IPotentialEvaluator.h>
+#include <potential/OptimisationSettings.h>
+#include <potential/SimplePairPotential.h>
+#include <potential/TpsdGeomOptimiser.h>
+
+namespace ssc = ::sstbx::common;
+namespace ssm = ::sstbx::math;
+namespace ssp = ::sstbx::potential;
+
+ssp::TpsdGeomOptimiser::PotentialPtr createPotential(ssc::AtomSpeciesDatabase & speciesDb);
+void createStructures(::boost::ptr_vector<ssc::Structure> & structures, const size_t numStructures);
+
+BOOST_AUTO_TEST_CASE(BatchEvaluationTest)
+{
+  // SETTINGS ////////////////
+  const size_t numStructures = 10;
+  const double tolerance = 1e-10;
+
+  ssc::AtomSpeciesDatabase speciesDb;
+  const ssp::TpsdGeomOptimiser::PotentialPtr potential = createPotential(speciesDb);
+
+  ::boost::ptr_vector<ssc::Structure> structures;
+  createStructures(structures, numStructures);
+
+  ssp::PotentialBatchData::Structures batchStructures;
+  for(size_t i = 0; i < numStructures; ++i)
+    batchStructures.push_back(&structures[i]);
+
+  ::boost::shared_ptr<ssp::IBatchPotentialEvaluator> batchEvaluator =
+    potential->createBatchEvaluator(batchStructures);
+  BOOST_REQUIRE(batchEvaluator.get());
+  ssp::PotentialBatchData & batchData = batchEvaluator->getData();
+
+  // Leave one structure out to check that inactive structures aren't evaluated
+  batchData.active[1] = false;
+  batchEvaluator->evalPotential();
+  BOOST_REQUIRE(batchData.internalEnergy[1] == 0.0);
+
+  for(size_t i = 0; i < numStructures; ++i)
+  {
+    if(!batchData.active[i])
+      continue;
+
+    ::boost::shared_ptr<ssp::IPotentialEvaluator> evaluator = potential->createEvaluator(structures[i]);
+    const ssp::PotentialData & data = *evaluator->evalPotential().first;
+
+    BOOST_REQUIRE(::std::abs(data.internalEnergy - batchData.internalEnergy[i]) < tolerance);
+    BOOST_REQUIRE(::arma::norm(data.stressMtx - batchData.stressMtx[i], 2) < tolerance);
+    const size_t first = batchData.getFirstParticle(i);
+    const ::arma::mat batchForces = batchData.forces.cols(first, first + batchData.getNumParticles(i) - 1);
+    BOOST_REQUIRE(::arma::norm(data.forces - batchForces, 2) < tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BatchOptimisationTest)
+{
+  // SETTINGS ////////////////
+  const size_t numStructures = 10;
+  const double tolerance = 1e-8;
+
+  ssc::AtomSpeciesDatabase speciesDb;
+  const ssp::TpsdGeomOptimiser optimiser(createPotential(speciesDb));
+  const ssp::OptimisationSettings settings;
+
+  ::boost::ptr_vector<ssc::Structure> structures;
+  createStructures(structures, numStructures);
+
+  // Optimise copies of the structures one at a time
+  ::boost::ptr_vector<ssc::Structure> singleStructures;
+  ::std::vector<ssp::OptimisationOutcome> singleOutcomes;
+  for(size_t i = 0; i < numStructures; ++i)
+  {
+    singleStructures.push_back(new ssc::Structure(structures[i]));
+    singleOutcomes.push_back(optimiser.optimise(singleStructures.back(), settings));
+  }
+
+  // and the originals as a batch
+  ssp::TpsdGeomOptimiser::Structures batchStructures;
+  for(size_t i = 0; i < numStructures; ++i)
+    batchStructures.push_back(&structures[i]);
+  ::std::vector<ssp::OptimisationOutcome> batchOutcomes;
+  optimiser.optimise(batchStructures, batchOutcomes, settings);
+
+  BOOST_REQUIRE(batchOutcomes.size() == numStructures);
+  const double * singleEnergy, * batchEnergy;
+  for(size_t i = 0; i < numStructures; ++i)
+  {
+    BOOST_REQUIRE(singleOutcomes[i].isSuccess() == batchOutcomes[i].isSuccess());
+    if(!batchOutcomes[i].isSuccess())
+      continue;
+
+    singleEnergy = singleStructures[i].getProperty(ssc::structure_properties::general::ENERGY_INTERNAL);
+    batchEnergy = structures[i].getProperty(ssc::structure_properties::general::ENERGY_INTERNAL);
+    BOOST_REQUIRE(singleEnergy);
+    BOOST_REQUIRE(batchEnergy);
+    BOOST_REQUIRE(::std::abs(*singleEnergy - *batchEnergy) < tolerance);
+  }
+}
+
+ssp::TpsdGeomOptimiser::PotentialPtr createPotential(ssc::AtomSpeciesDatabase & speciesDb)
+{
+  ssp::SimplePairPotential::SpeciesList species;
+  species.push_back(ssc::AtomSpeciesId::CUSTOM_1);
+  species.push_back(ssc::AtomSpeciesId::CUSTOM_2);
+
+  ::arma::mat epsilon, sigma, beta;
+  epsilon.set_size(2, 2);
+  epsilon.fill(1.0);
+  sigma.set_size(2, 2);
+  sigma(0, 0) = 2.0;
+  sigma(0, 1) = sigma(1, 0) = 2.5;
+  sigma(1, 1) = 3.0;
+  beta.set_size(2, 2);
+  beta.fill(1.0);
+
+  return ssp::TpsdGeomOptimiser::PotentialPtr(
+    new ssp::SimplePairPotential(speciesDb, species, epsilon, sigma, 2.5, beta, 12, 6)
+  );
+}
+
+void createStructures(::boost::ptr_vector<ssc::Structure> & structures, const size_t numStructures)
+{
+  const size_t numAtoms = 6;
+
+  for(size_t i = 0; i < numStructures; ++i)
+  {
+    ssc::Structure * const structure = new ssc::Structure();
+    structures.push_back(structure);
+
+    structure->setUnitCell(ssc::UnitCellPtr(new ssc::UnitCell(
+      ssm::randu(4.0, 6.0),
+      ssm::randu(4.0, 6.0),
+      ssm::randu(4.0, 6.0), 90.0, 90.0, 90.0)));
+
+    for(size_t j = 0; j < numAtoms; ++j)
+    {
+      structure->newAtom(j % 2 == 0 ? ssc::AtomSpeciesId::CUSTOM_1 : ssc::AtomSpeciesId::CUSTOM_2)
+        .setPosition(structure->getUnitCell()->randomPoint());
+    }
+  }
+}
+
@@ -0,0 +1,102 @@
+/*
+ * TpsdMixedPrecisionTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "sslibtest.h"
+
+#include <cmath>
+
+#include <armadillo>
+
+#include <common/AtomSpeciesDatabase.h>
+#include <common/Structure.h>
+#include <common/StructureProperties.h>
+#include <common/Types.h>
+#include <common/UnitCell.h>
+#include <potential/OptimisationSettings.h>
+#include <potential/SimplePairPotential.h>
+#include <potential/TpsdGeomOptimiser.h>
+
+namespace ssc = ::sstbx::common;
+namespace ssp = ::sstbx::potential;
+namespace structure_properties = ssc::structure_properties;
+
+ssp::TpsdGeomOptimiser::PotentialPtr createLennardJones(ssc::AtomSpeciesDatabase & speciesDb);
+ssc::Structure createSimpleCubic(const double latticeParam);
+
+BOOST_AUTO_TEST_CASE(MixedPrecisionMinimumTest)
+{
+  // SETTINGS ////////////////
+  const double tolerance = 1e-6;
+
+  ssc::AtomSpeciesDatabase speciesDb;
+  ssp::TpsdGeomOptimiser optimiser(createLennardJones(speciesDb));
+  const ssp::OptimisationSettings settings;
+
+  // Compressed so that the cell has to relax out to the minimum
+  ssc::Structure doubleStructure = createSimpleCubic(2.0);
+  ssc::Structure mixedStructure(doubleStructure);
+
+  BOOST_REQUIRE(optimiser.optimise(doubleStructure, settings).isSuccess());
+  optimiser.setMixedPrecision(true);
+  BOOST_REQUIRE(optimiser.optimise(mixedStructure, settings).isSuccess());
+
+  // Mixed precision finishes in double so should end up in the same place
+  const double * const doubleEnergy = doubleStructure.getProperty(structure_properties::general::ENERGY_INTERNAL);
+  const double * const mixedEnergy = mixedStructure.getProperty(structure_properties::general::ENERGY_INTERNAL);
+  BOOST_REQUIRE(doubleEnergy);
+  BOOST_REQUIRE(mixedEnergy);
+  BOOST_REQUIRE(*doubleEnergy < 0.0);
+  BOOST_REQUIRE(::std::abs(*mixedEnergy - *doubleEnergy) < tolerance * ::std::abs(*doubleEnergy));
+  BOOST_REQUIRE(::std::abs(
+    mixedStructure.getUnitCell()->getVolume() - doubleStructure.getUnitCell()->getVolume()) <
+    tolerance * doubleStructure.getUnitCell()->getVolume());
+}
+
+BOOST_AUTO_TEST_CASE(MixedPrecisionZeroEnergyTest)
+{
+  ssc::AtomSpeciesDatabase speciesDb;
+  ssp::TpsdGeomOptimiser optimiser(createLennardJones(speciesDb));
+  optimiser.setMixedPrecision(true);
+  ssp::OptimisationSettings settings;
+  settings.maxSteps.reset(10);
+
+  // The atom is too far from its images to interact so the energy is zero
+  // from the start, mixed precision mustn't stop it converging straight away
+  ssc::Structure structure = createSimpleCubic(20.0);
+  BOOST_REQUIRE(optimiser.optimise(structure, settings).isSuccess());
+
+  const double * const energy = structure.getProperty(structure_properties::general::ENERGY_INTERNAL);
+  BOOST_REQUIRE(energy);
+  BOOST_REQUIRE(*energy == 0.0);
+}
+
+ssp::TpsdGeomOptimiser::PotentialPtr createLennardJones(ssc::AtomSpeciesDatabase & speciesDb)
+{
+  ssp::SimplePairPotential::SpeciesList species;
+  species.push_back(ssc::AtomSpeciesId::CUSTOM_1);
+
+  ::arma::mat epsilon, sigma, beta;
+  epsilon.set_size(1, 1);
+  epsilon.fill(1.0);
+  sigma.set_size(1, 1);
+  sigma.fill(2.0);
+  beta.set_size(1, 1);
+  beta.fill(1.0);
+
+  return ssp::TpsdGeomOptimiser::PotentialPtr(
+    new ssp::SimplePairPotential(speciesDb, species, epsilon, sigma, 2.5, beta, 12, 6)
+  );
+}
+
+ssc::Structure createSimpleCubic(const double latticeParam)
+{
+  ssc::Structure structure(ssc::UnitCellPtr(
+    new ssc::UnitCell(latticeParam, latticeParam, latticeParam, 90.0, 90.0, 90.0)));
+  structure.newAtom(ssc::AtomSpeciesId::CUSTOM_1).setPosition(0.0, 0.0, 0.0);
+  return structure;
+}
@@ -31,6 +31,7 @@ typedef common::SharedData SharedDataType;
 typedef common::GlobalData GlobalDataType;
 
 // Pipe blocks
+typedef pipelib::AsyncPipeBlock<StructureDataType, SharedDataType, GlobalDataType> SpAsyncPipeBlock;
 typedef pipelib::Block<StructureDataType, SharedDataType, GlobalDataType>        SpBlock;
 typedef pipelib::Barrier<StructureDataType, SharedDataType, GlobalDataType>      SpBarrier;
 typedef pipelib::FinishedSink<StructureDataType>                                 SpFinishedSink;
@@ -8,11 +8,18 @@
 // INCLUDES //////////////////////////////////
 #include "blocks/LowestFreeEnergy.h"
 
+#include <cmath>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
 #include <common/Structure.h>
 #include <common/StructureData.h>
 
 #include <pipelib/pipelib.h>
 
+#include "utility/Checkpointer.h"
+
 // NAMESPACES ////////////////////////////////
 
 
@@ -50,6 +57,35 @@ void LowestFreeEnergy::in(spipe::common::StructureData & data)
   keep(data, *internalEnergy);
 }
 
+bool LowestFreeEnergy::saveState(const ::std::string & dir)
+{
+  ::std::vector<const ssc::Structure *> structures;
+  BOOST_FOREACH(Structures::const_reference structurePair, myStructures)
+  {
+    structures.push_back(structurePair.second->getStructure());
+  }
+  return utility::saveStructures(
+    dir,
+    structures,
+    getRunner()->memory().global().getSpeciesDatabase()
+  );
+}
+
+bool LowestFreeEnergy::restoreState(const ::std::string & dir)
+{
+  ::sstbx::io::StructuresContainer structures;
+  utility::loadStructures(structures, dir, getRunner()->memory().global().getSpeciesDatabase());
+
+  // Hold on to them again as if they had just come in
+  while(!structures.empty())
+  {
+    StructureData & data = getRunner()->registerData(SpStructureDataPtr(new StructureData()));
+    data.setStructure(structures.release(structures.begin()));
+    in(data);
+  }
+  return true;
+}
+
 size_t LowestFreeEnergy::release()
 {
   const size_t numReleased = myStructures.size();
@@ -69,57 +105,64 @@ bool LowestFreeEnergy::hasData() const
 void LowestFreeEnergy::keep(StructureData & structure, const double energy)
 {
   if(myKeepTopNMode)
+    keepTopN(structure, energy);
+  else
+    keepWithinCutoff(structure, energy);
+}
+
+void LowestFreeEnergy::keepTopN(StructureData & structure, const double energy)
+{
+  if(myStructures.size() < myKeepTopN)
   {
-    myStructures[energy] = &structure;
-    if(myStructures.size() > myKeepTopN)
-    {
-      // There are already enough
-      Structures::iterator removeStart = myStructures.begin();
-      // Skip over the ones we want to keep
-      for(size_t i = 0; i < myKeepTopN; ++i)
-        ++removeStart;
-
-      for(Structures::iterator it = removeStart, end = myStructures.end();
-        it != end; ++it)
-      {
-        getRunner()->dropData(*it->second);
-      }
-      // Remove the entries from the container
-      myStructures.erase(removeStart, myStructures.end());
-    }
+    myStructures.insert(Structures::value_type(energy, &structure));
+    return;
   }
-  else
+
+  // Full, so it has to beat the highest we have (which came in first if it's a tie)
+  if(myKeepTopN == 0 || energy >= myStructures.rbegin()->first)
   {
-    // Check if we have any structures yet
-    if(myStructures.empty())
-      myStructures[energy] = &structure;
-    else
-    {
-      if(energy < myStructures.begin()->first)
-        newLowest(structure, energy);
-      else if(energy < getEnergyCutoff())
-        myStructures[energy] = &structure;
-    }
+    getRunner()->dropData(structure);
+    return;
   }
+
+  myStructures.insert(Structures::value_type(energy, &structure));
+  dropHighest();
 }
 
-void LowestFreeEnergy::newLowest(StructureData & structure, const double energy)
+void LowestFreeEnergy::keepWithinCutoff(StructureData & structure, const double energy)
 {
-  myStructures[energy] = &structure;
-  const double cutoff = getEnergyCutoff();
+  // A new lowest is always kept, otherwise it has to be within the cutoff
+  const bool newLowest = myStructures.empty() || energy < myStructures.begin()->first;
+  if(!newLowest && energy > getEnergyCutoff())
+  {
+    getRunner()->dropData(structure);
+    return;
+  }
 
-  // Go from the end erasing all entries greater than the new cutoff
-  Structures::reverse_iterator it;
+  myStructures.insert(Structures::value_type(energy, &structure));
 
-  // Erasing using reverse iterator is a bit annoying
-  // see: http://stackoverflow.com/questions/1830158/how-to-call-erase-with-a-reverse-iterator
-  while((it = myStructures.rbegin())->first > cutoff)
-    myStructures.erase((++it).base());
+  // A new lowest brings the cutoff down so drop anything that's now above it
+  if(newLowest)
+  {
+    const double cutoff = getEnergyCutoff();
+    while(myStructures.size() > 1 && myStructures.rbegin()->first > cutoff)
+      dropHighest();
+  }
+}
+
+void LowestFreeEnergy::dropHighest()
+{
+  Structures::iterator highest = myStructures.end();
+  --highest;
+  getRunner()->dropData(*highest->second);
+  myStructures.erase(highest);
 }
 
 double LowestFreeEnergy::getEnergyCutoff() const
 {
-  return myStructures.begin()->first * (1.0 - myKeepTopEnergyPercentage);
+  // Measure the percentage from the lowest whatever its sign
+  const double lowest = myStructures.begin()->first;
+  return lowest + ::std::abs(lowest) * myKeepTopEnergyPercentage;
 }
 
 }
@@ -26,6 +26,13 @@
 namespace spipe {
 namespace blocks {
 
+/**
+/* Holds on to the lowest energy structures until released, either the lowest
+/* N or all those within a percentage of the lowest energy.  Anything that
+/* doesn't make the cut is dropped straight away.  In percentage mode a
+/* structure exactly at the cutoff is kept and the percentage is of the
+/* magnitude of the lowest energy so positive energies work too.
+/**/
 class LowestFreeEnergy : public SpBarrier, ::boost::noncopyable
 {
 public:
@@ -35,6 +42,8 @@ public:
 
   // From Block /////////////////
 	virtual void in(spipe::common::StructureData & data);
+  virtual bool saveState(const ::std::string & dir);
+  virtual bool restoreState(const ::std::string & dir);
   // End from Block /////////////
 
   // From Barrier /////////////////
@@ -44,10 +53,13 @@ public:
 
 private:
   typedef ::spipe::common::StructureData StructureData;
-  typedef ::std::map<double, StructureData *> Structures;
+  /** Ordered by energy, structures with the same energy are kept in the order they came in. */
+  typedef ::std::multimap<double, StructureData *> Structures;
 
   void keep(StructureData & structure, const double energy);
-  void newLowest(StructureData & structure, const double energy);
+  void keepTopN(StructureData & structure, const double energy);
+  void keepWithinCutoff(StructureData & structure, const double energy);
+  void dropHighest();
   double getEnergyCutoff() const;
 
   const bool myKeepTopNMode;
@@ -11,136 +11,353 @@
 #ifdef SP_USE_QHULL
 
 #include <algorithm>
+#include <cmath>
+#include <iostream>
 
 #include <boost/foreach.hpp>
 
-#include <pipelib/IPipeline.h>
-
-#include <libqhullcpp/Coordinates.h>
-#include <libqhullcpp/PointCoordinates.h>
 #include <libqhullcpp/Qhull.h>
-//#include <libqhullcpp/UsingLibQhull.h>
+#include <libqhullcpp/QhullFacet.h>
+#include <libqhullcpp/QhullFacetList.h>
+#include <libqhullcpp/QhullHyperplane.h>
+#include <libqhullcpp/QhullPoint.h>
+#include <libqhullcpp/QhullVertex.h>
+#include <libqhullcpp/QhullVertexSet.h>
 
 #include <common/Structure.h>
+#include <common/StructureProperties.h>
 
 #include "common/StructureData.h"
 
 // NAMESPACES ////////////////////////////////
 
 
-namespace spipe
-{
-namespace blocks
-{
+namespace spipe {
+namespace blocks {
 
 namespace ssc = ::sstbx::common;
+namespace structure_properties = ssc::structure_properties;
+
+namespace {
+const double TOLERANCE = 1e-10;
+
+bool sameComposition(const ::std::vector<double> & comp1, const ::std::vector<double> & comp2)
+{
+  for(size_t i = 0; i < comp1.size(); ++i)
+  {
+    if(::std::abs(comp1[i] - comp2[i]) > TOLERANCE)
+      return false;
+  }
+  return true;
+}
+}
 
-MakeConvexHull::MakeConvexHull():
-::pipelib::Block< ::spipe::StructureDataTyp, ::spipe::SharedDataType>("Make convex hull")
+MakeConvexHull::MakeConvexHull(const double dropAbove):
+SpBlock("Make convex hull"),
+myDropAbove(dropAbove)
 {}
 
-void MakeConvexHull::pipelineFinishing()
+void MakeConvexHull::in(StructureData & data)
 {
-  //myHullPoints.
+  const ssc::Structure * const structure = data.getStructure();
+  if(!structure || structure->getNumAtoms() == 0)
+  {
+    out(data);
+    return;
+  }
+
+  const double * enthalpy = structure->getProperty(structure_properties::general::ENTHALPY);
+  if(!enthalpy)
+    enthalpy = structure->getProperty(structure_properties::general::ENERGY_INTERNAL);
+  // Let anything that doesn't have an energy through
+  if(!enthalpy)
+  {
+    out(data);
+    return;
+  }
+
+  HullPoint point;
+  const bool newSpecies = getComposition(point.composition, *structure);
+  point.energy = *enthalpy / static_cast<double>(structure->getNumAtoms());
+  point.data = &data;
+
+  double distance;
+  if(!newSpecies &&
+    getDistanceAboveHull(distance, point.composition, point.energy) &&
+    distance > -TOLERANCE)
+  {
+    // On or above the hull so it stays as it is
+    if(distance > myDropAbove)
+    {
+      getRunner()->dropData(data);
+      return;
+    }
+    point.distance = ::std::max(distance, 0.0);
+    myPoints.push_back(point);
+    return;
+  }
+
+  // It's below the hull (or outside the compositions it covers) so it's now part of it
+  myPoints.push_back(point);
+  rebuildHull(point);
+  updateDistances();
 }
 
-void MakeConvexHull::in(StructureDataTyp & strData)
+void MakeConvexHull::pipelineFinishing()
 {
-  myStoichiometryData.addStoichiometry(strData);
+  mySpecies.clear();
+  myPoints.clear();
+  myVertices.clear();
+  myFacets.clear();
 }
 
 size_t MakeConvexHull::release()
 {
-  return 0;
+  // Pass them on closest to the hull first
+  ::std::stable_sort(myPoints.begin(), myPoints.end(), &MakeConvexHull::lowerDistance);
+
+  HullPoints toRelease;
+  toRelease.swap(myPoints);
+  BOOST_FOREACH(HullPoint & point, toRelease)
+  {
+    point.data->getStructure()->setProperty(structure_properties::searching::HULL_DISTANCE, point.distance);
+    out(*point.data);
+  }
+  return toRelease.size();
 }
 
 bool MakeConvexHull::hasData() const
 {
-  return false;
+  return !myPoints.empty();
 }
 
+bool MakeConvexHull::lowerDistance(const HullPoint & p1, const HullPoint & p2)
+{
+  return p1.distance < p2.distance;
+}
 
-void MakeConvexHull::StoichData::addStoichiometry(
-  const StructureDataTyp & strData)
+bool MakeConvexHull::getComposition(Composition & composition, const ssc::Structure & structure)
 {
-  const ssc::Structure * const structure = strData.getStructure();
+  const size_t numSpeciesBefore = mySpecies.size();
+
+  SpeciesContainer species;
+  structure.getAtomSpecies(species);
 
-  if(structure)
+  ::std::vector<size_t> counts(mySpecies.size(), 0);
+  BOOST_FOREACH(const ssc::AtomSpeciesId::Value & atomSpecies, species)
   {
-    const double energyPerAtom = *strData.enthalpy / structure->getNumAtoms();
+    const SpeciesContainer::const_iterator it =
+      ::std::find(mySpecies.begin(), mySpecies.end(), atomSpecies);
+    if(it == mySpecies.end())
+    {
+      mySpecies.push_back(atomSpecies);
+      counts.push_back(1);
+    }
+    else
+      ++counts[it - mySpecies.begin()];
+  }
 
-    ::std::vector<ssc::AtomSpeciesId::Value> species;
-    structure->getAtomSpecies(species);
+  composition.resize(mySpecies.size());
+  for(size_t i = 0; i < mySpecies.size(); ++i)
+    composition[i] = static_cast<double>(counts[i]) / static_cast<double>(species.size());
 
-    size_t maxSpeciesIndex = 0;
-    bool found;
-    BOOST_FOREACH(const ssc::AtomSpeciesId::Value & strSpecies, species)
+  if(mySpecies.size() == numSpeciesBefore)
+    return false;
+
+  // Everything up to now has none of the new species
+  BOOST_FOREACH(HullPoint & point, myPoints)
+  {
+    point.composition.resize(mySpecies.size(), 0.0);
+  }
+  BOOST_FOREACH(HullPoint & vertex, myVertices)
+  {
+    vertex.composition.resize(mySpecies.size(), 0.0);
+  }
+  return true;
+}
+
+bool MakeConvexHull::getDistanceAboveHull(
+  double & distance,
+  const Composition & composition,
+  const double energy) const
+{
+  if(myFacets.empty())
+  {
+    // No hull yet, compare to the lowest at the same composition
+    BOOST_FOREACH(const HullPoint & vertex, myVertices)
     {
-      found = false;
-      for(size_t i = 0; i < mySpecies.size(); ++i)
+      if(sameComposition(vertex.composition, composition))
       {
-        if(strSpecies == mySpecies[i])
-        {
-          found = true;
-          maxSpeciesIndex = ::std::max(maxSpeciesIndex, i);
-          break;
-        }
-      }
-      if(!found)
-      {
-        // Add it to the list
-        maxSpeciesIndex = mySpecies.size();
-        mySpecies.push_back(strSpecies);
+        distance = energy - vertex.energy;
+        return true;
       }
     }
+    return false;
+  }
+
+  const ::arma::vec x = toHullCoordinates(composition);
+  BOOST_FOREACH(const Facet & facet, myFacets)
+  {
+    const ::arma::vec lambda = facet.toBarycentric * (x - facet.origin);
+    if(lambda.min() < -TOLERANCE || ::arma::accu(lambda) > 1.0 + TOLERANCE)
+      continue;
 
-    ::std::vector<size_t> speciesCounts(maxSpeciesIndex + 1);
+    distance = energy - (::arma::dot(facet.gradient, x) + facet.offset);
+    return true;
+  }
+  return false;
+}
+
+void MakeConvexHull::rebuildHull(const HullPoint & newPoint)
+{
+  // Anything that wasn't on the bottom of the hull before can't be now
+  HullPoints candidates(myVertices);
+  candidates.push_back(newPoint);
+  candidates.back().data = NULL;
+
+  if(runQhull(candidates))
+    return;
+
+  if(!myFacets.empty())
+  {
+    // Qhull couldn't cope with the new point, rather than lose the hull we
+    // have keep it and try the point again next time the hull is rebuilt
+    ::std::cerr << "Failed to rebuild convex hull, keeping the previous one" << ::std::endl;
+    myVertices.push_back(candidates.back());
+    return;
+  }
 
-    for(size_t i = 0; i <= maxSpeciesIndex; ++i)
+  // Not enough points (or they are all in a plane) for a hull so just keep the
+  // lowest at each composition
+  HullPoints lowest;
+  BOOST_FOREACH(const HullPoint & candidate, candidates)
+  {
+    HullPoints::iterator it = lowest.begin();
+    for(; it != lowest.end(); ++it)
     {
-      speciesCounts[i] = structure->getNumAtomsOfSpecies(mySpecies[i]);
+      if(sameComposition(it->composition, candidate.composition))
+        break;
     }
+    if(it == lowest.end())
+      lowest.push_back(candidate);
+    else if(candidate.energy < it->energy)
+      *it = candidate;
+  }
+  myVertices.swap(lowest);
+}
 
-    // Now construct a species matrix for this structure
-    HullPoints::iterator hullPoint = myHullPoints.insert(
-      myHullPoints.end(),
-      HullPoint(
-        energyPerAtom,
-        SpeciesMatrix(maxSpeciesIndex + 1, maxSpeciesIndex + 1)
-      )
-    );
+bool MakeConvexHull::runQhull(const HullPoints & candidates)
+{
+  // Each point is the composition (less the last species as the fractions sum
+  // to one) followed by the energy
+  const size_t dims = mySpecies.size();
+  if(dims < 2 || candidates.size() <= dims)
+    return false;
+
+  ::std::vector<double> coords;
+  coords.reserve(candidates.size() * dims);
+  BOOST_FOREACH(const HullPoint & candidate, candidates)
+  {
+    coords.insert(coords.end(), candidate.composition.begin(), candidate.composition.begin() + dims - 1);
+    coords.push_back(candidate.energy);
+  }
 
-    SpeciesMatrix & speciesMtx = hullPoint->speciesMtx;
+  orgQhull::Qhull qhull;
+  try
+  {
+    // Triangulate so that every facet is a simplex
+    qhull.runQhull("", static_cast<int>(dims), static_cast<int>(candidates.size()), &coords[0], "Qt");
+  }
+  catch(const ::std::exception & /*e*/)
+  {
+    return false;
+  }
 
-    for(size_t row = 0; row <= maxSpeciesIndex - 1; ++row)
+  Facets facets;
+  ::std::vector<bool> isVertex(candidates.size(), false);
+  const orgQhull::QhullFacetList facetList = qhull.facetList();
+  for(orgQhull::QhullFacetList::const_iterator it = facetList.begin(), end = facetList.end();
+    it != end; ++it)
+  {
+    const orgQhull::QhullFacet qFacet = *it;
+    const orgQhull::QhullHyperplane plane = qFacet.hyperplane();
+    const double energyNormal = plane.coordinates()[dims - 1];
+    // Only the bottom of the hull matters
+    if(energyNormal > -TOLERANCE)
+      continue;
+
+    const orgQhull::QhullVertexSet qVertices = qFacet.vertices();
+    if(static_cast<size_t>(qVertices.size()) != dims)
+      continue;
+
+    ::arma::mat vertices(dims - 1, dims);
+    size_t col = 0;
+    for(orgQhull::QhullVertexSet::const_iterator vIt = qVertices.begin(), vEnd = qVertices.end();
+      vIt != vEnd; ++vIt, ++col)
     {
-      for(size_t col = row + 1; col <= maxSpeciesIndex; ++col)
-      {
-        speciesMtx(row, col) =
-          speciesCounts[row] / (speciesCounts[row] + speciesCounts[col]);
-      }
+      const double * const point = (*vIt).point().coordinates();
+      isVertex[(point - &coords[0]) / dims] = true;
+      for(size_t row = 0; row < dims - 1; ++row)
+        vertices(row, col) = point[row];
     }
+
+    Facet facet;
+    facet.origin = vertices.col(0);
+    ::arma::mat edges(dims - 1, dims - 1);
+    for(size_t i = 1; i < dims; ++i)
+      edges.col(i - 1) = vertices.col(i) - facet.origin;
+    // Skip facets that are vertical (they have no extent in composition)
+    if(!::arma::inv(facet.toBarycentric, edges))
+      continue;
+
+    // The plane is normal . (x, E) + offset = 0, rearrange to get E(x)
+    facet.gradient.set_size(dims - 1);
+    for(size_t i = 0; i < dims - 1; ++i)
+      facet.gradient(i) = -plane.coordinates()[i] / energyNormal;
+    facet.offset = -plane.offset() / energyNormal;
+    facets.push_back(facet);
   }
+  if(facets.empty())
+    return false;
+
+  HullPoints vertices;
+  for(size_t i = 0; i < candidates.size(); ++i)
+  {
+    if(isVertex[i])
+      vertices.push_back(candidates[i]);
+  }
+  myVertices.swap(vertices);
+  myFacets.swap(facets);
+  return true;
 }
 
-void MakeConvexHull::StoichData::makeHull() const
+void MakeConvexHull::updateDistances()
 {
-  // Dimensions = num species + 1 (for energy)
-  const size_t dims = mySpecies.size() + 1;
-  orgQhull::PointCoordinates points(dims);
+  HullPoints kept;
+  kept.reserve(myPoints.size());
 
-  ::std::vector<double> coords(dims);
-  BOOST_FOREACH(const HullPoint & hullPoint, myHullPoints)
+  double distance;
+  BOOST_FOREACH(HullPoint & point, myPoints)
   {
-    points.append(orgQhull::Coordinates(hullPoint.pointCoordinates(dims)));
+    // If it's not over any facet it must be on the edge of the hull
+    if(!getDistanceAboveHull(distance, point.composition, point.energy))
+      distance = 0.0;
+    point.distance = ::std::max(distance, 0.0);
+
+    if(point.distance > myDropAbove)
+      getRunner()->dropData(*point.data);
+    else
+      kept.push_back(point);
   }
-
+  myPoints.swap(kept);
 }
 
-void MakeConvexHull::StoichData::clear()
+::arma::vec MakeConvexHull::toHullCoordinates(const Composition & composition) const
 {
-  mySpecies.clear();
-  myHullPoints.clear();
+  ::arma::vec x(composition.size() - 1);
+  for(size_t i = 0; i < composition.size() - 1; ++i)
+    x(i) = composition[i];
+  return x;
 }
 
 }
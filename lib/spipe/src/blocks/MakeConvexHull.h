@@ -14,7 +14,7 @@
 
 #ifdef SP_USE_QHULL
 
-#include <map>
+#include <limits>
 #include <vector>
 
 #include <boost/noncopyable.hpp>
@@ -28,18 +28,34 @@
 #include "SpTypes.h"
 
 // FORWARD DECLARATIONS ////////////////////////////////////
+namespace sstbx {
+namespace common {
+class Structure;
+}
+}
 
 namespace spipe {
 namespace blocks {
 
-class MakeConvexHull : ::pipelib::AbstractSimpleBarrier<StructureDataTyp, SharedDataType>, ::boost::noncopyable
+/**
+/* Builds the convex hull of the enthalpy per atom against composition of the
+/* structures as they come in and holds on to them until released, at which
+/* point each is given its distance above the hull.  The hull is only rebuilt
+/* (using Qhull) when a structure lands below it, and then only from the
+/* current hull vertices and the new point.  Structures that are more than
+/* dropAbove per atom above the hull can never make it back down so they are
+/* dropped as soon as they are known to be that far above.  This is only once
+/* they reach this block, which needs their final energy, so anything before
+/* it in the pipe (e.g. relaxing) has already been done for them.
+/**/
+class MakeConvexHull : public SpBarrier, ::boost::noncopyable
 {
 public:
 
-  MakeConvexHull();
+  explicit MakeConvexHull(const double dropAbove = ::std::numeric_limits<double>::max());
 
   // From Block ///////////
-  virtual void in(StructureDataTyp & strData);
+  virtual void in(::spipe::common::StructureData & data);
   virtual void pipelineFinishing();
   // End from Block ///////
 
@@ -49,78 +65,50 @@ public:
   // End from Barrier //////////////
 
 private:
+  typedef ::spipe::common::StructureData StructureData;
+  typedef ::std::vector< ::sstbx::common::AtomSpeciesId::Value> SpeciesContainer;
+  /** The fraction of each species, in the order they were first seen. */
+  typedef ::std::vector<double> Composition;
 
-  class StoichData
+  struct HullPoint
   {
-  public:
-
-    void addStoichiometry(const StructureDataTyp & strData);
-
-    void clear();
-
-    void makeHull() const;
-
-
-  private:
-
-    typedef ::arma::mat                     SpeciesMatrix;
-
-    struct HullPoint
-    {
-      HullPoint(const double _energyPerAtom, const SpeciesMatrix & _speciesMtx):
-        energyPerAtom(_energyPerAtom),
-        speciesMtx(_speciesMtx)
-      {}
-
-      HullPoint & operator =(const HullPoint & rhs)
-      {
-        energyPerAtom = rhs.energyPerAtom;
-        speciesMtx = rhs.speciesMtx;
-        return *this;
-      }
+    HullPoint(): energy(0.0), data(NULL), distance(0.0) {}
 
-      ::std::vector<double> pointCoordinates(const size_t numSpecies) const
-      {
-        const size_t numPoints = numSpecies * (numSpecies - 1) / 2.0 + 1;
-        ::std::vector<double> coords(numPoints);
-
-        // Fill the thing with 0
-        coords.assign(numPoints + 1, 0.0);
-        // Energy is always the first entry
-        coords[0] = energyPerAtom;
-
-        // Unroll the matrix
-        size_t idx = 1;
-        for(size_t row = 0; row < speciesMtx.n_rows - row; ++row)
-        {
-          for(size_t col = row + 1; col < speciesMtx.n_cols; ++col)
-          {
-            coords[idx] = speciesMtx(row, col);
-            ++idx;
-          }
-        }
-        return coords;
-      }
-
-      double              energyPerAtom;
-      SpeciesMatrix       speciesMtx;
-    };
-
-    typedef ::std::vector< ::sstbx::common::AtomSpeciesId::Value> SpeciesContainer;
-    typedef ::std::vector<HullPoint>    HullPoints;
-
-    /** All the species being used for the convex hull */
-    SpeciesContainer          mySpecies;
-    HullPoints                myHullPoints;
+    Composition composition;
+    double energy;
+    StructureData * data;
+    double distance;
+  };
+  typedef ::std::vector<HullPoint> HullPoints;
 
+  /** A lower facet of the hull. */
+  struct Facet
+  {
+    ::arma::vec origin;
+    ::arma::mat toBarycentric;
+    ::arma::vec gradient;
+    double offset;
   };
+  typedef ::std::vector<Facet> Facets;
 
-  StoichData  myStoichiometryData;
+  static bool lowerDistance(const HullPoint & p1, const HullPoint & p2);
 
-  
+  bool getComposition(Composition & composition, const ::sstbx::common::Structure & structure);
+  bool getDistanceAboveHull(double & distance, const Composition & composition, const double energy) const;
+  void rebuildHull(const HullPoint & newPoint);
+  bool runQhull(const HullPoints & candidates);
+  void updateDistances();
+  ::arma::vec toHullCoordinates(const Composition & composition) const;
 
-};
+  const double myDropAbove;
 
+  SpeciesContainer mySpecies;
+  /** The structures we're holding on to. */
+  HullPoints myPoints;
+  /** The points (not necessarily held) that make up the bottom of the hull. */
+  HullPoints myVertices;
+  Facets myFacets;
+};
 
 }
 }
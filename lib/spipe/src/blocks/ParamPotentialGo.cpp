@@ -99,6 +99,14 @@ void ParamPotentialGo::in(spipe::common::StructureData & data)
   PotentialGo::in(data);
 }
 
+void ParamPotentialGo::inBatch(const DataBatch & batch)
+{
+  for(size_t i = 0; i < batch.size(); ++i)
+    batch[i]->objectsStore[common::GlobalKeys::POTENTIAL_PARAMS] = myCurrentParams;
+
+  PotentialGo::inBatch(batch);
+}
+
 void ParamPotentialGo::init()
 {
   SSLIB_ASSERT_MSG(
@@ -58,6 +58,7 @@ public:
 
   // From PipeBlock ///////////////////////////
 	virtual void in(spipe::common::StructureData & data);
+  virtual void inBatch(const DataBatch & batch);
   // End from PipeBlock ///////////////////////
 
 private:
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <locale>
 #include <set>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -69,20 +70,55 @@ void PotentialGo::pipelineInitialising()
   myTableSupport.registerRunner(*getRunner());
 }
 
-void PotentialGo::in(spipe::common::StructureData & data)
+void PotentialGo::inBatch(const DataBatch & batch)
 {
-  ssc::Structure * const structure = data.getStructure();
-  const ssp::OptimisationOutcome outcome = myOptimiser->optimise(*structure, myOptimisationParams);
-	if(outcome.isSuccess())
+  // Let the optimiser do all the structures at once
+  ssp::IGeomOptimiser::Structures structures;
+  structures.reserve(batch.size());
+  BOOST_FOREACH(spipe::common::StructureData * const data, batch)
+    structures.push_back(data->getStructure());
+
+  ::std::vector<ssp::OptimisationOutcome> outcomes;
+  myOptimiser->optimise(structures, outcomes, myOptimisationParams);
+
+  for(size_t i = 0; i < batch.size(); ++i)
   {
-    // Update our data table with the structure data
-    updateTable(*structure);
+    if(outcomes[i].isSuccess())
+    {
+      updateTable(*structures[i]);
+      out(*batch[i]);
+    }
+    else
+    {
+      ::std::cerr << "Optimisation failed: " << outcomes[i].getMessage() << ::std::endl;
+      getRunner()->dropData(*batch[i]);
+    }
+  }
+}
 
-	  out(data);
+bool PotentialGo::processAsync(spipe::common::StructureData & data)
+{
+  // May be on another thread so only touch the structure
+  const ssp::OptimisationOutcome outcome = myOptimiser->optimise(*data.getStructure(), myOptimisationParams);
+  if(!outcome.isSuccess())
+  {
+    // Build the whole message first so it doesn't get interleaved with others
+    ::std::cerr << ("Optimisation failed: " + outcome.getMessage() + "\n") << ::std::flush;
+    return false;
+  }
+  return true;
+}
+
+void PotentialGo::processed(spipe::common::StructureData & data, const bool keep)
+{
+  if(keep)
+  {
+    // Update our data table with the structure data
+    updateTable(*data.getStructure());
+    out(data);
   }
   else
   {
-    ::std::cerr << "Optimisation failed: " << outcome.getMessage() << ::std::endl;
     // The structure failed to geometry optimise properly so drop it
     getRunner()->dropData(data);
   }
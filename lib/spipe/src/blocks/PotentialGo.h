@@ -42,7 +42,11 @@ class IPotential;
 namespace spipe {
 namespace blocks {
 
-class PotentialGo : public SpPipeBlock, ::boost::noncopyable
+/**
+/* The optimisations are done by the async executor, by default this is serial
+/* but it can be given a thread pool to optimise several structures at once.
+/**/
+class PotentialGo : public SpAsyncPipeBlock, ::boost::noncopyable
 {
 public:
 
@@ -62,7 +66,8 @@ public:
   // End from Block //////////////////////////
 
   // From PipeBlock ///////////////////////////
-	virtual void in(spipe::common::StructureData & data);
+  virtual void inBatch(const DataBatch & batch);
+  virtual bool supportsBatches() const { return true; }
   // End from PipeBlock ///////////////////////
 
 protected:
@@ -71,6 +76,11 @@ protected:
 
   void updateTable(const sstbx::common::Structure & structure);
 
+  // From AsyncPipeBlock //////////////////////
+  virtual bool processAsync(spipe::common::StructureData & data);
+  virtual void processed(spipe::common::StructureData & data, const bool keep);
+  // End from AsyncPipeBlock //////////////////
+
   // Should we write information about structures being optimised
   // to file.
   const bool myWriteOutput;
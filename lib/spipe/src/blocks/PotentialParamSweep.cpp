@@ -8,11 +8,15 @@
 // INCLUDES //////////////////////////////////
 #include "blocks/PotentialParamSweep.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
 
 // From SSTbx
 #include <common/Structure.h>
+#include <io/BoostFilesystem.h>
 #include <utility/MultiIdxRange.h>
 #include <utility/UtilFunctions.h>
 
@@ -20,6 +24,7 @@
 #include "common/SharedData.h"
 #include "common/StructureData.h"
 #include "common/UtilityFunctions.h"
+#include "utility/Checkpointer.h"
 
 // NAMESPACES ////////////////////////////////
 
@@ -35,14 +40,42 @@ typedef common::GlobalKeys Keys;
 
 const ::std::string PotentialParamSweep::POTPARAMS_FILE_EXTENSION("potparams");
 
+namespace {
+
+const char PROGRESS_FILE[] = "progress";
+const char DONE_STRUCTURES_DIR[] = "done";
+
+double getEnergyPerAtom(const ssc::Structure & structure)
+{
+  const double * const energy = structure.getProperty(structure_properties::general::ENERGY_INTERNAL);
+  if(!energy || structure.getNumAtoms() == 0)
+    return ::std::numeric_limits<double>::max();
+  return *energy / static_cast<double>(structure.getNumAtoms());
+}
+
+struct LowerEnergyPerAtom
+{
+  bool operator()(
+    const common::SharedStructures::value_type & lhs,
+    const common::SharedStructures::value_type & rhs) const
+  {
+    return getEnergyPerAtom(*lhs) < getEnergyPerAtom(*rhs);
+  }
+};
+
+}
+
 PotentialParamSweep::PotentialParamSweep(
   const common::ParamRange & paramRange,
 	SubpipePtr sweepPipeline):
 SpBlock("Potential param sweep"),
 myParamRange(paramRange),
-mySweepPipeline(sweepPipeline),
-myStepExtents(paramRange.nSteps.size())
+myStepExtents(paramRange.nSteps.size()),
+myWarmStart(false),
+myNumPointsDone(0)
 {
+  mySweepPipelines.push_back(sweepPipeline.release());
+
 	SP_ASSERT(
     (myParamRange.from.size() == myParamRange.step.size()) &&
     (myParamRange.from.size() == myParamRange.nSteps.size())
@@ -55,6 +88,23 @@ myStepExtents(paramRange.nSteps.size())
 	}
 }
 
+bool PotentialParamSweep::getWarmStart() const
+{
+  return myWarmStart;
+}
+
+void PotentialParamSweep::setWarmStart(const bool warmStart)
+{
+  myWarmStart = warmStart;
+}
+
+void PotentialParamSweep::addWorkerPipe(SubpipePtr sweepPipeline)
+{
+  SP_ASSERT(!getRunner());
+
+  mySweepPipelines.push_back(sweepPipeline.release());
+}
+
 void PotentialParamSweep::pipelineInitialising()
 {
 	// Set the parameters in the shared data
@@ -69,75 +119,169 @@ void PotentialParamSweep::pipelineInitialising()
 
 void PotentialParamSweep::start()
 {
-  ::std::string sweepPipeOutputPath;
+  mySweepOrder.clear();
+  generateSweepOrder(mySweepOrder);
+  mySweepOutputPaths.assign(mySweepOrder.size(), ::std::string());
+
+  // In warm start mode each point depends on the ones done before it so
+  // they have to be done one after the other.  If we've been restored from
+  // a checkpoint carry on from the first point that wasn't finished.
+  myWorkers.run(mySweepOrder.size(), *this, !myWarmStart, myNumPointsDone);
+
+  mySweepOrder.clear();
+  mySweepOutputPaths.clear();
+  myDoneStructures.clear();
+  myNumPointsDone = 0;
+}
 
-  const ssu::MultiIdxRange<int> stepsRange(
-    ParamSpaceIdx(myStepExtents.dims()),
-    myStepExtents
-  );
+bool PotentialParamSweep::saveState(const ::std::string & dir)
+{
+  const fs::path stateDir(dir);
+  {
+    fs::ofstream progressFile(stateDir / PROGRESS_FILE);
+    progressFile << myNumPointsDone << ::std::endl;
+    myTableSupport.getTable().save(progressFile);
+    if(!progressFile.good())
+      return false;
+  }
 
-  PotentialParams params(myNumParams);
-  BOOST_FOREACH(const ParamSpaceIdx & stepsIdx, stepsRange)
-	{
-    ::spipe::SharedDataType & sweepPipeSharedData = mySubpipeRunner->memory().shared();
+  // Save the structures that the remaining points will be seeded with
+  const ssc::AtomSpeciesDatabase & speciesDb = getRunner()->memory().global().getSpeciesDatabase();
+  ::std::vector<const ssc::Structure *> structures;
+  BOOST_FOREACH(const DoneStructures::value_type & done, myDoneStructures)
+  {
+    structures.clear();
+    BOOST_FOREACH(const common::SharedStructures::value_type & structure, done.second)
+    {
+      structures.push_back(structure.get());
+    }
+    if(!utility::saveStructures(
+      stateDir / DONE_STRUCTURES_DIR / ::boost::lexical_cast< ::std::string>(done.first),
+      structures,
+      speciesDb))
+      return false;
+  }
+  return true;
+}
+
+bool PotentialParamSweep::restoreState(const ::std::string & dir)
+{
+  const fs::path stateDir(dir);
+  {
+    fs::ifstream progressFile(stateDir / PROGRESS_FILE);
+    size_t numPointsDone;
+    progressFile >> numPointsDone;
+    progressFile.ignore(::std::numeric_limits< ::std::streamsize>::max(), '\n');
+    if(progressFile.fail() || !myTableSupport.getTable().load(progressFile))
+      return false;
+    myNumPointsDone = numPointsDone;
+  }
+
+  myDoneStructures.clear();
+  const fs::path doneDir(stateDir / DONE_STRUCTURES_DIR);
+  if(fs::is_directory(doneDir))
+  {
+    const ssc::AtomSpeciesDatabase & speciesDb = getRunner()->memory().global().getSpeciesDatabase();
+    ssio::StructuresContainer structures;
+    for(fs::directory_iterator it(doneDir), end; it != end; ++it)
+    {
+      common::SharedStructures & done =
+        myDoneStructures[::boost::lexical_cast<size_t>(it->path().filename().string())];
+      utility::loadStructures(structures, it->path(), speciesDb);
+      while(!structures.empty())
+        done.push_back(common::SharedStructures::value_type(structures.release(structures.begin()).release()));
+    }
+  }
+  return true;
+}
 
-		// Load the current potential parameters into the pipeline data
-		for(size_t i = 0; i < myNumParams; ++i)
-			params[i] = myParamRange.from[i] +
-      static_cast<double>(stepsIdx[i]) * myParamRange.step[i];
+void PotentialParamSweep::runnerAttached(SpRunnerSetup & setup)
+{
+  myWorkers.clear();
+  BOOST_FOREACH(SpPipe & sweepPipeline, mySweepPipelines)
+  {
+    myWorkers.addWorker(setup, sweepPipeline);
+  }
+}
 
-		// Store the potential parameters in global memory
-    getRunner()->memory().global().objectsStore[common::GlobalKeys::POTENTIAL_PARAMS] = params;
+void PotentialParamSweep::prepareJob(const size_t job, SpRunner & runner)
+{
+  const ParamSpaceIdx & stepsIdx = mySweepOrder[job];
+  ::spipe::SharedDataType & sweepPipeSharedData = runner.memory().shared();
 
-    // Set a directory for this set of parameters
-    sweepPipeSharedData.appendToOutputDirName(ssu::generateUniqueName());
+	// Load the current potential parameters into the pipeline data
+  PotentialParams params(myNumParams);
+	for(size_t i = 0; i < myNumParams; ++i)
+		params[i] = myParamRange.from[i] +
+    static_cast<double>(stepsIdx[i]) * myParamRange.step[i];
 
-    // Get the relative path to where the pipeline write the structures to
-    sweepPipeOutputPath = sweepPipeSharedData.getOutputPath(*mySubpipeRunner).string();
+  // Store the potential parameters in the shared memory of the runner doing this point,
+  // it's reset after each run and, unlike global memory, not seen by the other workers
+  sweepPipeSharedData.objectsStore[common::GlobalKeys::POTENTIAL_PARAMS] = params;
 
-		// Run the sweep pipeline
-		mySubpipeRunner->run();
+  if(myWarmStart)
+  {
+    // Seed the sweep pipeline with what was found at the neighbouring points
+    common::SharedStructures seeds;
+    getNeighbourStructures(seeds, stepsIdx);
+    if(!seeds.empty())
+      sweepPipeSharedData.objectsStore[common::GlobalKeys::SEED_STRUCTURES] = seeds;
+
+    // Ask for a copy of the unique structures found at this point
+    runner.memory().global().objectsStore[common::GlobalKeys::UNIQUE_STRUCTURES] =
+      common::SharedStructures();
+  }
 
-		// Send any finished structure data down my pipe
-		releaseBufferedStructures(sweepPipeOutputPath);
-	}
-}
+  // Set a directory for this set of parameters
+  sweepPipeSharedData.appendToOutputDirName(ssu::generateUniqueName());
 
-void PotentialParamSweep::runnerAttached(SpRunnerSetup & setup)
-{
-  mySubpipeRunner = setup.createChildRunner(*mySweepPipeline);
-	// Set outselves to collect any finished data from the sweep pipeline
-	mySubpipeRunner->setFinishedDataSink(this);
+  // Get the relative path to where the pipeline write the structures to
+  mySweepOutputPaths[job] = sweepPipeSharedData.getOutputPath(runner).string();
 }
 
-void PotentialParamSweep::finished(SpStructureDataPtr data)
+void PotentialParamSweep::jobDataFinished(
+  const size_t job,
+  StructureDataType & data,
+  SpRunner & runner)
 {
 	// Copy over the parameters into the structure data
   const ::spipe::common::ObjectData<const PotentialParams> result = ::spipe::common::getObjectConst(
     ::spipe::common::GlobalKeys::POTENTIAL_PARAMS,
-    mySubpipeRunner->memory()
+    runner.memory()
   );
 
   if(result.first != common::DataLocation::NONE)
-    data->objectsStore[common::GlobalKeys::POTENTIAL_PARAMS] = *result.second;
-
-	// Register the data with our pipeline to transfer ownership
-	// Save it in the buffer for sending down the pipe
-	myBuffer.push_back(&getRunner()->registerData(data));
+    data.objectsStore[common::GlobalKeys::POTENTIAL_PARAMS] = *result.second;
 }
 
-void PotentialParamSweep::releaseBufferedStructures(
-  const ::spipe::utility::DataTable::Key & key
-)
+void PotentialParamSweep::jobFinished(const size_t job, FinishedData & finished)
 {
+  if(myWarmStart)
+  {
+    ::spipe::GlobalDataType & globalData = getRunner()->memory().global();
+    common::SharedStructures * const uniqueStructures =
+      globalData.objectsStore.find(common::GlobalKeys::UNIQUE_STRUCTURES);
+    if(uniqueStructures)
+      myDoneStructures[getLinearIndex(mySweepOrder[job])].swap(*uniqueStructures);
+    globalData.objectsStore.erase(common::GlobalKeys::UNIQUE_STRUCTURES);
+  }
+
 	// Send any finished structure data down my pipe
-	BOOST_FOREACH(StructureDataType * const sweepStrData, myBuffer)
+  StructureDataType * sweepStrData;
+  while(!finished.empty())
 	{
-    updateTable(key, *sweepStrData);
+    // Register the data with our pipeline to transfer ownership
+    sweepStrData = &getRunner()->registerData(
+      SpStructureDataPtr(finished.release(finished.begin()).release())
+    );
+
+    updateTable(mySweepOutputPaths[job], *sweepStrData);
 
 		out(*sweepStrData);
 	}
-	myBuffer.clear();
+
+  myNumPointsDone = job + 1;
+  utility::checkpoint(*getRunner());
 }
 
 void PotentialParamSweep::updateTable(
@@ -200,6 +344,80 @@ void PotentialParamSweep::updateTable(
   }
 }
 
+void PotentialParamSweep::generateSweepOrder(SweepOrder & order) const
+{
+  const ssu::MultiIdxRange<int> stepsRange(
+    ParamSpaceIdx(myStepExtents.dims()),
+    myStepExtents
+  );
+
+  ParamSpaceIdx snakeIdx(myStepExtents.dims());
+  BOOST_FOREACH(const ParamSpaceIdx & stepsIdx, stepsRange)
+  {
+    if(myWarmStart)
+    {
+      // Walk the space boustrophedon style: a dimension is traversed in reverse
+      // whenever the indices of the slower dimensions sum to an odd number.  This
+      // way consecutive points are always neighbours.
+      int slowerSum = 0;
+      for(size_t i = myNumParams; i > 0; --i)
+      {
+        const size_t dim = i - 1;
+        snakeIdx[dim] = (slowerSum % 2 == 0) ?
+          stepsIdx[dim] : myStepExtents[dim] - 1 - stepsIdx[dim];
+        slowerSum += snakeIdx[dim];
+      }
+      order.push_back(snakeIdx);
+    }
+    else
+      order.push_back(stepsIdx);
+  }
 }
+
+size_t PotentialParamSweep::getLinearIndex(const ParamSpaceIdx & stepsIdx) const
+{
+  size_t linearIdx = 0;
+  size_t stride = 1;
+  for(size_t i = 0; i < myNumParams; ++i)
+  {
+    linearIdx += static_cast<size_t>(stepsIdx[i]) * stride;
+    stride *= static_cast<size_t>(myStepExtents[i]);
+  }
+  return linearIdx;
 }
 
+void PotentialParamSweep::getNeighbourStructures(
+  common::SharedStructures & structures,
+  const ParamSpaceIdx & stepsIdx) const
+{
+  // Go through all the points in the 3^n block surrounding this one
+  const ssu::MultiIdxRange<int> offsets(
+    ParamSpaceIdx(myNumParams, -1),
+    ParamSpaceIdx(myNumParams, 2)
+  );
+
+  ParamSpaceIdx neighbour(myNumParams);
+  bool inRange;
+  BOOST_FOREACH(const ParamSpaceIdx & offset, offsets)
+  {
+    if(offset.min() == 0 && offset.max() == 0)
+      continue; // This is us
+
+    neighbour = stepsIdx + offset;
+    inRange = true;
+    for(size_t i = 0; inRange && i < myNumParams; ++i)
+      inRange = neighbour[i] >= 0 && neighbour[i] < myStepExtents[i];
+    if(!inRange)
+      continue;
+
+    const DoneStructures::const_iterator it = myDoneStructures.find(getLinearIndex(neighbour));
+    if(it != myDoneStructures.end())
+      structures.insert(structures.end(), it->second.begin(), it->second.end());
+  }
+
+  // Put the most promising candidates first
+  ::std::stable_sort(structures.begin(), structures.end(), LowerEnergyPerAtom());
+}
+
+}
+}
@@ -11,9 +11,11 @@
 // INCLUDES /////////////////////////////////////////////
 #include "StructurePipe.h"
 
+#include <map>
 #include <vector>
 
 #include <boost/noncopyable.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include <armadillo>
@@ -28,6 +30,8 @@
 #include "common/CommonData.h"
 #include "utility/DataTable.h"
 #include "utility/DataTableSupport.h"
+#include "utility/ISubpipeJobs.h"
+#include "utility/SubpipeWorkers.h"
 
 namespace spipe {
 
@@ -38,7 +42,7 @@ class DataTableWriter;
 
 namespace blocks {
 
-class PotentialParamSweep : public SpStartBlock, public SpFinishedSink, ::boost::noncopyable
+class PotentialParamSweep : public SpStartBlock, public utility::ISubpipeJobs, ::boost::noncopyable
 {
 public:
   typedef ::sstbx::UniquePtr< ::spipe::SpPipe>::Type SubpipePtr;
@@ -47,45 +51,76 @@ public:
 
 	PotentialParamSweep(const common::ParamRange & paramRange, SubpipePtr sweepPipeline);
 
+  /**
+  /* In warm start mode the parameter space is walked in an order where consecutive
+  /* points are neighbours and each point is seeded with the unique structures found
+  /* at the neighbouring points that have already been done.
+  /**/
+  bool getWarmStart() const;
+  void setWarmStart(const bool warmStart);
+
+  /**
+  /* Add another, independent, instance of the sweep pipeline.  Each instance gets
+  /* its own thread so this many parameter points are done concurrently.  Must be
+  /* called before the block is attached to a runner.
+  /**/
+  void addWorkerPipe(SubpipePtr sweepPipeline);
+
 	// From Block /////////////////////////////////
 	virtual void start();
+  virtual bool saveState(const ::std::string & dir);
+  virtual bool restoreState(const ::std::string & dir);
 	// End from Block //////////////////////////////
 
 private:
 
   typedef ::sstbx::utility::MultiIdx<int> ParamSpaceIdx;
   typedef ::std::vector<double> PotentialParams;
+  typedef ::std::vector<ParamSpaceIdx> SweepOrder;
+  typedef ::std::map<size_t, common::SharedStructures> DoneStructures;
 
   // From Block ///////////////////////////////
   virtual void runnerAttached(SpRunnerSetup & setup);
   virtual void pipelineInitialising();
   // End From Block ///////////////////////////
 
-  // From FinishedSink ///////////////////////
-  virtual void finished(SpStructureDataPtr data);
-  // End from FinishedSink //////////////////
-
-  void releaseBufferedStructures(
-    const ::spipe::utility::DataTable::Key & key
-  );
+  // From ISubpipeJobs ///////////////////////
+  virtual void prepareJob(const size_t job, SpRunner & runner);
+  virtual void jobDataFinished(const size_t job, StructureDataType & data, SpRunner & runner);
+  virtual void jobFinished(const size_t job, FinishedData & finished);
+  // End from ISubpipeJobs ///////////////////
 
   void updateTable(
     const utility::DataTable::Key & key,
     const StructureDataType & sweepStrData
   );
 
+  void generateSweepOrder(SweepOrder & order) const;
+  size_t getLinearIndex(const ParamSpaceIdx & stepsIdx) const;
+  void getNeighbourStructures(
+    common::SharedStructures & structures,
+    const ParamSpaceIdx & stepsIdx
+  ) const;
+
 	size_t myNumParams;
   const common::ParamRange myParamRange;
 	ParamSpaceIdx	myStepExtents;
+  bool myWarmStart;
 
   ::spipe::utility::DataTableSupport myTableSupport;
 
-	SubpipePtr mySweepPipeline;
+  /** One instance of the sweep pipeline per worker. */
+  ::boost::ptr_vector<SpPipe> mySweepPipelines;
+  utility::SubpipeWorkers myWorkers;
 
-	/** Buffer to store structure that have finished their path through the sub pipeline. */
-	::std::vector<StructureDataType *>		myBuffer;
-  SpChildRunnerPtr mySubpipeRunner;
+  /** The parameter points being done in the current sweep and where each one is saved. */
+  SweepOrder mySweepOrder;
+  ::std::vector< ::std::string> mySweepOutputPaths;
+  /** The number of points, in sweep order, that have been finished. */
+  size_t myNumPointsDone;
 
+  /** The unique structures found at each parameter point done so far (warm start mode only). */
+  DoneStructures myDoneStructures;
 };
 
 }}
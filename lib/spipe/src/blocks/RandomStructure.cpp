@@ -9,7 +9,10 @@
 #include "blocks/RandomStructure.h"
 
 #include <cmath>
+#include <iomanip>
+#include <limits>
 
+#include <boost/foreach.hpp>
 #include <boost/optional.hpp>
 
 // From SSTbx
@@ -20,11 +23,14 @@
 #include <common/Constants.h>
 #include <common/Structure.h>
 #include <common/Types.h>
+#include <io/BoostFilesystem.h>
 #include <utility/UtilFunctions.h>
 
 // Local includes
+#include "common/CommonData.h"
 #include "common/PipeFunctions.h"
 #include "common/UtilityFunctions.h"
+#include "utility/Checkpointer.h"
 
 // NAMESPACES ////////////////////////////////
 
@@ -32,10 +38,15 @@
 namespace spipe {
 namespace blocks {
 
+namespace fs = ::boost::filesystem;
 namespace ssbc = ::sstbx::build_cell;
 namespace ssc = ::sstbx::common;
 namespace ssu = ::sstbx::utility;
 
+namespace {
+const char PROGRESS_FILE[] = "progress";
+}
+
 RandomStructure::RandomStructure(
   const int numToGenerate,
   IStructureGeneratorPtr structureGenerator
@@ -64,44 +75,71 @@ void RandomStructure::start()
 {
 	using ::spipe::common::StructureData;
 
+  if(myProgress.restored)
+    myProgress.restored = false; // Carry on from the checkpoint, the seeds have been sent already
+  else
+  {
+    // If the number to generate is fixed any seed structures count towards it,
+    // otherwise the number is worked out from the random structures alone
+    const int numSeeds = sendSeedStructures();
+    myProgress.nextStructure = myFixedNumGenerate ? numSeeds : 0;
+    myProgress.numToGenerate = myFixedNumGenerate ? myNumToGenerate : 100;
+    myProgress.totalAtomsGenerated = 0.0;
+  }
+
   ssbc::IStructureGenerator * const generator = getStructureGenerator();
+  // Each shard generates every count'th structure so the names stay unique
+  // across all of them
+  const common::Shard * const shard = getShard();
+  const float numShards = shard ? static_cast<float>(shard->count) : 1.0f;
 
   if(generator)
   {
-    int numToGenerate = myFixedNumGenerate ? myNumToGenerate : 100;
-  	
-    float totalAtomsGenerated = 0.0;
     ssbc::GenerationOutcome outcome;
-    for(int i = 0; i < numToGenerate; ++i)
+    // Generate into the same structure until successful and after that into
+    // any spare structure that comes with recycled data
+    ssc::StructurePtr str;
+    while(myProgress.nextStructure < myProgress.numToGenerate)
     {
+      const int i = myProgress.nextStructure++;
+      if(shard && !shard->isMine(i))
+        continue;
+
 	    // Create the random structure
-      ssc::StructurePtr str;
       outcome = generator->generateStructure(str, getRunner()->memory().global().getSpeciesDatabase());
 
 	    if(outcome.success() && str.get())
 	    {
         StructureData & data = getRunner()->createData();
+        ssc::StructurePtr spare = data.takeSpareStructure();
 		    data.setStructure(str);
+#ifdef SSLIB_USE_CPP11
+        str = ::std::move(spare);
+#else
+        str = spare;
+#endif
 
 			  data.getStructure()->setName(generateStructureName(*getRunner(), i));
 
         if(!myFixedNumGenerate)
         {
-          totalAtomsGenerated += static_cast<float>(str->getNumAtoms());
-          numToGenerate = static_cast<int>(std::ceil(
-            myAtomsMultiplierGenerate * totalAtomsGenerated /
+          myProgress.totalAtomsGenerated += static_cast<float>(data.getStructure()->getNumAtoms());
+          myProgress.numToGenerate = static_cast<int>(std::ceil(
+            myAtomsMultiplierGenerate * numShards * myProgress.totalAtomsGenerated /
             static_cast<float>(i))
             );
         }
 
 		    // Send it down the pipe
 		    out(data);
+
+        // Everything up to this structure is done
+        utility::checkpoint(*getRunner());
 	    }
     }
   }
 }
 
-
 void RandomStructure::in(::spipe::common::StructureData & data)
 {
   ssbc::IStructureGenerator * const generator = getStructureGenerator();
@@ -131,6 +169,61 @@ void RandomStructure::in(::spipe::common::StructureData & data)
 		getRunner()->dropData(data);
 }
 
+bool RandomStructure::saveState(const ::std::string & dir)
+{
+  fs::ofstream progressFile(fs::path(dir) / PROGRESS_FILE);
+  progressFile << ::std::setprecision(::std::numeric_limits<float>::digits10 + 2)
+    << myProgress.nextStructure << " "
+    << myProgress.numToGenerate << " "
+    << myProgress.totalAtomsGenerated << ::std::endl;
+  return progressFile.good();
+}
+
+bool RandomStructure::restoreState(const ::std::string & dir)
+{
+  fs::ifstream progressFile(fs::path(dir) / PROGRESS_FILE);
+  Progress progress;
+  progressFile >> progress.nextStructure >> progress.numToGenerate >> progress.totalAtomsGenerated;
+  if(progressFile.fail())
+    return false;
+
+  myProgress = progress;
+  myProgress.restored = true;
+  return true;
+}
+
+int RandomStructure::sendSeedStructures()
+{
+  using ::spipe::common::StructureData;
+
+  const common::SharedStructures * const seeds =
+    getRunner()->memory().shared().objectsStore.find(common::GlobalKeys::SEED_STRUCTURES);
+  if(!seeds)
+    return 0;
+
+  const common::Shard * const shard = getShard();
+  int numSent = 0;
+  BOOST_FOREACH(const common::SharedStructures::value_type & seed, *seeds)
+  {
+    if(myFixedNumGenerate && numSent >= myNumToGenerate)
+      break;
+    if(shard && !shard->isMine(numSent))
+    {
+      // Another shard sends this one
+      ++numSent;
+      continue;
+    }
+
+    StructureData & data = getRunner()->createData();
+    data.setStructure(seed->clone());
+    data.getStructure()->setName(generateSeedName(*getRunner(), numSent));
+
+    ++numSent;
+    out(data);
+  }
+  return numSent;
+}
+
 ::sstbx::build_cell::IStructureGenerator *
 RandomStructure::getStructureGenerator()
 {
@@ -147,6 +240,13 @@ RandomStructure::getStructureGenerator()
   return generator;
 }
 
+const common::Shard * RandomStructure::getShard() const
+{
+  if(getRunner()->getParentAccess())
+    return NULL;
+  return getRunner()->memory().global().objectsStore.find(common::GlobalKeys::SHARD);
+}
+
 ::std::string RandomStructure::generateStructureName(const SpRunnerAccess & runner, const size_t structureNum) const
 {
   // Build up the name
@@ -155,5 +255,12 @@ RandomStructure::getStructureGenerator()
   return ss.str();
 }
 
+::std::string RandomStructure::generateSeedName(const SpRunnerAccess & runner, const size_t seedNum) const
+{
+  ::std::stringstream ss;
+  ss << common::generateStructureName(runner.memory()) << "-seed-" << seedNum;
+  return ss.str();
+}
+
 }
 }
@@ -28,6 +28,10 @@
 // FORWARD DECLARATIONS ////////////////////////////////////
 
 namespace spipe {
+namespace common {
+class Shard;
+}
+
 namespace blocks {
 
 class RandomStructure : public virtual SpStartBlock, public virtual SpPipeBlock,
@@ -56,16 +60,40 @@ public:
 	virtual void in(::spipe::common::StructureData & data);
   // End from PipeBlock
 
+  // From Block //
+  virtual bool saveState(const ::std::string & dir);
+  virtual bool restoreState(const ::std::string & dir);
+  // End from Block
+
 private:
   typedef ::boost::scoped_ptr< ::sstbx::build_cell::IStructureGenerator> StructureGeneratorPtr;
 
+  /** How far through generating the structures we are, so we can carry on after a checkpoint. */
+  struct Progress
+  {
+    Progress(): nextStructure(0), numToGenerate(0), totalAtomsGenerated(0.0), restored(false) {}
+    int nextStructure;
+    int numToGenerate;
+    float totalAtomsGenerated;
+    bool restored;
+  };
+
+  /**
+  /* Send any seed structures found in shared memory down the pipe.  Returns the number sent.
+  /**/
+  int sendSeedStructures();
   ::sstbx::build_cell::IStructureGenerator * getStructureGenerator();
+  /** If we're generating in the top level pipe of a sharded search, get our shard. */
+  const common::Shard * getShard() const;
   ::std::string generateStructureName(const SpRunnerAccess & runner, const size_t structureNum) const;
+  /** Seeds have names of their own so they never clash with the random structures. */
+  ::std::string generateSeedName(const SpRunnerAccess & runner, const size_t seedNum) const;
 
 	const IStructureGeneratorPtr myStructureGenerator;
   const bool myFixedNumGenerate;
   const int myNumToGenerate;
   const float myAtomsMultiplierGenerate;
+  Progress myProgress;
 };
 
 
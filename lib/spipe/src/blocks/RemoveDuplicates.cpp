@@ -9,14 +9,25 @@
 #include "blocks/RemoveDuplicates.h"
 #include "StructurePipe.h"
 
+#include <iomanip>
+#include <limits>
 #include <map>
+#include <vector>
 
 #include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 
 // From SSTbx
 #include <common/Structure.h>
+#include <common/StructureProperties.h>
+#include <io/ResourceLocator.h>
+#include <io/SslibReaderWriter.h>
 
+#include "common/CommonData.h"
+#include "common/PipeFunctions.h"
 #include "common/StructureData.h"
+#include "utility/Checkpointer.h"
+#include "utility/SharedStructureStore.h"
 
 // NAMESPACES ////////////////////////////////
 
@@ -24,18 +35,77 @@
 namespace spipe {
 namespace blocks {
 
+namespace fs = ::boost::filesystem;
 namespace ssc = ::sstbx::common;
+namespace ssio = ::sstbx::io;
 namespace ssu = ::sstbx::utility;
 namespace structure_properties = ssc::structure_properties;
 
-RemoveDuplicates::RemoveDuplicates(ssu::IStructureComparatorPtr comparator):
+namespace {
+const char SPILL_DIR_EXTENSION[] = ".spilled";
+const char SPILLED_RECORDS_FILE[] = "spilled";
+
+bool getSpilledIndex(unsigned int & idx, const ssc::Structure & structure)
+{
+  // Spilled structures are saved with their index in the chunk as the id
+  const ssio::ResourceLocator * const locator =
+    structure.getProperty(structure_properties::io::LAST_ABS_FILE_PATH);
+  if(!locator)
+    return false;
+
+  try
+  {
+    idx = ::boost::lexical_cast<unsigned int>(locator->id());
+  }
+  catch(const ::boost::bad_lexical_cast & /*e*/)
+  {
+    return false;
+  }
+  return true;
+}
+
+bool getEnergy(double & energy, const ssc::Structure & structure)
+{
+  const double * const structureEnergy =
+    structure.getProperty(structure_properties::general::ENERGY_INTERNAL);
+  if(!structureEnergy)
+    return false;
+
+  energy = *structureEnergy;
+  return true;
+}
+}
+
+const size_t RemoveDuplicates::SPILL_CHUNK_SIZE = 1000;
+const unsigned int RemoveDuplicates::SpilledRecord::NO_CHUNK = ::std::numeric_limits<unsigned int>::max();
+const double RemoveDuplicates::SpilledRecord::NO_ENERGY = ::std::numeric_limits<double>::max();
+
+RemoveDuplicates::RemoveDuplicates(
+  ssu::IStructureComparatorPtr comparator,
+  const bool spillToDisk,
+  const size_t spillChunkSize):
 SpBlock("Remove duplicates"),
-myStructureSet(comparator)
+myComparator(comparator),
+myStructureSet(*myComparator),
+mySpillToDisk(spillToDisk),
+mySpillChunkSize(spillChunkSize),
+mySpilledSet(*myComparator),
+myNumSpillChunks(0)
 {}
 
-RemoveDuplicates::RemoveDuplicates(const sstbx::utility::IStructureComparator & comparator):
+RemoveDuplicates::RemoveDuplicates(
+  const sstbx::utility::IStructureComparator & comparator,
+  const bool spillToDisk,
+  const size_t spillChunkSize):
 SpBlock("Remove duplicates"),
-myStructureSet(comparator)
+myStructureSet(comparator),
+mySpillToDisk(spillToDisk),
+mySpillChunkSize(spillChunkSize),
+mySpilledSet(comparator),
+myNumSpillChunks(0)
+{}
+
+RemoveDuplicates::~RemoveDuplicates()
 {}
 
 void RemoveDuplicates::in(::spipe::common::StructureData & data)
@@ -46,10 +116,286 @@ void RemoveDuplicates::in(::spipe::common::StructureData & data)
     return;
   }
 
+  if(mySpillToDisk)
+  {
+    handleInsertResult(data, insertSpilled(*data.getStructure()));
+    return;
+  }
+
   // Flag the data to say that we may want to use it again
   const StructureDataHandle handle = getRunner()->createDataHandle(data);
-  const StructureSet::insert_return_type result = myStructureSet.insert(handle, *data.getStructure());
+  handleInsertResult(data, handle, insert(handle, *data.getStructure()));
+}
+
+void RemoveDuplicates::inBatch(const DataBatch & batch)
+{
+  if(mySpillToDisk)
+  {
+    // Spilled structures are keyed by the order they were found in so go one at a time
+    BOOST_FOREACH(::spipe::common::StructureData * const data, batch)
+    {
+      in(*data);
+    }
+    return;
+  }
+
+  ::std::vector<StructureDataHandle> handles;
+  ::std::vector<ssc::Structure *> structures;
+  ::std::vector< ::spipe::common::StructureData *> batchData;
+  handles.reserve(batch.size());
+  structures.reserve(batch.size());
+  batchData.reserve(batch.size());
+
+  BOOST_FOREACH(::spipe::common::StructureData * const data, batch)
+  {
+    if(data->getStructure())
+    {
+      handles.push_back(getRunner()->createDataHandle(*data));
+      structures.push_back(data->getStructure());
+      batchData.push_back(data);
+    }
+    else
+      out(*data);
+  }
+
+  // Do all the comparisons in one go
+  ::std::vector<StructureSet::insert_return_type> results;
+  if(mySharedStore)
+  {
+    const utility::SharedStructureStore::Lock lock(*mySharedStore);
+    adoptSharedStructures();
+    myStructureSet.insert(handles, structures, results);
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+      if(results[i].second)
+        mySharedStore->append(*structures[i]);
+    }
+  }
+  else
+    myStructureSet.insert(handles, structures, results);
+
+  for(size_t i = 0; i < batchData.size(); ++i)
+    handleInsertResult(*batchData[i], handles[i], results[i]);
+}
+
+void RemoveDuplicates::pipelineStarting()
+{
+  // Only the top level pipe takes part in sharding, sub-pipes do their own thing
+  const common::Shard * const shard =
+    getRunner()->memory().global().objectsStore.find(common::GlobalKeys::SHARD);
+  if(shard && !shard->uniqueStore.empty() && !getRunner()->getParentAccess())
+  {
+    mySharedStore.reset(new utility::SharedStructureStore(
+      shard->uniqueStore,
+      getRunner()->memory().global().getSpeciesDatabase())
+    );
+  }
+
+  if(mySpillToDisk)
+  {
+    mySpillDir = getRunner()->memory().shared().getOutputPath(*getRunner());
+    mySpillDir /= common::getOutputFileStem(getRunner()->memory()) + SPILL_DIR_EXTENSION;
+    mySpilledRecords.clear();
+    myNumSpillChunks = 0;
+  }
+}
+
+void RemoveDuplicates::pipelineFinishing()
+{
+  // Has anyone asked for a copy of the unique structures we found?
+  common::SharedStructures * const uniqueStructures =
+    getRunner()->memory().global().objectsStore.find(common::GlobalKeys::UNIQUE_STRUCTURES);
+
+	// Make sure we clean up any data we are holding on to
+  BOOST_FOREACH(const StructureDataHandle & handle, myStructureSet)
+	{
+    if(uniqueStructures)
+    {
+      const ssc::Structure * const structure = getRunner()->getData(handle).getStructure();
+      if(structure)
+        uniqueStructures->push_back(common::SharedStructures::value_type(new ssc::Structure(*structure)));
+    }
+		getRunner()->releaseDataHandle(handle);
+	}
+	myStructureSet.clear();
+
+  if(mySpillToDisk)
+    finishSpilling();
+
+  mySharedStore.reset();
+}
+
+bool RemoveDuplicates::saveState(const ::std::string & dir)
+{
+  if(mySpillToDisk)
+  {
+    // Everything found so far has to be on disk, then we just need to know where
+    writeSpillChunk();
+    fs::ofstream recordsFile(fs::path(dir) / SPILLED_RECORDS_FILE);
+    // Enough digits for the energies to make it back exactly
+    recordsFile << ::std::setprecision(::std::numeric_limits<double>::digits10 + 2);
+    recordsFile << myNumSpillChunks << " " << mySpilledRecords.size() << ::std::endl;
+    BOOST_FOREACH(const SpilledRecord & record, mySpilledRecords)
+    {
+      recordsFile << record.chunk << " " << record.idx << " " << record.energy << " " << record.timesFound << ::std::endl;
+    }
+    return recordsFile.good();
+  }
+
+  // Save the unique structures found so far to compare new ones against
+  ::std::vector<const ssc::Structure *> structures;
+  BOOST_FOREACH(const StructureDataHandle & handle, myStructureSet)
+  {
+    structures.push_back(getRunner()->getData(handle).getStructure());
+  }
+  return utility::saveStructures(
+    dir,
+    structures,
+    getRunner()->memory().global().getSpeciesDatabase()
+  );
+}
+
+bool RemoveDuplicates::restoreState(const ::std::string & dir)
+{
+  if(mySpillToDisk)
+  {
+    fs::ifstream recordsFile(fs::path(dir) / SPILLED_RECORDS_FILE);
+    size_t numRecords;
+    recordsFile >> myNumSpillChunks >> numRecords;
+    if(recordsFile.fail())
+      return false;
+
+    // Find which record each spilled structure belongs to
+    mySpilledRecords.resize(numRecords);
+    ::std::vector< ::std::vector<size_t> > chunkRecords(myNumSpillChunks);
+    for(size_t i = 0; i < numRecords; ++i)
+    {
+      SpilledRecord & record = mySpilledRecords[i];
+      recordsFile >> record.chunk >> record.idx >> record.energy >> record.timesFound;
+      if(recordsFile.fail())
+        return false;
+
+      if(record.chunk < myNumSpillChunks)
+      {
+        ::std::vector<size_t> & records = chunkRecords[record.chunk];
+        if(records.size() <= record.idx)
+          records.resize(record.idx + 1, numRecords);
+        records[record.idx] = i;
+      }
+    }
+
+    // Regenerate the comparison data one chunk at a time
+    const ssio::SslibReaderWriter reader;
+    unsigned int idx;
+    for(unsigned int chunk = 0; chunk < myNumSpillChunks; ++chunk)
+    {
+      ssio::StructuresContainer structures;
+      reader.readStructures(
+        structures,
+        getSpillChunkPath(chunk),
+        getRunner()->memory().global().getSpeciesDatabase()
+      );
+      BOOST_FOREACH(ssc::Structure & structure, structures)
+      {
+        if(getSpilledIndex(idx, structure) && idx < chunkRecords[chunk].size() &&
+          chunkRecords[chunk][idx] < numRecords)
+          mySpilledSet.insert(chunkRecords[chunk][idx], structure);
+      }
+    }
+    return true;
+  }
+
+  ::sstbx::io::StructuresContainer structures;
+  utility::loadStructures(structures, dir, getRunner()->memory().global().getSpeciesDatabase());
+
+  // These have already been passed on so we just hold on to them
+  while(!structures.empty())
+  {
+    ::spipe::common::StructureData * const data = new ::spipe::common::StructureData();
+    ssc::Structure & structure = data->setStructure(structures.release(structures.begin()));
+    myStructureSet.insert(getRunner()->createDataHandle(SpStructureDataPtr(data)), structure);
+  }
+  return true;
+}
+
+RemoveDuplicates::StructureSet::insert_return_type RemoveDuplicates::insert(
+  const StructureDataHandle & handle,
+  ssc::Structure & structure)
+{
+  if(!mySharedStore)
+    return myStructureSet.insert(handle, structure);
+
+  // Hold the store until we've added the structure so no other shard can find
+  // the same one in the meantime
+  const utility::SharedStructureStore::Lock lock(*mySharedStore);
+  adoptSharedStructures();
+  const StructureSet::insert_return_type result = myStructureSet.insert(handle, structure);
+  if(result.second)
+    mySharedStore->append(structure);
+  return result;
+}
 
+RemoveDuplicates::SpilledSet::insert_return_type
+RemoveDuplicates::insertSpilled(ssc::Structure & structure)
+{
+  if(!mySharedStore)
+  {
+    const SpilledSet::insert_return_type result = mySpilledSet.insert(mySpilledRecords.size(), structure);
+    if(result.second)
+      spill(structure);
+    return result;
+  }
+
+  const utility::SharedStructureStore::Lock lock(*mySharedStore);
+  adoptSharedStructures();
+  const SpilledSet::insert_return_type result = mySpilledSet.insert(mySpilledRecords.size(), structure);
+  if(result.second)
+  {
+    mySharedStore->append(structure);
+    spill(structure);
+  }
+  return result;
+}
+
+void RemoveDuplicates::adoptSharedStructures()
+{
+  ::sstbx::io::StructuresContainer structures;
+  mySharedStore->readNew(structures);
+
+  if(mySpillToDisk)
+  {
+    // We only need the comparison data, the structures aren't ours to spill
+    // and neither are the times they are found
+    BOOST_FOREACH(ssc::Structure & structure, structures)
+    {
+      if(mySpilledSet.insert(mySpilledRecords.size(), structure).second)
+      {
+        SpilledRecord record;
+        getEnergy(record.energy, structure);
+        mySpilledRecords.push_back(record);
+      }
+    }
+    return;
+  }
+
+  // Hold on to the structures found by the other shards as if they had come
+  // through here, they are never passed on so any times found we count
+  // against them go nowhere
+  while(!structures.empty())
+  {
+    ::spipe::common::StructureData * const data = new ::spipe::common::StructureData();
+    ssc::Structure & structure = data->setStructure(structures.release(structures.begin()));
+    const StructureDataHandle handle = getRunner()->createDataHandle(SpStructureDataPtr(data));
+    if(!myStructureSet.insert(handle, structure).second)
+      getRunner()->releaseDataHandle(handle);
+  }
+}
+
+void RemoveDuplicates::handleInsertResult(
+  ::spipe::common::StructureData & data,
+  const StructureDataHandle & handle,
+  const StructureSet::insert_return_type & result)
+{
 	if(result.second)
 	{
     // Inserted
@@ -81,14 +427,121 @@ void RemoveDuplicates::in(::spipe::common::StructureData & data)
 	}
 }
 
-void RemoveDuplicates::pipelineFinishing()
+void RemoveDuplicates::handleInsertResult(
+  ::spipe::common::StructureData & data,
+  const SpilledSet::insert_return_type & result)
 {
-	// Make sure we clean up any data we are holding on to
-  BOOST_FOREACH(const StructureDataHandle & handle, myStructureSet)
-	{
-		getRunner()->releaseDataHandle(handle);
-	}
-	myStructureSet.clear();
+  if(result.second)
+  {
+    data.getStructure()->setProperty(structure_properties::searching::TIMES_FOUND, (unsigned int)1);
+    out(data);
+  }
+  else
+  {
+    getRunner()->dropData(data);
+    ++mySpilledRecords[*result.first].timesFound;
+  }
+}
+
+void RemoveDuplicates::spill(const ssc::Structure & structure)
+{
+  SpilledRecord record;
+  record.chunk = myNumSpillChunks;
+  record.idx = static_cast<unsigned int>(mySpillChunk.size());
+  getEnergy(record.energy, structure);
+  mySpilledRecords.push_back(record);
+
+  mySpillChunk.push_back(new ssc::Structure(structure));
+  if(mySpillChunk.size() >= mySpillChunkSize)
+    writeSpillChunk();
+}
+
+void RemoveDuplicates::writeSpillChunk()
+{
+  if(mySpillChunk.empty())
+    return;
+
+  // Make sure we don't add to a chunk left over from a previous search
+  const fs::path chunkPath(getSpillChunkPath(myNumSpillChunks));
+  if(fs::exists(chunkPath))
+    fs::remove(chunkPath);
+
+  ssio::IStructureWriter::Structures structures;
+  ssio::IStructureWriter::Locators locators;
+  for(size_t i = 0; i < mySpillChunk.size(); ++i)
+  {
+    structures.push_back(&mySpillChunk[i]);
+    locators.push_back(ssio::ResourceLocator(chunkPath, ::boost::lexical_cast< ::std::string>(i)));
+  }
+  ssio::SslibReaderWriter().writeStructures(
+    structures,
+    locators,
+    getRunner()->memory().global().getSpeciesDatabase()
+  );
+
+  mySpillChunk.clear();
+  ++myNumSpillChunks;
+}
+
+void RemoveDuplicates::finishSpilling()
+{
+  writeSpillChunk();
+
+  // Gather up the times each spilled structure was found by chunk
+  ::std::vector< ::std::vector<unsigned int> > timesFound(myNumSpillChunks);
+  BOOST_FOREACH(const SpilledRecord & record, mySpilledRecords)
+  {
+    if(record.chunk == SpilledRecord::NO_CHUNK)
+      continue;
+
+    ::std::vector<unsigned int> & chunkTimesFound = timesFound[record.chunk];
+    if(chunkTimesFound.size() <= record.idx)
+      chunkTimesFound.resize(record.idx + 1, 1);
+    chunkTimesFound[record.idx] = record.timesFound;
+  }
+  mySpilledSet.clear();
+  mySpilledRecords.clear();
+
+  common::SharedStructures * const uniqueStructures =
+    getRunner()->memory().global().objectsStore.find(common::GlobalKeys::UNIQUE_STRUCTURES);
+
+  // Rewrite each chunk with the final counts
+  const ssio::SslibReaderWriter readerWriter;
+  const ssc::AtomSpeciesDatabase & speciesDb = getRunner()->memory().global().getSpeciesDatabase();
+  unsigned int idx;
+  for(unsigned int chunk = 0; chunk < myNumSpillChunks; ++chunk)
+  {
+    const fs::path chunkPath(getSpillChunkPath(chunk));
+    ssio::StructuresContainer structures;
+    readerWriter.readStructures(structures, chunkPath, speciesDb);
+
+    ssio::IStructureWriter::Structures toWrite;
+    ssio::IStructureWriter::Locators locators;
+    BOOST_FOREACH(ssc::Structure & structure, structures)
+    {
+      if(!getSpilledIndex(idx, structure))
+        continue;
+
+      if(idx < timesFound[chunk].size())
+        structure.setProperty(structure_properties::searching::TIMES_FOUND, timesFound[chunk][idx]);
+      if(uniqueStructures)
+        uniqueStructures->push_back(common::SharedStructures::value_type(new ssc::Structure(structure)));
+
+      toWrite.push_back(&structure);
+      locators.push_back(ssio::ResourceLocator(chunkPath, ::boost::lexical_cast< ::std::string>(idx)));
+    }
+
+    fs::remove(chunkPath);
+    if(!toWrite.empty())
+      readerWriter.writeStructures(toWrite, locators, speciesDb);
+  }
+  myNumSpillChunks = 0;
+}
+
+fs::path RemoveDuplicates::getSpillChunkPath(const unsigned int chunk) const
+{
+  return mySpillDir /
+    (::boost::lexical_cast< ::std::string>(chunk) + "." + ssio::SslibReaderWriter::DEFAULT_EXTENSION);
 }
 
 }
@@ -10,11 +10,16 @@
 
 // INCLUDES /////////////////////////////////////////////
 #include <map>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include <pipelib/pipelib.h>
 
+#include <io/BoostFilesystem.h>
+
 #include <utility/UniqueStructureSet.h>
 #include <utility/UtilityFwd.h>
 
@@ -29,25 +34,107 @@ class Structure;
 }
 
 namespace spipe {
+namespace utility {
+class SharedStructureStore;
+}
+
 namespace blocks {
 
+/**
+/* Drops any structure that is the same as one that has come through before.
+/* If the search is one shard of a bigger one the top level block also checks
+/* against, and adds to, the unique structures in the store shared by the shards.
+/* The times found written to each structure only counts the times that the shard
+/* which found it first came across it again: a shard that finds a structure
+/* another shard already has drops it and the count is lost.
+/*
+/* Normally the block holds on to every unique structure until the pipe finishes
+/* so it can count how many times each was found.  For very long searches it can
+/* instead spill them to disk as they are found, keeping only the comparison
+/* data and a compact record in memory, and write the counts to the spilled
+/* structures once the pipe finishes.  Only the copies in the spill directory get
+/* the final counts: any file a later block, e.g. WriteStructure, has already
+/* written will still say the structure was found once.
+/**/
 class RemoveDuplicates : public SpPipeBlock, ::boost::noncopyable
 {
 public:
-
-  RemoveDuplicates(::sstbx::utility::IStructureComparatorPtr comparator);
-  RemoveDuplicates(const ::sstbx::utility::IStructureComparator & comparator);
+  static const size_t SPILL_CHUNK_SIZE;
+
+  /** When spilling, the structures are written out in chunks of spillChunkSize. */
+  RemoveDuplicates(
+    ::sstbx::utility::IStructureComparatorPtr comparator,
+    const bool spillToDisk = false,
+    const size_t spillChunkSize = SPILL_CHUNK_SIZE);
+  RemoveDuplicates(
+    const ::sstbx::utility::IStructureComparator & comparator,
+    const bool spillToDisk = false,
+    const size_t spillChunkSize = SPILL_CHUNK_SIZE);
+  ~RemoveDuplicates();
 
 	virtual void in(::spipe::common::StructureData & data);
+  virtual void inBatch(const DataBatch & batch);
+  virtual bool supportsBatches() const { return true; }
 
   // From Block /////////////////////////
+  virtual void pipelineStarting();
 	virtual void pipelineFinishing();
+  virtual bool saveState(const ::std::string & dir);
+  virtual bool restoreState(const ::std::string & dir);
   // End from Block ///////////////////
 
 private:
   typedef sstbx::utility::UniqueStructureSet<StructureDataHandle> StructureSet;
-
+  /** Keyed by index into the spilled records. */
+  typedef sstbx::utility::UniqueStructureSet<size_t> SpilledSet;
+
+  /**
+  /* Where to find a structure that has been spilled to disk, its energy and
+  /* how many times it was found.
+  /**/
+  struct SpilledRecord
+  {
+    static const unsigned int NO_CHUNK;
+    /** Used for structures that didn't have an energy. */
+    static const double NO_ENERGY;
+
+    SpilledRecord(): chunk(NO_CHUNK), idx(0), energy(NO_ENERGY), timesFound(1) {}
+    unsigned int chunk;
+    unsigned int idx;
+    double energy;
+    unsigned int timesFound;
+  };
+
+  StructureSet::insert_return_type insert(
+    const StructureDataHandle & handle,
+    ::sstbx::common::Structure & structure);
+  SpilledSet::insert_return_type insertSpilled(::sstbx::common::Structure & structure);
+  void adoptSharedStructures();
+  void handleInsertResult(
+    ::spipe::common::StructureData & data,
+    const StructureDataHandle & handle,
+    const StructureSet::insert_return_type & result);
+  void handleInsertResult(
+    ::spipe::common::StructureData & data,
+    const SpilledSet::insert_return_type & result);
+
+  void spill(const ::sstbx::common::Structure & structure);
+  void writeSpillChunk();
+  void finishSpilling();
+  ::boost::filesystem::path getSpillChunkPath(const unsigned int chunk) const;
+
+  ::sstbx::utility::IStructureComparatorPtr myComparator;
 	StructureSet	myStructureSet;
+  ::boost::scoped_ptr<utility::SharedStructureStore> mySharedStore;
+
+  const bool mySpillToDisk;
+  const size_t mySpillChunkSize;
+  SpilledSet mySpilledSet;
+  ::std::vector<SpilledRecord> mySpilledRecords;
+  ::boost::filesystem::path mySpillDir;
+  unsigned int myNumSpillChunks;
+  /** Copies of the structures waiting to be written out as the next chunk. */
+  ::boost::ptr_vector< ::sstbx::common::Structure> mySpillChunk;
 };
 
 }
@@ -8,6 +8,8 @@
 // INCLUDES //////////////////////////////////
 #include "blocks/StoichiometrySearch.h"
 
+#include <limits>
+
 #include <boost/foreach.hpp>
 #include <boost/optional.hpp>
 #include <boost/lexical_cast.hpp>
@@ -30,6 +32,7 @@
 #include "common/StructureData.h"
 #include "common/SharedData.h"
 #include "common/UtilityFunctions.h"
+#include "utility/Checkpointer.h"
 #include "utility/DataTable.h"
 
 
@@ -45,6 +48,10 @@ namespace ssio = ::sstbx::io;
 namespace ssu = ::sstbx::utility;
 namespace structure_properties = ssc::structure_properties;
 
+namespace {
+const char PROGRESS_FILE[] = "progress";
+}
+
 
 StoichiometrySearch::StoichiometrySearch(
   const ::sstbx::common::AtomSpeciesId::Value species1,
@@ -54,9 +61,10 @@ StoichiometrySearch::StoichiometrySearch(
   StructureBuilderPtr structureBuilder):
 SpBlock("Sweep stoichiometry"),
 myMaxAtoms(maxAtoms),
-mySubpipe(subpipe),
+myNumStoichiometriesDone(0),
 myStructureGenerator(structureBuilder)
 {
+  mySubpipes.push_back(subpipe.release());
   mySpeciesParameters.push_back(SpeciesParameter(species1, maxAtoms));
   mySpeciesParameters.push_back(SpeciesParameter(species2, maxAtoms));
 }
@@ -70,10 +78,19 @@ StoichiometrySearch::StoichiometrySearch(
 SpBlock("Sweep stoichiometry"),
 mySpeciesParameters(speciesParameters),
 myMaxAtoms(maxAtoms),
-mySubpipe(sweepPipe),
 myTableSupport(fs::path("stoich.dat")),
+myNumStoichiometriesDone(0),
 myStructureGenerator(structureBuilder)
-{}
+{
+  mySubpipes.push_back(sweepPipe.release());
+}
+
+void StoichiometrySearch::addWorkerPipe(SubpipePtr subpipe)
+{
+  SP_ASSERT(!getRunner());
+
+  mySubpipes.push_back(subpipe.release());
+}
 
 void StoichiometrySearch::pipelineInitialising()
 {
@@ -90,103 +107,146 @@ void StoichiometrySearch::pipelineStarting()
 
 void StoichiometrySearch::start()
 {
-  using ::boost::lexical_cast;
-  using ::std::string;
+  // Find all the stoichiometries that we're going to do
+  const ssu::MultiIdxRange<unsigned int> stoichRange = getStoichRange();
+  size_t totalAtoms;
+  BOOST_FOREACH(const StoichIdx & currentIdx, stoichRange)
+  {
+    totalAtoms = currentIdx.sum();
+    if(totalAtoms != 0 && totalAtoms <= myMaxAtoms)
+      myStoichiometries.push_back(currentIdx);
+  }
+  myStoichOutputPaths.assign(myStoichiometries.size(), ::std::string());
 
-  const ssc::AtomSpeciesDatabase & atomsDb = getRunner()->memory().global().getSpeciesDatabase();
+  // Start looping over the possible stoichiometries, if we've been restored
+  // from a checkpoint carry on from the first one that wasn't finished
+  myWorkers.run(myStoichiometries.size(), *this, true, myNumStoichiometriesDone);
 
-  // Start looping over the possible stoichiometries
-  size_t totalAtoms = 0;
-  ::std::string sweepPipeOutputPath;
+  myStoichiometries.clear();
+  myStoichOutputPaths.clear();
+  myNumStoichiometriesDone = 0;
+}
 
-  const ssu::MultiIdxRange<unsigned int> stoichRange = getStoichRange();
-  BOOST_FOREACH(const ssu::MultiIdx<unsigned int> & currentIdx, stoichRange)
+bool StoichiometrySearch::saveState(const ::std::string & dir)
+{
+  fs::ofstream progressFile(fs::path(dir) / PROGRESS_FILE);
+  progressFile << myNumStoichiometriesDone << ::std::endl;
+  myTableSupport.getTable().save(progressFile);
+  return progressFile.good();
+}
+
+bool StoichiometrySearch::restoreState(const ::std::string & dir)
+{
+  fs::ifstream progressFile(fs::path(dir) / PROGRESS_FILE);
+  size_t numDone;
+  progressFile >> numDone;
+  progressFile.ignore(::std::numeric_limits< ::std::streamsize>::max(), '\n');
+  if(progressFile.fail() || !myTableSupport.getTable().load(progressFile))
+    return false;
+
+  myNumStoichiometriesDone = numDone;
+  return true;
+}
+
+void StoichiometrySearch::runnerAttached(RunnerSetupType & setup)
+{
+  myWorkers.clear();
+  BOOST_FOREACH(SpPipe & subpipe, mySubpipes)
   {
-    // Need to get the shared data each time as it may have been reset after each
-    // run of the pipe
-    SharedDataType & sweepPipeData = mySubpipeRunner->memory().shared();
+    myWorkers.addWorker(setup, subpipe);
+  }
+}
 
-    totalAtoms = currentIdx.sum();
-    if(totalAtoms == 0 || totalAtoms > myMaxAtoms)
-      continue;
-
-    // Create a new structure description
-    StructureBuilderPtr builder = newStructureGenerator();
-
-    // Insert all the atoms
-    ::std::stringstream stoichStringStream;
-    size_t                    numAtomsOfSpecies;
-    ssc::AtomSpeciesId::Value species;
-    const string *            speciesSymbol;
-    for(size_t i = 0; i < currentIdx.dims(); ++i)
-    {
-      species           = mySpeciesParameters[i].id;
-      speciesSymbol     = atomsDb.getSymbol(species);
-      numAtomsOfSpecies = currentIdx[i];
-  
-      if(numAtomsOfSpecies > 0)
-      {
-        ssbc::AtomsGeneratorConstructionInfo constructionInfo;
-        constructionInfo.atoms.push_back(ssbc::AtomsDescription(mySpeciesParameters[i].id, numAtomsOfSpecies));
-        builder->addGenerator(::sstbx::makeUniquePtr(new ssbc::AtomsGenerator(constructionInfo)));
-      }
+void StoichiometrySearch::prepareJob(const size_t job, SpRunner & runner)
+{
+  using ::std::string;
 
-      stoichStringStream << numAtomsOfSpecies;
+  const ssc::AtomSpeciesDatabase & atomsDb = runner.memory().global().getSpeciesDatabase();
+  const StoichIdx & currentIdx = myStoichiometries[job];
 
+  // The shared data is reset after each run of the pipe
+  SharedDataType & sweepPipeData = runner.memory().shared();
 
-      // Append the species symbol
-      if(speciesSymbol)
-        stoichStringStream << *speciesSymbol;
+  // Create a new structure description
+  StructureBuilderPtr builder = newStructureGenerator();
 
-      // Add delimiter apart from for last species
-      if(i + 1 < currentIdx.dims())
-        stoichStringStream << "-";
+  // Insert all the atoms
+  ::std::stringstream stoichStringStream;
+  size_t                    numAtomsOfSpecies;
+  ssc::AtomSpeciesId::Value species;
+  const string *            speciesSymbol;
+  for(size_t i = 0; i < currentIdx.dims(); ++i)
+  {
+    species           = mySpeciesParameters[i].id;
+    speciesSymbol     = atomsDb.getSymbol(species);
+    numAtomsOfSpecies = currentIdx[i];
 
-    } // End loop over atoms
+    if(numAtomsOfSpecies > 0)
+    {
+      ssbc::AtomsGeneratorConstructionInfo constructionInfo;
+      constructionInfo.atoms.push_back(ssbc::AtomsDescription(mySpeciesParameters[i].id, numAtomsOfSpecies));
+      builder->addGenerator(::sstbx::makeUniquePtr(new ssbc::AtomsGenerator(constructionInfo)));
+    }
+
+    stoichStringStream << numAtomsOfSpecies;
 
-    // Transfer ownership to the pipeline
-    sweepPipeData.setStructureGenerator(builder);
 
-    // Append the species ratios to the output directory name
-    sweepPipeData.appendToOutputDirName(stoichStringStream.str());
+    // Append the species symbol
+    if(speciesSymbol)
+      stoichStringStream << *speciesSymbol;
 
-    // Find out the pipeline relative path to where all the structures are going to be saved
-    sweepPipeOutputPath = sweepPipeData.getPipeRelativeOutputPath().string();
+    // Add delimiter apart from for last species
+    if(i + 1 < currentIdx.dims())
+      stoichStringStream << "-";
 
-    // Start the sweep pipeline
-    mySubpipeRunner->run();
+  } // End loop over atoms
 
-    // Update the table
-    updateTable(sweepPipeOutputPath, currentIdx, atomsDb);
+  // Transfer ownership to the pipeline
+  sweepPipeData.setStructureGenerator(builder);
 
-    // Send any finished structure data down my pipe, this will also
-    // update the table with any information from the buffered structures
-    releaseBufferedStructures(sweepPipeOutputPath);
+  // Append the species ratios to the output directory name
+  sweepPipeData.appendToOutputDirName(stoichStringStream.str());
 
-  } // End loop over stoichiometries
+  // Find out the pipeline relative path to where all the structures are going to be saved
+  myStoichOutputPaths[job] = sweepPipeData.getPipeRelativeOutputPath().string();
 }
 
-void StoichiometrySearch::finished(SpStructureDataPtr data)
+void StoichiometrySearch::jobFinished(const size_t job, FinishedData & finished)
 {
-  // Register the data with our pipeline to transfer ownership
-  // and save it in the buffer for sending down the pipe
-  myBuffer.push_back(&getRunner()->registerData(data));
+  const ssc::AtomSpeciesDatabase & atomsDb = getRunner()->memory().global().getSpeciesDatabase();
+
+  // Update the table
+  updateTable(myStoichOutputPaths[job], myStoichiometries[job], atomsDb);
+
+  // Send any finished structure data down my pipe, this will also
+  // update the table with any information from the finished structures
+  releaseFinishedStructures(myStoichOutputPaths[job], finished);
+
+  myNumStoichiometriesDone = job + 1;
+  utility::checkpoint(*getRunner());
 }
 
-void StoichiometrySearch::releaseBufferedStructures(
-  const utility::DataTable::Key & tableKey)
+void StoichiometrySearch::releaseFinishedStructures(
+  const utility::DataTable::Key & tableKey,
+  FinishedData & finished)
 {
 	// Send any finished structure data down my pipe
   utility::DataTable & table = myTableSupport.getTable();
 
   ssio::ResourceLocator lastSavedRelative;
 
+  StructureDataTyp * strData;
   const ssc::Structure * structure;
   const double * internalEnergy;
 
   unsigned int * spacegroup;
-	BOOST_FOREACH(StructureDataTyp * const strData, myBuffer)
+	while(!finished.empty())
 	{
+    // Register the data with our pipeline to transfer ownership
+    strData = &getRunner()->registerData(
+      SpStructureDataPtr(finished.release(finished.begin()).release())
+    );
+
     structure = strData->getStructure();
     lastSavedRelative = strData->getRelativeSavePath(*getRunner());
 
@@ -215,14 +275,6 @@ void StoichiometrySearch::releaseBufferedStructures(
     // Pass the structure on
 		out(*strData);
 	}
-	myBuffer.clear();
-}
-
-void StoichiometrySearch::runnerAttached(RunnerSetupType & setup)
-{
-  mySubpipeRunner = setup.createChildRunner(*mySubpipe);
-  // Set outselves to collect any finished data from the sweep pipeline
-  mySubpipeRunner->setFinishedDataSink(this);
 }
 
 ssu::MultiIdxRange<unsigned int> StoichiometrySearch::getStoichRange()
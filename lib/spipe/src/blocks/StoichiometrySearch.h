@@ -14,6 +14,7 @@
 
 #include <vector>
 
+#include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -31,6 +32,8 @@
 #include "SpTypes.h"
 #include "utility/DataTable.h"
 #include "utility/DataTableSupport.h"
+#include "utility/ISubpipeJobs.h"
+#include "utility/SubpipeWorkers.h"
 
 // FORWARD DECLARATIONS ////////////////////////////////////
 namespace sstbx {
@@ -62,7 +65,7 @@ struct SpeciesParameter
   size_t                                maxNum;
 };
 
-class StoichiometrySearch : public SpStartBlock, public SpFinishedSink,
+class StoichiometrySearch : public SpStartBlock, public utility::ISubpipeJobs,
   ::boost::noncopyable
 {
 public:
@@ -86,32 +89,45 @@ public:
     StructureBuilderPtr structureBuilder = StructureBuilderPtr()
   );
 
+  /**
+  /* Add another, independent, instance of the sub pipeline.  Each instance gets
+  /* its own thread so this many stoichiometries are done concurrently.  Must be
+  /* called before the block is attached to a runner.
+  /**/
+  void addWorkerPipe(SubpipePtr subpipe);
+
   // From Block ////////
   virtual void pipelineInitialising();
   virtual void pipelineStarting();
+  virtual bool saveState(const ::std::string & dir);
+  virtual bool restoreState(const ::std::string & dir);
   // End from Block ////
 
   // From StartBlock ///
   virtual void start();
   // End from StartBlock ///
 
-  // From IDataSink /////////////////////////////
-  virtual void finished(SpStructureDataPtr data);
-  // End from IDataSink /////////////////////////
-
 private:
   typedef ::spipe::StructureDataType                                        StructureDataTyp;
   typedef ::boost::scoped_ptr< ::spipe::utility::DataTableWriter>           TableWriterPtr;
   typedef ::pipelib::PipeRunner<StructureDataTyp, SharedDataType, SharedDataType> RunnerType;
 
+  typedef ::sstbx::utility::MultiIdx<unsigned int> StoichIdx;
+
   // From Block ////////
   virtual void runnerAttached(RunnerSetupType & setup);
   // End from Block ////
 
+  // From ISubpipeJobs ///////////////////////
+  virtual void prepareJob(const size_t job, SpRunner & runner);
+  virtual void jobFinished(const size_t job, FinishedData & finished);
+  // End from ISubpipeJobs ///////////////////
+
   ::sstbx::utility::MultiIdxRange<unsigned int> getStoichRange();
 
-  void releaseBufferedStructures(
-    const utility::DataTable::Key &             key
+  void releaseFinishedStructures(
+    const utility::DataTable::Key &             key,
+    FinishedData &                              finished
   );
 
   void updateTable(
@@ -122,16 +138,20 @@ private:
 
   StructureBuilderPtr newStructureGenerator() const;
 
-  SubpipePtr mySubpipe;
-  SpChildRunnerPtr mySubpipeRunner;
+  /** One instance of the sub pipeline per worker. */
+  ::boost::ptr_vector<SpPipe> mySubpipes;
+  utility::SubpipeWorkers     myWorkers;
 
   // Use this to write out our table data
   ::spipe::utility::DataTableSupport    myTableSupport;
   const size_t                          myMaxAtoms;
   ::boost::filesystem::path             myOutputPath;
 
-	/** Buffer to store structure that have finished their path through the sub pipeline. */
-	::std::vector<StructureDataTyp *>		  myBuffer;
+  /** The stoichiometries being done in the current search and where each one is saved. */
+  ::std::vector<StoichIdx>              myStoichiometries;
+  ::std::vector< ::std::string>         myStoichOutputPaths;
+  /** The number of stoichiometries, in order, that have been finished. */
+  size_t                                myNumStoichiometriesDone;
 
   SpeciesParameters                     mySpeciesParameters;
   StructureBuilderPtr                   myStructureGenerator;
@@ -82,12 +82,7 @@ void WriteStructure::in(::spipe::common::StructureData & data)
     common::SharedData & shared = getRunner()->memory().shared();
     ssc::Structure * const structure = data.getStructure();
 
-    const ssio::IStructureWriter * writer = NULL;
-    
-    if(myState == State::USE_CUSTOM_WRITER)
-      writer = rwMan.getWriter(myFileType);
-    else
-      writer = rwMan.getDefaultWriter();
+    const ssio::IStructureWriter * const writer = getWriter();
 
     if(writer)
     {
@@ -112,6 +107,35 @@ void WriteStructure::in(::spipe::common::StructureData & data)
 	out(data);
 }
 
+void WriteStructure::inBatch(const DataBatch & batch)
+{
+  const ssio::IStructureWriter * const writer = myState == State::DISABLED ? NULL : getWriter();
+  if(writer)
+  {
+    // Hand all the structures over at once so that the writer can
+    // avoid opening the same file over and over
+    ssio::IStructureWriter::Structures structures;
+    ssio::IStructureWriter::Locators locators;
+    structures.reserve(batch.size());
+    locators.reserve(batch.size());
+    for(size_t i = 0; i < batch.size(); ++i)
+    {
+      ssc::Structure * const structure = batch[i]->getStructure();
+      locators.push_back(generateLocator(*structure, *writer));
+      structures.push_back(structure);
+    }
+
+    const ssio::StructureReadWriteManager & rwMan = getRunner()->memory().global().getStructureIo();
+    if(myState == State::USE_CUSTOM_WRITER)
+      rwMan.writeStructures(structures, locators, getRunner()->memory().global().getSpeciesDatabase(), myFileType);
+    else
+      rwMan.writeStructures(structures, locators, getRunner()->memory().global().getSpeciesDatabase());
+  }
+
+  for(size_t i = 0; i < batch.size(); ++i)
+    out(*batch[i]);
+}
+
 ssio::ResourceLocator
 WriteStructure::generateLocator(
   ssc::Structure & structure,
@@ -137,6 +161,15 @@ WriteStructure::generateLocator(
   return ssio::ResourceLocator(p, structure.getName());
 }
 
+const ssio::IStructureWriter * WriteStructure::getWriter()
+{
+  const ssio::StructureReadWriteManager & rwMan = getRunner()->memory().global().getStructureIo();
+  if(myState == State::USE_CUSTOM_WRITER)
+    return rwMan.getWriter(myFileType);
+  else
+    return rwMan.getDefaultWriter();
+}
+
 bool WriteStructure::useMultiStructure(const ssio::IStructureWriter & writer) const
 {
   if(myWriteMultiStructure && writer.multiStructureSupport())
@@ -50,6 +50,8 @@ public:
   // From PipeBlock ////
   virtual void pipelineStarting();
   virtual void in(StructureDataType & data);
+  virtual void inBatch(const DataBatch & batch);
+  virtual bool supportsBatches() const { return true; }
   // End from PipeBlock ////
 
 private:
@@ -63,6 +65,7 @@ private:
     ::sstbx::common::Structure & structure,
     const ::sstbx::io::IStructureWriter & writer) const;
   bool useMultiStructure(const ::sstbx::io::IStructureWriter & writer) const;
+  const ::sstbx::io::IStructureWriter * getWriter();
 
   State::Value myState;
   bool myWriteMultiStructure;
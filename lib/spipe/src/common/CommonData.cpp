@@ -108,9 +108,42 @@ bool ParamRange::parseParamString(const size_t idx, const ::std::string & paramS
   return true;
 }
 
+bool Shard::fromString(const ::std::string & shardString)
+{
+  const size_t slashPos = shardString.find("/");
+  if(slashPos == ::std::string::npos)
+    return false;
+
+  ::std::string indexString = shardString.substr(0, slashPos);
+  ::std::string countString = shardString.substr(slashPos + 1);
+  ::boost::trim(indexString);
+  ::boost::trim(countString);
+
+  size_t lIndex, lCount;
+  try
+  {
+    lIndex = ::boost::lexical_cast<size_t>(indexString);
+    lCount = ::boost::lexical_cast<size_t>(countString);
+  }
+  catch(const ::boost::bad_lexical_cast & /*e*/)
+  {
+    return false;
+  }
+  if(lCount == 0 || lIndex >= lCount)
+    return false;
+
+  index = lIndex;
+  count = lCount;
+  return true;
+}
+
 // Objects keys ////////////////
 ssu::Key< ::std::vector<double> > GlobalKeys::POTENTIAL_PARAMS;
 ssu::Key<ParamRange> GlobalKeys::POTENTIAL_SWEEP_RANGE;
+ssu::Key<SharedStructures> GlobalKeys::SEED_STRUCTURES;
+ssu::Key<SharedStructures> GlobalKeys::UNIQUE_STRUCTURES;
+ssu::Key<utility::Checkpointer *> GlobalKeys::CHECKPOINTER;
+ssu::Key<Shard> GlobalKeys::SHARD;
 
 
 }
@@ -15,14 +15,25 @@
 #include <string>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include <armadillo>
 
+#include <io/BoostFilesystem.h>
 #include <utility/HeterogeneousMap.h>
 
 // FORWARD DECLARATIONS ////////////////////////////////////
-
+namespace sstbx {
+namespace common {
+class Structure;
+}
+}
 
 namespace spipe {
+namespace utility {
+class Checkpointer;
+}
+
 namespace common {
 
 class ParamRange
@@ -41,11 +52,40 @@ private:
   bool parseParamString(const size_t idx, const ::std::string & paramString);
 };
 
+/**
+/* One of a number of searches (possibly in different processes) that split
+/* the work between them.  The shards agree on which structures are unique
+/* through a store that they all share on disk.
+/**/
+class Shard
+{
+public:
+  Shard(): index(0), count(1) {}
+
+  /** Parse a string of the form i/N */
+  bool fromString(const ::std::string & shardString);
+  bool isMine(const size_t workIndex) const { return workIndex % count == index; }
+
+  size_t index;
+  size_t count;
+  ::boost::filesystem::path uniqueStore;
+};
+
+typedef ::std::vector< ::boost::shared_ptr<const ::sstbx::common::Structure> > SharedStructures;
+
 struct GlobalKeys
 {
   // The current parameterised potential parameters
   static ::sstbx::utility::Key< ::std::vector<double> >  POTENTIAL_PARAMS;
   static ::sstbx::utility::Key<ParamRange> POTENTIAL_SWEEP_RANGE;
+  // Structures that a start block should send down the pipe before generating any new ones
+  static ::sstbx::utility::Key<SharedStructures> SEED_STRUCTURES;
+  // If present blocks that establish structure uniqueness append a copy of each unique structure
+  static ::sstbx::utility::Key<SharedStructures> UNIQUE_STRUCTURES;
+  // The checkpointer of the top level pipe, if it is being checkpointed
+  static ::sstbx::utility::Key<utility::Checkpointer *> CHECKPOINTER;
+  // If this search is one shard of a bigger one
+  static ::sstbx::utility::Key<Shard> SHARD;
 
 };
 
@@ -68,7 +68,7 @@ ObjectData<T> getObject(::sstbx::utility::Key<T> & key, MemoryAccessType & memor
 
   // Try getting the object from shared data
   result.second = memory.shared().objectsStore.find(key);
-  if(result.first)
+  if(result.second)
     result.first  = DataLocation::SHARED;    
   else
   {
@@ -88,7 +88,7 @@ const ObjectData<const T> getObjectConst(::sstbx::utility::Key<T> & key, const M
 
   // Try getting the object from shared data
   result.second = memory.shared().objectsStore.find(key);
-  if(result.first)
+  if(result.second)
     result.first  = DataLocation::SHARED;    
   else
   {
@@ -49,6 +49,29 @@ ssc::Structure & StructureData::setStructure(ssio::StructuresContainer::auto_typ
   return *myStructure.get();
 }
 
+void StructureData::recycle()
+{
+  objectsStore.clear();
+  if(myStructure.get())
+  {
+    myStructure->clear();
+#ifdef SSLIB_USE_CPP11
+    mySpareStructure = ::std::move(myStructure);
+#else
+    mySpareStructure = myStructure;
+#endif
+  }
+}
+
+ssc::types::StructurePtr StructureData::takeSpareStructure()
+{
+#ifdef SSLIB_USE_CPP11
+  return ::std::move(mySpareStructure);
+#else
+  return mySpareStructure;
+#endif
+}
+
 ssio::ResourceLocator
 StructureData::getRelativeSavePath(const SpRunnerAccess & runner) const
 {
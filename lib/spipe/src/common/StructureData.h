@@ -14,6 +14,8 @@
 
 #include <boost/optional.hpp>
 
+#include <pipelib/DataPoolTraits.h>
+
 #include <armadillo>
 
 // From SSLib
@@ -52,14 +54,40 @@ public:
   /**/
   ::sstbx::io::ResourceLocator getRelativeSavePath(const SpRunnerAccess & runner) const;
 
+  /**
+  /* Put the data back into the state of newly created data so the runner can
+  /* hand it out again.  Any structure is cleared and kept as a spare.
+  /**/
+  void recycle();
+
+  /**
+  /* Take the spare structure left over from when this data was recycled (if
+  /* any) so that it can be reused instead of allocating a new one.
+  /**/
+  ::sstbx::common::types::StructurePtr takeSpareStructure();
+
   ::sstbx::utility::HeterogeneousMap  objectsStore;
 
 private:
 
   ::sstbx::UniquePtr< ::sstbx::common::Structure>::Type   myStructure;
+  ::sstbx::UniquePtr< ::sstbx::common::Structure>::Type   mySpareStructure;
 };
 
 }
 }
 
+namespace pipelib {
+
+// Have the runners reuse structure data rather than allocating it afresh
+template <>
+struct DataPoolTraits< ::spipe::common::StructureData>
+{
+  static const bool POOLED = true;
+  static void recycle(::spipe::common::StructureData & data)
+  { data.recycle(); }
+};
+
+}
+
 #endif /* STRUCTURE_DATA_H */
@@ -8,19 +8,30 @@
 // INCLUDES //////////////////////////////////
 #include "factory/Factory.h"
 
+#include <iostream>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
+
+#include <pipelib/ThreadPoolExecutor.h>
+
 // SSLib includes
+#include <common/AtomSpeciesDatabase.h>
 #include <potential/Types.h>
 #include <utility/UtilityFwd.h>
 #include <factory/SsLibElements.h>
 
 // Local includes
 #include "blocks/DetermineSpaceGroup.h"
+#include "blocks/MakeConvexHull.h"
 #include "blocks/LowestFreeEnergy.h"
 #include "blocks/NiggliReduction.h"
 #include "blocks/ParamPotentialGo.h"
 #include "blocks/PotentialParamSweep.h"
 #include "blocks/RandomStructure.h"
 #include "blocks/RemoveDuplicates.h"
+#include "blocks/StoichiometrySearch.h"
 #include "blocks/WriteStructure.h"
 #include "common/CommonData.h"
 #include "common/StructureData.h"
@@ -41,6 +52,21 @@ namespace ssio    = ::sstbx::io;
 namespace ssp     = ::sstbx::potential;
 namespace ssu     = ::sstbx::utility;
 
+bool Factory::createConvexHullBlock(BlockPtr & blockOut, const OptionsMap & options) const
+{
+#ifdef SP_USE_QHULL
+  const double * const dropAbove = options.find(DROP_ABOVE);
+  if(dropAbove)
+    blockOut.reset(new blocks::MakeConvexHull(*dropAbove));
+  else
+    blockOut.reset(new blocks::MakeConvexHull());
+  return true;
+#else
+  ::std::cerr << "Convex hull needs StructurePipe to be built with Qhull (SP_USE_QHULL)" << ::std::endl;
+  return false;
+#endif
+}
+
 bool Factory::createDetermineSpaceGroupBlock(BlockPtr & blockOut) const
 {
   blockOut.reset(new blocks::DetermineSpaceGroup());
@@ -78,13 +104,40 @@ bool Factory::createParamSweepBlock(
   PipePtr subPipe
 ) const
 {
+  Pipes subPipes;
+  subPipes.push_back(subPipe.release());
+  return createParamSweepBlock(blockOut, options, subPipes);
+}
+
+bool Factory::createParamSweepBlock(
+  BlockPtr & blockOut,
+  const OptionsMap & options,
+  Pipes & subPipes
+) const
+{
+  if(subPipes.empty())
+    return false;
+
   const ::std::vector< ::std::string> * const paramStrings = options.find(PARAM_RANGE);
   if(!paramStrings)
     return false;
   common::ParamRange paramRange;
   paramRange.fromStrings(*paramStrings);
 
-  blockOut.reset(new blocks::PotentialParamSweep(paramRange, subPipe));
+  PipePtr sweepPipe(subPipes.release(subPipes.begin()).release());
+  ::sstbx::UniquePtr<blocks::PotentialParamSweep>::Type
+    paramSweep(new blocks::PotentialParamSweep(paramRange, sweepPipe));
+
+  // Any remaining sub pipes are used as additional workers
+  while(!subPipes.empty())
+    paramSweep->addWorkerPipe(PipePtr(subPipes.release(subPipes.begin()).release()));
+
+  const bool * const warmStart = options.find(WARM_START);
+  if(warmStart)
+    paramSweep->setWarmStart(*warmStart);
+
+  // Transfer ownership
+  blockOut = paramSweep;
   return true;
 }
 
@@ -93,7 +146,8 @@ bool Factory::createPotentialGeomOptimiseBlock(
   const OptionsMap & optimiserOptions,
   const OptionsMap * const potentialOptions,
   const ssp::OptimisationSettings * optimisationSettings,
-  const OptionsMap * const globalOptions
+  const OptionsMap * const globalOptions,
+  const int numWorkers
 ) const
 {
   ssp::IGeomOptimiserPtr optimiser = mySsLibFactory.createGeometryOptimiser(
@@ -108,21 +162,32 @@ bool Factory::createPotentialGeomOptimiseBlock(
   if(!optimiser.get())
     return false;
 
+  ::sstbx::UniquePtr<blocks::PotentialGo>::Type goBlock;
   if(optimisationSettings)
   {
     if(potentialIsParameterisable)
-      blockOut.reset(new blocks::ParamPotentialGo(optimiser, *optimisationSettings));
+      goBlock.reset(new blocks::ParamPotentialGo(optimiser, *optimisationSettings));
     else
-      blockOut.reset(new blocks::PotentialGo(optimiser, *optimisationSettings));
+      goBlock.reset(new blocks::PotentialGo(optimiser, *optimisationSettings));
   }
   else
   {
     if(potentialIsParameterisable)
-      blockOut.reset(new blocks::ParamPotentialGo(optimiser));
+      goBlock.reset(new blocks::ParamPotentialGo(optimiser));
     else
-      blockOut.reset(new blocks::PotentialGo(optimiser));
+      goBlock.reset(new blocks::PotentialGo(optimiser));
+  }
+
+  // Optimise more than one structure at a time?
+  if(numWorkers > 1)
+  {
+    goBlock->setExecutor(
+      SpAsyncPipeBlock::ExecutorPtr(new ::pipelib::ThreadPoolExecutor(numWorkers))
+    );
   }
 
+  // Transfer ownership
+  blockOut = goBlock;
   return true;
 }
 
@@ -162,8 +227,64 @@ bool Factory::createRemoveDuplicatesBlock(
   if(!comparator.get())
     return false;
 
-  blockOut.reset(new blocks::RemoveDuplicates(comparator));
+  const bool * const spill = options.find(SPILL);
+  blockOut.reset(new blocks::RemoveDuplicates(comparator, spill && *spill));
+
+  return true;
+}
+
+bool Factory::createStoichiometrySearchBlock(
+  BlockPtr & blockOut,
+  const OptionsMap & options,
+  Pipes & subPipes
+) const
+{
+  typedef ::boost::tokenizer< ::boost::char_separator<char> > Tok;
+  const ::boost::char_separator<char> tokSep(" \t");
 
+  if(subPipes.empty())
+    return false;
+
+  const ::std::vector< ::std::string> * const speciesStrings = options.find(SPECIES_MAX);
+  const int * const maxAtoms = options.find(MAX_ATOMS);
+  if(!speciesStrings || !maxAtoms || *maxAtoms < 1)
+    return false;
+
+  // Each entry is a species symbol followed by the maximum number of that species
+  spb::StoichiometrySearch::SpeciesParameters speciesParameters;
+  BOOST_FOREACH(const ::std::string & speciesString, *speciesStrings)
+  {
+    const Tok tok(speciesString, tokSep);
+    const ::std::vector< ::std::string> tokens(tok.begin(), tok.end());
+    if(tokens.size() != 2)
+      return false;
+
+    const ::sstbx::common::AtomSpeciesId::Value species = mySpeciesDb.getIdFromSymbol(tokens[0]);
+    if(species == ::sstbx::common::AtomSpeciesId::DUMMY)
+      return false;
+
+    try
+    {
+      speciesParameters.push_back(
+        spb::SpeciesParameter(species, ::boost::lexical_cast<size_t>(tokens[1]))
+      );
+    }
+    catch(const ::boost::bad_lexical_cast & /*e*/)
+    {
+      return false;
+    }
+  }
+
+  PipePtr searchPipe(subPipes.release(subPipes.begin()).release());
+  ::sstbx::UniquePtr<blocks::StoichiometrySearch>::Type stoichSearch(
+    new blocks::StoichiometrySearch(speciesParameters, static_cast<size_t>(*maxAtoms), 0.0, searchPipe));
+
+  // Any remaining sub pipes are used as additional workers
+  while(!subPipes.empty())
+    stoichSearch->addWorkerPipe(PipePtr(subPipes.release(subPipes.begin()).release()));
+
+  // Transfer ownership
+  blockOut = stoichSearch;
   return true;
 }
 
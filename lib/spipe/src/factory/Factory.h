@@ -13,6 +13,7 @@
 #include "StructurePipe.h"
 
 #include <boost/optional.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 // From SSTbx
 #include <potential/OptimisationSettings.h>
@@ -39,30 +40,40 @@ class Factory
 public:
   typedef ::sstbx::UniquePtr<SpBlock>::Type BlockPtr;
   typedef ::sstbx::UniquePtr<SpPipe>::Type PipePtr;
+  typedef ::boost::ptr_vector<SpPipe> Pipes;
   typedef ::sstbx::utility::HeterogeneousMap OptionsMap;
 
   Factory(::sstbx::common::AtomSpeciesDatabase & speciesDb):
+    mySpeciesDb(speciesDb),
     mySsLibFactory(speciesDb)
   {}
 
+  /** Only available if built with Qhull, otherwise always fails. */
+  bool createConvexHullBlock(BlockPtr & blockOut, const OptionsMap & options) const;
   bool createDetermineSpaceGroupBlock(BlockPtr & blockOut) const;
   bool createLowestEnergyBlock(BlockPtr & blockOut, const OptionsMap & options) const;
   bool createNiggliReduceBlock(BlockPtr & blockOut) const;
   bool createParamPotentialGeomOptimiseBlock(BlockPtr & blockOut, const OptionsMap & options) const;
   bool createParamSweepBlock(BlockPtr & blockOut, const OptionsMap & options, PipePtr subPipe) const;
+  /** Create a param sweep block that uses each of the (identical) sub pipes as a concurrent worker. */
+  bool createParamSweepBlock(BlockPtr & blockOut, const OptionsMap & options, Pipes & subPipes) const;
   bool createPotentialGeomOptimiseBlock(
     BlockPtr & blockOut,
     const OptionsMap & optimiserOptions,
     const OptionsMap * const potentialOptions = NULL,
     const ::sstbx::potential::OptimisationSettings * optimisationSettings = NULL,
-    const OptionsMap * const globalOptions = NULL
+    const OptionsMap * const globalOptions = NULL,
+    const int numWorkers = 1
   ) const;
   bool createRandomStructureBlock(BlockPtr & blockOut, const OptionsMap & options) const;
   bool createRemoveDuplicatesBlock(BlockPtr & blockOut, const OptionsMap & options) const;
+  /** Create a stoichiometry search block that uses each of the (identical) sub pipes as a concurrent worker. */
+  bool createStoichiometrySearchBlock(BlockPtr & blockOut, const OptionsMap & options, Pipes & subPipes) const;
   bool createWriteStructuresBlock(BlockPtr & blockOut, const OptionsMap & options) const;
 
 private:
 
+  ::sstbx::common::AtomSpeciesDatabase & mySpeciesDb;
   ::sstbx::factory::SsLibFactoryYaml mySsLibFactory;
 
 };
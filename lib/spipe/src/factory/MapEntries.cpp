@@ -22,14 +22,24 @@ namespace factory {
 ::sstbx::utility::Key<size_t> KEEP_TOP;
 ::sstbx::utility::Key<double> KEEP_WITHIN;
 
+::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> CONVEX_HULL;
+::sstbx::utility::Key<double> DROP_ABOVE;
+
 ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> GEOM_OPTIMISE;
 
 ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> PARAM_SWEEP;
 ::sstbx::utility::Key< ::std::vector< ::std::string> > PARAM_RANGE;
+::sstbx::utility::Key<bool> WARM_START;
+::sstbx::utility::Key<int> NUM_WORKERS;
+
+::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> STOICHIOMETRY_SEARCH;
+::sstbx::utility::Key< ::std::vector< ::std::string> > SPECIES_MAX;
+::sstbx::utility::Key<int> MAX_ATOMS;
 
 ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> PRE_GEOM_OPTIMISE;
 ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> RANDOM_STRUCTURE;
 ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> REMOVE_DUPLICATES;
+::sstbx::utility::Key<bool> SPILL;
 
 ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> WRITE_STRUCTURES;
 ::sstbx::utility::Key<bool> MULTI_WRITE;
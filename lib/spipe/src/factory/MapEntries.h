@@ -33,14 +33,24 @@ extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> LOWEST_ENERGY;
 extern ::sstbx::utility::Key<size_t> KEEP_TOP;
 extern ::sstbx::utility::Key<double> KEEP_WITHIN;
 
+extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> CONVEX_HULL;
+extern ::sstbx::utility::Key<double> DROP_ABOVE;
+
 extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> GEOM_OPTIMISE;
 
 extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> PARAM_SWEEP;
 extern ::sstbx::utility::Key< ::std::vector< ::std::string> > PARAM_RANGE;
+extern ::sstbx::utility::Key<bool> WARM_START;
+extern ::sstbx::utility::Key<int> NUM_WORKERS;
+
+extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> STOICHIOMETRY_SEARCH;
+extern ::sstbx::utility::Key< ::std::vector< ::std::string> > SPECIES_MAX;
+extern ::sstbx::utility::Key<int> MAX_ATOMS;
 
 extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> PRE_GEOM_OPTIMISE;
 extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> RANDOM_STRUCTURE;
 extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> REMOVE_DUPLICATES;
+extern ::sstbx::utility::Key<bool> SPILL;
 
 extern ::sstbx::utility::Key< ::sstbx::utility::HeterogeneousMap> WRITE_STRUCTURES;
 extern ::sstbx::utility::Key<bool> MULTI_WRITE;
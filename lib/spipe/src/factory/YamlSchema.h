@@ -34,6 +34,16 @@ namespace factory {
 ///////////////////////////////////////////////////////////
 namespace blocks {
 
+struct ConvexHull : public ::sstbx::yaml_schema::SchemaHeteroMap
+{
+  typedef ::sstbx::utility::HeterogeneousMap BindingType;
+  ConvexHull()
+  {
+    // Drop structures more than this (energy per atom) above the hull
+    addScalarEntry("dropAbove", DROP_ABOVE);
+  }
+};
+
 struct GeomOptimise : ::sstbx::yaml_schema::SchemaHeteroMap
 {
   typedef ::sstbx::utility::HeterogeneousMap BindingType;
@@ -50,6 +60,7 @@ struct GeomOptimise : ::sstbx::yaml_schema::SchemaHeteroMap
       new ::sstbx::factory::Potential()
     );
     addScalarEntry("pressure", ::sstbx::factory::PRESSURE);
+    addScalarEntry("numWorkers", NUM_WORKERS)->element()->defaultValue(1);
   }
 };
 
@@ -73,6 +84,8 @@ struct ParamSweep : public ::sstbx::yaml_schema::SchemaHeteroMap
       PARAM_RANGE,
       new ::sstbx::yaml_schema::SchemaWrapper< ::sstbx::yaml::VectorAsString< ::std::string> >
     )->required();
+    addScalarEntry("warmStart", WARM_START)->element()->defaultValue(false);
+    addScalarEntry("numWorkers", NUM_WORKERS)->element()->defaultValue(1);
   }
 };
 
@@ -95,6 +108,7 @@ struct RemoveDuplicates : public ::sstbx::yaml_schema::SchemaHeteroMap
       ::sstbx::factory::COMPARATOR,
       new ::sstbx::factory::Comparator()
     );
+    addScalarEntry("spill", SPILL)->element()->defaultValue(false);
 
     //::sstbx::utility::HeterogeneousMap defaultOptions;
     //defaultOptions[::sstbx::factory::COMPARATOR];
@@ -102,6 +116,22 @@ struct RemoveDuplicates : public ::sstbx::yaml_schema::SchemaHeteroMap
   }
 };
 
+struct StoichiometrySearch : public ::sstbx::yaml_schema::SchemaHeteroMap
+{
+  typedef ::sstbx::utility::HeterogeneousMap BindingType;
+  StoichiometrySearch()
+  {
+    // A list of species and the maximum number of each e.g. [Na 4, Cl 4]
+    addEntry(
+      "species",
+      SPECIES_MAX,
+      new ::sstbx::yaml_schema::SchemaWrapper< ::sstbx::yaml::VectorAsString< ::std::string> >
+    )->required();
+    addScalarEntry("maxAtoms", MAX_ATOMS)->required();
+    addScalarEntry("numWorkers", NUM_WORKERS)->element()->defaultValue(1);
+  }
+};
+
 struct WriteStructure : ::sstbx::yaml_schema::SchemaHeteroMap
 {
   typedef ::sstbx::utility::HeterogeneousMap BindingType;
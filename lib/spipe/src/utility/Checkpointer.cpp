@@ -0,0 +1,449 @@
+/*
+ * Checkpointer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "utility/Checkpointer.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <boost/crc.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+// From SSTbx
+#include <common/Structure.h>
+#include <common/StructureProperties.h>
+#include <io/ResourceLocator.h>
+#include <io/SslibReaderWriter.h>
+#include <math/Random.h>
+
+// Local includes
+#include "common/CommonData.h"
+
+// NAMESPACES ////////////////////////////////
+
+namespace spipe {
+namespace utility {
+
+namespace fs = ::boost::filesystem;
+namespace ssc = ::sstbx::common;
+namespace ssio = ::sstbx::io;
+namespace structure_properties = ssc::structure_properties;
+
+namespace {
+const char CHECKPOINT_DIR[] = "checkpoint";
+const char NEW_CHECKPOINT_DIR[] = "checkpoint.new";
+const char OLD_CHECKPOINT_DIR[] = "checkpoint.old";
+const char MANIFEST_FILE[] = "blocks";
+const char CONTENTS_FILE[] = "contents";
+const char RNG_FILE[] = "rng";
+const char STRUCTURES_FILE_STEM[] = "structures";
+const char PATHS_FILE[] = "structures.paths";
+
+fs::path getStructuresFile(const fs::path & dir)
+{
+  return dir / (::std::string(STRUCTURES_FILE_STEM) + "." + ssio::SslibReaderWriter::DEFAULT_EXTENSION);
+}
+
+::boost::posix_time::ptime now()
+{
+  return ::boost::posix_time::second_clock::universal_time();
+}
+
+unsigned int getChecksum(const fs::path & file)
+{
+  fs::ifstream in(file, ::std::ios::binary);
+  ::boost::crc_32_type crc;
+  char buffer[4096];
+  while(in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+    crc.process_bytes(buffer, static_cast<size_t>(in.gcount()));
+  return crc.checksum();
+}
+
+::std::string getRelativePath(const fs::path & dir, const fs::path & file)
+{
+  // Both come from iterating over dir so the file path always starts with it
+  return file.generic_string().substr(dir.generic_string().size() + 1);
+}
+}
+
+const double Checkpointer::DEFAULT_INTERVAL = 600.0;
+
+Checkpointer::Checkpointer(
+  const fs::path & dir,
+  SpPipe & pipe,
+  const double interval,
+  const bool resume):
+myDir(dir),
+myPipe(pipe),
+myRunner(NULL),
+myInterval(interval),
+myResume(resume),
+myLastCheckpoint(now())
+{}
+
+Checkpointer::~Checkpointer()
+{
+  deregisterRunner();
+}
+
+void Checkpointer::registerRunner(SpRunner & runner)
+{
+  deregisterRunner();
+
+  myRunner = &runner;
+  myRunner->addListener(*this);
+}
+
+bool Checkpointer::deregisterRunner()
+{
+  if(!myRunner)
+    return false;
+
+  myRunner->removeListener(*this);
+  myRunner = NULL;
+
+  return true;
+}
+
+bool Checkpointer::hasCheckpoint() const
+{
+  return isComplete(getCheckpointDir()) || isComplete(getPreviousCheckpointDir());
+}
+
+bool Checkpointer::checkpointIfDue(SpRunnerAccess & runner)
+{
+  const Time t = now();
+  if(static_cast<double>((t - myLastCheckpoint).total_seconds()) < myInterval)
+    return false;
+
+  return save(runner);
+}
+
+bool Checkpointer::save(SpRunnerAccess & runner)
+{
+  // Make sure nothing is left between blocks, this way all the state is in the blocks
+  runner.flush();
+
+  const fs::path newDir(myDir / NEW_CHECKPOINT_DIR);
+  if(fs::exists(newDir))
+    fs::remove_all(newDir);
+
+  if(!save(newDir))
+  {
+    ::std::cerr << "Failed to save checkpoint to " << newDir << ::std::endl;
+    return false;
+  }
+
+  // Swap the new checkpoint in, at any point there is always a complete one on disk
+  const fs::path checkpointDir(getCheckpointDir());
+  const fs::path oldDir(getPreviousCheckpointDir());
+  if(fs::exists(oldDir))
+    fs::remove_all(oldDir);
+  if(fs::exists(checkpointDir))
+    fs::rename(checkpointDir, oldDir);
+  fs::rename(newDir, checkpointDir);
+  if(fs::exists(oldDir))
+    fs::remove_all(oldDir);
+
+  myLastCheckpoint = now();
+  return true;
+}
+
+bool Checkpointer::restore()
+{
+  // If we were stopped while swapping in a new checkpoint the old one is still
+  // complete.  Pick one before touching the pipe, blocks can't undo a restore
+  // so falling back once one has started would leave them with a mix of both.
+  fs::path checkpointDir(getCheckpointDir());
+  if(!isComplete(checkpointDir))
+  {
+    checkpointDir = getPreviousCheckpointDir();
+    if(!isComplete(checkpointDir))
+      return false;
+  }
+
+  if(!restore(checkpointDir))
+  {
+    // Some blocks may have been restored already so carrying on would give a wrong search
+    throw ::std::runtime_error(
+      "Failed to restore the checkpoint in " + checkpointDir.string() + ", the pipe is only partly restored");
+  }
+  return true;
+}
+
+void Checkpointer::notify(const ::pipelib::event::PipeRunnerStateChanged<SpRunnerAccess> & evt)
+{
+  if(!myRunner)
+    return;
+
+  if(evt.getNewState() == ::pipelib::PipelineState::RUNNING)
+  {
+    if(myResume)
+    {
+      if(!restore())
+        ::std::cerr << "Failed to restore checkpoint from " << myDir << ", starting from scratch." << ::std::endl;
+      myResume = false;
+    }
+    myRunner->memory().global().objectsStore[common::GlobalKeys::CHECKPOINTER] = this;
+    myLastCheckpoint = now();
+  }
+  else if(evt.getNewState() == ::pipelib::PipelineState::FINISHED)
+    myRunner->memory().global().objectsStore.erase(common::GlobalKeys::CHECKPOINTER);
+}
+
+void Checkpointer::notify(const ::pipelib::event::PipeRunnerDestroyed<SpRunnerAccess> & /*evt*/)
+{
+  // We only listen to the one runner
+  myRunner = NULL;
+}
+
+bool Checkpointer::save(const fs::path & checkpointDir)
+{
+  if(!fs::create_directories(checkpointDir))
+    return false;
+
+  {
+    fs::ofstream rngFile(checkpointDir / RNG_FILE);
+    ::sstbx::math::saveState(rngFile);
+    if(!rngFile.good())
+      return false;
+  }
+
+  // Each block gets a directory named by its position in the pipe
+  size_t i = 0;
+  SpBlock & startBlock = *myPipe.getStartBlock();
+  for(SpBlock::PreorderIterator it = startBlock.beginPreorder(), end = startBlock.endPreorder();
+    it != end; ++it, ++i)
+  {
+    const fs::path blockDir(checkpointDir / ::boost::lexical_cast< ::std::string>(i));
+    if(!fs::create_directory(blockDir) || !it->saveState(blockDir.string()))
+      return false;
+  }
+
+  // Write the manifest last, a checkpoint without one is incomplete
+  return writeContents(checkpointDir) && writeManifest(checkpointDir);
+}
+
+bool Checkpointer::restore(const fs::path & checkpointDir)
+{
+  {
+    fs::ifstream rngFile(checkpointDir / RNG_FILE);
+    if(!::sstbx::math::loadState(rngFile))
+      return false;
+  }
+
+  size_t i = 0;
+  SpBlock & startBlock = *myPipe.getStartBlock();
+  for(SpBlock::PreorderIterator it = startBlock.beginPreorder(), end = startBlock.endPreorder();
+    it != end; ++it, ++i)
+  {
+    const fs::path blockDir(checkpointDir / ::boost::lexical_cast< ::std::string>(i));
+    if(!it->restoreState(blockDir.string()))
+    {
+      ::std::cerr << "Failed to restore the state of " << it->getName() << ::std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Checkpointer::writeManifest(const fs::path & checkpointDir)
+{
+  fs::ofstream manifest(checkpointDir / MANIFEST_FILE);
+  SpBlock & startBlock = *myPipe.getStartBlock();
+  for(SpBlock::PreorderIterator it = startBlock.beginPreorder(), end = startBlock.endPreorder();
+    it != end; ++it)
+  {
+    manifest << it->getName() << ::std::endl;
+  }
+  return manifest.good();
+}
+
+bool Checkpointer::writeContents(const fs::path & checkpointDir)
+{
+  // Record every file so a checkpoint that has been damaged since can be spotted
+  // before any of it is restored
+  ::std::vector<fs::path> files;
+  for(fs::recursive_directory_iterator it(checkpointDir), end; it != end; ++it)
+  {
+    if(fs::is_regular_file(it->path()))
+      files.push_back(it->path());
+  }
+
+  fs::ofstream contents(checkpointDir / CONTENTS_FILE);
+  BOOST_FOREACH(const fs::path & file, files)
+  {
+    contents << fs::file_size(file) << " " << getChecksum(file) << " "
+      << getRelativePath(checkpointDir, file) << ::std::endl;
+  }
+  return contents.good();
+}
+
+bool Checkpointer::isComplete(const fs::path & checkpointDir) const
+{
+  return manifestMatches(checkpointDir) && contentsMatch(checkpointDir);
+}
+
+bool Checkpointer::contentsMatch(const fs::path & checkpointDir) const
+{
+  fs::ifstream contents(checkpointDir / CONTENTS_FILE);
+  if(!contents.is_open())
+    return false;
+
+  ::std::string line, relativePath;
+  ::boost::uintmax_t size;
+  unsigned int checksum;
+  while(::std::getline(contents, line))
+  {
+    ::std::istringstream lineStream(line);
+    if(!(lineStream >> size >> checksum) || !::std::getline(lineStream >> ::std::ws, relativePath))
+      return false;
+
+    const fs::path file(checkpointDir / relativePath);
+    if(!fs::is_regular_file(file) || fs::file_size(file) != size || getChecksum(file) != checksum)
+    {
+      ::std::cerr << "Checkpoint file " << file << " is missing or damaged" << ::std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Checkpointer::manifestMatches(const fs::path & checkpointDir) const
+{
+  fs::ifstream manifest(checkpointDir / MANIFEST_FILE);
+  if(!manifest.is_open())
+    return false;
+
+  // The checkpoint has to have come from the same pipe
+  ::std::string name;
+  SpBlock & startBlock = *myPipe.getStartBlock();
+  for(SpBlock::PreorderIterator it = startBlock.beginPreorder(), end = startBlock.endPreorder();
+    it != end; ++it)
+  {
+    if(!::std::getline(manifest, name) || name != it->getName())
+    {
+      ::std::cerr << "Checkpoint in " << checkpointDir << " is from a different pipe" << ::std::endl;
+      return false;
+    }
+  }
+  return !::std::getline(manifest, name);
+}
+
+fs::path Checkpointer::getCheckpointDir() const
+{
+  return myDir / CHECKPOINT_DIR;
+}
+
+fs::path Checkpointer::getPreviousCheckpointDir() const
+{
+  return myDir / OLD_CHECKPOINT_DIR;
+}
+
+bool checkpoint(SpRunnerAccess & runner)
+{
+  // Only the top level pipe is checkpointed, sub-pipes are picked up again by
+  // whichever block runs them
+  if(runner.getParentAccess())
+    return false;
+
+  Checkpointer * const * const checkpointer =
+    runner.memory().global().objectsStore.find(common::GlobalKeys::CHECKPOINTER);
+  if(!checkpointer)
+    return false;
+
+  return (*checkpointer)->checkpointIfDue(runner);
+}
+
+bool saveStructures(
+  const fs::path & dir,
+  const ::std::vector<const ssc::Structure *> & structures,
+  const ssc::AtomSpeciesDatabase & speciesDb)
+{
+  if(!fs::exists(dir) && !fs::create_directories(dir))
+    return false;
+
+  const fs::path structuresFile(getStructuresFile(dir));
+  fs::ofstream pathsFile(dir / PATHS_FILE);
+
+  // Write out copies as writing sets where the structure was last saved
+  ::boost::ptr_vector<ssc::Structure> copies;
+  ssio::IStructureWriter::Structures toWrite;
+  ssio::IStructureWriter::Locators locators;
+  for(size_t i = 0; i < structures.size(); ++i)
+  {
+    copies.push_back(new ssc::Structure(*structures[i]));
+    toWrite.push_back(&copies.back());
+    locators.push_back(ssio::ResourceLocator(structuresFile, ::boost::lexical_cast< ::std::string>(i)));
+
+    const ssio::ResourceLocator * const lastPath =
+      structures[i]->getProperty(structure_properties::io::LAST_ABS_FILE_PATH);
+    pathsFile << (lastPath ? lastPath->string() : ::std::string()) << ::std::endl;
+  }
+
+  if(!toWrite.empty())
+    ssio::SslibReaderWriter().writeStructures(toWrite, locators, speciesDb);
+
+  return pathsFile.good();
+}
+
+size_t loadStructures(
+  ssio::StructuresContainer & structures,
+  const fs::path & dir,
+  const ssc::AtomSpeciesDatabase & speciesDb)
+{
+  const fs::path structuresFile(getStructuresFile(dir));
+  if(!fs::exists(structuresFile))
+    return 0;
+
+  ::std::vector< ::std::string> lastPaths;
+  {
+    fs::ifstream pathsFile(dir / PATHS_FILE);
+    ::std::string line;
+    while(::std::getline(pathsFile, line))
+      lastPaths.push_back(line);
+  }
+
+  ssio::StructuresContainer loaded;
+  ssio::SslibReaderWriter().readStructures(loaded, structuresFile, speciesDb);
+
+  // Point each structure back to where the pipe last saved it
+  ssio::ResourceLocator lastPath;
+  size_t idx;
+  BOOST_FOREACH(ssc::Structure & structure, loaded)
+  {
+    const ssio::ResourceLocator * const loadedFrom =
+      structure.getProperty(structure_properties::io::LAST_ABS_FILE_PATH);
+    if(!loadedFrom)
+      continue;
+    const ::std::string id = loadedFrom->id();
+    structure.eraseProperty(structure_properties::io::LAST_ABS_FILE_PATH);
+
+    try
+    {
+      idx = ::boost::lexical_cast<size_t>(id);
+    }
+    catch(const ::boost::bad_lexical_cast & /*e*/)
+    {
+      continue;
+    }
+    if(idx < lastPaths.size() && !lastPaths[idx].empty() && lastPath.set(lastPaths[idx]))
+      structure.setProperty(structure_properties::io::LAST_ABS_FILE_PATH, lastPath);
+  }
+
+  const size_t numLoaded = loaded.size();
+  structures.transfer(structures.end(), loaded);
+  return numLoaded;
+}
+
+}
+}
@@ -0,0 +1,130 @@
+/*
+ * Checkpointer.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+// INCLUDES /////////////////////////////////////////////
+#include "StructurePipe.h"
+
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <io/BoostFilesystem.h>
+#include <io/IStructureReader.h>
+
+#include <pipelib/pipelib.h>
+
+// Local includes
+#include "SpTypes.h"
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+namespace sstbx {
+namespace common {
+class AtomSpeciesDatabase;
+class Structure;
+}
+}
+
+namespace spipe {
+namespace utility {
+
+/**
+/* Periodically saves the state of a running pipe so that a long search can be
+/* picked up again from where it left off if it gets interrupted.  A checkpoint
+/* is made up of the state of the random number generator and whatever each
+/* block saves in Block::saveState.  Start blocks say when it's safe to save by
+/* calling checkpoint() (below).  To resume, the same pipe is built again and
+/* run with a checkpointer that has been told to resume from the directory.
+/**/
+class Checkpointer : public SpRunnerListener, ::boost::noncopyable
+{
+public:
+  static const double DEFAULT_INTERVAL;
+
+  Checkpointer(
+    const ::boost::filesystem::path & dir,
+    SpPipe & pipe,
+    const double interval = DEFAULT_INTERVAL,
+    const bool resume = false);
+  ~Checkpointer();
+
+  /** Checkpoint the pipe run by this (top level) runner. */
+  void registerRunner(SpRunner & runner);
+  bool deregisterRunner();
+
+  /** Is there a complete, undamaged, checkpoint in the directory to resume from. */
+  bool hasCheckpoint() const;
+
+  /**
+  /* Save a checkpoint if the interval has passed since the last one.  The
+  /* runner is flushed first so that all the data sent out so far has gone
+  /* as far as it can.
+  /**/
+  bool checkpointIfDue(SpRunnerAccess & runner);
+  bool save(SpRunnerAccess & runner);
+  /**
+  /* Restore the pipe from the checkpoint, the pipe has to be running.  Returns
+  /* false, leaving the pipe untouched, if there is no complete checkpoint.  If
+  /* a block fails to restore from one that is complete the pipe is left in a
+  /* state that can't be run from so a ::std::runtime_error is thrown.
+  /**/
+  bool restore();
+
+  // From IPipeListener /////////////////////
+  virtual void notify(const ::pipelib::event::PipeRunnerStateChanged<SpRunnerAccess> & evt);
+  virtual void notify(const ::pipelib::event::PipeRunnerDestroyed<SpRunnerAccess> & evt);
+  // End from IPipeListener /////////////////
+
+private:
+  typedef ::boost::posix_time::ptime Time;
+
+  bool save(const ::boost::filesystem::path & checkpointDir);
+  bool restore(const ::boost::filesystem::path & checkpointDir);
+  bool writeContents(const ::boost::filesystem::path & checkpointDir);
+  bool writeManifest(const ::boost::filesystem::path & checkpointDir);
+  bool isComplete(const ::boost::filesystem::path & checkpointDir) const;
+  bool contentsMatch(const ::boost::filesystem::path & checkpointDir) const;
+  bool manifestMatches(const ::boost::filesystem::path & checkpointDir) const;
+  ::boost::filesystem::path getCheckpointDir() const;
+  ::boost::filesystem::path getPreviousCheckpointDir() const;
+
+  const ::boost::filesystem::path myDir;
+  SpPipe &                        myPipe;
+  SpRunner *                      myRunner;
+  const double                    myInterval;
+  bool                            myResume;
+  Time                            myLastCheckpoint;
+};
+
+/**
+/* Called by start blocks at points where the state they've saved would let them
+/* carry on from where they are now.  Saves a checkpoint if the top level pipe
+/* has a checkpointer and one is due.
+/**/
+bool checkpoint(SpRunnerAccess & runner);
+
+/**
+/* Save/load structures held by a block as part of its state.  The structures
+/* still point to wherever the pipe last saved them rather than the checkpoint.
+/**/
+bool saveStructures(
+  const ::boost::filesystem::path & dir,
+  const ::std::vector<const ::sstbx::common::Structure *> & structures,
+  const ::sstbx::common::AtomSpeciesDatabase & speciesDb);
+size_t loadStructures(
+  ::sstbx::io::StructuresContainer & structures,
+  const ::boost::filesystem::path & dir,
+  const ::sstbx::common::AtomSpeciesDatabase & speciesDb);
+
+}
+}
+
+#endif /* CHECKPOINTER_H */
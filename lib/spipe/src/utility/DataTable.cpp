@@ -10,6 +10,9 @@
 #include "utility/DataTable.h"
 
 #include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
 
 #include <boost/foreach.hpp>
 
@@ -23,6 +26,18 @@ namespace spipe
 namespace utility
 {
 
+namespace {
+bool readCount(::std::istream & is, size_t & count)
+{
+  ::std::string line;
+  if(!::std::getline(is, line))
+    return false;
+  ::std::istringstream lineStream(line);
+  lineStream >> count;
+  return !lineStream.fail();
+}
+}
+
 DataTable::Column::Column() {}
 
 DataTable::Column::Column(const ::std::string & name):
@@ -119,6 +134,78 @@ void DataTable::clear()
   myTableNotes.clear();
 }
 
+void DataTable::save(::std::ostream & os) const
+{
+  // One entry per line, each preceded by the number of entries in the section
+  os << myColumns.size() << ::std::endl;
+  BOOST_FOREACH(const Column & colInfo, myColumns)
+  {
+    os << colInfo.getName() << ::std::endl;
+  }
+
+  os << myRows.size() << ::std::endl;
+  BOOST_FOREACH(const RowMap::value_type & rowPair, myRows)
+  {
+    os << rowPair.first << ::std::endl << rowPair.second.size() << ::std::endl;
+    BOOST_FOREACH(const Value & value, rowPair.second)
+    {
+      os << value << ::std::endl;
+    }
+  }
+
+  os << myTableNotes.size() << ::std::endl;
+  BOOST_FOREACH(const ::std::string & note, myTableNotes)
+  {
+    os << note << ::std::endl;
+  }
+}
+
+bool DataTable::load(::std::istream & is)
+{
+  ColumnInfo columns;
+  RowMap rows;
+  NotesContainer notes;
+  ::std::string line;
+  size_t num, numValues;
+
+  if(!readCount(is, num))
+    return false;
+  for(size_t i = 0; i < num; ++i)
+  {
+    if(!::std::getline(is, line))
+      return false;
+    columns.push_back(Column(line));
+  }
+
+  if(!readCount(is, num))
+    return false;
+  for(size_t i = 0; i < num; ++i)
+  {
+    if(!::std::getline(is, line) || !readCount(is, numValues))
+      return false;
+    ColumnData & colData = rows[line];
+    colData.resize(numValues);
+    for(size_t j = 0; j < numValues; ++j)
+    {
+      if(!::std::getline(is, colData[j]))
+        return false;
+    }
+  }
+
+  if(!readCount(is, num))
+    return false;
+  for(size_t i = 0; i < num; ++i)
+  {
+    if(!::std::getline(is, line))
+      return false;
+    notes.push_back(line);
+  }
+
+  myColumns.swap(columns);
+  myRows.swap(rows);
+  myTableNotes.swap(notes);
+  return true;
+}
 
 void DataTable::addDataTableChangeListener(IDataTableChangeListener & listener)
 {
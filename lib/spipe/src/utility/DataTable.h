@@ -11,6 +11,7 @@
 
 // INCLUDES /////////////////////////////////////////////
 
+#include <iosfwd>
 #include <map>
 #include <string>
 #include <vector>
@@ -65,6 +66,13 @@ public:
 
   void clear();
 
+  /**
+  /* Save/load the full contents of the table, e.g. to carry on filling it in
+  /* after a checkpoint.  Loading replaces whatever is in the table.
+  /**/
+  void save(::std::ostream & os) const;
+  bool load(::std::istream & is);
+
   // Event //////////////////////////////////////
   void addDataTableChangeListener(IDataTableChangeListener & listener);
   bool removeDataTableChangeListener(IDataTableChangeListener & listener);
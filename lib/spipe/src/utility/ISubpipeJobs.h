@@ -0,0 +1,58 @@
+/*
+ * ISubpipeJobs.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef I_SUBPIPE_JOBS_H
+#define I_SUBPIPE_JOBS_H
+
+// INCLUDES /////////////////////////////////////////////
+#include "StructurePipe.h"
+
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include "SpTypes.h"
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+
+namespace spipe {
+namespace utility {
+
+/**
+/* A set of independent jobs, each of which is a run of a sub-pipeline, to be
+/* carried out by SubpipeWorkers.
+/**/
+class ISubpipeJobs
+{
+public:
+  typedef ::boost::ptr_vector<StructureDataType> FinishedData;
+
+  virtual ~ISubpipeJobs() {}
+
+  /**
+  /* Set up the memory of the runner that is about to run the job.  This may be
+  /* called from a worker thread.
+  /**/
+  virtual void prepareJob(const size_t job, SpRunner & runner) = 0;
+
+  /**
+  /* A structure has finished its way through the sub-pipeline running the job.
+  /* This may be called from a worker thread.  Does nothing by default.
+  /**/
+  virtual void jobDataFinished(const size_t job, StructureDataType & data, SpRunner & runner) {}
+
+  /**
+  /* The job has finished.  This is always called from the thread that started
+  /* the jobs and in job order so anything that is not thread safe (e.g. updating
+  /* tables or sending data down the parent pipe) should be done here.
+  /**/
+  virtual void jobFinished(const size_t job, FinishedData & finished) = 0;
+};
+
+}}
+
+#endif /* I_SUBPIPE_JOBS_H */
@@ -0,0 +1,105 @@
+/*
+ * ProfileReport.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "utility/ProfileReport.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/lexical_cast.hpp>
+
+// Local includes
+#include "common/UtilityFunctions.h"
+#include "utility/DataTableWriter.h"
+
+// NAMESPACES ////////////////////////////////
+
+namespace spipe {
+namespace utility {
+namespace fs = ::boost::filesystem;
+
+ProfileReport::ProfileReport(const ::boost::filesystem::path & filename):
+myRunner(NULL),
+myFilename(filename)
+{}
+
+ProfileReport::~ProfileReport()
+{
+  deregisterRunner();
+}
+
+void ProfileReport::registerRunner(SpRunnerAccess & runner)
+{
+  deregisterRunner();
+
+  myRunner = &runner;
+  myRunner->addListener(*this);
+}
+
+bool ProfileReport::deregisterRunner()
+{
+  if(!myRunner)
+    return false;
+
+  myRunner->removeListener(*this);
+  myRunner = NULL;
+
+  return true;
+}
+
+void ProfileReport::notify(const ::pipelib::event::PipeRunnerStateChanged<SpRunnerAccess> & evt)
+{
+  if(evt.getNewState() == ::pipelib::PipelineState::RUNNING)
+  {
+    // Start a fresh report for each run
+    myWriter.reset();
+    myTable.clear();
+  }
+}
+
+void ProfileReport::notify(const ::pipelib::event::PipeRunnerDestroyed<SpRunnerAccess> & evt)
+{
+  if(myRunner == &evt.getRunner())
+    myRunner = NULL;
+}
+
+void ProfileReport::notify(const ::pipelib::event::PipeRunnerProfileUpdated<SpRunnerAccess> & evt)
+{
+  typedef SpRunnerAccess::ProfileType Profile;
+  using ::boost::lexical_cast;
+  using ::std::string;
+
+  const Profile & profile = evt.getProfile();
+
+  size_t i = 0;
+  for(Profile::const_iterator it = profile.begin(), end = profile.end(); it != end; ++it, ++i)
+  {
+    // The writer separates columns with spaces so they can't appear in the key,
+    // the index keeps the rows in order and blocks with the same name apart
+    ::std::stringstream keyStream;
+    keyStream << ::std::setw(3) << ::std::setfill('0') << i << "_" << it->block->getName();
+    const DataTable::Key key = ::boost::algorithm::replace_all_copy(keyStream.str(), " ", "_");
+
+    myTable.insert(key, "time/s", common::getString(it->time));
+    myTable.insert(key, "received", lexical_cast<string>(it->numReceived));
+    myTable.insert(key, "emitted", lexical_cast<string>(it->numEmitted));
+    myTable.insert(key, "dropped", lexical_cast<string>(it->numDropped));
+    myTable.insert(key, "held/s", common::getString(it->holdTime));
+    myTable.insert(key, "releases", lexical_cast<string>(it->numReleases));
+  }
+  myTable.insert("total", "time/s", common::getString(profile.getElapsedTime()));
+  myTable.insert("total", "peak_data", lexical_cast<string>(profile.getPeakLiveData()));
+
+  if(!myWriter.get())
+    myWriter.reset(new DataTableWriter(myTable, myFilename, false));
+  myWriter->write();
+}
+
+}
+}
@@ -0,0 +1,67 @@
+/*
+ * ProfileReport.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PROFILE_REPORT_H
+#define PROFILE_REPORT_H
+
+// INCLUDES /////////////////////////////////////////////
+#include "StructurePipe.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <io/BoostFilesystem.h>
+
+#include <pipelib/pipelib.h>
+
+// Local includes
+#include "SpTypes.h"
+#include "utility/DataTable.h"
+
+
+namespace spipe {
+namespace utility {
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+class DataTableWriter;
+
+/**
+/* Writes the block timings and data counts of a runner that has profiling
+/* switched on to a table, one row per block in the order they were first
+/* called.  The table is rewritten each time the runner sends a profile.
+/**/
+class ProfileReport : public SpRunnerListener
+{
+public:
+
+  explicit ProfileReport(const ::boost::filesystem::path & filename);
+  ~ProfileReport();
+
+  void registerRunner(SpRunnerAccess & runner);
+  bool deregisterRunner();
+
+  // From IPipeListener /////////////////////
+  virtual void notify(const ::pipelib::event::PipeRunnerStateChanged<SpRunnerAccess> & evt);
+  virtual void notify(const ::pipelib::event::PipeRunnerDestroyed<SpRunnerAccess> & evt);
+  virtual void notify(const ::pipelib::event::PipeRunnerProfileUpdated<SpRunnerAccess> & evt);
+  // End from IPipeListener /////////////////
+
+private:
+
+  typedef ::boost::scoped_ptr<DataTableWriter> DataTableWriterPtr;
+
+  SpRunnerAccess *                  myRunner;
+  const ::boost::filesystem::path   myFilename;
+  DataTable                         myTable;
+  DataTableWriterPtr                myWriter;
+};
+
+
+}
+}
+
+#endif /* PROFILE_REPORT_H */
@@ -0,0 +1,180 @@
+/*
+ * SharedStructureStore.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "utility/SharedStructureStore.h"
+
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+// From SSTbx
+#include <common/Structure.h>
+#include <io/StructureYamlGenerator.h>
+
+// NAMESPACES ////////////////////////////////
+
+namespace spipe {
+namespace utility {
+
+namespace fs = ::boost::filesystem;
+namespace ssc = ::sstbx::common;
+namespace ssio = ::sstbx::io;
+
+namespace {
+const char RECORD_SEPARATOR[] = "---";
+const char LOCK_FILE_EXTENSION[] = ".lock";
+}
+
+SharedStructureStore::Lock::Lock(SharedStructureStore & store):
+myStore(store)
+{
+  SP_ASSERT(!myStore.myLocked);
+
+  myStore.myFileLock->lock();
+  myStore.myLocked = true;
+}
+
+SharedStructureStore::Lock::~Lock()
+{
+  myStore.myLocked = false;
+  myStore.myFileLock->unlock();
+}
+
+SharedStructureStore::SharedStructureStore(
+  const fs::path & path,
+  const ssc::AtomSpeciesDatabase & speciesDb):
+myPath(path),
+mySpeciesDb(speciesDb),
+myReadOffset(0),
+myLocked(false)
+{
+  const fs::path dir = myPath.parent_path();
+  if(!dir.empty() && !fs::exists(dir))
+    fs::create_directories(dir);
+
+  // The files have to exist before we can lock them, opening to append leaves
+  // whatever is there already
+  const fs::path lockPath(myPath.string() + LOCK_FILE_EXTENSION);
+  {
+    fs::ofstream storeFile(myPath, ::std::ios_base::app);
+    fs::ofstream lockFile(lockPath, ::std::ios_base::app);
+  }
+
+  myFileLock.reset(new FileLock(lockPath.string().c_str()));
+}
+
+const fs::path & SharedStructureStore::getPath() const
+{
+  return myPath;
+}
+
+size_t SharedStructureStore::readNew(ssio::StructuresContainer & structures)
+{
+  SP_ASSERT(myLocked);
+
+  fs::ifstream storeFile(myPath, ::std::ios_base::in | ::std::ios_base::binary);
+  if(!storeFile.is_open())
+    return 0;
+
+  storeFile.seekg(myReadOffset);
+  const ::std::string newRecords(
+    (::std::istreambuf_iterator<char>(storeFile)),
+    ::std::istreambuf_iterator<char>()
+  );
+  myReadOffset += static_cast< ::std::streamoff>(newRecords.size());
+
+  // Records are only ever written whole while holding the lock
+  ::std::istringstream recordsStream(newRecords);
+  ::std::string line, record;
+  size_t numRead = 0;
+  while(::std::getline(recordsStream, line))
+  {
+    if(line == RECORD_SEPARATOR)
+    {
+      if(readRecord(structures, record))
+        ++numRead;
+      record.clear();
+    }
+    else
+      record += line + "\n";
+  }
+  if(readRecord(structures, record))
+    ++numRead;
+
+  return numRead;
+}
+
+bool SharedStructureStore::append(const ssc::Structure & structure)
+{
+  SP_ASSERT(myLocked);
+
+  // If someone else has added to the store since we last read it we still
+  // have to read their structures next time
+  const bool upToDate =
+    static_cast< ::std::streamoff>(fs::file_size(myPath)) == myReadOffset;
+
+  const ssio::StructureYamlGenerator generator(mySpeciesDb);
+  YAML::Emitter out;
+  out << generator.generateNode(structure);
+
+  fs::ofstream storeFile(myPath, ::std::ios_base::app | ::std::ios_base::binary);
+  // A process killed while writing may have left part of a line, make sure our
+  // separator starts a line of its own so it doesn't get lost along with it
+  if(!endsWithNewline())
+    storeFile << "\n";
+  storeFile << RECORD_SEPARATOR << "\n" << out.c_str() << "\n";
+  storeFile.close();
+  if(storeFile.fail())
+    return false;
+
+  if(upToDate)
+    myReadOffset = static_cast< ::std::streamoff>(fs::file_size(myPath));
+  return true;
+}
+
+bool SharedStructureStore::endsWithNewline() const
+{
+  fs::ifstream storeFile(myPath, ::std::ios_base::in | ::std::ios_base::binary);
+  storeFile.seekg(0, ::std::ios_base::end);
+  if(!storeFile.is_open() || storeFile.tellg() <= 0)
+    return true;
+
+  storeFile.seekg(-1, ::std::ios_base::end);
+  return storeFile.get() == '\n';
+}
+
+bool SharedStructureStore::readRecord(
+  ssio::StructuresContainer & structures,
+  const ::std::string & record) const
+{
+  // Nothing but the line ending left before a write that was cut short
+  if(record.find_first_not_of(" \t\r\n") == ::std::string::npos)
+    return false;
+
+  const ssio::StructureYamlGenerator generator(mySpeciesDb);
+  try
+  {
+    ssc::types::StructurePtr structure = generator.generateStructure(YAML::Load(record));
+    if(!structure.get())
+      return false;
+    structures.push_back(structure.release());
+  }
+  catch(const YAML::Exception & /*e*/)
+  {
+    // A process may have been killed while writing, skip what it left behind
+    ::std::cerr << "Skipping unreadable record in " << myPath << ::std::endl;
+    return false;
+  }
+  return true;
+}
+
+}
+}
@@ -0,0 +1,87 @@
+/*
+ * SharedStructureStore.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SHARED_STRUCTURE_STORE_H
+#define SHARED_STRUCTURE_STORE_H
+
+// INCLUDES /////////////////////////////////////////////
+#include "StructurePipe.h"
+
+#include <iosfwd>
+
+// Interprocess only uses the header only part of date_time
+#define BOOST_DATE_TIME_NO_LIB
+
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <io/BoostFilesystem.h>
+#include <io/IStructureReader.h>
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+namespace sstbx {
+namespace common {
+class AtomSpeciesDatabase;
+class Structure;
+}
+}
+
+namespace spipe {
+namespace utility {
+
+/**
+/* An append-only file of structures that a number of processes can share to
+/* agree on which structures have been found so far.  Each process keeps track
+/* of how far through the file it has read so it only ever reads the structures
+/* added by the others since it last looked.  A process must hold the lock to
+/* read from or append to the store.  The lock is taken on a separate file as
+/* POSIX releases all of a process' locks on a file when any descriptor to it
+/* is closed.
+/**/
+class SharedStructureStore : ::boost::noncopyable
+{
+public:
+
+  /** Holds the store for as long as it is in scope. */
+  class Lock : ::boost::noncopyable
+  {
+  public:
+    explicit Lock(SharedStructureStore & store);
+    ~Lock();
+  private:
+    SharedStructureStore & myStore;
+  };
+
+  SharedStructureStore(
+    const ::boost::filesystem::path & path,
+    const ::sstbx::common::AtomSpeciesDatabase & speciesDb);
+
+  const ::boost::filesystem::path & getPath() const;
+
+  /** Read any structures added since we last looked, returns the number read. */
+  size_t readNew(::sstbx::io::StructuresContainer & structures);
+  bool append(const ::sstbx::common::Structure & structure);
+
+private:
+  typedef ::boost::interprocess::file_lock FileLock;
+
+  bool endsWithNewline() const;
+  bool readRecord(::sstbx::io::StructuresContainer & structures, const ::std::string & record) const;
+
+  const ::boost::filesystem::path myPath;
+  const ::sstbx::common::AtomSpeciesDatabase & mySpeciesDb;
+  ::boost::scoped_ptr<FileLock> myFileLock;
+  ::std::streamoff myReadOffset;
+  bool myLocked;
+};
+
+}
+}
+
+#endif /* SHARED_STRUCTURE_STORE_H */
@@ -0,0 +1,226 @@
+/*
+ * SubpipeWorkers.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "utility/SubpipeWorkers.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/thread.hpp>
+
+// From SSLib
+#include <math/Random.h>
+
+// NAMESPACES ////////////////////////////////
+
+namespace spipe {
+namespace utility {
+
+void SubpipeWorkers::addWorker(SpRunnerSetup & setup, SpPipe & subpipe)
+{
+  SpChildRunnerPtr runner = setup.createChildRunner(subpipe);
+  myWorkers.push_back(new Worker(runner));
+}
+
+size_t SubpipeWorkers::getNumWorkers() const
+{
+  return myWorkers.size();
+}
+
+void SubpipeWorkers::clear()
+{
+  myWorkers.clear();
+}
+
+void SubpipeWorkers::run(
+  const size_t numJobs,
+  ISubpipeJobs & jobs,
+  const bool concurrent,
+  const size_t firstJob)
+{
+  SP_ASSERT(!myWorkers.empty());
+
+  if(firstJob >= numJobs)
+    return;
+
+  const size_t numThreads = ::std::min(myWorkers.size(), numJobs - firstJob);
+  if(!concurrent || numThreads < 2)
+  {
+    runSerial(numJobs, jobs, firstJob);
+    return;
+  }
+
+  Progress progress(numJobs, firstJob);
+
+  // The sub-pipes draw random numbers so each job gets its own generator.  The
+  // seeds come from this thread's generator and the job index, not from which
+  // thread happens to pick the job up, so that a seeded run stays reproducible.
+  const unsigned int baseSeed =
+    ::sstbx::math::randu<unsigned int>(::std::numeric_limits<unsigned int>::max());
+
+  ::boost::thread_group threads;
+  for(size_t i = 0; i < numThreads; ++i)
+  {
+    threads.create_thread(::boost::bind(
+      &SubpipeWorkers::doJobs,
+      this,
+      ::boost::ref(myWorkers[i]),
+      ::boost::ref(jobs),
+      ::boost::ref(progress),
+      baseSeed)
+    );
+  }
+
+  // Hand the jobs back in order as they become available
+  try
+  {
+    for(size_t job = firstJob; job < numJobs; ++job)
+    {
+      {
+        ::boost::unique_lock< ::boost::mutex> lock(progress.mutex);
+        while(!progress.done[job] && !progress.error)
+          progress.jobDone.wait(lock);
+        // A job has failed, the rest won't be finished
+        if(progress.error)
+          break;
+      }
+      jobs.jobFinished(job, progress.finished[job]);
+      progress.finished[job].clear();
+    }
+  }
+  catch(...)
+  {
+    // Stop the workers starting any more jobs, they have to be finished with
+    // the progress before we leave
+    ::boost::lock_guard< ::boost::mutex> lock(progress.mutex);
+    if(!progress.error)
+      progress.error = ::boost::current_exception();
+  }
+
+  threads.join_all();
+
+  if(progress.error)
+    ::boost::rethrow_exception(progress.error);
+}
+
+void SubpipeWorkers::runSerial(
+  const size_t numJobs,
+  ISubpipeJobs & jobs,
+  const size_t firstJob)
+{
+  Worker & worker = myWorkers.front();
+  FinishedData finished;
+  for(size_t job = firstJob; job < numJobs; ++job)
+  {
+    worker.runJob(job, jobs, finished);
+    jobs.jobFinished(job, finished);
+    finished.clear();
+  }
+}
+
+void SubpipeWorkers::doJobs(
+  Worker & worker,
+  ISubpipeJobs & jobs,
+  Progress & progress,
+  const unsigned int baseSeed)
+{
+  size_t job;
+  while(true)
+  {
+    {
+      ::boost::lock_guard< ::boost::mutex> lock(progress.mutex);
+      if(progress.nextJob == progress.numJobs || progress.error)
+        return;
+      job = progress.nextJob++;
+    }
+
+    ::sstbx::math::seedThread(baseSeed + static_cast<unsigned int>(job));
+
+    // Only this thread touches the finished data for this job until it is marked
+    // done.  An exception can't be allowed to leave the thread so it is passed
+    // back to the thread that started the jobs.
+    ::boost::exception_ptr error;
+    try
+    {
+      worker.runJob(job, jobs, progress.finished[job]);
+    }
+    catch(...)
+    {
+      error = ::boost::current_exception();
+    }
+
+    {
+      ::boost::lock_guard< ::boost::mutex> lock(progress.mutex);
+      if(error && !progress.error)
+        progress.error = error;
+      progress.done[job] = true;
+    }
+    progress.jobDone.notify_one();
+  }
+}
+
+SubpipeWorkers::Worker::Worker(SpChildRunnerPtr & runner):
+myRunner(runner),
+myJob(0),
+myJobs(NULL),
+myFinished(NULL)
+{
+  // Collect any finished data from the sub-pipeline
+  myRunner->setFinishedDataSink(this);
+}
+
+void SubpipeWorkers::Worker::runJob(
+  const size_t job,
+  ISubpipeJobs & jobs,
+  FinishedData & finished)
+{
+  myJob = job;
+  myJobs = &jobs;
+  myFinished = &finished;
+
+  try
+  {
+    jobs.prepareJob(job, *myRunner);
+    myRunner->run();
+  }
+  catch(...)
+  {
+    // Don't hang on to the job, its data may not outlive the exception
+    myJobs = NULL;
+    myFinished = NULL;
+    throw;
+  }
+
+  myJobs = NULL;
+  myFinished = NULL;
+}
+
+void SubpipeWorkers::Worker::finished(SpStructureDataPtr data)
+{
+  // Not running a job so let the data be deleted
+  if(!myJobs)
+    return;
+
+  myJobs->jobDataFinished(myJob, *data, *myRunner);
+  myFinished->push_back(data.release());
+}
+
+SubpipeWorkers::Progress::Progress(const size_t numJobs_, const size_t firstJob):
+numJobs(numJobs_),
+nextJob(firstJob),
+done(numJobs_, false)
+{
+  for(size_t i = 0; i < numJobs; ++i)
+    finished.push_back(new FinishedData());
+}
+
+}
+}
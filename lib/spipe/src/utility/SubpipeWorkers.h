@@ -0,0 +1,113 @@
+/*
+ * SubpipeWorkers.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SUBPIPE_WORKERS_H
+#define SUBPIPE_WORKERS_H
+
+// INCLUDES /////////////////////////////////////////////
+#include "StructurePipe.h"
+
+#include <vector>
+
+#include <boost/exception_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <pipelib/pipelib.h>
+
+// Local includes
+#include "SpTypes.h"
+#include "utility/ISubpipeJobs.h"
+
+// FORWARD DECLARATIONS ////////////////////////////////////
+
+
+namespace spipe {
+namespace utility {
+
+/**
+/* Runs a set of jobs using one child runner per sub-pipeline instance.  Each
+/* instance is driven by its own thread so the jobs have to be independent and
+/* the instances must not share any state.  When run concurrently each job gets
+/* its own random number generator seeded from the calling thread's generator
+/* and the job index so a seeded run gives the same results however the jobs
+/* end up spread over the threads.
+/**/
+class SubpipeWorkers : ::boost::noncopyable
+{
+public:
+  typedef ISubpipeJobs::FinishedData FinishedData;
+
+  /** Add a worker for the given sub-pipeline instance, call this from Block::runnerAttached. */
+  void addWorker(SpRunnerSetup & setup, SpPipe & subpipe);
+  size_t getNumWorkers() const;
+  void clear();
+
+  /**
+  /* Run the jobs from firstJob up to numJobs.  If concurrent is false, or there
+  /* is only one worker, the jobs are run one after the other on the calling thread.
+  /* If a job throws then no further jobs are started or handed back and the
+  /* exception is rethrown here once the running jobs have finished.
+  /**/
+  void run(
+    const size_t numJobs,
+    ISubpipeJobs & jobs,
+    const bool concurrent = true,
+    const size_t firstJob = 0);
+
+private:
+
+  class Worker : public SpFinishedSink, ::boost::noncopyable
+  {
+  public:
+    Worker(SpChildRunnerPtr & runner);
+
+    void runJob(const size_t job, ISubpipeJobs & jobs, FinishedData & finished);
+
+    // From FinishedSink ////////////
+    virtual void finished(SpStructureDataPtr data);
+    // End from FinishedSink ////////
+
+  private:
+    SpChildRunnerPtr myRunner;
+    size_t myJob;
+    ISubpipeJobs * myJobs;
+    FinishedData * myFinished;
+  };
+
+  struct Progress
+  {
+    Progress(const size_t numJobs, const size_t firstJob);
+
+    const size_t numJobs;
+    size_t nextJob;
+    ::boost::ptr_vector<FinishedData> finished;
+    ::std::vector<bool> done;
+    /** The first exception thrown by a job, if any. */
+    ::boost::exception_ptr error;
+    ::boost::mutex mutex;
+    ::boost::condition_variable jobDone;
+  };
+
+  typedef ::boost::ptr_vector<Worker> Workers;
+
+  void runSerial(const size_t numJobs, ISubpipeJobs & jobs, const size_t firstJob);
+  void doJobs(
+    Worker & worker,
+    ISubpipeJobs & jobs,
+    Progress & progress,
+    const unsigned int baseSeed);
+
+  Workers myWorkers;
+};
+
+}}
+
+#endif /* SUBPIPE_WORKERS_H */
@@ -85,6 +85,51 @@ private:
   const unsigned int myNumToGenerate;
 };
 
+class EnergiesSender : public ::spipe::SpStartBlock
+{
+public:
+  EnergiesSender(const ::std::vector<double> & energies):
+  ::spipe::SpStartBlock::BlockType("Send energies"),
+  myEnergies(energies) {}
+
+  virtual void start()
+  {
+    typedef ::sstbx::UniquePtr<ssc::Structure>::Type StructurePtr;
+    typedef ::spipe::StructureDataType StructureDataType;
+    typedef ::sstbx::UniquePtr<StructureDataType>::Type StructureDataPtr;
+
+    BOOST_FOREACH(const double energy, myEnergies)
+    {
+      StructureDataPtr structureData(new StructureDataType());
+      StructurePtr structure(new ssc::Structure());
+      structure->setProperty(structure_properties::general::ENERGY_INTERNAL, energy);
+      structureData->setStructure(structure);
+      out(getRunner()->registerData(structureData));
+    }
+  }
+
+private:
+  const ::std::vector<double> myEnergies;
+};
+
+/** Send the energies through a block keeping those within the percentage and count how many come out. */
+unsigned int numKeptWithin(const double percentage, const double * const energies, const size_t numEnergies)
+{
+  spipe::SpPipe pipe;
+  EnergiesSender * const send =
+    pipe.addBlock(new EnergiesSender(::std::vector<double>(energies, energies + numEnergies)));
+  blocks::LowestFreeEnergy * const lowestEnergy = pipe.addBlock(new blocks::LowestFreeEnergy(percentage));
+  pipe.setStartBlock(send);
+  pipe.connect(send, lowestEnergy);
+
+  StructureSink sink;
+  spipe::SpSingleThreadedEngine engine;
+  spipe::SpSingleThreadedEngine::RunnerPtr runner = engine.createRunner();
+  runner->setFinishedDataSink(&sink);
+  runner->run(pipe);
+  return sink.getNumReceived();
+}
+
 BOOST_AUTO_TEST_CASE(LowestFreeEnergyTest)
 {
   typedef spipe::SpSingleThreadedEngine Engine;
@@ -97,7 +142,7 @@ BOOST_AUTO_TEST_CASE(LowestFreeEnergyTest)
 
   Pipe pipe;
   StructuresSender * const send = pipe.addBlock(new StructuresSender(NUM_STRUCTURES));
-  blocks::LowestFreeEnergy * const lowestEnergy = pipe.addBlock(new blocks::LowestFreeEnergy(NUM_TO_KEEP));
+  blocks::LowestFreeEnergy * const lowestEnergy = pipe.addBlock(new blocks::LowestFreeEnergy(static_cast<size_t>(NUM_TO_KEEP)));
 
   // Set up the pipe
   pipe.setStartBlock(send);
@@ -118,4 +163,22 @@ BOOST_AUTO_TEST_CASE(LowestFreeEnergyTest)
   BOOST_REQUIRE(sink.getNumReceived() == NUM_TO_KEEP);
 }
 
-// TODO: Write test to test keep top % mode
+BOOST_AUTO_TEST_CASE(KeepTopPercentageTest)
+{
+  // Within 10% of -10 is down to -9, -9 itself is kept and -8.9 is not.  Then
+  // -20 brings the cutoff down to -18 so only it and what comes after are left.
+  const double NEGATIVE[] = { -10.0, -9.5, -9.0, -8.9, -10.0, -20.0, -18.0, -19.0, -17.9 };
+  BOOST_REQUIRE(numKeptWithin(0.1, NEGATIVE, sizeof(NEGATIVE) / sizeof(double)) == 3);
+
+  // A new lowest is kept even though it's below the current cutoff.  9.5 moves
+  // the cutoff to 10.45 so 10.5 goes and 10 stays, along with the second 9.5.
+  const double POSITIVE[] = { 10.0, 10.5, 9.5, 9.5, 11.0 };
+  BOOST_REQUIRE(numKeptWithin(0.1, POSITIVE, sizeof(POSITIVE) / sizeof(double)) == 3);
+
+  // With no leeway only structures equal to the lowest are kept
+  const double EQUAL[] = { -5.0, -5.0, -4.0, -5.0 };
+  BOOST_REQUIRE(numKeptWithin(0.0, EQUAL, sizeof(EQUAL) / sizeof(double)) == 3);
+
+  const double ZERO[] = { 0.0, 0.0, 1.0 };
+  BOOST_REQUIRE(numKeptWithin(0.5, ZERO, sizeof(ZERO) / sizeof(double)) == 2);
+}
@@ -0,0 +1,129 @@
+/*
+ * MakeConvexHullTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "spipetest.h"
+
+#include <StructurePipe.h>
+
+#ifdef SP_USE_QHULL
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <pipelib/pipelib.h>
+
+// From SSLib
+#include <common/Structure.h>
+#include <common/StructureProperties.h>
+
+// From SPipe
+#include <SpTypes.h>
+#include <blocks/MakeConvexHull.h>
+#include <common/StructureData.h>
+
+namespace ssc = ::sstbx::common;
+namespace blocks = ::spipe::blocks;
+namespace structure_properties = ssc::structure_properties;
+
+class HullSink : public ::spipe::SpFinishedSink
+{
+  typedef ::spipe::SpFinishedSink::PipelineDataPtr StructureDataPtr;
+public:
+  void finished(StructureDataPtr data)
+  {
+    const double * const distance =
+      data->getStructure()->getProperty(structure_properties::searching::HULL_DISTANCE);
+    distances[data->getStructure()->getName()] = distance ? *distance : -1.0;
+  }
+
+  ::std::map< ::std::string, double> distances;
+};
+
+/** Sends Na-Cl structures with the given number of each and energy per atom. */
+class NaClSender : public ::spipe::SpStartBlock
+{
+public:
+  struct Entry
+  {
+    ::std::string name;
+    unsigned int numNa;
+    unsigned int numCl;
+    double energyPerAtom;
+  };
+
+  NaClSender(const Entry * const entries, const size_t numEntries):
+  ::spipe::SpStartBlock::BlockType("Send Na-Cl"),
+  myEntries(entries, entries + numEntries) {}
+
+  virtual void start()
+  {
+    typedef ::sstbx::UniquePtr<ssc::Structure>::Type StructurePtr;
+    typedef ::spipe::StructureDataType StructureDataType;
+    typedef ::sstbx::UniquePtr<StructureDataType>::Type StructureDataPtr;
+
+    for(size_t i = 0; i < myEntries.size(); ++i)
+    {
+      const Entry & entry = myEntries[i];
+      StructurePtr structure(new ssc::Structure());
+      structure->setName(entry.name);
+      for(unsigned int j = 0; j < entry.numNa; ++j)
+        structure->newAtom(ssc::AtomSpeciesId::NA);
+      for(unsigned int j = 0; j < entry.numCl; ++j)
+        structure->newAtom(ssc::AtomSpeciesId::CL);
+      structure->setProperty(
+        structure_properties::general::ENERGY_INTERNAL,
+        entry.energyPerAtom * static_cast<double>(entry.numNa + entry.numCl)
+      );
+
+      StructureDataPtr structureData(new StructureDataType());
+      structureData->setStructure(structure);
+      out(getRunner()->registerData(structureData));
+    }
+  }
+
+private:
+  const ::std::vector<Entry> myEntries;
+};
+
+BOOST_AUTO_TEST_CASE(MakeConvexHullTest)
+{
+  // The hull goes from Na (0) down to NaCl (-1) and back up to Cl (0).  The
+  // second NaCl is 0.5 above it and Na2Cl is 1/3 of the way from NaCl to Na
+  // so 1 - 0.2 - 1/3 = 0.4667 above.
+  const NaClSender::Entry ENTRIES[] = {
+    { "Na", 1, 0, 0.0 },
+    { "Cl", 0, 1, 0.0 },
+    { "NaCl", 1, 1, -1.0 },
+    { "NaCl-high", 2, 2, -0.5 },
+    { "Na2Cl", 2, 1, -0.2 }
+  };
+  const double DROP_ABOVE = 0.48;
+
+  ::spipe::SpPipe pipe;
+  NaClSender * const send = pipe.addBlock(new NaClSender(ENTRIES, sizeof(ENTRIES) / sizeof(NaClSender::Entry)));
+  blocks::MakeConvexHull * const hull = pipe.addBlock(new blocks::MakeConvexHull(DROP_ABOVE));
+  pipe.setStartBlock(send);
+  pipe.connect(send, hull);
+
+  HullSink sink;
+  ::spipe::SpSingleThreadedEngine engine;
+  ::spipe::SpSingleThreadedEngine::RunnerPtr runner = engine.createRunner();
+  runner->setFinishedDataSink(&sink);
+  runner->run(pipe);
+
+  BOOST_REQUIRE(sink.distances.size() == 4);
+  BOOST_REQUIRE(sink.distances.find("NaCl-high") == sink.distances.end());
+  BOOST_REQUIRE(::std::abs(sink.distances["Na"]) < 1e-10);
+  BOOST_REQUIRE(::std::abs(sink.distances["Cl"]) < 1e-10);
+  BOOST_REQUIRE(::std::abs(sink.distances["NaCl"]) < 1e-10);
+  BOOST_REQUIRE(::std::abs(sink.distances["Na2Cl"] - (0.8 - 1.0 / 3.0)) < 1e-10);
+}
+
+#endif /* SP_USE_QHULL */
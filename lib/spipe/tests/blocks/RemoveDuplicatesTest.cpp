@@ -0,0 +1,148 @@
+/*
+ * RemoveDuplicatesTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "spipetest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <pipelib/pipelib.h>
+
+// From SSLib
+#include <common/Structure.h>
+#include <common/StructureProperties.h>
+#include <common/Types.h>
+#include <common/UnitCell.h>
+#include <io/BoostFilesystem.h>
+#include <utility/SortedDistanceComparator.h>
+#include <utility/UtilityFwd.h>
+
+// From SPipe
+#include <SpTypes.h>
+#include <StructurePipe.h>
+#include <blocks/RemoveDuplicates.h>
+#include <common/CommonData.h>
+#include <common/StructureData.h>
+
+namespace fs = ::boost::filesystem;
+namespace ssc = ::sstbx::common;
+namespace ssu = ::sstbx::utility;
+namespace blocks = ::spipe::blocks;
+namespace structure_properties = ssc::structure_properties;
+
+class UniqueSink : public ::spipe::SpFinishedSink
+{
+  typedef ::spipe::SpFinishedSink::PipelineDataPtr StructureDataPtr;
+public:
+  void finished(StructureDataPtr data)
+  { names.push_back(data->getStructure()->getName()); }
+
+  ::std::vector< ::std::string> names;
+};
+
+/** Sends pairs of atoms, structures with the same separation are duplicates. */
+class PairsSender : public ::spipe::SpStartBlock
+{
+public:
+  PairsSender(const ::std::vector<double> & separations):
+  ::spipe::SpStartBlock::BlockType("Send pairs"),
+  mySeparations(separations) {}
+
+  virtual void start()
+  {
+    typedef ::sstbx::UniquePtr<ssc::Structure>::Type StructurePtr;
+    typedef ::spipe::StructureDataType StructureDataType;
+    typedef ::sstbx::UniquePtr<StructureDataType>::Type StructureDataPtr;
+
+    BOOST_FOREACH(const double separation, mySeparations)
+    {
+      StructurePtr structure(new ssc::Structure());
+      structure->setName(::boost::lexical_cast< ::std::string>(separation));
+      structure->setUnitCell(ssc::types::UnitCellPtr(new ssc::UnitCell(10.0, 10.0, 10.0, 90.0, 90.0, 90.0)));
+      structure->newAtom(ssc::AtomSpeciesId::NA).setPosition(0.0, 0.0, 0.0);
+      structure->newAtom(ssc::AtomSpeciesId::NA).setPosition(separation, 0.0, 0.0);
+
+      StructureDataPtr structureData(new StructureDataType());
+      structureData->setStructure(structure);
+      out(getRunner()->registerData(structureData));
+    }
+  }
+
+private:
+  const ::std::vector<double> mySeparations;
+};
+
+BOOST_AUTO_TEST_CASE(SpillToDiskTest)
+{
+  typedef spipe::SpSingleThreadedEngine Engine;
+  typedef Engine::RunnerPtr RunnerPtr;
+
+  // SETTINGS /////////////
+  // Write a chunk to disk every two unique structures so that the duplicates
+  // of 1 and 2 come after the originals have left memory
+  const size_t SPILL_CHUNK_SIZE = 2;
+  const double SEPARATIONS[] = { 1.0, 2.0, 3.0, 1.0, 4.0, 2.0, 5.0, 1.0 };
+
+  ::std::vector<double> separations(SEPARATIONS, SEPARATIONS + sizeof(SEPARATIONS) / sizeof(double));
+
+  spipe::SpPipe pipe;
+  PairsSender * const send = pipe.addBlock(new PairsSender(separations));
+  blocks::RemoveDuplicates * const removeDuplicates =
+    pipe.addBlock(new blocks::RemoveDuplicates(
+      ssu::IStructureComparatorPtr(new ssu::SortedDistanceComparator()), true, SPILL_CHUNK_SIZE));
+  pipe.setStartBlock(send);
+  pipe.connect(send, removeDuplicates);
+
+  UniqueSink sink;
+  Engine engine;
+  RunnerPtr runner = engine.createRunner();
+  runner->setFinishedDataSink(&sink);
+
+  // Spill to a directory of our own and ask for the unique structures with their counts
+  const ::std::string seedName = fs::unique_path().string();
+  runner->memory().global().setSeedName(seedName);
+  runner->memory().global().objectsStore[spipe::common::GlobalKeys::UNIQUE_STRUCTURES] =
+    spipe::common::SharedStructures();
+
+  runner->run(pipe);
+
+  const ::std::string expected[] = { "1", "2", "3", "4", "5" };
+  BOOST_REQUIRE(sink.names == ::std::vector< ::std::string>(expected, expected + 5));
+
+  const spipe::common::SharedStructures * const unique =
+    runner->memory().global().objectsStore.find(spipe::common::GlobalKeys::UNIQUE_STRUCTURES);
+  BOOST_REQUIRE(unique);
+  BOOST_REQUIRE(unique->size() == 5);
+
+  ::std::map< ::std::string, unsigned int> timesFound;
+  BOOST_FOREACH(const spipe::common::SharedStructures::value_type & structure, *unique)
+  {
+    const unsigned int * const found = structure->getProperty(structure_properties::searching::TIMES_FOUND);
+    BOOST_REQUIRE(found);
+    timesFound[structure->getName()] = *found;
+  }
+  BOOST_REQUIRE(timesFound["1"] == 3);
+  BOOST_REQUIRE(timesFound["2"] == 2);
+  BOOST_REQUIRE(timesFound["3"] == 1);
+  BOOST_REQUIRE(timesFound["4"] == 1);
+  BOOST_REQUIRE(timesFound["5"] == 1);
+
+  // The spill directory is named after the seed and the pipe instance
+  ::std::vector<fs::path> spillDirs;
+  for(fs::directory_iterator it(fs::current_path()), end; it != end; ++it)
+  {
+    if(it->path().filename().string().compare(0, seedName.size(), seedName) == 0)
+      spillDirs.push_back(it->path());
+  }
+  BOOST_FOREACH(const fs::path & dir, spillDirs)
+    fs::remove_all(dir);
+}
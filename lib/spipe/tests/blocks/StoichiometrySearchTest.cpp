@@ -92,11 +92,12 @@ private:
 };
 
 
-BOOST_AUTO_TEST_CASE(StoichiometrySearchTest)
+void runStoichiometrySearch(const size_t numWorkers)
 {
   typedef spipe::SpSingleThreadedEngine Engine;
   typedef Engine::RunnerPtr RunnerPtr;
   typedef ::spipe::SpPipe Pipe;
+  typedef ::sstbx::UniquePtr<Pipe>::Type PipePtr;
 
   // SETTINGS ////
   SpeciesParameters speciesParams;
@@ -104,14 +105,23 @@ BOOST_AUTO_TEST_CASE(StoichiometrySearchTest)
   speciesParams.push_back(SpeciesParameter(ssc::AtomSpeciesId::CL, 13));
 
 
-  ::sstbx::UniquePtr<Pipe>::Type searchPipe(new Pipe());
-  blocks::RandomStructure * const randomStructure = searchPipe->addBlock(new blocks::RandomStructure(1));
+  PipePtr searchPipe(new Pipe());
+  blocks::RandomStructure * randomStructure = searchPipe->addBlock(new blocks::RandomStructure(1));
   searchPipe->setStartBlock(randomStructure);
 
   Pipe stoichPipe;
   blocks::StoichiometrySearch * const stoichSearch = stoichPipe.addBlock(new blocks::StoichiometrySearch(speciesParams, 1000, 0.5, searchPipe));
   stoichPipe.setStartBlock(stoichSearch);
 
+  // Give each additional worker its own search pipe
+  for(size_t i = 1; i < numWorkers; ++i)
+  {
+    searchPipe.reset(new Pipe());
+    randomStructure = searchPipe->addBlock(new blocks::RandomStructure(1));
+    searchPipe->setStartBlock(randomStructure);
+    stoichSearch->addWorkerPipe(searchPipe);
+  }
+
   Engine engine;
   RunnerPtr runner = engine.createRunner();
 
@@ -122,3 +132,12 @@ BOOST_AUTO_TEST_CASE(StoichiometrySearchTest)
   sink.doFinishedCheck();
 }
 
+BOOST_AUTO_TEST_CASE(StoichiometrySearchTest)
+{
+  runStoichiometrySearch(1);
+}
+
+BOOST_AUTO_TEST_CASE(StoichiometrySearchConcurrentTest)
+{
+  runStoichiometrySearch(4);
+}
@@ -0,0 +1,173 @@
+/*
+ * CheckpointerTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "spipetest.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include <pipelib/pipelib.h>
+
+// From SSLib
+#include <io/BoostFilesystem.h>
+
+// From SPipe
+#include <SpTypes.h>
+#include <StructurePipe.h>
+#include <utility/Checkpointer.h>
+
+namespace fs = ::boost::filesystem;
+namespace spu = ::spipe::utility;
+
+typedef ::std::vector<int> Values;
+
+// Restoring appends to the values so that restoring twice, or from two
+// checkpoints, would show up as extra values
+bool saveValues(const Values & values, const ::std::string & dir)
+{
+  fs::ofstream file(fs::path(dir) / "values");
+  BOOST_FOREACH(const int value, values)
+    file << value << ::std::endl;
+  file << "end" << ::std::endl;
+  return file.good();
+}
+
+bool restoreValues(Values & values, const ::std::string & dir)
+{
+  fs::ifstream file(fs::path(dir) / "values");
+  ::std::string line;
+  while(::std::getline(file, line))
+  {
+    if(line == "end")
+      return true;
+    values.push_back(atoi(line.c_str()));
+  }
+  return false;
+}
+
+class CheckpointingStart : public ::spipe::SpStartBlock
+{
+public:
+  CheckpointingStart(): ::spipe::SpStartBlock::BlockType("Checkpointing start") {}
+
+  virtual void start()
+  { spu::checkpoint(*getRunner()); }
+
+  virtual bool saveState(const ::std::string & dir)
+  { return saveValues(values, dir); }
+  virtual bool restoreState(const ::std::string & dir)
+  { return restoreValues(values, dir); }
+
+  Values values;
+};
+
+class ValuesBlock : public ::spipe::SpPipeBlock
+{
+public:
+  ValuesBlock(): ::spipe::SpPipeBlock::BlockType("Values") {}
+
+  virtual void in(::spipe::StructureDataType & data)
+  { out(data); }
+
+  virtual bool saveState(const ::std::string & dir)
+  { return saveValues(values, dir); }
+  virtual bool restoreState(const ::std::string & dir)
+  { return restoreValues(values, dir); }
+
+  Values values;
+};
+
+struct CheckpointedPipe
+{
+  CheckpointedPipe()
+  {
+    start = pipe.addBlock(new CheckpointingStart());
+    values = pipe.addBlock(new ValuesBlock());
+    pipe.setStartBlock(start);
+    pipe.connect(start, values);
+  }
+
+  void run(const fs::path & dir, const bool resume)
+  {
+    ::spipe::SpSingleThreadedEngine engine;
+    ::spipe::SpSingleThreadedEngine::RunnerPtr runner = engine.createRunner();
+    // An interval of 0 means the start block always saves a checkpoint
+    spu::Checkpointer checkpointer(dir, pipe, 0.0, resume);
+    checkpointer.registerRunner(*runner);
+    runner->run(pipe);
+  }
+
+  ::spipe::SpPipe pipe;
+  CheckpointingStart * start;
+  ValuesBlock * values;
+};
+
+BOOST_AUTO_TEST_CASE(CorruptCheckpointTest)
+{
+  const fs::path dir(fs::temp_directory_path() / fs::unique_path());
+
+  // Leave the directory as if we were stopped while swapping in a new
+  // checkpoint: checkpoint.old has the first state and checkpoint the second
+  {
+    CheckpointedPipe first;
+    first.start->values.push_back(1);
+    first.start->values.push_back(2);
+    first.values->values.push_back(10);
+    first.run(dir, false);
+    fs::rename(dir / "checkpoint", dir / "first");
+
+    CheckpointedPipe second;
+    second.start->values.push_back(3);
+    second.values->values.push_back(30);
+    second.run(dir, false);
+    fs::rename(dir / "first", dir / "checkpoint.old");
+  }
+
+  // Damage the last block of the newest checkpoint, by the time it would be
+  // restored the start block would already have taken its values
+  {
+    fs::ofstream damaged(dir / "checkpoint" / "1" / "values");
+    damaged << "3";
+  }
+
+  {
+    CheckpointedPipe resumed;
+    resumed.run(dir, true);
+
+    // Everything should come from the old checkpoint and nothing from the damaged one
+    BOOST_REQUIRE(resumed.start->values.size() == 2);
+    BOOST_REQUIRE(resumed.start->values[0] == 1);
+    BOOST_REQUIRE(resumed.start->values[1] == 2);
+    BOOST_REQUIRE(resumed.values->values.size() == 1);
+    BOOST_REQUIRE(resumed.values->values[0] == 10);
+  }
+
+  // Resuming saved a new checkpoint from the restored state, damage that too
+  // so there is nothing left to resume from
+  {
+    fs::ofstream damaged(dir / "checkpoint" / "0" / "values");
+    damaged << "1";
+  }
+  if(fs::exists(dir / "checkpoint.old"))
+    fs::remove_all(dir / "checkpoint.old");
+
+  {
+    CheckpointedPipe resumed;
+    spu::Checkpointer checkpointer(dir, resumed.pipe, 0.0, true);
+    BOOST_REQUIRE(!checkpointer.hasCheckpoint());
+
+    resumed.run(dir, true);
+    BOOST_REQUIRE(resumed.start->values.empty());
+    BOOST_REQUIRE(resumed.values->values.empty());
+  }
+
+  fs::remove_all(dir);
+}
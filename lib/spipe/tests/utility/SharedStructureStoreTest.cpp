@@ -0,0 +1,107 @@
+/*
+ * SharedStructureStoreTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "spipetest.h"
+
+#include <string>
+
+#include <boost/foreach.hpp>
+
+// From SSLib
+#include <common/AtomSpeciesDatabase.h>
+#include <common/Structure.h>
+#include <io/BoostFilesystem.h>
+#include <io/IStructureReader.h>
+
+// From SPipe
+#include <utility/SharedStructureStore.h>
+
+namespace fs = ::boost::filesystem;
+namespace ssc = ::sstbx::common;
+namespace ssio = ::sstbx::io;
+namespace spu = ::spipe::utility;
+
+bool appendStructure(spu::SharedStructureStore & store, const ::std::string & name)
+{
+  ssc::Structure structure;
+  structure.setName(name);
+  structure.newAtom(ssc::AtomSpeciesId::NA);
+
+  const spu::SharedStructureStore::Lock lock(store);
+  return store.append(structure);
+}
+
+::std::string readNames(spu::SharedStructureStore & store)
+{
+  ssio::StructuresContainer structures;
+  {
+    const spu::SharedStructureStore::Lock lock(store);
+    store.readNew(structures);
+  }
+
+  ::std::string names;
+  BOOST_FOREACH(const ssc::Structure & structure, structures)
+    names += structure.getName();
+  return names;
+}
+
+BOOST_AUTO_TEST_CASE(TwoWritersTest)
+{
+  const ssc::AtomSpeciesDatabase speciesDb;
+  const fs::path storePath(fs::temp_directory_path() / fs::unique_path() / "shared.unique");
+
+  // Each store stands in for a different process sharing the file
+  spu::SharedStructureStore first(storePath, speciesDb);
+  spu::SharedStructureStore second(storePath, speciesDb);
+
+  BOOST_REQUIRE(readNames(first).empty());
+
+  // Each should only see what the other has added since it last looked
+  BOOST_REQUIRE(appendStructure(first, "a"));
+  BOOST_REQUIRE(readNames(first).empty());
+  BOOST_REQUIRE(readNames(second) == "a");
+
+  BOOST_REQUIRE(appendStructure(second, "b"));
+  BOOST_REQUIRE(readNames(second).empty());
+  BOOST_REQUIRE(readNames(first) == "b");
+
+  // Appending when the other has added something we haven't read yet mustn't
+  // skip it, we read back our own structure along with it
+  BOOST_REQUIRE(appendStructure(first, "c"));
+  BOOST_REQUIRE(appendStructure(second, "d"));
+  BOOST_REQUIRE(readNames(second) == "cd");
+  BOOST_REQUIRE(readNames(first) == "d");
+
+  // A store opened later adopts everything that is there already
+  spu::SharedStructureStore third(storePath, speciesDb);
+  BOOST_REQUIRE(readNames(third) == "abcd");
+
+  fs::remove_all(storePath.parent_path());
+}
+
+BOOST_AUTO_TEST_CASE(InterruptedWriterTest)
+{
+  const ssc::AtomSpeciesDatabase speciesDb;
+  const fs::path storePath(fs::temp_directory_path() / fs::unique_path() / "shared.unique");
+
+  spu::SharedStructureStore store(storePath, speciesDb);
+  BOOST_REQUIRE(appendStructure(store, "a"));
+
+  // A writer that died part way through a line
+  {
+    fs::ofstream storeFile(storePath, ::std::ios_base::app | ::std::ios_base::binary);
+    storeFile << "---\nname: [brok";
+  }
+
+  // The next record mustn't get swallowed by what was left behind
+  BOOST_REQUIRE(appendStructure(store, "b"));
+  spu::SharedStructureStore reader(storePath, speciesDb);
+  BOOST_REQUIRE(readNames(reader) == "ab");
+
+  fs::remove_all(storePath.parent_path());
+}
@@ -0,0 +1,153 @@
+/*
+ * SubpipeWorkersTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "spipetest.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include <pipelib/pipelib.h>
+
+// From SSLib
+#include <math/Random.h>
+#include <utility/HeterogeneousMap.h>
+
+// From SPipe
+#include <SpTypes.h>
+#include <StructurePipe.h>
+#include <common/SharedData.h>
+#include <utility/ISubpipeJobs.h>
+#include <utility/SubpipeWorkers.h>
+
+namespace ssm = ::sstbx::math;
+namespace ssu = ::sstbx::utility;
+namespace spu = ::spipe::utility;
+
+typedef ::std::vector<unsigned int> Numbers;
+
+/** Where the sub-pipe finds out which job it is doing. */
+ssu::Key<size_t> CURRENT_JOB;
+
+/** Draws a random number for the current job, or throws for one particular job. */
+class DrawNumber : public ::spipe::SpStartBlock
+{
+public:
+  DrawNumber(Numbers & numbers, const size_t throwOnJob):
+  ::spipe::SpStartBlock::BlockType("Draw number"),
+  myNumbers(numbers),
+  myThrowOnJob(throwOnJob) {}
+
+  virtual void start()
+  {
+    const size_t job = *getRunner()->memory().shared().objectsStore.find(CURRENT_JOB);
+    if(job == myThrowOnJob)
+      throw ::std::runtime_error("Job failed");
+    // Each job has its own entry so there is no need to lock
+    myNumbers[job] = ssm::randu<unsigned int>(1000000);
+  }
+
+private:
+  Numbers & myNumbers;
+  const size_t myThrowOnJob;
+};
+
+class DrawNumbersJobs : public ::spipe::SpStartBlock, public spu::ISubpipeJobs, ::boost::noncopyable
+{
+public:
+  DrawNumbersJobs(const size_t numWorkers, const size_t numJobs, const size_t throwOnJob):
+  ::spipe::SpStartBlock::BlockType("Draw numbers"),
+  numbers(numJobs, 0),
+  myNumJobs(numJobs)
+  {
+    for(size_t i = 0; i < numWorkers; ++i)
+    {
+      mySubpipes.push_back(new ::spipe::SpPipe());
+      mySubpipes.back().setStartBlock(mySubpipes.back().addBlock(new DrawNumber(numbers, throwOnJob)));
+    }
+  }
+
+  virtual void start()
+  { myWorkers.run(myNumJobs, *this); }
+
+  virtual void runnerAttached(RunnerSetupType & setup)
+  {
+    myWorkers.clear();
+    for(size_t i = 0; i < mySubpipes.size(); ++i)
+      myWorkers.addWorker(setup, mySubpipes[i]);
+  }
+
+  virtual void prepareJob(const size_t job, ::spipe::SpRunner & runner)
+  { runner.memory().shared().objectsStore[CURRENT_JOB] = job; }
+
+  virtual void jobFinished(const size_t job, FinishedData & finished)
+  { handedBack.push_back(job); }
+
+  Numbers numbers;
+  ::std::vector<size_t> handedBack;
+
+private:
+  const size_t myNumJobs;
+  ::boost::ptr_vector< ::spipe::SpPipe> mySubpipes;
+  spu::SubpipeWorkers myWorkers;
+};
+
+void runDrawNumbers(::spipe::SpPipe & pipe)
+{
+  ::spipe::SpSingleThreadedEngine engine;
+  ::spipe::SpSingleThreadedEngine::RunnerPtr runner = engine.createRunner();
+  runner->run(pipe);
+}
+
+BOOST_AUTO_TEST_CASE(ReproducibleJobsTest)
+{
+  // SETTINGS ////////////////
+  const size_t numJobs = 20;
+  const size_t noThrow = numJobs;
+
+  // The numbers for each job shouldn't depend on how the jobs are spread over the threads
+  ::spipe::SpPipe fourPipe;
+  DrawNumbersJobs * const fourWorkers = fourPipe.addBlock(new DrawNumbersJobs(4, numJobs, noThrow));
+  fourPipe.setStartBlock(fourWorkers);
+  ssm::seed(1234);
+  runDrawNumbers(fourPipe);
+
+  ::spipe::SpPipe twoPipe;
+  DrawNumbersJobs * const twoWorkers = twoPipe.addBlock(new DrawNumbersJobs(2, numJobs, noThrow));
+  twoPipe.setStartBlock(twoWorkers);
+  ssm::seed(1234);
+  runDrawNumbers(twoPipe);
+
+  BOOST_REQUIRE(fourWorkers->numbers == twoWorkers->numbers);
+
+  // and they should have been handed back in order
+  BOOST_REQUIRE(fourWorkers->handedBack.size() == numJobs);
+  for(size_t i = 0; i < numJobs; ++i)
+    BOOST_REQUIRE(fourWorkers->handedBack[i] == i);
+}
+
+BOOST_AUTO_TEST_CASE(WorkerExceptionTest)
+{
+  // SETTINGS ////////////////
+  const size_t numJobs = 20;
+  const size_t throwOnJob = 5;
+
+  ::spipe::SpPipe pipe;
+  DrawNumbersJobs * const jobs = pipe.addBlock(new DrawNumbersJobs(4, numJobs, throwOnJob));
+  pipe.setStartBlock(jobs);
+
+  // The exception should come out on this thread rather than terminating
+  BOOST_REQUIRE_THROW(runDrawNumbers(pipe), ::std::runtime_error);
+
+  // Nothing from the failed job onwards should have been handed back
+  BOOST_REQUIRE(jobs->handedBack.size() <= throwOnJob);
+  for(size_t i = 0; i < jobs->handedBack.size(); ++i)
+    BOOST_REQUIRE(jobs->handedBack[i] == i);
+}
@@ -148,6 +148,15 @@ Factory::createSearchPipe(PipePtr & pipeOut, const OptionsMap & options) const
 bool Factory::createSearchPipeExtended(PipePtr & pipeOut, const OptionsMap & options) const
 {
   const OptionsMap * const paramSweepOptions = options.find(spf::PARAM_SWEEP);
+  const OptionsMap * const stoichSearchOptions = options.find(spf::STOICHIOMETRY_SEARCH);
+  const OptionsMap * const convexHullOptions = options.find(spf::CONVEX_HULL);
+
+  // Can only do one type of sweep at a time
+  if(paramSweepOptions && stoichSearchOptions)
+    return false;
+  // The hull is across compositions so needs a stoichiometry search to feed it
+  if(convexHullOptions && !stoichSearchOptions)
+    return false;
 
   // Create a search pipe
   PipePtr searchPipe;
@@ -160,9 +169,20 @@ bool Factory::createSearchPipeExtended(PipePtr & pipeOut, const OptionsMap & opt
     // Create the param sweep pipe
     PipePtr paramSweepPipe(new sp::SpPipe());
 
+    // Each worker needs its own instance of the search pipe
+    spf::Factory::Pipes searchPipes;
+    searchPipes.push_back(searchPipe.release());
+    const int * const numWorkers = paramSweepOptions->find(spf::NUM_WORKERS);
+    for(int i = 1; numWorkers && i < *numWorkers; ++i)
+    {
+      if(!createSearchPipe(searchPipe, options))
+        return false;
+      searchPipes.push_back(searchPipe.release());
+    }
+
     spf::Factory::BlockPtr block;
     // Try creating the parameter sweep block
-    if(!mySpFactory.createParamSweepBlock(block, *paramSweepOptions, searchPipe))
+    if(!mySpFactory.createParamSweepBlock(block, *paramSweepOptions, searchPipes))
       return false;
 
     // Keep track of the last block so we can connect everything up
@@ -171,6 +191,42 @@ bool Factory::createSearchPipeExtended(PipePtr & pipeOut, const OptionsMap & opt
     
     pipeOut = paramSweepPipe;
   }
+  else if(stoichSearchOptions)
+  {
+    PipePtr stoichPipe(new sp::SpPipe());
+
+    // Each worker needs its own instance of the search pipe
+    spf::Factory::Pipes searchPipes;
+    searchPipes.push_back(searchPipe.release());
+    const int * const numWorkers = stoichSearchOptions->find(spf::NUM_WORKERS);
+    for(int i = 1; numWorkers && i < *numWorkers; ++i)
+    {
+      if(!createSearchPipe(searchPipe, options))
+        return false;
+      searchPipes.push_back(searchPipe.release());
+    }
+
+    spf::Factory::BlockPtr block;
+    if(!mySpFactory.createStoichiometrySearchBlock(block, *stoichSearchOptions, searchPipes))
+      return false;
+
+    sp::SpBlock * lastBlock = stoichPipe->addBlock(block.release());
+    stoichPipe->setStartBlock(lastBlock->asStartBlock());
+
+    if(convexHullOptions)
+    {
+      if(!mySpFactory.createConvexHullBlock(block, *convexHullOptions))
+        return false;
+      lastBlock = addAndConnect(*stoichPipe, lastBlock, block.release());
+
+      // Save the structures that made it with their distance above the hull
+      const OptionsMap * const outputOptions = options.find(spf::WRITE_STRUCTURES);
+      if(outputOptions)
+        lastBlock = addWriteStructuresBlock(*stoichPipe, lastBlock, *outputOptions, false);
+    }
+
+    pipeOut = stoichPipe;
+  }
   else
     pipeOut = searchPipe; // Only doing search, so search pipe is the 'main' pipe
 
@@ -201,12 +257,15 @@ bool Factory::createGeomOptimiseBlock(
     optimisationSettings.pressure.reset(pressureMtx);
   }
 
+  const int * const numWorkers = geomOptimiseOptions.find(spf::NUM_WORKERS);
+
   return mySpFactory.createPotentialGeomOptimiseBlock(
     blockOut,
     *optimiserOptions,
     potentialOptions,
     &optimisationSettings,
-    globalOptions
+    globalOptions,
+    numWorkers ? *numWorkers : 1
   ); 
 }
 
@@ -75,6 +75,16 @@ struct Search : public ::sstbx::yaml_schema::SchemaHeteroMap
       spf::PARAM_SWEEP,
       new spf::blocks::ParamSweep()
     );
+    addEntry(
+      "stoichiometrySearch",
+      spf::STOICHIOMETRY_SEARCH,
+      new spf::blocks::StoichiometrySearch()
+    );
+    addEntry(
+      "convexHull",
+      spf::CONVEX_HULL,
+      new spf::blocks::ConvexHull()
+    );
     addEntry(
       "randomStructures",
       spf::RANDOM_STRUCTURE,
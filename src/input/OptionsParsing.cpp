@@ -56,7 +56,9 @@ bool insertScalarValues(YAML::Node & node, const ::std::vector< ::std::string> &
   return true;
 }
 
-void seedRandomNumberGenerator(const ::sstbx::utility::HeterogeneousMap & options)
+void seedRandomNumberGenerator(
+  const ::sstbx::utility::HeterogeneousMap & options,
+  const unsigned int stream)
 {
   namespace spf = ::spipe::factory;
   namespace ssm = ::sstbx::math;
@@ -68,14 +70,17 @@ void seedRandomNumberGenerator(const ::sstbx::utility::HeterogeneousMap & option
     // Is it an integer?
     try
     {
-      ssm::seed(::boost::lexical_cast<unsigned int>(*rngSeed));
+      // Spread the streams out (by the golden ratio) so they don't overlap
+      ssm::seed(::boost::lexical_cast<unsigned int>(*rngSeed) + stream * 2654435761u);
       userSuppliedSeed = true;
     }
     catch(const ::boost::bad_lexical_cast & /*e*/)
     {}
   }
   if(!userSuppliedSeed)
-    ssm::seed(static_cast<unsigned int>(time(NULL)) * static_cast<unsigned int>(::sstbx::os::getProcessId()));
+    ssm::seed(
+      static_cast<unsigned int>(time(NULL)) * static_cast<unsigned int>(::sstbx::os::getProcessId()) +
+      stream * 2654435761u);
 }
 
 } // namespace stools
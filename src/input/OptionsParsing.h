@@ -31,7 +31,14 @@ namespace input {
 int parseYaml(YAML::Node & nodeOut, const ::std::string & inputFile);
 bool insertScalarValues(YAML::Node & node, const ::std::vector< ::std::string> & scalarValues);
 
-void seedRandomNumberGenerator(const ::sstbx::utility::HeterogeneousMap & schemaOptions);
+/**
+/* Seed from the options, or the time and process if there is no seed.  Processes
+/* that should each get their own sequence of random numbers from the same seed
+/* (e.g. shards of a search) pass a different stream.
+/**/
+void seedRandomNumberGenerator(
+  const ::sstbx::utility::HeterogeneousMap & schemaOptions,
+  const unsigned int stream = 0);
 
 }
 }
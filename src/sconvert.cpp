@@ -8,11 +8,18 @@
 // INCLUDES //////////////////////////////////
 #include "STools.h"
 
+#include <boost/filesystem.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 // From SSTbx
 #include <common/AtomSpeciesDatabase.h>
 #include <common/Structure.h>
+#include <io/BoostFilesystem.h>
+#include <io/ResourceLocator.h>
+#include <io/SslibReaderWriter.h>
 #include <io/StructureReadWriteManager.h>
 
 // From StructurePipe
@@ -20,6 +27,8 @@
 
 // Local //
 #include "utility/BoostCapabilities.h"
+#include "utility/OutputNames.h"
+#include "utility/ParallelJobs.h"
 
 // MACROS ////////////////////////////////////
 
@@ -30,12 +39,61 @@ namespace sp    = ::spipe;
 namespace ssc   = ::sstbx::common;
 namespace ssio  = ::sstbx::io;
 namespace ssu   = ::sstbx::utility;
+namespace stu   = ::stools::utility;
 
 typedef ::std::vector< ::std::string> StringsVector;
 
 struct InputOptions
 {
   StringsVector inputOutputFiles;
+  ::std::string outputFormat;
+  size_t numJobs;
+};
+
+class ConversionJobs : public stu::IParallelJobs
+{
+public:
+  ConversionJobs(const InputOptions & in, const size_t numWorkers);
+
+  /** Is there a reader for the type of file at the given path. */
+  bool canRead(const fs::path & path) const;
+
+  /**
+  /* Convert the input to output + extension.  If nameByIndex is true and there is
+  /* more than one structure in the input then each goes to output-i + extension.
+  /**/
+  void addJob(
+    const fs::path & input,
+    const fs::path & output,
+    const ::std::string & extension,
+    const bool nameByIndex);
+  size_t numJobs() const;
+
+  virtual bool runJob(
+    const size_t job,
+    const size_t worker,
+    ::std::ostream & out,
+    ::std::ostream & err);
+
+private:
+  struct Job
+  {
+    fs::path input;
+    fs::path output;
+    ::std::string extension;
+    bool nameByIndex;
+  };
+
+  bool writeStructure(
+    ssc::Structure & structure,
+    const ::std::string & path,
+    const ssio::StructureReadWriteManager & rwMan) const;
+
+  const InputOptions & myIn;
+  const ssc::AtomSpeciesDatabase mySpeciesDb;
+  // The readers and writers aren't guaranteed to be thread safe so give each worker its own
+  ::boost::ptr_vector<ssio::StructureReadWriteManager> myRwMans;
+  ::std::vector<Job> myJobs;
 };
 
 int processCommandLineArgs(InputOptions & in, const int argc, char * argv[]);
@@ -52,32 +110,77 @@ int main(const int argc, char * argv[])
   if(result != 0)
     return result;
 
-  ssio::ResourceLocator fileIn, fileOut;
-  if(!fileIn.set(in.inputOutputFiles[0]))
-    ::std::cerr << "Input file not valid" << ::std::endl;
-  if(!fileOut.set(in.inputOutputFiles[1]))
-    ::std::cerr << "Output file not valid" << ::std::endl;
+  if(in.inputOutputFiles.size() < 2)
+  {
+    ::std::cerr << "Must supply at least one input and an output" << ::std::endl;
+    return 1;
+  }
 
-  ssc::AtomSpeciesDatabase speciesDb;
+  const fs::path outputPath(in.inputOutputFiles.back());
+  const StringsVector inputs(in.inputOutputFiles.begin(), in.inputOutputFiles.end() - 1);
 
-  ssio::StructureReadWriteManager rwMan;
-  sp::utility::initStructureRwManDefault(rwMan);
+  const size_t numThreads = stu::getNumThreads(in.numJobs);
+  ConversionJobs jobs(in, numThreads);
+  size_t numSkipped = 0;
 
-  ssio::StructuresContainer structures;
-  if(rwMan.readStructures(structures, fileIn, speciesDb) == 0)
+  if(inputs.size() == 1 && !fs::is_directory(inputs.front()) && !fs::is_directory(outputPath))
   {
-    ::std::cerr << "Failed to ready any structures." << ::std::endl;
-    return 1;
+    // Simple file to file conversion
+    jobs.addJob(inputs.front(), outputPath, "", false);
   }
-
-  BOOST_FOREACH(ssc::Structure & structure, structures)
+  else
   {
-    if(!rwMan.writeStructure(structure, fileOut, speciesDb))
+    // Directory mode: each input file goes to a file of the same name in the output directory
+    if(!fs::exists(outputPath))
+      fs::create_directories(outputPath);
+    else if(!fs::is_directory(outputPath))
+    {
+      ::std::cerr << "Output " << outputPath << " must be a directory when converting multiple inputs" << ::std::endl;
+      return 1;
+    }
+
+    ::std::vector<fs::path> inputFiles;
+    BOOST_FOREACH(const ::std::string & input, inputs)
+    {
+      const fs::path inputPath(input);
+      if(fs::is_directory(inputPath))
+      {
+        for(fs::directory_iterator it(inputPath), end; it != end; ++it)
+        {
+          if(fs::is_regular_file(it->path()) && jobs.canRead(it->path()))
+            inputFiles.push_back(it->path());
+        }
+      }
+      else if(!fs::exists(inputPath))
+      {
+        ::std::cerr << "File " << input << " does not exist.  Skipping." << ::std::endl;
+        ++numSkipped;
+      }
+      else
+        inputFiles.push_back(inputPath);
+    }
+
+    // Always give the outputs an extension, the stem of an input could have a
+    // dot in it that would otherwise be taken as the format
+    const ::std::string extension =
+      "." + (in.outputFormat.empty() ? ssio::SslibReaderWriter::DEFAULT_EXTENSION : in.outputFormat);
+    const StringsVector outputNames = stu::getOutputNames(inputFiles);
+    for(size_t i = 0; i < inputFiles.size(); ++i)
     {
-      ::std::cerr << "Failed to write structure to " << fileOut << ::std::endl;
+      if(outputNames[i].empty())
+      {
+        ::std::cerr << "Output for " << inputFiles[i] << " would overwrite another.  Skipping." << ::std::endl;
+        ++numSkipped;
+      }
+      else
+        jobs.addJob(inputFiles[i], outputPath / outputNames[i], extension, true);
     }
   }
 
+  const size_t numFailed = stu::runJobsInOrder(jobs.numJobs(), jobs, numThreads);
+  if(numSkipped != 0 || numFailed != 0)
+    return 1;
+
   return 0;
 }
 
@@ -85,17 +188,21 @@ int processCommandLineArgs(InputOptions & in, const int argc, char * argv[])
 {
   const ::std::string exeName(argv[0]);
 
-  in.inputOutputFiles.resize(2);
   try
   {
-    po::options_description general("sconvert\nUsage: " + exeName + " [input-options] inpue-file(s) [output-options] output-file(s)\nOptions");
+    po::options_description general(
+      "sconvert\nUsage: " + exeName + " [options] input-file output-file\n"
+      "       " + exeName + " [options] input-files/dirs... output-dir\nOptions");
     general.add_options()
       ("help", "Show help message")
-      ("input,i", po::value<StringsVector>(&in.inputOutputFiles)_ADD_REQUIRED_, "Input and output filenames")
+      ("input,i", po::value<StringsVector>(&in.inputOutputFiles)_ADD_REQUIRED_, "Input filename(s) or directories followed by the output filename or directory")
+      ("format,f", po::value< ::std::string>(&in.outputFormat), "Output format extension, e.g. res.  Defaults to the output file extension or the sslib format.  "
+        "Outputs in a directory are named after their inputs, keeping the input extension as well if two share a name.")
+      ("jobs,j", po::value<size_t>(&in.numJobs)->default_value(1), "Number of files to convert in parallel, 0 uses all cores")
     ;
 
     po::positional_options_description p;
-    p.add("input", 2);
+    p.add("input", -1);
 
     po::options_description cmdLineOptions;
     cmdLineOptions.add(general);
@@ -121,4 +228,105 @@ int processCommandLineArgs(InputOptions & in, const int argc, char * argv[])
   return 0;
 }
 
+ConversionJobs::ConversionJobs(const InputOptions & in, const size_t numWorkers):
+myIn(in)
+{
+  for(size_t i = 0; i < numWorkers; ++i)
+  {
+    myRwMans.push_back(new ssio::StructureReadWriteManager());
+    sp::utility::initStructureRwManDefault(myRwMans.back());
+  }
+}
+
+bool ConversionJobs::canRead(const fs::path & path) const
+{
+  ::std::string ext = path.extension().string();
+  if(ext.empty())
+    return false;
+  ext.erase(0, 1); // Erase the dot
+
+  const ssio::StructureReadWriteManager & rwMan = myRwMans.front();
+  for(ssio::StructureReadWriteManager::ReadersConstIterator it = rwMan.beginReaders(),
+    end = rwMan.endReaders(); it != end; ++it)
+  {
+    if(it->first == ext)
+      return true;
+  }
+  return false;
+}
+
+void ConversionJobs::addJob(
+  const fs::path & input,
+  const fs::path & output,
+  const ::std::string & extension,
+  const bool nameByIndex)
+{
+  Job job;
+  job.input = input;
+  job.output = output;
+  job.extension = extension;
+  job.nameByIndex = nameByIndex;
+  myJobs.push_back(job);
+}
+
+size_t ConversionJobs::numJobs() const
+{
+  return myJobs.size();
+}
+
+bool ConversionJobs::runJob(
+  const size_t jobIdx,
+  const size_t worker,
+  ::std::ostream & out,
+  ::std::ostream & err)
+{
+  const Job & job = myJobs[jobIdx];
+  const ssio::StructureReadWriteManager & rwMan = myRwMans[worker];
+
+  ssio::ResourceLocator fileIn;
+  if(!fileIn.set(job.input.string()))
+  {
+    err << "Input file " << job.input << " not valid" << ::std::endl;
+    return false;
+  }
+
+  ssio::StructuresContainer structures;
+  if(rwMan.readStructures(structures, fileIn, mySpeciesDb) == 0)
+  {
+    err << "Failed to read any structures from " << job.input << ::std::endl;
+    return false;
+  }
+
+  bool allWritten = true;
+  const bool multipleOutputs = job.nameByIndex && structures.size() > 1;
+  for(size_t i = 0; i < structures.size(); ++i)
+  {
+    ::std::string outputPath = job.output.string();
+    // Keep structures from the same input apart by appending their index
+    if(multipleOutputs)
+      outputPath += "-" + ::boost::lexical_cast< ::std::string>(i);
+    outputPath += job.extension;
 
+    if(!writeStructure(structures[i], outputPath, rwMan))
+    {
+      err << "Failed to write structure to " << outputPath << ::std::endl;
+      allWritten = false;
+    }
+  }
+  return allWritten;
+}
+
+bool ConversionJobs::writeStructure(
+  ssc::Structure & structure,
+  const ::std::string & path,
+  const ssio::StructureReadWriteManager & rwMan) const
+{
+  ssio::ResourceLocator fileOut;
+  if(!fileOut.set(path))
+    return false;
+
+  if(myIn.outputFormat.empty())
+    return rwMan.writeStructure(structure, fileOut, mySpeciesDb);
+  else
+    return rwMan.writeStructure(structure, fileOut, mySpeciesDb, myIn.outputFormat);
+}
@@ -13,6 +13,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 #include <boost/program_options.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 // From Pipelib //
 
@@ -29,6 +30,7 @@
 #include <utility/PipeDataInitialisation.h>
 
 // My includes //
+#include "utility/ParallelJobs.h"
 
 // NAMESPACES ////////////////////////////////
 namespace fs = ::boost::filesystem;
@@ -37,12 +39,32 @@ namespace sp = ::spipe;
 namespace ssc = ::sstbx::common;
 namespace ssio = ::sstbx::io;
 namespace ssa = ::sstbx::analysis;
+namespace stu = ::stools::utility;
 
 struct InputOptions
 {
   double precision;
   ::std::vector< ::std::string> inputFiles;
   bool printSgNumber;
+  size_t numJobs;
+};
+
+class SpacegroupJobs : public stu::IParallelJobs
+{
+public:
+  SpacegroupJobs(const InputOptions & in, const size_t numWorkers);
+
+  virtual bool runJob(
+    const size_t job,
+    const size_t worker,
+    ::std::ostream & out,
+    ::std::ostream & err);
+
+private:
+  const InputOptions & myIn;
+  const ssc::AtomSpeciesDatabase mySpeciesDb;
+  // The readers aren't guaranteed to be thread safe so give each worker its own
+  ::boost::ptr_vector<ssio::StructureReadWriteManager> myRwMans;
 };
 
 int main(const int argc, char * argv[])
@@ -60,6 +82,7 @@ int main(const int argc, char * argv[])
       ("prec,p", po::value<double>(&in.precision)->default_value(ssa::space_group::DEFAULT_PRECISION), "Set space group identifier precision")
       ("input-file", po::value< ::std::vector< ::std::string> >(&in.inputFiles), "input file(s)")
       ("num,n", po::value<bool>(&in.printSgNumber)->default_value(false)->zero_tokens(), "print space group number")
+      ("jobs,j", po::value<size_t>(&in.numJobs)->default_value(1), "number of files to process in parallel, 0 uses all cores")
     ;
 
     po::positional_options_description p;
@@ -83,42 +106,67 @@ int main(const int argc, char * argv[])
     return 1;
   }
 
-  ssio::StructureReadWriteManager rwMan;
-  sp::utility::initStructureRwManDefault(rwMan);
+  const size_t numThreads = stu::getNumThreads(in.numJobs);
+  SpacegroupJobs jobs(in, numThreads);
+  if(stu::runJobsInOrder(in.inputFiles.size(), jobs, numThreads) != 0)
+    return 1;
+
+  return 0;
+}
+
+SpacegroupJobs::SpacegroupJobs(const InputOptions & in, const size_t numWorkers):
+myIn(in)
+{
+  for(size_t i = 0; i < numWorkers; ++i)
+  {
+    myRwMans.push_back(new ssio::StructureReadWriteManager());
+    sp::utility::initStructureRwManDefault(myRwMans.back());
+  }
+}
+
+bool SpacegroupJobs::runJob(
+  const size_t job,
+  const size_t worker,
+  ::std::ostream & out,
+  ::std::ostream & err)
+{
+  const ::std::string & inputFile = myIn.inputFiles[job];
 
-  ssc::AtomSpeciesDatabase speciesDb;
-  ssio::StructuresContainer loadedStructures;
   ssio::ResourceLocator structureLocator;
-  ssa::space_group::SpacegroupInfo sgInfo;
+  if(!structureLocator.set(inputFile))
+  {
+    err << "Invalid structure path " << inputFile << ". Skipping." << ::std::endl;
+    return false;
+  }
+  if(!fs::exists(structureLocator.path()))
+  {
+    err << "File " << inputFile << " does not exist.  Skipping." << ::std::endl;
+    return false;
+  }
 
-  BOOST_FOREACH(const ::std::string & inputFile, in.inputFiles)
+  ssio::StructuresContainer loadedStructures;
+  if(myRwMans[worker].readStructures(loadedStructures, structureLocator, mySpeciesDb) == 0)
   {
-    if(!structureLocator.set(inputFile))
-    {
-      ::std::cerr << "Invalid structure path " << inputFile << ". Skipping." << ::std::endl;
-      continue;
-    }
-    if(!fs::exists(structureLocator.path()))
+    err << "Failed to read any structures from " << inputFile << ::std::endl;
+    return false;
+  }
+
+  bool allFound = true;
+  ssa::space_group::SpacegroupInfo sgInfo;
+  BOOST_FOREACH(const ssc::Structure & structure, loadedStructures)
+  {
+    if(ssa::space_group::getSpacegroupInfo(sgInfo, structure, myIn.precision))
     {
-      ::std::cerr << "File " << inputFile << " does not exist.  Skipping." << ::std::endl;
-      continue;
+      if(myIn.printSgNumber)
+        out << sgInfo.number << ::std::endl;
+      else
+        out << sgInfo.iucSymbol << ::std::endl;
     }
-
-    if(rwMan.readStructures(loadedStructures, structureLocator, speciesDb) > 0)
+    else
     {
-      BOOST_FOREACH(const ssc::Structure & structure, loadedStructures)
-      {
-        if(ssa::space_group::getSpacegroupInfo(sgInfo, structure, in.precision))
-        {
-          if(in.printSgNumber)
-            ::std::cout << sgInfo.number << ::std::endl;
-          else
-            ::std::cout << sgInfo.iucSymbol << ::std::endl;
-        }
-      }
-      loadedStructures.clear();
+      err << "Failed to find the space group of " << structure.getName() << " in " << inputFile << ::std::endl;
+      allFound = false;
     }
   }
-
-
+  return allFound;
 }
@@ -9,9 +9,11 @@
 #include "STools.h"
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
 #include <boost/program_options.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include <yaml-cpp/yaml.h>
 
@@ -22,10 +24,13 @@
 #include <pipelib/pipelib.h>
 
 // From StructurePipe
+#include <common/CommonData.h>
 #include <factory/StFactory.h>
 
 // Local
+#include "utility/Checkpointer.h"
 #include "utility/PipeDataInitialisation.h"
+#include "utility/ProfileReport.h"
 #include "input/OptionsParsing.h"
 #include "factory/YamlSchema.h"
 
@@ -45,6 +50,15 @@ struct InputOptions
 {
   ::std::string inputOptionsFile;
   ::std::vector< ::std::string> additionalOptions;
+  unsigned int maxQueueSize;
+  unsigned int maxBatchSize;
+  bool profile;
+  double profileInterval;
+  ::std::string checkpointDir;
+  double checkpointInterval;
+  ::std::string resumeDir;
+  ::std::string shard;
+  ::std::string shardStore;
 };
 
 // CONSTANTS /////////////////////////////////
@@ -88,12 +102,45 @@ int main(const int argc, char * argv[])
     parse.printErrors();
     return 1;
   }
-  ::stools::input::seedRandomNumberGenerator(schemaOptions);
+
+  const ::std::string seedName(::sstbx::io::stemString(in.inputOptionsFile));
+
+  sp::common::Shard shard;
+  if(!in.shard.empty())
+  {
+    if(!shard.fromString(in.shard))
+    {
+      ::std::cerr << "Invalid shard " << in.shard << ", expected i/N with 0 <= i < N" << ::std::endl;
+      return 1;
+    }
+    shard.uniqueStore = in.shardStore.empty() ? fs::path(seedName + ".unique") : fs::path(in.shardStore);
+  }
+  // Each shard gets its own stream of random numbers
+  ::stools::input::seedRandomNumberGenerator(schemaOptions, static_cast<unsigned int>(shard.index));
 
   // Create the pipe the run the search
   Engine pipeEngine;
+  if(in.maxQueueSize != 0)
+  {
+    pipeEngine.setDispatchMode(::pipelib::DispatchMode::QUEUED);
+    pipeEngine.setMaxQueueSize(in.maxQueueSize);
+    pipeEngine.setMaxBatchSize(in.maxBatchSize);
+  }
+  pipeEngine.setProfiling(in.profile);
+  pipeEngine.setProfileReportInterval(in.profileInterval);
+
+  // Must outlive the runner as it listens for the runner being destroyed
+  ::boost::scoped_ptr<spu::ProfileReport> profileReport;
+  if(in.profile)
+    profileReport.reset(new spu::ProfileReport(seedName + ".profile"));
+  ::boost::scoped_ptr<spu::Checkpointer> checkpointer;
+
   RunnerPtr runner = spu::generateRunnerInitDefault(pipeEngine);
-  runner->memory().global().setSeedName(::sstbx::io::stemString(in.inputOptionsFile));
+  runner->memory().global().setSeedName(seedName);
+  if(!in.shard.empty())
+    runner->memory().global().objectsStore[sp::common::GlobalKeys::SHARD] = shard;
+  if(profileReport)
+    runner->addListener(*profileReport);
 
   ::stools::factory::Factory factory(runner->memory().global().getSpeciesDatabase());
 
@@ -104,7 +151,30 @@ int main(const int argc, char * argv[])
     return 1;
   }
 
-  runner->run(*pipe);
+  if(!in.resumeDir.empty())
+  {
+    // Carry on checkpointing to the same place
+    checkpointer.reset(new spu::Checkpointer(in.resumeDir, *pipe, in.checkpointInterval, true));
+    if(!checkpointer->hasCheckpoint())
+    {
+      ::std::cerr << "No checkpoint to resume from in " << in.resumeDir << ::std::endl;
+      return 1;
+    }
+  }
+  else if(!in.checkpointDir.empty())
+    checkpointer.reset(new spu::Checkpointer(in.checkpointDir, *pipe, in.checkpointInterval));
+  if(checkpointer)
+    checkpointer->registerRunner(*runner);
+
+  try
+  {
+    runner->run(*pipe);
+  }
+  catch(const ::std::runtime_error & e)
+  {
+    ::std::cerr << e.what() << ::std::endl;
+    return 1;
+  }
 
   return 0;
 }
@@ -123,6 +193,24 @@ int processCommandLineArgs(InputOptions & in, const int argc, char * argv[])
       ("input,i", po::value< ::std::string>(&in.inputOptionsFile), "The input options file")
       ("define,D", po::value< ::std::vector< ::std::string> >(&in.additionalOptions)->composing(),
       "Define program options on the command line as if they had been included in the input file")
+      ("queue-size", po::value<unsigned int>(&in.maxQueueSize)->default_value(0),
+      "Pass structures between blocks using a work queue of this size rather than directly, 0 to disable")
+      ("batch-size", po::value<unsigned int>(&in.maxBatchSize)->default_value(1),
+      "When using a work queue hand up to this many structures at once to blocks that support it")
+      ("profile", po::bool_switch(&in.profile), "Write the time spent in, and structures passed through, each block to [seed].profile")
+      ("profile-interval", po::value<double>(&in.profileInterval)->default_value(60.0),
+      "How often (in seconds) to update the profile during the search, 0 to only write it at the end")
+      ("checkpoint", po::value< ::std::string>(&in.checkpointDir),
+      "Periodically save the state of the search to this directory so it can be resumed")
+      ("checkpoint-interval", po::value<double>(&in.checkpointInterval)->default_value(spu::Checkpointer::DEFAULT_INTERVAL),
+      "How often (in seconds) to save the state of the search")
+      ("resume", po::value< ::std::string>(&in.resumeDir),
+      "Carry on the search from the checkpoint in this directory, the input must be the same as the original search")
+      ("shard", po::value< ::std::string>(&in.shard),
+      "Run as shard i/N of a search split between N processes, each generates every N'th structure.  "
+      "The times each unique structure was found only counts those found by the shard that found it first")
+      ("shard-store", po::value< ::std::string>(&in.shardStore),
+      "The file the shards share to agree on unique structures, defaults to [seed].unique")
     ;
 
     po::positional_options_description p;
@@ -0,0 +1,55 @@
+/*
+ * OutputNames.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "utility/OutputNames.h"
+
+#include <map>
+#include <set>
+
+// From SSTbx
+#include <io/BoostFilesystem.h>
+
+// NAMESPACES ////////////////////////////////
+
+namespace stools {
+namespace utility {
+
+namespace fs = ::boost::filesystem;
+namespace ssio = ::sstbx::io;
+
+::std::vector< ::std::string>
+getOutputNames(const ::std::vector<fs::path> & inputs)
+{
+  ::std::vector< ::std::string> names;
+  ::std::map< ::std::string, size_t> stemCounts;
+  for(size_t i = 0; i < inputs.size(); ++i)
+  {
+    names.push_back(ssio::stemString(inputs[i]));
+    ++stemCounts[names.back()];
+  }
+
+  ::std::set< ::std::string> used;
+  for(size_t i = 0; i < inputs.size(); ++i)
+  {
+    ::std::string & name = names[i];
+    if(stemCounts[name] > 1)
+    {
+      ::std::string extension = inputs[i].extension().string();
+      if(!extension.empty())
+        name += "-" + extension.erase(0, 1); // Drop the dot
+    }
+
+    if(!used.insert(name).second)
+      name.clear();
+  }
+
+  return names;
+}
+
+}
+}
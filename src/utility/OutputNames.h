@@ -0,0 +1,38 @@
+/*
+ * OutputNames.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef OUTPUT_NAMES_H
+#define OUTPUT_NAMES_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+// FORWARD DECLARES ////////////////////////////////
+
+
+namespace stools {
+namespace utility {
+
+/**
+/* Get the names of the outputs for inputs that are all going to the same
+/* directory.  Each is the stem of its input unless another input has the same
+/* stem, e.g. a.res and a.cell, in which case the extension is kept as well
+/* giving a-res and a-cell.  Any input that would still overwrite an earlier
+/* one, e.g. the same filename from two directories, gets an empty name.
+/**/
+::std::vector< ::std::string>
+getOutputNames(const ::std::vector< ::boost::filesystem::path> & inputs);
+
+}
+}
+
+
+#endif /* OUTPUT_NAMES_H */
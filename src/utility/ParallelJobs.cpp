@@ -0,0 +1,129 @@
+/*
+ * ParallelJobs.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "utility/ParallelJobs.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+// NAMESPACES ////////////////////////////////
+
+namespace stools {
+namespace utility {
+
+namespace {
+
+struct Progress
+{
+  Progress(const size_t numJobs_):
+    numJobs(numJobs_), nextJob(0), numFailed(0), done(numJobs_, false), out(numJobs_), err(numJobs_)
+  {}
+
+  const size_t numJobs;
+  size_t nextJob;
+  size_t numFailed;
+  ::std::vector<bool> done;
+  ::std::vector< ::std::string> out;
+  ::std::vector< ::std::string> err;
+  ::boost::mutex mutex;
+  ::boost::condition_variable jobDone;
+};
+
+void doJobs(IParallelJobs & jobs, const size_t worker, Progress & progress)
+{
+  size_t job;
+  while(true)
+  {
+    {
+      ::boost::lock_guard< ::boost::mutex> lock(progress.mutex);
+      if(progress.nextJob == progress.numJobs)
+        return;
+      job = progress.nextJob++;
+    }
+
+    ::std::ostringstream out, err;
+    const bool succeeded = jobs.runJob(job, worker, out, err);
+
+    {
+      ::boost::lock_guard< ::boost::mutex> lock(progress.mutex);
+      if(!succeeded)
+        ++progress.numFailed;
+      progress.out[job] = out.str();
+      progress.err[job] = err.str();
+      progress.done[job] = true;
+    }
+    progress.jobDone.notify_one();
+  }
+}
+
+}
+
+size_t getNumThreads(const size_t requested)
+{
+  if(requested != 0)
+    return requested;
+
+  const size_t numCores = ::boost::thread::hardware_concurrency();
+  return numCores == 0 ? 1 : numCores;
+}
+
+size_t runJobsInOrder(
+  const size_t numJobs,
+  IParallelJobs & jobs,
+  const size_t numThreads,
+  ::std::ostream & out,
+  ::std::ostream & err)
+{
+  const size_t numWorkers = ::std::min(numThreads, numJobs);
+  if(numWorkers < 2)
+  {
+    size_t numFailed = 0;
+    for(size_t job = 0; job < numJobs; ++job)
+    {
+      if(!jobs.runJob(job, 0, out, err))
+        ++numFailed;
+    }
+    return numFailed;
+  }
+
+  Progress progress(numJobs);
+
+  ::boost::thread_group threads;
+  for(size_t i = 0; i < numWorkers; ++i)
+    threads.create_thread(::boost::bind(&doJobs, ::boost::ref(jobs), i, ::boost::ref(progress)));
+
+  // Print the output in order as it becomes available
+  for(size_t job = 0; job < numJobs; ++job)
+  {
+    ::std::string jobOut, jobErr;
+    {
+      ::boost::unique_lock< ::boost::mutex> lock(progress.mutex);
+      while(!progress.done[job])
+        progress.jobDone.wait(lock);
+      jobOut.swap(progress.out[job]);
+      jobErr.swap(progress.err[job]);
+    }
+    err << jobErr;
+    out << jobOut << ::std::flush;
+  }
+
+  threads.join_all();
+
+  return progress.numFailed;
+}
+
+}
+}
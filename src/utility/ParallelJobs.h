@@ -0,0 +1,59 @@
+/*
+ * ParallelJobs.h
+ *
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PARALLEL_JOBS_H
+#define PARALLEL_JOBS_H
+
+// INCLUDES /////////////////////////////////////////////
+#include <cstddef>
+#include <iostream>
+
+// FORWARD DECLARES ////////////////////////////////
+
+
+namespace stools {
+namespace utility {
+
+class IParallelJobs
+{
+public:
+  virtual ~IParallelJobs() {}
+
+  /**
+  /* Run the given job.  Anything that should be printed goes to out and err
+  /* which are flushed to the real streams in job order.  The worker index is
+  /* unique to the thread running the job so it can be used to pick state that
+  /* mustn't be shared between threads.  Returns false if the job failed.
+  /**/
+  virtual bool runJob(
+    const size_t job,
+    const size_t worker,
+    ::std::ostream & out,
+    ::std::ostream & err) = 0;
+};
+
+/** The number of threads to use for the requested number of jobs, 0 means one per core. */
+size_t getNumThreads(const size_t requested);
+
+/**
+/* Run the jobs on up to numThreads threads printing the output of each job
+/* in order as soon as it, and all those before it, have finished.  Returns
+/* the number of jobs that failed.
+/**/
+size_t runJobsInOrder(
+  const size_t numJobs,
+  IParallelJobs & jobs,
+  const size_t numThreads,
+  ::std::ostream & out = ::std::cout,
+  ::std::ostream & err = ::std::cerr);
+
+}
+}
+
+
+#endif /* PARALLEL_JOBS_H */
@@ -0,0 +1,72 @@
+/*
+ * StFactoryTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "stoolstest.h"
+
+#include <yaml-cpp/yaml.h>
+
+// From SSTbx
+#include <common/AtomSpeciesDatabase.h>
+#include <utility/HeterogeneousMap.h>
+#include <yaml_schema/SchemaParse.h>
+
+// From SPipe
+#include <StructurePipe.h>
+#include <factory/MapEntries.h>
+
+// Local //
+#include "factory/StFactory.h"
+// StructurePipe has a factory/YamlSchema.h of its own so be explicit
+#include "../../src/factory/YamlSchema.h"
+
+namespace ssc = ::sstbx::common;
+namespace ssu = ::sstbx::utility;
+namespace ssys = ::sstbx::yaml_schema;
+namespace spf = ::spipe::factory;
+namespace stf = ::stools::factory;
+
+BOOST_AUTO_TEST_CASE(ConvexHullSearchTest)
+{
+  const YAML::Node searchNode = YAML::Load(
+    "stoichiometrySearch:\n"
+    "  species: [Na 2, Cl 2]\n"
+    "  maxAtoms: 4\n"
+    "convexHull:\n"
+    "  dropAbove: 0.1\n"
+    "randomStructures:\n"
+    "  num: 1\n"
+  );
+
+  // The search schema should take the convex hull options
+  ssys::SchemaParse parse;
+  stf::Search searchSchema;
+  ssu::HeterogeneousMap options;
+  searchSchema.nodeToValue(parse, options, searchNode, true);
+  BOOST_REQUIRE(!parse.hasErrors());
+
+  const ssu::HeterogeneousMap * const convexHullOptions = options.find(spf::CONVEX_HULL);
+  BOOST_REQUIRE(convexHullOptions);
+  const double * const dropAbove = convexHullOptions->find(spf::DROP_ABOVE);
+  BOOST_REQUIRE(dropAbove);
+  BOOST_REQUIRE(*dropAbove == 0.1);
+
+  ssc::AtomSpeciesDatabase speciesDb;
+  stf::Factory factory(speciesDb);
+  stf::Factory::PipePtr pipe;
+#ifdef SP_USE_QHULL
+  BOOST_REQUIRE(factory.createSearchPipeExtended(pipe, options));
+  BOOST_REQUIRE(pipe.get());
+#else
+  // Without Qhull the block can't be made so the pipe shouldn't be either
+  BOOST_REQUIRE(!factory.createSearchPipeExtended(pipe, options));
+#endif
+
+  // The hull needs a stoichiometry search to feed it
+  options.erase(spf::STOICHIOMETRY_SEARCH);
+  BOOST_REQUIRE(!factory.createSearchPipeExtended(pipe, options));
+}
@@ -0,0 +1,16 @@
+/*
+ * stoolstest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+
+// Initialise the boost testing framework
+// This has to be in only one of the files if we are using dynamic linking to UTF.
+// See: http://www.boost.org/doc/libs/1_48_0/libs/test/doc/html/utf/user-guide/test-runners.html
+// under heading: Dynamic library variant of the UTF
+#define BOOST_TEST_MAIN
+
+#include "stoolstest.h"
@@ -0,0 +1,10 @@
+/*
+ * stoolstest.h
+ * 
+ * STools tests global configuration file
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
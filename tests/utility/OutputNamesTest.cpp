@@ -0,0 +1,54 @@
+/*
+ * OutputNamesTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "stoolstest.h"
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+// Local //
+#include "utility/OutputNames.h"
+
+namespace fs = ::boost::filesystem;
+namespace stu = ::stools::utility;
+
+typedef ::std::vector< ::std::string> Names;
+
+BOOST_AUTO_TEST_CASE(OutputNamesTest)
+{
+  ::std::vector<fs::path> inputs;
+  inputs.push_back("dir1/a.res");
+  inputs.push_back("dir1/a.cell");
+  inputs.push_back("dir1/b.res");
+  inputs.push_back("dir2/b.res");
+  inputs.push_back("dir2/c.res");
+
+  const Names names = stu::getOutputNames(inputs);
+  BOOST_REQUIRE(names.size() == inputs.size());
+
+  // Stems that collide keep their extension
+  BOOST_REQUIRE(names[0] == "a-res");
+  BOOST_REQUIRE(names[1] == "a-cell");
+  // The same filename from two directories can't be told apart
+  BOOST_REQUIRE(names[2] == "b-res");
+  BOOST_REQUIRE(names[3].empty());
+  // Unique stems are left alone
+  BOOST_REQUIRE(names[4] == "c");
+
+  // A name made by keeping the extension mustn't overwrite a real one
+  inputs.clear();
+  inputs.push_back("a-res.cell");
+  inputs.push_back("a.res");
+  inputs.push_back("a.cell");
+  const Names clashing = stu::getOutputNames(inputs);
+  BOOST_REQUIRE(clashing[0] == "a-res");
+  BOOST_REQUIRE(clashing[1].empty());
+  BOOST_REQUIRE(clashing[2] == "a-cell");
+}
@@ -0,0 +1,68 @@
+/*
+ * ParallelJobsTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+// INCLUDES //////////////////////////////////
+#include "stoolstest.h"
+
+#include <sstream>
+#include <string>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+
+// Local //
+#include "utility/ParallelJobs.h"
+
+namespace stu = ::stools::utility;
+
+/** Jobs that finish in reverse order, every third one fails. */
+class ReverseFinishingJobs : public stu::IParallelJobs
+{
+public:
+  ReverseFinishingJobs(const size_t numJobs): myNumJobs(numJobs) {}
+
+  virtual bool runJob(
+    const size_t job,
+    const size_t worker,
+    ::std::ostream & out,
+    ::std::ostream & err)
+  {
+    ::boost::this_thread::sleep(::boost::posix_time::milliseconds(5 * (myNumJobs - job)));
+    out << job << " ";
+    if(job % 3 == 0)
+    {
+      err << job << " ";
+      return false;
+    }
+    return true;
+  }
+
+private:
+  const size_t myNumJobs;
+};
+
+BOOST_AUTO_TEST_CASE(OrderedOutputTest)
+{
+  const size_t NUM_JOBS = 10;
+
+  ::std::string expectedOut, expectedErr;
+  for(size_t i = 0; i < NUM_JOBS; ++i)
+  {
+    expectedOut += ::boost::lexical_cast< ::std::string>(i) + " ";
+    if(i % 3 == 0)
+      expectedErr += ::boost::lexical_cast< ::std::string>(i) + " ";
+  }
+
+  ReverseFinishingJobs jobs(NUM_JOBS);
+  for(size_t numThreads = 1; numThreads <= 4; ++numThreads)
+  {
+    ::std::ostringstream out, err;
+    BOOST_REQUIRE(stu::runJobsInOrder(NUM_JOBS, jobs, numThreads, out, err) == 4);
+    BOOST_REQUIRE(out.str() == expectedOut);
+    BOOST_REQUIRE(err.str() == expectedErr);
+  }
+}